@@ -0,0 +1,114 @@
+// Measures simulation steps per second against the number of steps recorded into each command buffer. A step
+// is the field pass, PIC push and periodic boundary, with every kernel's params taken from the uniform arena as in
+// Scene::compute. Tracers run once a frame rather than per step, so they are left out.
+//
+// Usage: batch_steps_bench [nParticles] [cellsPerAxis]
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "bench_util.h"
+#include "physical_constants.h"
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "compute/particles.h"
+#include "compute/fields.h"
+#include "compute/boundary.h"
+#include "util/uniform_arena.h"
+#include "current_segment.h"
+#include "mesh.h"
+#include "util/wgpu_util.h"
+
+namespace {
+
+const glm::u32 DEFAULT_PARTICLES = 4096;
+const glm::u32 DEFAULT_CELLS_PER_AXIS = 16;
+const glm::u32 STEPS = 512;                 // Steps timed per batch size
+const glm::u32 MAX_STEPS_PER_SUBMIT = 64;
+const glm::u32 UNIFORM_SLOTS_PER_STEP = 4;  // field, PIC params and mesh, boundary
+const glm::f32 DT = 1e-10f;
+
+void make_mesh(glm::u32 n, std::vector<Cell>& cells, MeshProperties& mesh) {
+    glm::f32 h = 2.0f / n;
+    mesh.min = glm::f32vec3(-1.0f + 0.5f * h);
+    mesh.max = glm::f32vec3(1.0f - 0.5f * h);
+    mesh.dim = glm::u32vec3(n, n, n);
+    mesh.cell_size = glm::f32vec3(h);
+
+    cells.clear();
+    for (glm::u32 x = 0; x < n; x++)
+        for (glm::u32 z = 0; z < n; z++)
+            for (glm::u32 y = 0; y < n; y++) {
+                glm::f32vec3 c(-1.0f + (x + 0.5f) * h, -1.0f + (y + 0.5f) * h, -1.0f + (z + 0.5f) * h);
+                Cell cell;
+                cell.pos = glm::f32vec4(c.x, c.y, c.z, 1.0f);
+                cell.min = glm::f32vec3(c.x - 0.5f * h, c.y - 0.5f * h, c.z - 0.5f * h);
+                cell.max = glm::f32vec3(c.x + 0.5f * h, c.y + 0.5f * h, c.z + 0.5f * h);
+                cells.push_back(cell);
+            }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    glm::u32 nParticles = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PARTICLES;
+    glm::u32 cellsPerAxis = argc > 2 ? std::stoul(argv[2]) : DEFAULT_CELLS_PER_AXIS;
+
+    BenchContext ctx = create_bench_context();
+    if (!ctx.valid) {
+        std::cerr << "WebGPU device not available" << std::endl;
+        return 1;
+    }
+
+    std::vector<Cell> cells;
+    MeshProperties mesh;
+    make_mesh(cellsPerAxis, cells, mesh);
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<glm::f32> unit(-1.0f, 1.0f);
+    ParticleBuffers particleBuf = create_particle_buffers(
+        ctx.device,
+        [&]() { return glm::f32vec4(0.9f * unit(gen), 0.9f * unit(gen), 0.9f * unit(gen), 0.0f); },
+        [&](PARTICLE_SPECIES) { return glm::f32vec4(1e5f * unit(gen), 1e5f * unit(gen), 1e5f * unit(gen), 0.0f); },
+        [&]() { return unit(gen) < 0.0f ? ELECTRON : PROTON; },
+        nParticles,
+        nParticles);
+    FieldBuffers fieldBuf = create_fields_buffers(ctx.device, nCells);
+
+    std::vector<CurrentVector> currents = {
+        CurrentVector{ .x = glm::f32vec4(0.f, 0.f, 0.f, 0.f), .dx = glm::f32vec4(1.f, 0.f, 0.f, 0.f), .i = 1.f }
+    };
+    wgpu::Buffer currentSegmentsBuffer = get_current_segment_buffer(ctx.device, currents);
+
+    UniformArena uniforms = create_uniform_arena(ctx.device, MAX_STEPS_PER_SUBMIT * UNIFORM_SLOTS_PER_STEP * 256);
+    FieldCompute fieldCompute = create_field_compute(ctx.device, cells, particleBuf, fieldBuf, currentSegmentsBuffer, 1u, nParticles, uniforms);
+    ParticleCompute particleCompute = create_particle_pic_compute(ctx.device, cells, particleBuf, fieldBuf, nParticles, uniforms);
+    BoundaryCompute boundaryCompute = create_boundary_compute(ctx.device, particleBuf, nParticles, uniforms);
+
+    auto record_step = [&](wgpu::ComputePassEncoder& pass) {
+        run_field_compute(pass, fieldCompute, uniforms, nCells, 1u, 0.f, 0u);
+        run_particle_pic_compute(pass, particleCompute, uniforms, mesh, DT, 0u, nParticles);
+        run_boundary_compute(pass, boundaryCompute, uniforms, -1.f, 1.f, -1.f, 1.f, -1.f, 1.f, nParticles);
+    };
+
+    std::cout << "cells: " << nCells << ", particles: " << nParticles << ", steps per run: " << STEPS << std::endl;
+    double baseline = 0.0;
+    for (glm::u32 k = 1; k <= MAX_STEPS_PER_SUBMIT; k *= 2) {
+        double msPerSubmit = time_submits_ms(ctx, STEPS / k, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            for (glm::u32 i = 0; i < k; i++) {
+                record_step(pass);
+            }
+            pass.End();
+            flush_uniform_arena(ctx.device, uniforms);
+        });
+        double stepsPerSecond = 1000.0 * k / msPerSubmit;
+        if (k == 1) baseline = stepsPerSecond;
+        std::cout << "K = " << k << ": " << stepsPerSecond << " steps/s (" << stepsPerSecond / baseline << "x)" << std::endl;
+    }
+    return 0;
+}
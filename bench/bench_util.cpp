@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include "bench_util.h"
+#include "physical_constants.h"
+#include "plasma.h"
+#include "util/wgpu_util.h"
+
+BenchContext create_bench_context() {
+    BenchContext ctx;
+#ifdef __APPLE__
+    wgpu::InstanceDescriptor instanceDesc{.capabilities = {.timedWaitAnyEnable = true}};
+#else
+    wgpu::InstanceFeatureName requiredFeatures[] = {wgpu::InstanceFeatureName::TimedWaitAny};
+    wgpu::InstanceDescriptor instanceDesc{
+        .requiredFeatureCount = 1,
+        .requiredFeatures = requiredFeatures
+    };
+#endif
+    ctx.instance = wgpu::CreateInstance(&instanceDesc);
+    if (!ctx.instance) return ctx;
+
+    wgpu::Future f1 = ctx.instance.RequestAdapter(
+        nullptr,
+        wgpu::CallbackMode::WaitAnyOnly,
+        [&ctx](wgpu::RequestAdapterStatus status, wgpu::Adapter a, wgpu::StringView message) {
+            if (status == wgpu::RequestAdapterStatus::Success)
+                ctx.adapter = std::move(a);
+        });
+    ctx.instance.WaitAny(f1, UINT64_MAX);
+    if (!ctx.adapter) return ctx;
+
+    wgpu::DeviceDescriptor desc{};
+    desc.SetUncapturedErrorCallback([](const wgpu::Device&, wgpu::ErrorType, wgpu::StringView message) {
+        std::cerr << "WebGPU error: " << message.data << std::endl;
+    });
+
+    wgpu::Future f2 = ctx.adapter.RequestDevice(
+        &desc, wgpu::CallbackMode::WaitAnyOnly,
+        [&ctx](wgpu::RequestDeviceStatus status, wgpu::Device d, wgpu::StringView message) {
+            if (status == wgpu::RequestDeviceStatus::Success)
+                ctx.device = std::move(d);
+        });
+    ctx.instance.WaitAny(f2, UINT64_MAX);
+    if (!ctx.device) return ctx;
+
+    ctx.valid = true;
+    return ctx;
+}
+
+void wait_for_submitted_work(BenchContext& ctx) {
+    wgpu::Future f = ctx.device.GetQueue().OnSubmittedWorkDone(
+        wgpu::CallbackMode::WaitAnyOnly,
+        [](wgpu::QueueWorkDoneStatus status, wgpu::StringView message) {
+            if (status != wgpu::QueueWorkDoneStatus::Success) {
+                std::cerr << "Queue work failed: " << message.data << std::endl;
+            }
+        });
+    ctx.instance.WaitAny(f, UINT64_MAX);
+}
+
+double time_submits_ms(BenchContext& ctx, int nIterations, const std::function<void(wgpu::CommandEncoder&)>& record) {
+    auto submit = [&]() {
+        wgpu::CommandEncoder encoder = ctx.device.CreateCommandEncoder();
+        record(encoder);
+        wgpu::CommandBuffer cmd = encoder.Finish();
+        ctx.device.GetQueue().Submit(1, &cmd);
+    };
+
+    submit();
+    wait_for_submitted_work(ctx);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < nIterations; i++) {
+        submit();
+    }
+    wait_for_submitted_work(ctx);
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / nIterations;
+}
+
+std::string format_bytes(double bytes) {
+    const char* units[] = { "B", "KB", "MB", "GB", "TB" };
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        unit++;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f %s", bytes, units[unit]);
+    return buf;
+}
+
+void read_back(BenchContext& ctx, const wgpu::Buffer& src, glm::u64 size, void* dst) {
+    wgpu::BufferDescriptor readDesc = {
+        .label = "Bench Readback Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+        .size = size,
+        .mappedAtCreation = false
+    };
+    wgpu::Buffer readBuf = ctx.device.CreateBuffer(&readDesc);
+    wgpu::CommandEncoder encoder = ctx.device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(src, 0, readBuf, 0, size);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    ctx.device.GetQueue().Submit(1, &commands);
+    if (!read_buffer(ctx.instance, readBuf, size, dst)) {
+        std::cerr << "Failed to read back buffer" << std::endl;
+        exit(1);
+    }
+}
+
+wgpu::BindGroupLayoutEntry storage_entry(glm::u32 binding, glm::u64 size) {
+    return wgpu::BindGroupLayoutEntry {
+        .binding = binding,
+        .visibility = wgpu::ShaderStage::Compute,
+        .buffer = {
+            .type = wgpu::BufferBindingType::Storage,
+            .minBindingSize = size
+        }
+    };
+}
+
+wgpu::BindGroupLayoutEntry uniform_entry(glm::u32 binding, glm::u64 size) {
+    return wgpu::BindGroupLayoutEntry {
+        .binding = binding,
+        .visibility = wgpu::ShaderStage::Compute,
+        .buffer = {
+            .type = wgpu::BufferBindingType::Uniform,
+            .minBindingSize = size
+        }
+    };
+}
+
+MeshProperties make_tokamak_mesh(glm::f32 h, std::vector<Cell>& cells) {
+    const glm::f32 R1 = TOKAMAK_R1;
+    const glm::f32 R2 = TOKAMAK_R2;
+    glm::f32vec3 minCoord(-(R1 + R2), -R2, -(R1 + R2));
+    glm::f32vec3 maxCoord(R1 + R2, R2, R1 + R2);
+
+    glm::u32 nx = 0, ny = 0, nz = 0;
+    bool countZ = true, countY = true;
+    cells.clear();
+    for (glm::f32 x = minCoord.x; x <= maxCoord.x; x += h) {
+        for (glm::f32 z = minCoord.z; z <= maxCoord.z; z += h) {
+            glm::f32 fromCenterline = std::sqrt(x * x + z * z) - R1;
+            for (glm::f32 y = minCoord.y; y <= maxCoord.y; y += h) {
+                bool isActive = std::sqrt(fromCenterline * fromCenterline + y * y) < R2;
+                Cell cell;
+                cell.pos = glm::f32vec4(x, y, z, isActive ? 1.0f : 0.0f);
+                cell.min = glm::f32vec3(x - h / 2.0f, y - h / 2.0f, z - h / 2.0f);
+                cell.max = glm::f32vec3(x + h / 2.0f, y + h / 2.0f, z + h / 2.0f);
+                cells.push_back(cell);
+                if (countY) ny++;
+            }
+            if (countZ) nz++;
+            countY = false;
+        }
+        nx++;
+        countZ = false;
+    }
+
+    MeshProperties mesh;
+    mesh.dim = glm::u32vec3(nx, ny, nz);
+    mesh.cell_size = glm::f32vec3(h);
+    mesh.min = minCoord;
+    mesh.max = maxCoord;
+    return mesh;
+}
+
+ParticleBuffers create_tokamak_plasma_buffers(wgpu::Device& device, glm::u32 nParticles, glm::f32 temperature, glm::u64 seed) {
+    ParticleDistribution distribution = {
+        .type = DISTRIBUTION_CYLINDRICAL,
+        .min = glm::f32vec3(TOKAMAK_R1 - TOKAMAK_R2 / 4.0f, -TOKAMAK_R2 / 4.0f, 0.0f),
+        .max = glm::f32vec3(TOKAMAK_R1 + TOKAMAK_R2 / 4.0f, TOKAMAK_R2 / 4.0f, 2.0f * PI)
+    };
+    return create_particle_buffers(device, nParticles, nParticles, [&](glm::f32vec4* pos, glm::f32vec4* vel) {
+        generate_initial_particles(
+            pos,
+            vel,
+            nParticles,
+            distribution,
+            { { ELECTRON, 0.5f }, { PROTON, 0.5f } },
+            temperature,
+            seed,
+            std::max(1u, std::thread::hardware_concurrency()));
+    });
+}
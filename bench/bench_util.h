@@ -0,0 +1,49 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+#include "shared/particles.h"
+
+// Shared setup for the GPU benchmarks. Each benchmark is its own executable and is run from the project root so
+// the kernel/ paths resolve.
+
+struct BenchContext {
+    wgpu::Instance instance;
+    wgpu::Adapter adapter;
+    wgpu::Device device;
+    bool valid = false;
+};
+
+BenchContext create_bench_context();
+
+// Blocks until everything submitted so far has finished on the GPU
+void wait_for_submitted_work(BenchContext& ctx);
+
+// Records and submits nIterations command buffers, returning the mean wall-clock time per submit in ms. One
+// untimed submit is run first to absorb pipeline creation.
+double time_submits_ms(BenchContext& ctx, int nIterations, const std::function<void(wgpu::CommandEncoder&)>& record);
+
+// Formats a byte count as KB/MB/GB
+std::string format_bytes(double bytes);
+
+// Copies size bytes of src back to the host, exiting if the map fails
+void read_back(BenchContext& ctx, const wgpu::Buffer& src, glm::u64 size, void* dst);
+
+// Compute-visible storage and uniform buffer layout entries
+wgpu::BindGroupLayoutEntry storage_entry(glm::u32 binding, glm::u64 size);
+wgpu::BindGroupLayoutEntry uniform_entry(glm::u32 binding, glm::u64 size);
+
+// TorusParameters defaults
+const glm::f32 TOKAMAK_R1 = 1.0f;
+const glm::f32 TOKAMAK_R2 = 0.4f;
+
+// The mesh TokamakScene::get_mesh_cells builds at cell spacing h: a box around the torus, walked x, z, y
+MeshProperties make_tokamak_mesh(glm::f32 h, std::vector<Cell>& cells);
+
+// nParticles electrons and protons, half of each, at temperature K in the band around the centerline the tokamak
+// scene starts its plasma in
+ParticleBuffers create_tokamak_plasma_buffers(wgpu::Device& device, glm::u32 nParticles, glm::f32 temperature, glm::u64 seed);
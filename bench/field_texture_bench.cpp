@@ -0,0 +1,321 @@
+// Measures the PIC mesh gather of E and B from the field buffers (8 storage loads per field, kernel/mesh.wgsl)
+// against the same gather from the field textures in kernel/field_texture.wgsl: 8 texel loads from rgba32float and
+// rgba16float, and one hardware-filtered sample from rgba16float. Each is timed on the particles in the order they
+// were drawn and again after sorting them by cell, along with the cost of writing the textures, and the texture
+// paths are checked against the buffer path in an analytic tokamak-like field.
+//
+// Usage: field_texture_bench [nParticles] [cellSpacing]
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "bench_util.h"
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "compute/field_textures.h"
+#include "compute/sort.h"
+#include "compute/indirect.h"
+#include "mesh.h"
+#include "util/wgpu_util.h"
+
+namespace {
+
+const glm::u32 DEFAULT_PARTICLES = 1000000;
+const glm::f32 DEFAULT_CELL_SPACING = 0.05f;
+const glm::u32 GATHERS_PER_SUBMIT = 16;
+const int ITERATIONS = 20;
+const glm::f32 TEMPERATURE = 100000.0f;
+const glm::u64 SEED = 1;
+const glm::f32 E_MAJOR_RADIUS = 1e4f; // V/m, radial from the torus axis, at the major radius
+const glm::f32 B_TOROIDAL = 1.0f;     // T, at the major radius
+const glm::f32 B_VERTICAL = 0.1f;     // T
+const glm::f32 E_SCALE_16 = 1e-2f;    // E near the torus axis reaches ~2e5 V/m at the default spacing
+
+struct GatherBenchCompute {
+    wgpu::ComputePipeline bufferPipeline;
+    wgpu::ComputePipeline loadPipeline;
+    wgpu::ComputePipeline samplePipeline; // Only for filterable textures
+    wgpu::BindGroup bindGroup;
+};
+
+// Gathers from fieldBuf or from the textures of textureCompute into gatheredE and gatheredB
+GatherBenchCompute create_gather_bench_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const FieldTextureCompute& textureCompute,
+    const wgpu::Buffer& gatheredE,
+    const wgpu::Buffer& gatheredB,
+    glm::u32 nParticles)
+{
+    GatherBenchCompute compute = {};
+
+    wgpu::ShaderModule module = create_shader_module(
+        device,
+        "bench/field_texture_bench.wgsl",
+        {
+            "kernel/mesh.wgsl",
+            "kernel/field_texture.wgsl"
+        }
+    );
+    if (!module) {
+        std::cerr << "Failed to create field texture bench shader module" << std::endl;
+        exit(1);
+    }
+
+    glm::u64 particleSize = nParticles * sizeof(glm::f32vec4);
+    glm::u64 fieldSize = fieldBuf.nCells * sizeof(glm::f32vec4);
+    bool filterable = textureCompute.format == wgpu::TextureFormat::RGBA16Float;
+
+    auto texture_entry = [&](glm::u32 binding) {
+        return wgpu::BindGroupLayoutEntry {
+            .binding = binding,
+            .visibility = wgpu::ShaderStage::Compute,
+            .texture = {
+                .sampleType = filterable ? wgpu::TextureSampleType::Float : wgpu::TextureSampleType::UnfilterableFloat,
+                .viewDimension = wgpu::TextureViewDimension::e3D
+            }
+        };
+    };
+    std::vector<wgpu::BindGroupLayoutEntry> bindings = {
+        storage_entry(0, sizeof(glm::u32)),              // nParticles
+        storage_entry(1, particleSize),                  // particlePos
+        storage_entry(2, fieldSize),                     // eField
+        storage_entry(3, fieldSize),                     // bField
+        storage_entry(4, particleSize),                  // gatheredE
+        storage_entry(5, particleSize),                  // gatheredB
+        uniform_entry(6, sizeof(FieldTextureParams)),    // textureParams
+        uniform_entry(7, sizeof(MeshPropertiesUniform)), // mesh
+        texture_entry(8),                                // eTexture
+        texture_entry(9)                                 // bTexture
+    };
+    // rgba32float is unfilterable, so its layout has no sampler and only the load path runs against it
+    if (filterable) {
+        bindings.push_back({ // fieldSampler
+            .binding = 10,
+            .visibility = wgpu::ShaderStage::Compute,
+            .sampler = { .type = wgpu::SamplerBindingType::Filtering }
+        });
+    }
+    wgpu::BindGroupLayoutDescriptor layoutDesc = {
+        .label = "Field Texture Bench Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(bindings.size()),
+        .entries = bindings.data()
+    };
+    wgpu::BindGroupLayout bindGroupLayout = device.CreateBindGroupLayout(&layoutDesc);
+
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDesc = {
+        .label = "Field Texture Bench Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &bindGroupLayout
+    };
+    wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&pipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint) {
+        wgpu::ComputePipelineDescriptor pipelineDesc = {
+            .label = label,
+            .layout = pipelineLayout,
+            .compute = {
+                .module = module,
+                .entryPoint = entryPoint
+            }
+        };
+        return device.CreateComputePipeline(&pipelineDesc);
+    };
+    compute.bufferPipeline = create_pipeline("Buffer Gather Pipeline", "gatherBuffer");
+    compute.loadPipeline = create_pipeline("Texture Load Gather Pipeline", "gatherTextureLoad");
+    if (filterable) {
+        compute.samplePipeline = create_pipeline("Texture Sample Gather Pipeline", "gatherTextureSample");
+    }
+
+    std::vector<wgpu::BindGroupEntry> entries = {
+        { .binding = 0, .buffer = particleBuf.nCur, .offset = 0, .size = sizeof(glm::u32) },
+        { .binding = 1, .buffer = particleBuf.pos, .offset = 0, .size = particleSize },
+        { .binding = 2, .buffer = fieldBuf.eField, .offset = 0, .size = fieldSize },
+        { .binding = 3, .buffer = fieldBuf.bField, .offset = 0, .size = fieldSize },
+        { .binding = 4, .buffer = gatheredE, .offset = 0, .size = particleSize },
+        { .binding = 5, .buffer = gatheredB, .offset = 0, .size = particleSize },
+        { .binding = 6, .buffer = textureCompute.paramsBuffer, .offset = 0, .size = sizeof(FieldTextureParams) },
+        { .binding = 7, .buffer = textureCompute.meshBuffer, .offset = 0, .size = sizeof(MeshPropertiesUniform) },
+        { .binding = 8, .textureView = textureCompute.eView },
+        { .binding = 9, .textureView = textureCompute.bView }
+    };
+    if (filterable) {
+        entries.push_back({ .binding = 10, .sampler = textureCompute.sampler });
+    }
+    wgpu::BindGroupDescriptor bindGroupDesc = {
+        .label = "Field Texture Bench Bind Group",
+        .layout = bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(entries.size()),
+        .entries = entries.data()
+    };
+    compute.bindGroup = device.CreateBindGroup(&bindGroupDesc);
+
+    return compute;
+}
+
+wgpu::Buffer create_gathered_buffer(wgpu::Device& device, glm::u32 nParticles) {
+    wgpu::BufferDescriptor desc = {
+        .label = "Gathered Field Buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc,
+        .size = nParticles * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    return device.CreateBuffer(&desc);
+}
+
+struct GatherError {
+    glm::f64 rms = 0.0;
+    glm::f64 max = 0.0;
+};
+
+// Error of each gathered vector relative to the reference, over the particles with a nonzero reference
+GatherError gather_error(const std::vector<glm::f32vec4>& gathered, const std::vector<glm::f32vec4>& reference) {
+    GatherError error;
+    glm::f64 sumErr2 = 0.0;
+    glm::u32 n = 0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        glm::f64 refLength = glm::length(glm::f32vec3(reference[i]));
+        if (refLength == 0.0) {
+            continue;
+        }
+        glm::f64 err = glm::length(glm::f32vec3(gathered[i]) - glm::f32vec3(reference[i])) / refLength;
+        sumErr2 += err * err;
+        error.max = std::max(error.max, err);
+        n++;
+    }
+    error.rms = n > 0 ? std::sqrt(sumErr2 / n) : 0.0;
+    return error;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    glm::u32 nParticles = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PARTICLES;
+    glm::f32 cellSpacing = argc > 2 ? std::stof(argv[2]) : DEFAULT_CELL_SPACING;
+
+    BenchContext ctx = create_bench_context();
+    if (!ctx.valid) {
+        std::cerr << "WebGPU device not available" << std::endl;
+        return 1;
+    }
+
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_tokamak_mesh(cellSpacing, cells);
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+
+    ParticleBuffers particleBuf = create_tokamak_plasma_buffers(ctx.device, nParticles, TEMPERATURE, SEED);
+
+    // E radial from the torus axis and B toroidal, both falling off as 1/r, plus a uniform vertical B, so the
+    // interpolation is not exact anywhere
+    std::vector<glm::f32vec4> eField(nCells);
+    std::vector<glm::f32vec4> bField(nCells);
+    for (glm::u32 i = 0; i < nCells; i++) {
+        glm::f32vec3 p = glm::f32vec3(cells[i].pos);
+        glm::f32 r = std::max(std::sqrt(p.x * p.x + p.z * p.z), cellSpacing);
+        glm::f32vec3 radial = glm::f32vec3(p.x, 0.0f, p.z) / r;
+        glm::f32vec3 toroidal = glm::f32vec3(-p.z, 0.0f, p.x) / r;
+        eField[i] = glm::f32vec4(radial * (E_MAJOR_RADIUS * TOKAMAK_R1 / r), 0.0f);
+        bField[i] = glm::f32vec4(toroidal * (B_TOROIDAL * TOKAMAK_R1 / r) + glm::f32vec3(0.0f, B_VERTICAL, 0.0f), 0.0f);
+    }
+    FieldBuffers fieldBuf = create_fields_buffers(ctx.device, nCells);
+    ctx.device.GetQueue().WriteBuffer(fieldBuf.eField, 0, eField.data(), nCells * sizeof(glm::f32vec4));
+    ctx.device.GetQueue().WriteBuffer(fieldBuf.bField, 0, bField.data(), nCells * sizeof(glm::f32vec4));
+
+    FieldTextureCompute textures32 = create_field_texture_compute(ctx.device, fieldBuf, mesh, wgpu::TextureFormat::RGBA32Float);
+    FieldTextureCompute textures16 = create_field_texture_compute(ctx.device, fieldBuf, mesh, wgpu::TextureFormat::RGBA16Float, E_SCALE_16);
+
+    wgpu::Buffer gatheredE = create_gathered_buffer(ctx.device, nParticles);
+    wgpu::Buffer gatheredB = create_gathered_buffer(ctx.device, nParticles);
+    GatherBenchCompute gather32 = create_gather_bench_compute(ctx.device, particleBuf, fieldBuf, textures32, gatheredE, gatheredB, nParticles);
+    GatherBenchCompute gather16 = create_gather_bench_compute(ctx.device, particleBuf, fieldBuf, textures16, gatheredE, gatheredB, nParticles);
+
+    ParticleIndirectCompute particleIndirect = create_particle_indirect_compute(ctx.device, particleBuf, nParticles, 0);
+    SortCompute sortCompute = create_sort_compute(ctx.device, particleBuf, mesh, nCells, nParticles);
+
+    auto time_texture_writes = [&](const FieldTextureCompute& textureCompute) {
+        double msPerSubmit = time_submits_ms(ctx, ITERATIONS, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            for (glm::u32 i = 0; i < GATHERS_PER_SUBMIT; i++) {
+                run_field_texture_compute(pass, textureCompute);
+            }
+            pass.End();
+        });
+        return msPerSubmit / GATHERS_PER_SUBMIT;
+    };
+    auto time_gathers = [&](const wgpu::ComputePipeline& pipeline, const wgpu::BindGroup& bindGroup) {
+        double msPerSubmit = time_submits_ms(ctx, ITERATIONS, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            pass.SetPipeline(pipeline);
+            pass.SetBindGroup(0, bindGroup);
+            for (glm::u32 i = 0; i < GATHERS_PER_SUBMIT; i++) {
+                pass.DispatchWorkgroupsIndirect(particleIndirect.argsBuffer, PARTICLE_DISPATCH_ARGS_OFFSET);
+            }
+            pass.End();
+        });
+        return msPerSubmit / GATHERS_PER_SUBMIT;
+    };
+
+    // Also leaves both sets of textures written for the gathers below
+    double write32Ms = time_texture_writes(textures32);
+    double write16Ms = time_texture_writes(textures16);
+
+    struct GatherPath {
+        const char* name;
+        const wgpu::ComputePipeline& pipeline;
+        const wgpu::BindGroup& bindGroup;
+        double unsortedMs = 0.0;
+        double sortedMs = 0.0;
+        GatherError eError;
+        GatherError bError;
+    };
+    std::vector<GatherPath> paths = {
+        { "buffer          ", gather32.bufferPipeline, gather32.bindGroup },
+        { "rgba32f load    ", gather32.loadPipeline, gather32.bindGroup },
+        { "rgba16f load    ", gather16.loadPipeline, gather16.bindGroup },
+        { "rgba16f sampled ", gather16.samplePipeline, gather16.bindGroup }
+    };
+
+    // Check each texture path against the buffer path (the first) on the particles as drawn
+    std::vector<glm::f32vec4> refE(nParticles), refB(nParticles), E(nParticles), B(nParticles);
+    for (size_t k = 0; k < paths.size(); k++) {
+        paths[k].unsortedMs = time_gathers(paths[k].pipeline, paths[k].bindGroup);
+        wait_for_submitted_work(ctx);
+        read_back(ctx, gatheredE, nParticles * sizeof(glm::f32vec4), k == 0 ? refE.data() : E.data());
+        read_back(ctx, gatheredB, nParticles * sizeof(glm::f32vec4), k == 0 ? refB.data() : B.data());
+        if (k > 0) {
+            paths[k].eError = gather_error(E, refE);
+            paths[k].bError = gather_error(B, refB);
+        }
+    }
+
+    wgpu::CommandEncoder encoder = ctx.device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    run_sort_compute(pass, sortCompute, particleIndirect.argsBuffer, false);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    ctx.device.GetQueue().Submit(1, &commands);
+
+    for (GatherPath& path : paths) {
+        path.sortedMs = time_gathers(path.pipeline, path.bindGroup);
+    }
+    wait_for_submitted_work(ctx);
+
+    std::cout << "cells: " << nCells << " (" << mesh.dim.x << "x" << mesh.dim.y << "x" << mesh.dim.z << "), particles: " << nParticles
+              << ", gathers per run: " << (ITERATIONS + 1) * GATHERS_PER_SUBMIT << std::endl;
+    std::cout << "texture writes: rgba32f " << write32Ms << " ms, rgba16f " << write16Ms << " ms" << std::endl;
+    for (const GatherPath& path : paths) {
+        std::cout << path.name << "unsorted " << path.unsortedMs << " ms/gather (" << paths[0].unsortedMs / path.unsortedMs << "x), "
+                  << "sorted " << path.sortedMs << " ms/gather (" << paths[0].sortedMs / path.sortedMs << "x)";
+        if (&path != &paths[0]) {
+            std::cout << ", E error rms " << path.eError.rms << " (max " << path.eError.max << "), B error rms "
+                      << path.bError.rms << " (max " << path.bError.max << ")";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
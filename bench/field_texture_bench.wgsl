@@ -0,0 +1,66 @@
+// Mesh gather of E and B at every particle, from the field buffers and from the field textures in
+// kernel/field_texture.wgsl, for field_texture_bench. Each entry point writes the same outputs; only how the fields
+// are read differs.
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> bField: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> gatheredE: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read_write> gatheredB: array<vec4<f32>>;
+@group(0) @binding(6) var<uniform> textureParams: FieldTextureParams;
+@group(0) @binding(7) var<uniform> mesh: MeshProperties;
+@group(0) @binding(8) var eTexture: texture_3d<f32>;
+@group(0) @binding(9) var bTexture: texture_3d<f32>;
+@group(0) @binding(10) var fieldSampler: sampler;
+
+// 8 storage loads per field through cell_neighbors(), as the PIC kernel gathers
+@compute @workgroup_size(256)
+fn gatherBuffer(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let pos = particlePos[id].xyz;
+    var E = vec3<f32>(0.0);
+    var B = vec3<f32>(0.0);
+    var neighbors = cell_neighbors(pos, &mesh);
+    if (neighbors.xp_yp_zp != -1i) {
+        var neighbors_E = cell_neighbor_vectors(&neighbors, &eField);
+        var neighbors_B = cell_neighbor_vectors(&neighbors, &bField);
+        E = interp(&mesh, &neighbors_E, pos);
+        B = interp(&mesh, &neighbors_B, pos);
+    }
+    gatheredE[id] = vec4<f32>(E, 0.0);
+    gatheredB[id] = vec4<f32>(B, 0.0);
+}
+
+// 8 texel loads per field, interpolated in the shader
+@compute @workgroup_size(256)
+fn gatherTextureLoad(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let pos = particlePos[id].xyz;
+    let E = load_field_texture(eTexture, pos, &mesh) / textureParams.eScale;
+    let B = load_field_texture(bTexture, pos, &mesh) / textureParams.bScale;
+    gatheredE[id] = vec4<f32>(E, 0.0);
+    gatheredB[id] = vec4<f32>(B, 0.0);
+}
+
+// One filtered sample per field
+@compute @workgroup_size(256)
+fn gatherTextureSample(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let pos = particlePos[id].xyz;
+    let E = sample_field_texture(eTexture, fieldSampler, pos, &mesh) / textureParams.eScale;
+    let B = sample_field_texture(bTexture, fieldSampler, pos, &mesh) / textureParams.bScale;
+    gatheredE[id] = vec4<f32>(E, 0.0);
+    gatheredB[id] = vec4<f32>(B, 0.0);
+}
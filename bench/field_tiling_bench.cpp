@@ -0,0 +1,126 @@
+// Compares the fields kernel summing particle contributions straight from storage against the workgroup-tiled
+// sum (PARTICLE_TILING override in kernel/fields.wgsl).
+//
+// Usage: field_tiling_bench [nParticles] [cellsPerAxis]
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "bench_util.h"
+#include "physical_constants.h"
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "compute/fields.h"
+#include "current_segment.h"
+#include "mesh.h"
+#include "util/uniform_arena.h"
+#include "util/wgpu_util.h"
+
+namespace {
+
+const glm::u32 DEFAULT_PARTICLES = 16384;
+const glm::u32 DEFAULT_CELLS_PER_AXIS = 24;
+const glm::u32 WORKGROUP_SIZE = 256; // PARTICLE_TILE_SIZE in kernel/field_common.wgsl
+const int ITERATIONS = 20;
+
+std::vector<Cell> make_cells(glm::u32 n) {
+    std::vector<Cell> cells;
+    glm::f32 h = 2.0f / n;
+    for (glm::u32 x = 0; x < n; x++)
+        for (glm::u32 z = 0; z < n; z++)
+            for (glm::u32 y = 0; y < n; y++) {
+                glm::f32vec3 c(-1.0f + (x + 0.5f) * h, -1.0f + (y + 0.5f) * h, -1.0f + (z + 0.5f) * h);
+                Cell cell;
+                cell.pos = glm::f32vec4(c.x, c.y, c.z, 1.0f);
+                cell.min = glm::f32vec3(c.x - 0.5f * h, c.y - 0.5f * h, c.z - 0.5f * h);
+                cell.max = glm::f32vec3(c.x + 0.5f * h, c.y + 0.5f * h, c.z + 0.5f * h);
+                cells.push_back(cell);
+            }
+    return cells;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    glm::u32 nParticles = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PARTICLES;
+    glm::u32 cellsPerAxis = argc > 2 ? std::stoul(argv[2]) : DEFAULT_CELLS_PER_AXIS;
+
+    BenchContext ctx = create_bench_context();
+    if (!ctx.valid) {
+        std::cerr << "WebGPU device not available" << std::endl;
+        return 1;
+    }
+
+    std::vector<Cell> cells = make_cells(cellsPerAxis);
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<glm::f32> unit(-1.0f, 1.0f);
+    ParticleBuffers particleBuf = create_particle_buffers(
+        ctx.device,
+        [&]() { return glm::f32vec4(unit(gen), unit(gen), unit(gen), 0.0f); },
+        [&](PARTICLE_SPECIES) { return glm::f32vec4(1e5f * unit(gen), 1e5f * unit(gen), 1e5f * unit(gen), 0.0f); },
+        [&]() { return unit(gen) < 0.0f ? ELECTRON : PROTON; },
+        nParticles,
+        nParticles);
+    FieldBuffers fieldBuf = create_fields_buffers(ctx.device, nCells);
+
+    std::vector<CurrentVector> currents = {
+        CurrentVector{ .x = glm::f32vec4(0.f, 0.f, 0.f, 0.f), .dx = glm::f32vec4(1.f, 0.f, 0.f, 0.f), .i = 0.f }
+    };
+    wgpu::Buffer currentSegmentsBuffer = get_current_segment_buffer(ctx.device, currents);
+
+    UniformArena uniforms = create_uniform_arena(ctx.device, 256);
+    FieldCompute tiled = create_field_compute(ctx.device, cells, particleBuf, fieldBuf, currentSegmentsBuffer, 1u, nParticles, uniforms);
+
+    // Same layout and bindings, with the tiling override turned off
+    FieldCompute direct = tiled;
+    wgpu::ShaderModule module = create_shader_module(ctx.device, "kernel/fields.wgsl", {"kernel/physical_constants.wgsl", "kernel/species.wgsl", "kernel/field_common.wgsl"});
+    wgpu::PipelineLayoutDescriptor layoutDesc = {
+        .label = "Direct Field Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &tiled.bindGroupLayout
+    };
+    wgpu::PipelineLayout layout = ctx.device.CreatePipelineLayout(&layoutDesc);
+    std::vector<wgpu::ConstantEntry> constants = {
+        { .key = "PARTICLE_TILING", .value = 0.0 }
+    };
+    wgpu::ComputePipelineDescriptor pipelineDesc = {
+        .label = "Direct Field Compute Pipeline",
+        .layout = layout,
+        .compute = {
+            .module = module,
+            .entryPoint = "computeFields",
+            .constantCount = constants.size(),
+            .constants = constants.data()
+        }
+    };
+    direct.pipeline = ctx.device.CreateComputePipeline(&pipelineDesc);
+
+    auto run = [&](FieldCompute& compute) {
+        return time_submits_ms(ctx, ITERATIONS, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            run_field_compute(pass, compute, uniforms, nCells, 1u, 0.f, 1u);
+            pass.End();
+            flush_uniform_arena(ctx.device, uniforms);
+        });
+    };
+    double directMs = run(direct);
+    double tiledMs = run(tiled);
+
+    // Particle data read from storage per dispatch: pos + vel per particle, per invocation (direct) or per
+    // workgroup (tiled)
+    glm::u32 nWorkgroups = (nCells + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+    double particleBytes = 2.0 * sizeof(glm::f32vec4) * nParticles;
+    double directBytes = particleBytes * nCells;
+    double tiledBytes = particleBytes * nWorkgroups;
+
+    std::cout << "cells: " << nCells << ", particles: " << nParticles << ", iterations: " << ITERATIONS << std::endl;
+    std::cout << "direct: " << directMs << " ms/dispatch, particle reads " << format_bytes(directBytes) << std::endl;
+    std::cout << "tiled:  " << tiledMs << " ms/dispatch, particle reads " << format_bytes(tiledBytes) << std::endl;
+    std::cout << "storage traffic reduction: " << directBytes / tiledBytes << "x, speedup: " << directMs / tiledMs << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,32 @@
+// Converts the particle arrays to and from the packed layout in bench/particle_pack.wgsl. Dispatches:
+//
+//   packParticles    particlePos/particleVel -> packedParticles
+//   unpackParticles  packedParticles -> particlePos/particleVel
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> packedParticles: array<PackedParticle>;
+@group(0) @binding(4) var<uniform> mesh: MeshProperties;
+
+@compute @workgroup_size(256)
+fn packParticles(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    packedParticles[id] = pack_particle(particlePos[id], particleVel[id].xyz, &mesh);
+}
+
+@compute @workgroup_size(256)
+fn unpackParticles(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let p = packedParticles[id];
+    particlePos[id] = unpack_particle_pos(p, &mesh);
+    particleVel[id] = vec4<f32>(unpack_particle_vel(p), 0.0);
+}
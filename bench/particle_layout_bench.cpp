@@ -0,0 +1,248 @@
+// Measures a PIC push over the fp32 particle arrays (pos and vel, 32 bytes a particle) against the same push over
+// the packed layout in bench/particle_pack.wgsl (24 bytes a particle), and how far the packed particles have
+// drifted from the fp32 ones after the same pushes. Both start from the same particles in uniform E and B.
+//
+// Usage: particle_layout_bench [nParticles] [cellSpacing]
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "bench_util.h"
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "particle_pack.h"
+#include "particle_pack_compute.h"
+#include "compute/indirect.h"
+#include "mesh.h"
+#include "util/wgpu_util.h"
+
+namespace {
+
+const glm::u32 DEFAULT_PARTICLES = 1000000;
+const glm::f32 DEFAULT_CELL_SPACING = 0.05f;
+const glm::u32 PUSHES_PER_SUBMIT = 16;
+const int ITERATIONS = 20;
+const glm::f32 DT = 1e-10f;
+const glm::f32 TEMPERATURE = 100000.0f;
+const glm::u64 SEED = 1;
+const glm::f32vec3 E_UNIFORM(0.0f, 1000.0f, 0.0f); // V/m
+const glm::f32vec3 B_UNIFORM(0.0f, 0.0f, 0.1f);    // T
+
+// LayoutBenchParams in bench/particle_layout_bench.wgsl, padded to 16 bytes
+struct LayoutBenchParams {
+    glm::f32 dt;
+    glm::f32 _pad[3];
+};
+
+struct LayoutBenchCompute {
+    wgpu::ComputePipeline unpackedPipeline;
+    wgpu::ComputePipeline packedPipeline;
+    wgpu::BindGroup bindGroup;
+};
+
+LayoutBenchCompute create_layout_bench_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const ParticlePackCompute& packCompute,
+    glm::u32 nParticles)
+{
+    LayoutBenchCompute compute = {};
+
+    wgpu::ShaderModule module = create_shader_module(
+        device,
+        "bench/particle_layout_bench.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/species.wgsl",
+            "kernel/mesh.wgsl",
+            "bench/particle_pack.wgsl"
+        }
+    );
+    if (!module) {
+        std::cerr << "Failed to create particle layout bench shader module" << std::endl;
+        exit(1);
+    }
+
+    glm::u64 particleSize = nParticles * sizeof(glm::f32vec4);
+    glm::u64 packedSize = nParticles * sizeof(PackedParticle);
+    glm::u64 fieldSize = fieldBuf.nCells * sizeof(glm::f32vec4);
+
+    LayoutBenchParams params = { .dt = DT };
+    wgpu::BufferDescriptor paramsDesc = {
+        .label = "Layout Bench Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(LayoutBenchParams),
+        .mappedAtCreation = false
+    };
+    wgpu::Buffer paramsBuffer = device.CreateBuffer(&paramsDesc);
+    device.GetQueue().WriteBuffer(paramsBuffer, 0, &params, sizeof(LayoutBenchParams));
+
+    std::vector<wgpu::BindGroupLayoutEntry> bindings = {
+        storage_entry(0, sizeof(glm::u32)),              // nParticles
+        storage_entry(1, particleSize),                  // particlePos
+        storage_entry(2, particleSize),                  // particleVel
+        storage_entry(3, packedSize),                    // packedParticles
+        storage_entry(4, fieldSize),                     // eField
+        storage_entry(5, fieldSize),                     // bField
+        uniform_entry(6, sizeof(LayoutBenchParams)),     // params
+        uniform_entry(7, sizeof(MeshPropertiesUniform)), // mesh
+        uniform_entry(8, SPECIES_TABLE_SIZE)             // speciesTable
+    };
+    wgpu::BindGroupLayoutDescriptor layoutDesc = {
+        .label = "Layout Bench Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(bindings.size()),
+        .entries = bindings.data()
+    };
+    wgpu::BindGroupLayout bindGroupLayout = device.CreateBindGroupLayout(&layoutDesc);
+
+    wgpu::PipelineLayoutDescriptor pipelineLayoutDesc = {
+        .label = "Layout Bench Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &bindGroupLayout
+    };
+    wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&pipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint) {
+        wgpu::ComputePipelineDescriptor pipelineDesc = {
+            .label = label,
+            .layout = pipelineLayout,
+            .compute = {
+                .module = module,
+                .entryPoint = entryPoint
+            }
+        };
+        return device.CreateComputePipeline(&pipelineDesc);
+    };
+    compute.unpackedPipeline = create_pipeline("Unpacked Push Pipeline", "pushUnpacked");
+    compute.packedPipeline = create_pipeline("Packed Push Pipeline", "pushPacked");
+
+    std::vector<wgpu::BindGroupEntry> entries = {
+        { .binding = 0, .buffer = particleBuf.nCur, .offset = 0, .size = sizeof(glm::u32) },
+        { .binding = 1, .buffer = particleBuf.pos, .offset = 0, .size = particleSize },
+        { .binding = 2, .buffer = particleBuf.vel, .offset = 0, .size = particleSize },
+        { .binding = 3, .buffer = packCompute.packed, .offset = 0, .size = packedSize },
+        { .binding = 4, .buffer = fieldBuf.eField, .offset = 0, .size = fieldSize },
+        { .binding = 5, .buffer = fieldBuf.bField, .offset = 0, .size = fieldSize },
+        { .binding = 6, .buffer = paramsBuffer, .offset = 0, .size = sizeof(LayoutBenchParams) },
+        { .binding = 7, .buffer = packCompute.meshBuffer, .offset = 0, .size = sizeof(MeshPropertiesUniform) },
+        { .binding = 8, .buffer = particleBuf.species, .offset = 0, .size = SPECIES_TABLE_SIZE }
+    };
+    wgpu::BindGroupDescriptor bindGroupDesc = {
+        .label = "Layout Bench Bind Group",
+        .layout = bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(entries.size()),
+        .entries = entries.data()
+    };
+    compute.bindGroup = device.CreateBindGroup(&bindGroupDesc);
+
+    return compute;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    glm::u32 nParticles = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PARTICLES;
+    glm::f32 cellSpacing = argc > 2 ? std::stof(argv[2]) : DEFAULT_CELL_SPACING;
+
+    BenchContext ctx = create_bench_context();
+    if (!ctx.valid) {
+        std::cerr << "WebGPU device not available" << std::endl;
+        return 1;
+    }
+
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_tokamak_mesh(cellSpacing, cells);
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+
+    ParticleBuffers particleBuf = create_tokamak_plasma_buffers(ctx.device, nParticles, TEMPERATURE, SEED);
+
+    FieldBuffers fieldBuf = create_fields_buffers(ctx.device, nCells);
+    std::vector<glm::f32vec4> eField(nCells, glm::f32vec4(E_UNIFORM, 0.0f));
+    std::vector<glm::f32vec4> bField(nCells, glm::f32vec4(B_UNIFORM, 0.0f));
+    ctx.device.GetQueue().WriteBuffer(fieldBuf.eField, 0, eField.data(), nCells * sizeof(glm::f32vec4));
+    ctx.device.GetQueue().WriteBuffer(fieldBuf.bField, 0, bField.data(), nCells * sizeof(glm::f32vec4));
+
+    ParticleIndirectCompute particleIndirect = create_particle_indirect_compute(ctx.device, particleBuf, nParticles, 0);
+    ParticlePackCompute packCompute = create_particle_pack_compute(ctx.device, particleBuf, mesh, nParticles);
+    LayoutBenchCompute benchCompute = create_layout_bench_compute(ctx.device, particleBuf, fieldBuf, packCompute, nParticles);
+
+    // Pack the initial particles so both layouts start from the same state
+    {
+        wgpu::CommandEncoder encoder = ctx.device.CreateCommandEncoder();
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        run_particle_pack_compute(pass, packCompute, particleIndirect.argsBuffer);
+        pass.End();
+        wgpu::CommandBuffer commands = encoder.Finish();
+        ctx.device.GetQueue().Submit(1, &commands);
+    }
+
+    auto time_pushes = [&](const wgpu::ComputePipeline& pipeline) {
+        double msPerSubmit = time_submits_ms(ctx, ITERATIONS, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            pass.SetPipeline(pipeline);
+            pass.SetBindGroup(0, benchCompute.bindGroup);
+            for (glm::u32 i = 0; i < PUSHES_PER_SUBMIT; i++) {
+                pass.DispatchWorkgroupsIndirect(particleIndirect.argsBuffer, PARTICLE_DISPATCH_ARGS_OFFSET);
+            }
+            pass.End();
+        });
+        return msPerSubmit / PUSHES_PER_SUBMIT;
+    };
+
+    // time_submits_ms runs one untimed submit first, so both layouts see the same number of pushes
+    double unpackedMs = time_pushes(benchCompute.unpackedPipeline);
+    double packedMs = time_pushes(benchCompute.packedPipeline);
+    wait_for_submitted_work(ctx);
+
+    // Compare the packed particles with the fp32 ones, leaving out any the fp32 run has pushed off the mesh
+    std::vector<glm::f32vec4> pos(nParticles);
+    std::vector<glm::f32vec4> vel(nParticles);
+    std::vector<PackedParticle> packed(nParticles);
+    read_back(ctx, particleBuf.pos, nParticles * sizeof(glm::f32vec4), pos.data());
+    read_back(ctx, particleBuf.vel, nParticles * sizeof(glm::f32vec4), vel.data());
+    read_back(ctx, packCompute.packed, nParticles * sizeof(PackedParticle), packed.data());
+
+    glm::f64 sumPosErr2 = 0.0, maxPosErr = 0.0, sumVelErr2 = 0.0, maxVelErr = 0.0;
+    glm::u32 nCompared = 0;
+    for (glm::u32 i = 0; i < nParticles; i++) {
+        glm::f32vec3 p = glm::f32vec3(pos[i]);
+        bool inMesh = true;
+        for (int k = 0; k < 3; k++) {
+            inMesh = inMesh && p[k] >= mesh.min[k] && p[k] <= mesh.max[k];
+        }
+        if (pos[i].w == 0.0f || !inMesh) {
+            continue;
+        }
+        // Position error in cells, velocity error relative to the particle's speed
+        glm::f64 posErr = glm::length((glm::f32vec3(unpack_particle_pos(packed[i], mesh)) - p) / mesh.cell_size);
+        glm::f64 speed = std::max(glm::length(glm::f32vec3(vel[i])), 1.0f);
+        glm::f64 velErr = glm::length(unpack_particle_vel(packed[i]) - glm::f32vec3(vel[i])) / speed;
+        sumPosErr2 += posErr * posErr;
+        sumVelErr2 += velErr * velErr;
+        maxPosErr = std::max(maxPosErr, posErr);
+        maxVelErr = std::max(maxVelErr, velErr);
+        nCompared++;
+    }
+
+    // Each push reads and writes every particle once
+    double unpackedBytes = 2.0 * nParticles * 2 * sizeof(glm::f32vec4);
+    double packedBytes = 2.0 * nParticles * sizeof(PackedParticle);
+
+    std::cout << "cells: " << nCells << ", particles: " << nParticles << ", pushes per layout: " << (ITERATIONS + 1) * PUSHES_PER_SUBMIT << std::endl;
+    std::cout << "fp32:   " << unpackedMs << " ms/push, " << nParticles / unpackedMs / 1000.0 << " M particles/s, "
+              << 2 * sizeof(glm::f32vec4) << " B/particle, " << format_bytes(unpackedBytes / unpackedMs * 1000.0) << "/s" << std::endl;
+    std::cout << "packed: " << packedMs << " ms/push, " << nParticles / packedMs / 1000.0 << " M particles/s, "
+              << sizeof(PackedParticle) << " B/particle, " << format_bytes(packedBytes / packedMs * 1000.0) << "/s" << std::endl;
+    std::cout << "speedup: " << unpackedMs / packedMs << "x" << std::endl;
+    if (nCompared > 0) {
+        std::cout << "packed vs fp32 over " << nCompared << " particles: position rms " << std::sqrt(sumPosErr2 / nCompared)
+                  << " cells (max " << maxPosErr << "), velocity rms " << std::sqrt(sumVelErr2 / nCompared)
+                  << " relative (max " << maxVelErr << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+// PIC push (mesh gather and Boris rotation, no self-field correction) over the fp32 particle arrays and over the
+// packed layout in bench/particle_pack.wgsl, for particle_layout_bench. The two entry points do the same
+// arithmetic; only the particle loads and stores differ.
+struct LayoutBenchParams {
+    dt: f32,
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> packedParticles: array<PackedParticle>;
+@group(0) @binding(4) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read_write> bField: array<vec4<f32>>;
+@group(0) @binding(6) var<uniform> params: LayoutBenchParams;
+@group(0) @binding(7) var<uniform> mesh: MeshProperties;
+@group(0) @binding(8) var<uniform> speciesTable: SpeciesTable;
+
+fn boris_push(vel: vec3<f32>, E: vec3<f32>, B: vec3<f32>, q_over_m: f32) -> vec3<f32> {
+    let t = q_over_m * B * 0.5 * params.dt;
+    let s = 2.0 * t / (1.0 + dot(t, t));
+    let v_minus = vel + q_over_m * E * 0.5 * params.dt;
+    let v_prime = v_minus + cross(v_minus, t);
+    let v_plus = v_minus + cross(v_prime, s);
+    return v_plus + q_over_m * E * 0.5 * params.dt;
+}
+
+// The 8 nodes around a base node, as cell_neighbors finds them from a position
+fn base_neighbors(base: vec3<i32>) -> CellNeighbors {
+    var neighbors: CellNeighbors;
+    neighbors.xp_yp_zp = to_linear_index(base.x + 1, base.y + 1, base.z + 1, mesh.dim);
+    neighbors.xp_yp_zm = to_linear_index(base.x + 1, base.y + 1, base.z, mesh.dim);
+    neighbors.xp_ym_zp = to_linear_index(base.x + 1, base.y, base.z + 1, mesh.dim);
+    neighbors.xp_ym_zm = to_linear_index(base.x + 1, base.y, base.z, mesh.dim);
+    neighbors.xm_yp_zp = to_linear_index(base.x, base.y + 1, base.z + 1, mesh.dim);
+    neighbors.xm_yp_zm = to_linear_index(base.x, base.y + 1, base.z, mesh.dim);
+    neighbors.xm_ym_zp = to_linear_index(base.x, base.y, base.z + 1, mesh.dim);
+    neighbors.xm_ym_zm = to_linear_index(base.x, base.y, base.z, mesh.dim);
+    return neighbors;
+}
+
+@compute @workgroup_size(256)
+fn pushUnpacked(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let species = particlePos[id].w;
+    if (species == 0.0) {
+        return;
+    }
+
+    let pos = particlePos[id].xyz;
+    var E = vec3<f32>(0.0);
+    var B = vec3<f32>(0.0);
+    var neighbors = cell_neighbors(pos, &mesh);
+    if (neighbors.xp_yp_zp != -1i) {
+        var neighbors_E = cell_neighbor_vectors(&neighbors, &eField);
+        var neighbors_B = cell_neighbor_vectors(&neighbors, &bField);
+        E = interp(&mesh, &neighbors_E, pos);
+        B = interp(&mesh, &neighbors_B, pos);
+    }
+
+    let vel_new = boris_push(particleVel[id].xyz, E, B, charge_to_mass_ratio(species));
+    particlePos[id] = vec4<f32>(pos + vel_new * params.dt, species);
+    particleVel[id] = vec4<f32>(vel_new, 0.0);
+}
+
+@compute @workgroup_size(256)
+fn pushPacked(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let p = packedParticles[id];
+    let species = packed_particle_species(p);
+    if (species == 0.0) {
+        return;
+    }
+
+    // The base node and weights come straight from the packed particle
+    var E = vec3<f32>(0.0);
+    var B = vec3<f32>(0.0);
+    var neighbors = base_neighbors(packed_particle_base(p, &mesh));
+    if (neighbors.xp_yp_zp != -1i) {
+        var neighbors_E = cell_neighbor_vectors(&neighbors, &eField);
+        var neighbors_B = cell_neighbor_vectors(&neighbors, &bField);
+        let w = packed_particle_frac(p);
+        E = trilinear(&neighbors_E, w);
+        B = trilinear(&neighbors_B, w);
+    }
+
+    let pos = unpack_particle_pos(p, &mesh);
+    let vel_new = boris_push(unpack_particle_vel(p), E, B, charge_to_mass_ratio(species));
+    packedParticles[id] = pack_particle(vec4<f32>(pos.xyz + vel_new * params.dt, species), vel_new, &mesh);
+}
@@ -0,0 +1,45 @@
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include "particle_pack.h"
+
+const glm::u32 PACKED_SPECIES_SHIFT = 16;
+
+PackedParticle pack_particle(glm::f32vec4 pos, glm::f32vec3 vel, const MeshProperties& mesh) {
+    if (pos.w == 0.0f) {
+        return PackedParticle{ 0u, 0u, 0u, glm::f32vec3(0.0f) };
+    }
+
+    glm::i32 base[3];
+    glm::f32 frac[3];
+    for (int k = 0; k < 3; k++) {
+        glm::f32 g = (pos[k] - mesh.min[k]) / mesh.cell_size[k];
+        glm::f32 b = std::clamp(std::floor(g), 0.0f, static_cast<glm::f32>(mesh.dim[k] - 1));
+        base[k] = static_cast<glm::i32>(b);
+        frac[k] = std::clamp(g - b, 0.0f, 1.0f);
+    }
+
+    return PackedParticle{
+        static_cast<glm::u32>(to_linear_index(base[0], base[1], base[2], mesh.dim)),
+        glm::packUnorm2x16(glm::f32vec2(frac[0], frac[1])),
+        (glm::packUnorm2x16(glm::f32vec2(frac[2], 0.0f)) & 0xFFFFu) | (static_cast<glm::u32>(pos.w) << PACKED_SPECIES_SHIFT),
+        vel
+    };
+}
+
+glm::f32vec4 unpack_particle_pos(const PackedParticle& p, const MeshProperties& mesh) {
+    // Inverse of to_linear_index
+    glm::f32vec3 base(
+        static_cast<glm::f32>(p.cell / (mesh.dim.y * mesh.dim.z)),
+        static_cast<glm::f32>(p.cell % mesh.dim.y),
+        static_cast<glm::f32>((p.cell / mesh.dim.y) % mesh.dim.z));
+    glm::f32vec2 fracXY = glm::unpackUnorm2x16(p.fracXY);
+    glm::f32vec3 frac(fracXY.x, fracXY.y, glm::unpackUnorm2x16(p.fracZSpecies).x);
+    glm::f32vec3 pos = mesh.min + (base + frac) * mesh.cell_size;
+    return glm::f32vec4(pos, static_cast<glm::f32>(p.fracZSpecies >> PACKED_SPECIES_SHIFT));
+}
+
+glm::f32vec3 unpack_particle_vel(const PackedParticle& p) {
+    return p.vel;
+}
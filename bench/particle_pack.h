@@ -0,0 +1,20 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+// Host side of the packed particle layout in bench/particle_pack.wgsl, with the same fields and rounding
+struct PackedParticle {
+    glm::u32 cell;         // Base mesh node (to_linear_index)
+    glm::u32 fracXY;       // x and y offset from the base node as unorm16
+    glm::u32 fracZSpecies; // z offset as unorm16 | species << 16
+    glm::f32vec3 vel;
+};
+static_assert(sizeof(PackedParticle) == 24, "PackedParticle must match the WGSL struct stride");
+
+PackedParticle pack_particle(glm::f32vec4 pos, glm::f32vec3 vel, const MeshProperties& mesh);
+
+// [x, y, z, species], as in particlePos
+glm::f32vec4 unpack_particle_pos(const PackedParticle& p, const MeshProperties& mesh);
+
+glm::f32vec3 unpack_particle_vel(const PackedParticle& p);
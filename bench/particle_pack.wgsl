@@ -0,0 +1,61 @@
+// Packed particle layout: one PackedParticle (24 bytes) per particle in place of the pos and vel vec4<f32> pairs
+// (32 bytes). Mirrored on the host by bench/particle_pack.h. Only particle_layout_bench uses it: the simulation
+// kernels still step the fp32 arrays, since clamping particles that leave the mesh would hide them from the wall.
+//
+// Positions resolve to 1/65535 of a cell anywhere in the mesh. Velocities stay fp32: at dt ~ 1e-10 s a step's
+// change in v is far below an f16 step, so a half-precision velocity would round the E-field acceleration away.
+// Particles outside the mesh are clamped onto its edge. A particle with species 0 is an empty slot.
+struct PackedParticle {
+    cell: u32,         // Base mesh node (to_linear_index)
+    fracXY: u32,       // x and y offset from the base node, in cells, as unorm16
+    fracZSpecies: u32, // z offset as unorm16 in the low half, species in the high half
+    vx: f32,
+    vy: f32,
+    vz: f32,
+}
+
+const PACKED_SPECIES_SHIFT: u32 = 16u;
+
+fn pack_particle(pos: vec4<f32>, vel: vec3<f32>, mesh: ptr<uniform, MeshProperties>) -> PackedParticle {
+    if (pos.w == 0.0) {
+        return PackedParticle(0u, 0u, 0u, 0.0, 0.0, 0.0);
+    }
+
+    let g = (pos.xyz - (*mesh).min) / (*mesh).cell_size;
+    let base = clamp(floor(g), vec3<f32>(0.0), vec3<f32>((*mesh).dim - vec3<u32>(1u)));
+    let frac = clamp(g - base, vec3<f32>(0.0), vec3<f32>(1.0));
+    let cell = u32(to_linear_index(i32(base.x), i32(base.y), i32(base.z), (*mesh).dim));
+
+    return PackedParticle(
+        cell,
+        pack2x16unorm(frac.xy),
+        (pack2x16unorm(vec2<f32>(frac.z, 0.0)) & 0xFFFFu) | (u32(pos.w) << PACKED_SPECIES_SHIFT),
+        vel.x,
+        vel.y,
+        vel.z);
+}
+
+fn packed_particle_species(p: PackedParticle) -> f32 {
+    return f32(p.fracZSpecies >> PACKED_SPECIES_SHIFT);
+}
+
+// Grid coordinates of the base node, the xm_ym_zm corner cell_neighbors would find
+fn packed_particle_base(p: PackedParticle, mesh: ptr<uniform, MeshProperties>) -> vec3<i32> {
+    return to_grid_coords(p.cell, (*mesh).dim);
+}
+
+// Offset from the base node in cells, the trilinear weights
+fn packed_particle_frac(p: PackedParticle) -> vec3<f32> {
+    return vec3<f32>(unpack2x16unorm(p.fracXY), unpack2x16unorm(p.fracZSpecies).x);
+}
+
+// [x, y, z, species], as in particlePos
+fn unpack_particle_pos(p: PackedParticle, mesh: ptr<uniform, MeshProperties>) -> vec4<f32> {
+    let base = vec3<f32>(packed_particle_base(p, mesh));
+    let pos = (*mesh).min + (base + packed_particle_frac(p)) * (*mesh).cell_size;
+    return vec4<f32>(pos, packed_particle_species(p));
+}
+
+fn unpack_particle_vel(p: PackedParticle) -> vec3<f32> {
+    return vec3<f32>(p.vx, p.vy, p.vz);
+}
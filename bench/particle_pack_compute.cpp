@@ -0,0 +1,181 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "particle_pack.h"
+#include "particle_pack_compute.h"
+#include "compute/indirect.h"
+
+ParticlePackCompute create_particle_pack_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles)
+{
+    ParticlePackCompute packCompute = {};
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "bench/pack_particles.wgsl",
+        {
+            "kernel/mesh.wgsl",
+            "bench/particle_pack.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create particle pack compute shader module" << std::endl;
+        exit(1);
+    }
+
+    glm::u64 particleSize = maxParticles * sizeof(glm::f32vec4);
+    glm::u64 packedSize = maxParticles * sizeof(PackedParticle);
+
+    // Create packed particle buffer
+    wgpu::BufferDescriptor packedDesc = {
+        .label = "Packed Particle Buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst,
+        .size = packedSize,
+        .mappedAtCreation = false
+    };
+    packCompute.packed = device.CreateBuffer(&packedDesc);
+
+    // Create mesh uniform buffer. It does not change after creation.
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Particle Pack Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    packCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(packCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // particlePos
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // particleVel
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // packedParticles
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = packedSize
+            }
+        }, { // mesh
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Particle Pack Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    packCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines, one per direction
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Particle Pack Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &packCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint) {
+        wgpu::ComputePipelineDescriptor computePipelineDesc = {
+            .label = label,
+            .layout = computePipelineLayout,
+            .compute = {
+                .module = computeShaderModule,
+                .entryPoint = entryPoint
+            }
+        };
+        return device.CreateComputePipeline(&computePipelineDesc);
+    };
+    packCompute.packPipeline = create_pipeline("Particle Pack Pipeline", "packParticles");
+    packCompute.unpackPipeline = create_pipeline("Particle Unpack Pipeline", "unpackParticles");
+
+    // Create compute bind group
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(uint32_t)
+        }, { // particlePos
+            .binding = 1,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = particleSize
+        }, { // particleVel
+            .binding = 2,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = particleSize
+        }, { // packedParticles
+            .binding = 3,
+            .buffer = packCompute.packed,
+            .offset = 0,
+            .size = packedSize
+        }, { // mesh
+            .binding = 4,
+            .buffer = packCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Particle Pack Compute Bind Group",
+        .layout = packCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    packCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return packCompute;
+}
+
+void run_particle_pack_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticlePackCompute& packCompute,
+    const wgpu::Buffer& indirectArgs)
+{
+    computePass.SetPipeline(packCompute.packPipeline);
+    computePass.SetBindGroup(0, packCompute.bindGroup);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
+
+void run_particle_unpack_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticlePackCompute& packCompute,
+    const wgpu::Buffer& indirectArgs)
+{
+    computePass.SetPipeline(packCompute.unpackPipeline);
+    computePass.SetBindGroup(0, packCompute.bindGroup);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "util/wgpu_util.h"
+#include "shared/particles.h"
+#include "mesh.h"
+
+struct ParticlePackCompute {
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::ComputePipeline packPipeline;
+    wgpu::ComputePipeline unpackPipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::Buffer meshBuffer;
+
+    wgpu::Buffer packed; // maxParticles slots in the layout of bench/particle_pack.wgsl
+};
+
+// Packs against the given mesh
+ParticlePackCompute create_particle_pack_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles);
+
+// Writes the first nCur particles to the packed buffer. The workgroup count is taken from the dispatch args in
+// indirectArgs (see compute/indirect.h).
+void run_particle_pack_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticlePackCompute& packCompute,
+    const wgpu::Buffer& indirectArgs);
+
+// Overwrites the first nCur particles with the packed buffer
+void run_particle_unpack_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticlePackCompute& packCompute,
+    const wgpu::Buffer& indirectArgs);
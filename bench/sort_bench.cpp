@@ -0,0 +1,95 @@
+// Measures PIC push throughput on the tokamak mesh with the particles in the order they were drawn, against the
+// same particles after a counting sort by cell (kernel/sort.wgsl), and the cost of the sort itself.
+//
+// Usage: sort_bench [nParticles] [cellSpacing]
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "bench_util.h"
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "compute/particles.h"
+#include "compute/sort.h"
+#include "compute/indirect.h"
+#include "util/uniform_arena.h"
+#include "mesh.h"
+#include "util/wgpu_util.h"
+
+namespace {
+
+const glm::u32 DEFAULT_PARTICLES = 1000000;
+const glm::f32 DEFAULT_CELL_SPACING = 0.05f;
+const glm::u32 PUSHES_PER_SUBMIT = 16;
+const int ITERATIONS = 20;
+const glm::f32 DT = 1e-10f;
+const glm::f32 TEMPERATURE = 100000.0f;
+const glm::u64 SEED = 1;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    glm::u32 nParticles = argc > 1 ? std::stoul(argv[1]) : DEFAULT_PARTICLES;
+    glm::f32 cellSpacing = argc > 2 ? std::stof(argv[2]) : DEFAULT_CELL_SPACING;
+
+    BenchContext ctx = create_bench_context();
+    if (!ctx.valid) {
+        std::cerr << "WebGPU device not available" << std::endl;
+        return 1;
+    }
+
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_tokamak_mesh(cellSpacing, cells);
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+
+    ParticleBuffers particleBuf = create_tokamak_plasma_buffers(ctx.device, nParticles, TEMPERATURE, SEED);
+    FieldBuffers fieldBuf = create_fields_buffers(ctx.device, nCells);
+
+    UniformArena uniforms = create_uniform_arena(ctx.device, PUSHES_PER_SUBMIT * 2 * 256);
+    ParticleCompute particleCompute = create_particle_pic_compute(ctx.device, cells, particleBuf, fieldBuf, nParticles, uniforms);
+    ParticleIndirectCompute particleIndirect = create_particle_indirect_compute(ctx.device, particleBuf, nParticles, 0);
+    SortCompute sortCompute = create_sort_compute(ctx.device, particleBuf, mesh, nCells, nParticles);
+
+    auto time_pushes = [&]() {
+        double msPerSubmit = time_submits_ms(ctx, ITERATIONS, [&](wgpu::CommandEncoder& encoder) {
+            wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+            for (glm::u32 i = 0; i < PUSHES_PER_SUBMIT; i++) {
+                run_particle_pic_compute(pass, particleCompute, uniforms, mesh, DT, 0u, nParticles);
+            }
+            pass.End();
+            flush_uniform_arena(ctx.device, uniforms);
+        });
+        return msPerSubmit / PUSHES_PER_SUBMIT;
+    };
+
+    double unsortedMs = time_pushes();
+
+    // Time one sort of the particles as they stand, after everything before it has finished
+    wait_for_submitted_work(ctx);
+    auto start = std::chrono::steady_clock::now();
+    wgpu::CommandEncoder encoder = ctx.device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    run_sort_compute(pass, sortCompute, particleIndirect.argsBuffer, true);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    ctx.device.GetQueue().Submit(1, &commands);
+    wait_for_submitted_work(ctx);
+    double sortMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    double sortedMs = time_pushes();
+
+    std::cout << "cells: " << nCells << ", particles: " << nParticles << ", pushes per run: " << ITERATIONS * PUSHES_PER_SUBMIT << std::endl;
+    std::cout << "unsorted: " << unsortedMs << " ms/push, " << nParticles / unsortedMs / 1000.0 << " M particles/s" << std::endl;
+    std::cout << "sorted:   " << sortedMs << " ms/push, " << nParticles / sortedMs / 1000.0 << " M particles/s" << std::endl;
+    std::cout << "sort:     " << sortMs << " ms (with cell offsets)" << std::endl;
+    std::cout << "speedup: " << unsortedMs / sortedMs << "x";
+    if (sortedMs < unsortedMs) {
+        std::cout << ", sort pays for itself after " << std::ceil(sortMs / (unsortedMs - sortedMs)) << " pushes";
+    }
+    std::cout << std::endl;
+    return 0;
+}
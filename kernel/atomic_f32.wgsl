@@ -0,0 +1,11 @@
+// WGSL has no floating point atomics, so accumulate through a compare-exchange loop on the raw bits
+fn atomic_add_f32(dst: ptr<storage, atomic<u32>, read_write>, value: f32) {
+    var old = atomicLoad(dst);
+    loop {
+        let result = atomicCompareExchangeWeak(dst, old, bitcast<u32>(bitcast<f32>(old) + value));
+        if (result.exchanged) {
+            break;
+        }
+        old = result.old_value;
+    }
+}
@@ -0,0 +1,144 @@
+// Stream compaction of the particle arrays: packs the live particles (species != 0) to the front, preserving
+// their order, and shrinks nParticles to the live count. Four dispatches:
+//
+//   scanBlocks     flag live particles, exclusive scan within each 256-particle block
+//   scanBlockSums  exclusive scan of the block totals (one workgroup), decide whether to compact
+//   scatter        write the live particles to their packed slots in the scratch arrays
+//   copyBack       copy the scratch arrays over the particle arrays and update nParticles
+//
+// Compaction is skipped on the GPU (scatter and copyBack exit) when the dead fraction is below the threshold.
+const COMPACT_BLOCK: u32 = 256u;
+
+struct CompactParams {
+    deadFraction: f32, // Compact only when more than this fraction of the slots is dead
+}
+
+struct CompactState {
+    oldCount: u32,  // nParticles before compaction
+    liveCount: u32, // Live particles found by the scan
+    compact: u32,   // 1 when the dead fraction exceeded the threshold
+    _pad: u32,
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> scratchPos: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> scratchVel: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read_write> localOffset: array<u32>;
+@group(0) @binding(6) var<storage, read_write> blockSums: array<u32>;
+@group(0) @binding(7) var<storage, read_write> state: CompactState;
+@group(0) @binding(8) var<uniform> params: CompactParams;
+
+var<workgroup> scanTile: array<u32, COMPACT_BLOCK>;
+var<workgroup> tileCount: u32;
+
+// Inclusive Hillis-Steele scan of one value per invocation across the workgroup
+fn workgroup_inclusive_scan(lid: u32, value: u32) -> u32 {
+    scanTile[lid] = value;
+    workgroupBarrier();
+    for (var offset: u32 = 1u; offset < COMPACT_BLOCK; offset <<= 1u) {
+        var add: u32 = 0u;
+        if (lid >= offset) {
+            add = scanTile[lid - offset];
+        }
+        workgroupBarrier();
+        scanTile[lid] += add;
+        workgroupBarrier();
+    }
+    let result = scanTile[lid];
+    workgroupBarrier();
+    return result;
+}
+
+@compute @workgroup_size(256)
+fn scanBlocks(
+    @builtin(global_invocation_id) global_id: vec3<u32>,
+    @builtin(local_invocation_index) lid: u32,
+    @builtin(workgroup_id) workgroup_id: vec3<u32>
+) {
+    let id = global_id.x;
+    let n = nParticles;
+    if (id == 0u) {
+        state.oldCount = n;
+    }
+
+    var live: u32 = 0u;
+    if (id < n && particlePos[id].w != 0.0) {
+        live = 1u;
+    }
+
+    let inclusive = workgroup_inclusive_scan(lid, live);
+    if (id < n) {
+        localOffset[id] = inclusive - live;
+    }
+    if (lid == COMPACT_BLOCK - 1u) {
+        blockSums[workgroup_id.x] = inclusive;
+    }
+}
+
+@compute @workgroup_size(256)
+fn scanBlockSums(@builtin(local_invocation_index) lid: u32) {
+    if (lid == 0u) {
+        tileCount = state.oldCount;
+    }
+    let n = workgroupUniformLoad(&tileCount);
+    let nBlocks = (n + COMPACT_BLOCK - 1u) / COMPACT_BLOCK;
+
+    // Scan the block totals a chunk at a time, carrying the running sum between chunks
+    var carry: u32 = 0u;
+    for (var base: u32 = 0u; base < nBlocks; base += COMPACT_BLOCK) {
+        let b = base + lid;
+        var total: u32 = 0u;
+        if (b < nBlocks) {
+            total = blockSums[b];
+        }
+        let inclusive = workgroup_inclusive_scan(lid, total);
+        if (b < nBlocks) {
+            blockSums[b] = carry + inclusive - total;
+        }
+        carry += workgroupUniformLoad(&scanTile[COMPACT_BLOCK - 1u]);
+    }
+
+    if (lid == 0u) {
+        state.liveCount = carry;
+        let dead = f32(n - carry);
+        state.compact = select(0u, 1u, dead > 0.0 && dead > params.deadFraction * f32(n));
+    }
+}
+
+@compute @workgroup_size(256)
+fn scatter(@builtin(global_invocation_id) global_id: vec3<u32>, @builtin(workgroup_id) workgroup_id: vec3<u32>) {
+    let id = global_id.x;
+    if (state.compact == 0u || id >= state.oldCount) {
+        return;
+    }
+
+    let pos = particlePos[id];
+    if (pos.w != 0.0) {
+        let dst = blockSums[workgroup_id.x] + localOffset[id];
+        scratchPos[dst] = pos;
+        scratchVel[dst] = particleVel[id];
+    }
+
+    // Slots past the live count are cleared; live particles only land below it
+    if (id >= state.liveCount) {
+        scratchPos[id] = vec4<f32>(0.0);
+        scratchVel[id] = vec4<f32>(0.0);
+    }
+}
+
+@compute @workgroup_size(256)
+fn copyBack(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (state.compact == 0u || id >= state.oldCount) {
+        return;
+    }
+
+    particlePos[id] = scratchPos[id];
+    particleVel[id] = scratchVel[id];
+
+    if (id == 0u) {
+        nParticles = state.liveCount;
+    }
+}
@@ -0,0 +1,83 @@
+// Cloud-in-cell deposition of particle charge and current onto the mesh nodes
+struct DepositParams {
+    nCells: u32,
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> rho: array<atomic<u32>>;     // f32 bits, one per cell
+@group(0) @binding(4) var<storage, read_write> current: array<atomic<u32>>; // f32 bits, four per cell
+@group(0) @binding(5) var<uniform> params: DepositParams;
+@group(0) @binding(6) var<uniform> mesh: MeshProperties;
+@group(0) @binding(7) var<uniform> speciesTable: SpeciesTable;
+
+@compute @workgroup_size(256)
+// Zeroes the charge and current density before deposition
+fn clearSources(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    atomicStore(&rho[id], 0u);
+    atomicStore(&current[id * 4u], 0u);
+    atomicStore(&current[id * 4u + 1u], 0u);
+    atomicStore(&current[id * 4u + 2u], 0u);
+    atomicStore(&current[id * 4u + 3u], 0u);
+}
+
+@compute @workgroup_size(256)
+// Spreads each particle's charge and current over the 8 surrounding mesh nodes with trilinear weights
+fn depositSources(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let species = particlePos[id].w;
+    if (species == 0.0) {
+        return; // inactive particle
+    }
+
+    let charge = particle_charge(species);
+    if (charge == 0.0) {
+        return;
+    }
+
+    let pos = vec3<f32>(particlePos[id].xyz);
+    let vel = vec3<f32>(particleVel[id].xyz);
+
+    // Same base node and weights as interp(), so deposit and gather share a stencil
+    let cell_idx_frac = (pos - mesh.min) / mesh.cell_size;
+    let base_f32 = floor(cell_idx_frac);
+    let w = cell_idx_frac - base_f32;
+    let base = vec3<i32>(base_f32);
+
+    let cell_volume = mesh.cell_size.x * mesh.cell_size.y * mesh.cell_size.z;
+    let q_density = charge / cell_volume;
+
+    for (var dx: i32 = 0; dx < 2; dx++) {
+        for (var dy: i32 = 0; dy < 2; dy++) {
+            for (var dz: i32 = 0; dz < 2; dz++) {
+                // Nodes past the upper faces of a periodic mesh wrap around to the lower ones
+                let node = wrap_grid_coords(base + vec3<i32>(dx, dy, dz), &mesh);
+                let idx = to_linear_index(node.x, node.y, node.z, mesh.dim);
+                if (idx < 0) {
+                    continue; // node outside the mesh
+                }
+
+                let wx = select(1.0 - w.x, w.x, dx == 1);
+                let wy = select(1.0 - w.y, w.y, dy == 1);
+                let wz = select(1.0 - w.z, w.z, dz == 1);
+                let q = q_density * wx * wy * wz;
+
+                let cell = u32(idx);
+                atomic_add_f32(&rho[cell], q);
+                atomic_add_f32(&current[cell * 4u], q * vel.x);
+                atomic_add_f32(&current[cell * 4u + 1u], q * vel.y);
+                atomic_add_f32(&current[cell * 4u + 2u], q * vel.z);
+            }
+        }
+    }
+}
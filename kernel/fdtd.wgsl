@@ -0,0 +1,162 @@
+// Explicit FDTD update of the self-consistent fields on a Yee lattice over the mesh. The components stored for
+// node (i, j, k) sit at:
+//
+//   yeeE, yeeJ: Ex (i+1/2, j, k)      Ey (i, j+1/2, k)      Ez (i, j, k+1/2)
+//   yeeB:       Bx (i, j+1/2, k+1/2)  By (i+1/2, j, k+1/2)  Bz (i+1/2, j+1/2, k)
+//
+// B lives half a step behind E (leapfrog):
+//
+//   dB/dt = -curl(E)
+//   dE/dt = C_LIGHT^2 * curl(B) - J / EPSILON_0
+//
+// The inactive nodes (including the mesh faces and everything past them) are a perfect conductor: edges with both
+// ends inside it carry no E. Every edge touching an active node is updated, so with the charge-conserving current
+// in yeeJ (kernel/fdtd_deposit.wgsl) the update keeps div(E) = rho / EPSILON_0 on the active nodes.
+struct FdtdParams {
+    nCells: u32,
+    dt: f32,       // substep, s
+    stepDt: f32,   // full step the particles moved over, s
+}
+
+@group(0) @binding(0) var<storage, read> yeeJ: array<vec4<f32>>;
+@group(0) @binding(1) var<storage, read_write> yeeE: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> yeeB: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> bField: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read> mask: array<u32>;
+@group(0) @binding(6) var<uniform> params: FdtdParams;
+@group(0) @binding(7) var<uniform> mesh: MeshProperties;
+@group(0) @binding(8) var<storage, read> potential: array<vec4<f32>>;
+
+fn e_at(x: i32, y: i32, z: i32) -> vec3<f32> {
+    let idx = to_linear_index(x, y, z, mesh.dim);
+    if (idx < 0) {
+        return vec3<f32>(0.0);
+    }
+    return yeeE[u32(idx)].xyz;
+}
+
+fn b_at(x: i32, y: i32, z: i32) -> vec3<f32> {
+    let idx = to_linear_index(x, y, z, mesh.dim);
+    if (idx < 0) {
+        return vec3<f32>(0.0);
+    }
+    return yeeB[u32(idx)].xyz;
+}
+
+fn phi_at(x: i32, y: i32, z: i32) -> f32 {
+    let idx = to_linear_index(x, y, z, mesh.dim);
+    if (idx < 0) {
+        return 0.0;
+    }
+    return potential[u32(idx)].w;
+}
+
+fn is_active(x: i32, y: i32, z: i32) -> bool {
+    let idx = to_linear_index(x, y, z, mesh.dim);
+    return idx >= 0 && mask[u32(idx)] != 0u;
+}
+
+// Zeroes the components of E stored at node c whose edges lie inside the conductor
+fn zero_conductor_edges(c: vec3<i32>, e: vec3<f32>) -> vec3<f32> {
+    if (is_active(c.x, c.y, c.z)) {
+        return e;
+    }
+
+    var out = e;
+    if (!is_active(c.x + 1, c.y, c.z)) { out.x = 0.0; }
+    if (!is_active(c.x, c.y + 1, c.z)) { out.y = 0.0; }
+    if (!is_active(c.x, c.y, c.z + 1)) { out.z = 0.0; }
+    return out;
+}
+
+@compute @workgroup_size(256)
+// Seeds E with -grad(phi) from the electrostatic solve in FieldBuffers::potential and clears B, so the fields start
+// out satisfying Gauss's law for the deposited charge
+fn initFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let phi = phi_at(c.x, c.y, c.z);
+    let e = -vec3<f32>(
+        phi_at(c.x + 1, c.y, c.z) - phi,
+        phi_at(c.x, c.y + 1, c.z) - phi,
+        phi_at(c.x, c.y, c.z + 1) - phi
+    ) / mesh.cell_size;
+
+    yeeE[id] = vec4<f32>(zero_conductor_edges(c, e), 0.0);
+    yeeB[id] = vec4<f32>(0.0);
+}
+
+@compute @workgroup_size(256)
+// Faraday: B -= dt * curl(E)
+fn updateB(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let inv_h = 1.0 / mesh.cell_size;
+    let e = yeeE[id].xyz;
+
+    let curl_e = vec3<f32>(
+        (e_at(c.x, c.y + 1, c.z).z - e.z) * inv_h.y - (e_at(c.x, c.y, c.z + 1).y - e.y) * inv_h.z,
+        (e_at(c.x, c.y, c.z + 1).x - e.x) * inv_h.z - (e_at(c.x + 1, c.y, c.z).z - e.z) * inv_h.x,
+        (e_at(c.x + 1, c.y, c.z).y - e.y) * inv_h.x - (e_at(c.x, c.y + 1, c.z).x - e.x) * inv_h.y
+    );
+
+    yeeB[id] = vec4<f32>(yeeB[id].xyz - params.dt * curl_e, 0.0);
+}
+
+@compute @workgroup_size(256)
+// Ampere: E += dt * (C_LIGHT^2 * curl(B) - J / EPSILON_0)
+fn updateE(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let inv_h = 1.0 / mesh.cell_size;
+    let b = yeeB[id].xyz;
+
+    let curl_b = vec3<f32>(
+        (b.z - b_at(c.x, c.y - 1, c.z).z) * inv_h.y - (b.y - b_at(c.x, c.y, c.z - 1).y) * inv_h.z,
+        (b.x - b_at(c.x, c.y, c.z - 1).x) * inv_h.z - (b.z - b_at(c.x - 1, c.y, c.z).z) * inv_h.x,
+        (b.y - b_at(c.x - 1, c.y, c.z).y) * inv_h.x - (b.x - b_at(c.x, c.y - 1, c.z).x) * inv_h.y
+    );
+
+    let e = yeeE[id].xyz + params.dt * (C_LIGHT * C_LIGHT * curl_b - yeeJ[id].xyz / EPSILON_0);
+    yeeE[id] = vec4<f32>(zero_conductor_edges(c, e), 0.0);
+}
+
+@compute @workgroup_size(256)
+// Averages the staggered components back to the mesh nodes and adds them to the external fields
+fn addYeeFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let e = yeeE[id].xyz;
+    let b = yeeB[id].xyz;
+
+    let e_node = 0.5 * vec3<f32>(
+        e.x + e_at(c.x - 1, c.y, c.z).x,
+        e.y + e_at(c.x, c.y - 1, c.z).y,
+        e.z + e_at(c.x, c.y, c.z - 1).z
+    );
+    let b_node = 0.25 * vec3<f32>(
+        b.x + b_at(c.x, c.y - 1, c.z).x + b_at(c.x, c.y, c.z - 1).x + b_at(c.x, c.y - 1, c.z - 1).x,
+        b.y + b_at(c.x - 1, c.y, c.z).y + b_at(c.x, c.y, c.z - 1).y + b_at(c.x - 1, c.y, c.z - 1).y,
+        b.z + b_at(c.x - 1, c.y, c.z).z + b_at(c.x, c.y - 1, c.z).z + b_at(c.x - 1, c.y - 1, c.z).z
+    );
+
+    eField[id] += vec4<f32>(e_node, 0.0);
+    bField[id] += vec4<f32>(b_node, 0.0);
+}
@@ -0,0 +1,107 @@
+// Charge-conserving (Esirkepov) deposit of the particle current onto the Yee edges for the FDTD solver. Each
+// particle's move over the last step is rebuilt from its position and velocity (the push sets pos += vel * dt), and
+// the current its cloud-in-cell shape carried across every edge is deposited, so div(J) matches the change in the
+// deposited charge exactly. Particles must move less than a cell per step.
+struct FdtdParams {
+    nCells: u32,
+    dt: f32,       // substep, s
+    stepDt: f32,   // full step the particles moved over, s
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> yeeJ: array<atomic<u32>>; // f32 bits, four per cell
+@group(0) @binding(4) var<uniform> params: FdtdParams;
+@group(0) @binding(5) var<uniform> mesh: MeshProperties;
+@group(0) @binding(6) var<uniform> speciesTable: SpeciesTable;
+
+@compute @workgroup_size(256)
+// Zeroes the edge currents before deposition
+fn clearCurrent(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    atomicStore(&yeeJ[id * 4u], 0u);
+    atomicStore(&yeeJ[id * 4u + 1u], 0u);
+    atomicStore(&yeeJ[id * 4u + 2u], 0u);
+    atomicStore(&yeeJ[id * 4u + 3u], 0u);
+}
+
+@compute @workgroup_size(256)
+// Deposits the current each particle carried across the Yee edges over its last move
+fn depositCurrent(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let species = particlePos[id].w;
+    if (species == 0.0) {
+        return; // inactive particle
+    }
+
+    let charge = particle_charge(species);
+    if (charge == 0.0) {
+        return;
+    }
+
+    // Start and end of the move in grid units, so node i sits at i
+    let pos = vec3<f32>(particlePos[id].xyz);
+    let vel = vec3<f32>(particleVel[id].xyz);
+    let start = (pos - vel * params.stepDt - mesh.min) / mesh.cell_size;
+    let end = (pos - mesh.min) / mesh.cell_size;
+
+    // Cloud-in-cell weights before the move, and their change over it, on the three nodes per axis it can touch
+    let first = vec3<i32>(floor(min(start, end)));
+    var s0: array<vec3<f32>, 3>;
+    var ds: array<vec3<f32>, 3>;
+    for (var n: i32 = 0; n < 3; n++) {
+        let node = vec3<f32>(first + vec3<i32>(n));
+        let w0 = max(vec3<f32>(0.0), 1.0 - abs(start - node));
+        let w1 = max(vec3<f32>(0.0), 1.0 - abs(end - node));
+        s0[n] = w0;
+        ds[n] = w1 - w0;
+    }
+
+    // Along each axis a, the current through the edge past node i is the running sum of -q W / (dt * face area)
+    // over the nodes up to i, where W is the part of the weight change at a node the move along a accounts for.
+    // The edge past the third node always sums to zero.
+    let h = mesh.cell_size;
+    let scale = -charge / (params.stepDt * vec3<f32>(h.y * h.z, h.x * h.z, h.x * h.y));
+    for (var a: u32 = 0u; a < 3u; a++) {
+        let b = (a + 1u) % 3u;
+        let c = (a + 2u) % 3u;
+        for (var j: i32 = 0; j < 3; j++) {
+            for (var k: i32 = 0; k < 3; k++) {
+                // Transverse weight averaged over the move (exact for straight-line motion)
+                let transverse =
+                    s0[j][b] * s0[k][c] +
+                    0.5 * ds[j][b] * s0[k][c] +
+                    0.5 * s0[j][b] * ds[k][c] +
+                    ds[j][b] * ds[k][c] / 3.0;
+                if (transverse == 0.0) {
+                    continue;
+                }
+
+                var flux = 0.0;
+                for (var i: i32 = 0; i < 2; i++) {
+                    flux += scale[a] * ds[i][a] * transverse;
+
+                    var node = first;
+                    node[a] += i;
+                    node[b] += j;
+                    node[c] += k;
+                    node = wrap_grid_coords(node, &mesh);
+                    let idx = to_linear_index(node.x, node.y, node.z, mesh.dim);
+                    if (idx < 0 || flux == 0.0) {
+                        continue; // edge outside the mesh or carrying nothing
+                    }
+                    atomic_add_f32(&yeeJ[u32(idx) * 4u + a], flux);
+                }
+            }
+        }
+    }
+}
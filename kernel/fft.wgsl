@@ -0,0 +1,145 @@
+// Spectral Poisson solve on a periodic mesh. The deposited sources are packed into FieldBuffers::potential as
+// two complex numbers per cell, (MU_0*Jx + i*MU_0*Jy, MU_0*Jz + i*rho/EPSILON_0), transformed in place one
+// axis at a time, divided by the eigenvalues of the discrete 7-point Laplacian and transformed back. Because
+// the Laplacian is real, the result unpacks directly as [Ax, Ay, Az, phi].
+//
+// Lines of up to FFT_MAX_LINE nodes are transformed in workgroup memory, one workgroup per line: radix-2
+// Cooley-Tukey for power-of-two lengths, a direct DFT otherwise.
+const FFT_MAX_LINE: u32 = 512u;
+const FFT_WORKGROUP_SIZE: u32 = 64u;
+
+// Pipeline constants select the axis (0 = x, 1 = y, 2 = z) and direction of fftLines
+override FFT_AXIS: u32 = 0u;
+override FFT_INVERSE: bool = false;
+
+struct FftParams {
+    nCells: u32,
+}
+
+@group(0) @binding(0) var<storage, read> rho: array<f32>;
+@group(0) @binding(1) var<storage, read> current: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> potential: array<vec4<f32>>;
+@group(0) @binding(3) var<uniform> params: FftParams;
+@group(0) @binding(4) var<uniform> mesh: MeshProperties;
+
+var<workgroup> line_data: array<vec4<f32>, FFT_MAX_LINE>;
+
+// Multiplies both complex numbers packed in v by the complex number w
+fn cmul2(v: vec4<f32>, w: vec2<f32>) -> vec4<f32> {
+    return vec4<f32>(
+        v.x * w.x - v.y * w.y,
+        v.x * w.y + v.y * w.x,
+        v.z * w.x - v.w * w.y,
+        v.z * w.y + v.w * w.x
+    );
+}
+
+// exp(+-2*pi*i * num / den), positive for the inverse transform
+fn twiddle(num: u32, den: u32) -> vec2<f32> {
+    let dir = select(-1.0, 1.0, FFT_INVERSE);
+    let angle = dir * 2.0 * PI * f32(num) / f32(den);
+    return vec2<f32>(cos(angle), sin(angle));
+}
+
+fn reverse_bits_n(i: u32, n: u32) -> u32 {
+    return reverseBits(i) >> (32u - countTrailingZeros(n));
+}
+
+@compute @workgroup_size(256)
+// Packs the deposited sources as the right-hand side of laplacian([A, phi]) = -[MU_0*J, rho/EPSILON_0]
+fn packSources(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    potential[id] = vec4<f32>(MU_0 * current[id].xyz, rho[id] / EPSILON_0);
+}
+
+@compute @workgroup_size(64)
+// Transforms every line of the mesh along FFT_AXIS in place, one workgroup per line
+fn fftLines(
+    @builtin(workgroup_id) workgroup_id: vec3<u32>,
+    @builtin(num_workgroups) num_workgroups: vec3<u32>,
+    @builtin(local_invocation_index) lid: u32
+) {
+    let n = mesh.dim[FFT_AXIS];
+    let line = workgroup_id.x + workgroup_id.y * num_workgroups.x;
+    if (line >= params.nCells / n) {
+        return;
+    }
+
+    // Linear index is x * dim.z * dim.y + z * dim.y + y
+    var start: u32;
+    var stride: u32;
+    if (FFT_AXIS == 0u) {
+        start = line;
+        stride = mesh.dim.z * mesh.dim.y;
+    } else if (FFT_AXIS == 1u) {
+        start = line * mesh.dim.y;
+        stride = 1u;
+    } else {
+        start = (line / mesh.dim.y) * mesh.dim.z * mesh.dim.y + line % mesh.dim.y;
+        stride = mesh.dim.y;
+    }
+
+    if ((n & (n - 1u)) == 0u) {
+        // Radix-2: load in bit-reversed order, then log2(n) butterfly stages
+        for (var i = lid; i < n; i += FFT_WORKGROUP_SIZE) {
+            line_data[reverse_bits_n(i, n)] = potential[start + i * stride];
+        }
+        workgroupBarrier();
+
+        for (var span = 1u; span < n; span *= 2u) {
+            for (var j = lid; j < n / 2u; j += FFT_WORKGROUP_SIZE) {
+                let pos = j % span;
+                let i0 = (j / span) * 2u * span + pos;
+                let i1 = i0 + span;
+                let a = line_data[i0];
+                let b = cmul2(line_data[i1], twiddle(pos, 2u * span));
+                line_data[i0] = a + b;
+                line_data[i1] = a - b;
+            }
+            workgroupBarrier();
+        }
+
+        for (var i = lid; i < n; i += FFT_WORKGROUP_SIZE) {
+            potential[start + i * stride] = line_data[i];
+        }
+    } else {
+        // Direct DFT out of workgroup memory
+        for (var i = lid; i < n; i += FFT_WORKGROUP_SIZE) {
+            line_data[i] = potential[start + i * stride];
+        }
+        workgroupBarrier();
+
+        for (var k = lid; k < n; k += FFT_WORKGROUP_SIZE) {
+            var sum = vec4<f32>(0.0);
+            for (var j = 0u; j < n; j++) {
+                sum += cmul2(line_data[j], twiddle((k * j) % n, n));
+            }
+            potential[start + k * stride] = sum;
+        }
+    }
+}
+
+@compute @workgroup_size(256)
+// Divides each mode by the discrete Laplacian eigenvalue (and by nCells to normalize the inverse transform).
+// The k = 0 mode is dropped, i.e. the net charge is neutralized by a uniform background.
+fn scaleSpectrum(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let m = vec3<f32>(to_grid_coords(id, mesh.dim));
+    let n = vec3<f32>(mesh.dim);
+    let k2 = (2.0 - 2.0 * cos(2.0 * PI * m / n)) / (mesh.cell_size * mesh.cell_size);
+    let eigenvalue = k2.x + k2.y + k2.z;
+
+    if (eigenvalue == 0.0) {
+        potential[id] = vec4<f32>(0.0);
+    } else {
+        potential[id] = potential[id] / (eigenvalue * f32(params.nCells));
+    }
+}
@@ -38,6 +38,69 @@ fn compute_particle_field_contributions(
     }
 }
 
+// Particles staged per tile by compute_particle_field_contributions_tiled, equal to the workgroup size of the
+// kernels that call it
+const PARTICLE_TILE_SIZE: u32 = 256u;
+
+var<workgroup> particleTilePos: array<vec4<f32>, PARTICLE_TILE_SIZE>;
+var<workgroup> particleTileVel: array<vec4<f32>, PARTICLE_TILE_SIZE>;
+var<workgroup> particleTileCount: u32;
+
+// Same sum as compute_particle_field_contributions, but the workgroup loads the particles into workgroup memory
+// one tile at a time and every invocation accumulates from the tile, so each particle is read from storage once
+// per workgroup rather than once per invocation. Uses barriers: every invocation of the workgroup must call it
+// from uniform control flow, including invocations past the end of the work (their result is discarded).
+fn compute_particle_field_contributions_tiled(
+    nParticles: ptr<storage, u32, read_write>,
+    particlePos: ptr<storage, array<vec4<f32>>, read_write>,
+    particleVel: ptr<storage, array<vec4<f32>>, read_write>,
+    loc: vec3<f32>,
+    skipId: i32,
+    localIdx: u32,
+    E: ptr<function, vec3<f32>>,
+    B: ptr<function, vec3<f32>>,
+    colliderId: ptr<function, i32>
+) {
+    if (localIdx == 0u) {
+        particleTileCount = *nParticles;
+    }
+    let n = workgroupUniformLoad(&particleTileCount);
+
+    for (var base: u32 = 0u; base < n; base += PARTICLE_TILE_SIZE) {
+        let load = base + localIdx;
+        if (load < n) {
+            particleTilePos[localIdx] = (*particlePos)[load];
+            particleTileVel[localIdx] = (*particleVel)[load];
+        } else {
+            particleTilePos[localIdx] = vec4<f32>(0.0); // species 0, skipped below
+        }
+        workgroupBarrier();
+
+        for (var k: u32 = 0u; k < PARTICLE_TILE_SIZE; k++) {
+            let i = base + k;
+            let species = particleTilePos[k].w;
+            if (i == u32(skipId) || species == 0.0) {
+                continue;
+            }
+
+            let r = loc - particleTilePos[k].xyz;
+            let r_mag = length(r);
+
+            // Avoid division by zero
+            if (r_mag < 0.00001) {
+                *colliderId = i32(i);
+                continue;
+            }
+
+            let r_norm = r / r_mag;
+            let charge = particle_charge(species);
+            *E += ((K_E * charge) / (r_mag * r_mag)) * r_norm;
+            *B += ((MU_0_OVER_4_PI * charge) / (r_mag * r_mag)) * cross(particleTileVel[k].xyz, r_norm);
+        }
+        workgroupBarrier();
+    }
+}
+
 // Computes E and B field at a given location due to a given particle
 fn compute_single_particle_field_contribution(
     pos: vec3<f32>,               // particle position
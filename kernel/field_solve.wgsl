@@ -0,0 +1,82 @@
+// Grid field solve: relaxes the potentials [Ax, Ay, Az, phi] against the deposited sources and
+// turns them into E = -grad(phi) and B = curl(A) on the mesh nodes.
+//
+//   laplacian(phi) = -rho / EPSILON_0
+//   laplacian(A)   = -MU_0 * J
+//
+// Nodes outside the mesh are held at zero potential (Dirichlet boundary), or wrap around when the potentials
+// come from the periodic spectral solve.
+struct FieldSolveParams {
+    nCells: u32,
+    periodic: u32, // 1 if neighbors wrap around the mesh
+}
+
+@group(0) @binding(0) var<storage, read> rho: array<f32>;
+@group(0) @binding(1) var<storage, read> current: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read> potentialIn: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> potentialOut: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read_write> bField: array<vec4<f32>>;
+@group(0) @binding(6) var<uniform> params: FieldSolveParams;
+@group(0) @binding(7) var<uniform> mesh: MeshProperties;
+
+// Potential at a mesh node, or zero outside a non-periodic mesh
+fn potential_at(x: i32, y: i32, z: i32) -> vec4<f32> {
+    var c = vec3<i32>(x, y, z);
+    if (params.periodic != 0u) {
+        let d = vec3<i32>(mesh.dim);
+        c = (c % d + d) % d;
+    }
+    let idx = to_linear_index(c.x, c.y, c.z, mesh.dim);
+    if (idx < 0) {
+        return vec4<f32>(0.0);
+    }
+    return potentialIn[u32(idx)];
+}
+
+@compute @workgroup_size(256)
+// One Jacobi sweep of the 7-point Laplacian for all four potential components
+fn relaxPotential(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let h2_inv = 1.0 / (mesh.cell_size * mesh.cell_size);
+
+    let neighbors =
+        (potential_at(c.x - 1, c.y, c.z) + potential_at(c.x + 1, c.y, c.z)) * h2_inv.x +
+        (potential_at(c.x, c.y - 1, c.z) + potential_at(c.x, c.y + 1, c.z)) * h2_inv.y +
+        (potential_at(c.x, c.y, c.z - 1) + potential_at(c.x, c.y, c.z + 1)) * h2_inv.z;
+    let source = vec4<f32>(MU_0 * current[id].xyz, rho[id] / EPSILON_0);
+
+    potentialOut[id] = (neighbors + source) / (2.0 * (h2_inv.x + h2_inv.y + h2_inv.z));
+}
+
+@compute @workgroup_size(256)
+// Adds the self-consistent fields from the solved potentials on top of the external fields
+fn addPotentialFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, mesh.dim);
+    let inv_2h = 0.5 / mesh.cell_size;
+
+    // Central differences of [Ax, Ay, Az, phi] along each axis
+    let d_dx = (potential_at(c.x + 1, c.y, c.z) - potential_at(c.x - 1, c.y, c.z)) * inv_2h.x;
+    let d_dy = (potential_at(c.x, c.y + 1, c.z) - potential_at(c.x, c.y - 1, c.z)) * inv_2h.y;
+    let d_dz = (potential_at(c.x, c.y, c.z + 1) - potential_at(c.x, c.y, c.z - 1)) * inv_2h.z;
+
+    let E = -vec3<f32>(d_dx.w, d_dy.w, d_dz.w);
+    let B = vec3<f32>(
+        d_dy.z - d_dz.y,
+        d_dz.x - d_dx.z,
+        d_dx.y - d_dy.x
+    );
+
+    eField[id] += vec4<f32>(E, 0.0);
+    bField[id] += vec4<f32>(B, 0.0);
+}
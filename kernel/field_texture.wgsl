@@ -0,0 +1,82 @@
+// Reads the E and B fields from the 3D textures written by kernel/write_field_textures.wgsl, where texel (x, y, z)
+// holds mesh node (x, y, z) scaled by FieldTextureParams. The position readers return zero outside the mesh, as
+// cell_neighbors() does, and leave undoing the scale to the caller. They do not wrap, so on a periodic mesh they
+// read zero past the last node; use field_texture_neighbor_vectors() there.
+struct FieldTextureParams {
+    eScale: f32, // texel = E * eScale, to keep rgba16float in range
+    bScale: f32, // texel = B * bScale
+}
+
+// Whether the 8 nodes around a position are all in the mesh. A position just below mesh.max can still round onto
+// the last node, so the upper corner is checked against the texture size as well.
+fn in_field_texture(pos: vec3<f32>, mesh: ptr<uniform, MeshProperties>) -> bool {
+    if (!all(pos >= (*mesh).min) || !all(pos < (*mesh).max)) {
+        return false;
+    }
+    let base = vec3<i32>(floor((pos - (*mesh).min) / (*mesh).cell_size));
+    return all(base + 1 < vec3<i32>((*mesh).dim));
+}
+
+// Trilinear interpolation from 8 texel loads, with the same weights as interp(). Works for any float format.
+fn load_field_texture(tex: texture_3d<f32>, pos: vec3<f32>, mesh: ptr<uniform, MeshProperties>) -> vec3<f32> {
+    if (!in_field_texture(pos, mesh)) {
+        return vec3<f32>(0.0);
+    }
+
+    let cell_idx_frac = (pos - (*mesh).min) / (*mesh).cell_size;
+    let base_f32 = floor(cell_idx_frac);
+    let base = vec3<i32>(base_f32);
+    let w = cell_idx_frac - base_f32;
+
+    var vectors: CellNeighborVectors;
+    vectors.xm_ym_zm = textureLoad(tex, base, 0).xyz;
+    vectors.xp_ym_zm = textureLoad(tex, base + vec3<i32>(1, 0, 0), 0).xyz;
+    vectors.xm_yp_zm = textureLoad(tex, base + vec3<i32>(0, 1, 0), 0).xyz;
+    vectors.xp_yp_zm = textureLoad(tex, base + vec3<i32>(1, 1, 0), 0).xyz;
+    vectors.xm_ym_zp = textureLoad(tex, base + vec3<i32>(0, 0, 1), 0).xyz;
+    vectors.xp_ym_zp = textureLoad(tex, base + vec3<i32>(1, 0, 1), 0).xyz;
+    vectors.xm_yp_zp = textureLoad(tex, base + vec3<i32>(0, 1, 1), 0).xyz;
+    vectors.xp_yp_zp = textureLoad(tex, base + vec3<i32>(1, 1, 1), 0).xyz;
+    return trilinear(&vectors, w);
+}
+
+// The texels at the 8 nodes cell_neighbors() found, the texture counterpart of cell_neighbor_vectors(). The nodes
+// wrap around a periodic mesh as they do for the field buffers, so interp() over these matches the buffer gather.
+fn field_texture_neighbor_vectors(tex: texture_3d<f32>, neighbors: ptr<function, CellNeighbors>, dim: vec3<u32>) -> CellNeighborVectors {
+    var vectors: CellNeighborVectors;
+
+    // Check if particle is outside mesh bounds
+    if (neighbors.xp_yp_zp == -1i) {
+        return vectors;
+    }
+
+    vectors.xm_ym_zm = textureLoad(tex, to_grid_coords(u32(neighbors.xm_ym_zm), dim), 0).xyz;
+    vectors.xm_ym_zp = textureLoad(tex, to_grid_coords(u32(neighbors.xm_ym_zp), dim), 0).xyz;
+    vectors.xm_yp_zm = textureLoad(tex, to_grid_coords(u32(neighbors.xm_yp_zm), dim), 0).xyz;
+    vectors.xm_yp_zp = textureLoad(tex, to_grid_coords(u32(neighbors.xm_yp_zp), dim), 0).xyz;
+    vectors.xp_ym_zm = textureLoad(tex, to_grid_coords(u32(neighbors.xp_ym_zm), dim), 0).xyz;
+    vectors.xp_ym_zp = textureLoad(tex, to_grid_coords(u32(neighbors.xp_ym_zp), dim), 0).xyz;
+    vectors.xp_yp_zm = textureLoad(tex, to_grid_coords(u32(neighbors.xp_yp_zm), dim), 0).xyz;
+    vectors.xp_yp_zp = textureLoad(tex, to_grid_coords(u32(neighbors.xp_yp_zp), dim), 0).xyz;
+
+    return vectors;
+}
+
+// Trilinear interpolation done by the sampler, which must be linear with clamp-to-edge addressing. Needs a
+// filterable format (rgba16float, or rgba32float with float32-filterable). The sampler's weights are only
+// guaranteed to 8 fractional bits on some hardware. From rgba16float, each component is within
+// 2^-10 * max|texel| + 3 * 2^-8 * (max texel - min texel) of interp(), taken over the 8 texels around pos.
+fn sample_field_texture(
+    tex: texture_3d<f32>,
+    fieldSampler: sampler,
+    pos: vec3<f32>,
+    mesh: ptr<uniform, MeshProperties>
+) -> vec3<f32> {
+    if (!in_field_texture(pos, mesh)) {
+        return vec3<f32>(0.0);
+    }
+
+    // Mesh nodes sit at texel centers
+    let uvw = ((pos - (*mesh).min) / (*mesh).cell_size + 0.5) / vec3<f32>((*mesh).dim);
+    return textureSampleLevel(tex, fieldSampler, uvw, 0.0).xyz;
+}
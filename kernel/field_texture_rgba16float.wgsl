@@ -0,0 +1,3 @@
+// Storage textures written by kernel/write_field_textures.wgsl as rgba16float
+@group(0) @binding(4) var eTexture: texture_storage_3d<rgba16float, write>;
+@group(0) @binding(5) var bTexture: texture_storage_3d<rgba16float, write>;
@@ -14,17 +14,26 @@ struct ComputeFieldsParams {
 @group(0) @binding(6) var<storage, read> currentSegments: array<vec4<f32>>;
 @group(0) @binding(7) var<storage, read_write> debug: array<vec4<f32>>;
 @group(0) @binding(8) var<uniform> params: ComputeFieldsParams;
+@group(0) @binding(9) var<storage, read_write> externalEField: array<vec4<f32>>;
+@group(0) @binding(10) var<storage, read_write> externalBField: array<vec4<f32>>;
+@group(0) @binding(11) var<uniform> speciesTable: SpeciesTable;
+
+// Stages the particles through workgroup memory; false sums straight from storage in every invocation
+override PARTICLE_TILING: bool = true;
 
 @compute @workgroup_size(256)
 // Computes the value of the E and B field at each cell location
-fn computeFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
+fn computeFields(
+    @builtin(global_invocation_id) global_id: vec3<u32>,
+    @builtin(local_invocation_index) local_idx: u32
+) {
     let id = global_id.x;
-    if (id >= params.nCells) {
-        return;
-    }
+
+    // Invocations past the last cell still take part in the tiled particle sum
+    let active = id < params.nCells;
 
     // Extract position for this cell
-    let loc = vec3<f32>(cellLocation[id].xyz);
+    let loc = vec3<f32>(cellLocation[select(0u, id, active)].xyz);
 
     // Calculate the E and B field at location
     var E = vec3<f32>(0.0, 0.0, 0.0);
@@ -32,17 +41,37 @@ fn computeFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
 
     if (params.enableParticleFieldContributions != 0u) {
         var unused: i32 = -1;
-        compute_particle_field_contributions(nParticles, &particlePos, &particleVel, loc, -1, &E, &B, &unused);
+        if (PARTICLE_TILING) {
+            compute_particle_field_contributions_tiled(&nParticles, &particlePos, &particleVel, loc, -1, local_idx, &E, &B, &unused);
+        } else if (active) {
+            compute_particle_field_contributions(nParticles, &particlePos, &particleVel, loc, -1, &E, &B, &unused);
+        }
     }
 
-    // Calculate the contribution of the currents
-    B += compute_currents_b_field(&currentSegments, params.nCurrentSegments, loc);
+    if (!active) {
+        return;
+    }
 
-    // Calculate the contribution of the central solenoid
-    E += compute_solenoid_e_field(params.solenoidFlux, loc);
+    // Add the cached contributions of the currents and the central solenoid
+    B += externalBField[id].xyz;
+    E += params.solenoidFlux * externalEField[id].xyz;
 
     eField[id] = vec4<f32>(E, 0.0);
     bField[id] = vec4<f32>(B, 0.0);
 
     debug[id] = vec4<f32>(loc, 0.0);
-} 
\ No newline at end of file
+}
+
+@compute @workgroup_size(256)
+// Caches the fields of the current segments and of the central solenoid (per unit flux) at each cell location
+fn computeExternalFields(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let loc = vec3<f32>(cellLocation[id].xyz);
+
+    externalBField[id] = vec4<f32>(compute_currents_b_field(&currentSegments, params.nCurrentSegments, loc), 0.0);
+    externalEField[id] = vec4<f32>(compute_solenoid_e_field(1.0, loc), 0.0);
+}
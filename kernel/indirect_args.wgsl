@@ -0,0 +1,36 @@
+// Builds the indirect dispatch and draw arguments for the particle kernels and particle render from the
+// current particle count, so the work tracks nParticles without reading it back to the CPU. Runs as a single
+// invocation after anything that changes nParticles (see src/compute/indirect.h for the buffer layout).
+const PARTICLE_WORKGROUP_SIZE: u32 = 256u;
+
+struct ParticleIndirectArgs {
+    // DispatchWorkgroupsIndirect, for the particle kernels with workgroup_size(256)
+    dispatchX: u32,
+    dispatchY: u32,
+    dispatchZ: u32,
+    // DrawIndirect, one point per particle
+    vertexCount: u32,
+    drawInstanceCount: u32,
+    firstVertex: u32,
+    drawFirstInstance: u32,
+    // DrawIndexedIndirect, one sphere instance per particle (indexCount is written once on the CPU)
+    indexCount: u32,
+    sphereInstanceCount: u32,
+    firstIndex: u32,
+    baseVertex: u32,
+    sphereFirstInstance: u32,
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> args: ParticleIndirectArgs;
+
+@compute @workgroup_size(1)
+fn buildIndirectArgs() {
+    let n = nParticles;
+    args.dispatchX = (n + PARTICLE_WORKGROUP_SIZE - 1u) / PARTICLE_WORKGROUP_SIZE;
+    args.dispatchY = 1u;
+    args.dispatchZ = 1u;
+    args.vertexCount = n;
+    args.drawInstanceCount = 1u;
+    args.sphereInstanceCount = n;
+}
@@ -1,5 +1,6 @@
 struct MeshProperties {
     min: vec3<f32>,       // minimum cell center
+    periodic: u32,        // 1 if the mesh wraps around over dim * cell_size, so node dim - 1 neighbors node 0
     max: vec3<f32>,       // maximum cell center
     dim: vec3<u32>,       // number of cells in each dimension
     cell_size: vec3<f32>, // cell size
@@ -37,12 +38,38 @@ fn to_linear_index(x: i32, y: i32, z: i32, dim: vec3<u32>) -> i32 {
     return i32((u32(x) * dim.z * dim.y) + (u32(z) * dim.y) + u32(y));
 }
 
+// Helper function to convert a linear index back to 3D coordinates
+fn to_grid_coords(idx: u32, dim: vec3<u32>) -> vec3<i32> {
+    let y = idx % dim.y;
+    let z = (idx / dim.y) % dim.z;
+    let x = idx / (dim.y * dim.z);
+    return vec3<i32>(i32(x), i32(y), i32(z));
+}
+
+// Grid coordinates wrapped around a periodic mesh, unchanged otherwise
+fn wrap_grid_coords(c: vec3<i32>, mesh: ptr<uniform, MeshProperties>) -> vec3<i32> {
+    if ((*mesh).periodic == 0u) {
+        return c;
+    }
+    let d = vec3<i32>((*mesh).dim);
+    return (c % d + d) % d;
+}
+
+// Upper corner of the region the mesh covers: the last node for a bounded mesh, one cell past it for a periodic one
+fn mesh_upper_bound(mesh: ptr<uniform, MeshProperties>) -> vec3<f32> {
+    if ((*mesh).periodic != 0u) {
+        return (*mesh).min + vec3<f32>((*mesh).dim) * (*mesh).cell_size;
+    }
+    return (*mesh).max;
+}
+
 // Computes the cell neighbors for a given position in space, or -1 for all neighbors if the position is outside the mesh
 fn cell_neighbors(pos: vec3<f32>, mesh: ptr<uniform, MeshProperties>) -> CellNeighbors {
     // Check if particle is outside the mesh bounds
-    if (pos.x < (*mesh).min.x || pos.x >= (*mesh).max.x ||
-        pos.y < (*mesh).min.y || pos.y >= (*mesh).max.y ||
-        pos.z < (*mesh).min.z || pos.z >= (*mesh).max.z) {
+    let upper = mesh_upper_bound(mesh);
+    if (pos.x < (*mesh).min.x || pos.x >= upper.x ||
+        pos.y < (*mesh).min.y || pos.y >= upper.y ||
+        pos.z < (*mesh).min.z || pos.z >= upper.z) {
         var neighbors: CellNeighbors;
         neighbors.xp_yp_zp = -1i;
         neighbors.xp_yp_zm = -1i;
@@ -55,28 +82,24 @@ fn cell_neighbors(pos: vec3<f32>, mesh: ptr<uniform, MeshProperties>) -> CellNei
         return neighbors;
     }
     
-    // Calculate which cell the particle is in and local position within that cell
+    // Mesh nodes are cell centers starting at mesh.min, so the node at or below the position is the base
+    // corner. This matches the weights used by interp() and the cloud-in-cell deposit. Past the last node of a
+    // periodic mesh, the upper corner wraps around to node 0.
     let cell_idx_frac: vec3<f32> = (pos - (*mesh).min) / (*mesh).cell_size;                                    // [x.aaa, y.bbb, z.ccc]
-    let cell_idx_i32 = vec3<i32>(i32(cell_idx_frac.x), i32(cell_idx_frac.y), i32(cell_idx_frac.z)); // [x, y, z]
-    let cell_idx_f32 = vec3<f32>(f32(cell_idx_i32.x), f32(cell_idx_i32.y), f32(cell_idx_i32.z));    // [x.000, y.000, z.000]
-    let local_pos = cell_idx_frac - cell_idx_f32;                                                   // [0.aaa, 0.bbb, 0.ccc]
-    
-    // Calculate which cell to base calculations off of
-    let base_x: i32 = cell_idx_i32.x + select(-1, 0, local_pos.x > 0.5);
-    let base_y: i32 = cell_idx_i32.y + select(-1, 0, local_pos.y > 0.5);
-    let base_z: i32 = cell_idx_i32.z + select(-1, 0, local_pos.z > 0.5);
+    let base = wrap_grid_coords(vec3<i32>(cell_idx_frac), mesh);
+    let next = wrap_grid_coords(base + vec3<i32>(1), mesh);
     
     // Calculate the 8 corner cells around the particle
     var neighbors: CellNeighbors;
 
-    neighbors.xp_yp_zp = to_linear_index(base_x + 1, base_y + 1, base_z + 1, (*mesh).dim); // x+, y+, z+
-    neighbors.xp_yp_zm = to_linear_index(base_x + 1, base_y + 1, base_z, (*mesh).dim); // x+, y+, z-
-    neighbors.xp_ym_zp = to_linear_index(base_x + 1, base_y, base_z + 1, (*mesh).dim); // x+, y-, z+
-    neighbors.xp_ym_zm = to_linear_index(base_x + 1, base_y, base_z, (*mesh).dim); // x+, y-, z-
-    neighbors.xm_yp_zp = to_linear_index(base_x, base_y + 1, base_z + 1, (*mesh).dim); // x-, y+, z+
-    neighbors.xm_yp_zm = to_linear_index(base_x, base_y + 1, base_z, (*mesh).dim); // x-, y+, z-
-    neighbors.xm_ym_zp = to_linear_index(base_x, base_y, base_z + 1, (*mesh).dim); // x-, y-, z+
-    neighbors.xm_ym_zm = to_linear_index(base_x, base_y, base_z, (*mesh).dim); // x-, y-, z-
+    neighbors.xp_yp_zp = to_linear_index(next.x, next.y, next.z, (*mesh).dim); // x+, y+, z+
+    neighbors.xp_yp_zm = to_linear_index(next.x, next.y, base.z, (*mesh).dim); // x+, y+, z-
+    neighbors.xp_ym_zp = to_linear_index(next.x, base.y, next.z, (*mesh).dim); // x+, y-, z+
+    neighbors.xp_ym_zm = to_linear_index(next.x, base.y, base.z, (*mesh).dim); // x+, y-, z-
+    neighbors.xm_yp_zp = to_linear_index(base.x, next.y, next.z, (*mesh).dim); // x-, y+, z+
+    neighbors.xm_yp_zm = to_linear_index(base.x, next.y, base.z, (*mesh).dim); // x-, y+, z-
+    neighbors.xm_ym_zp = to_linear_index(base.x, base.y, next.z, (*mesh).dim); // x-, y-, z+
+    neighbors.xm_ym_zm = to_linear_index(base.x, base.y, base.z, (*mesh).dim); // x-, y-, z-
     
     return neighbors;
 }
@@ -0,0 +1,163 @@
+// Geometric multigrid V-cycle for laplacian([A, phi]) = -[MU_0*J, rho/EPSILON_0] on a masked mesh. Inactive
+// cells (Cell::pos.w == 0, e.g. outside the tokamak torus), the mesh faces and nodes outside the mesh are held
+// at zero potential, so the wall is a Dirichlet boundary on every level.
+//
+// Each bind group couples one level with the next coarser one. Coarse node i sits on fine node 2i.
+
+// Pipeline constant selecting which nodes a red-black Gauss-Seidel sweep updates ((x + y + z) % 2)
+override SMOOTH_COLOR: u32 = 0u;
+
+struct MultigridParams {
+    dim: vec3<u32>,
+    nCells: u32,
+    cell_size: vec3<f32>,
+    coarseNCells: u32,
+    coarse_dim: vec3<u32>,
+    _padding: u32,
+}
+
+@group(0) @binding(0) var<storage, read> rho: array<f32>;
+@group(0) @binding(1) var<storage, read> current: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> u: array<vec4<f32>>;        // solution on this level
+@group(0) @binding(3) var<storage, read_write> f: array<vec4<f32>>;        // right-hand side on this level
+@group(0) @binding(4) var<storage, read_write> residual: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read> mask: array<u32>;
+@group(0) @binding(6) var<storage, read_write> coarseU: array<vec4<f32>>;
+@group(0) @binding(7) var<storage, read_write> coarseF: array<vec4<f32>>;
+@group(0) @binding(8) var<storage, read> coarseMask: array<u32>;
+@group(0) @binding(9) var<uniform> params: MultigridParams;
+
+// Solution at a node of this level, or zero on inactive nodes and outside the mesh
+fn u_at(x: i32, y: i32, z: i32) -> vec4<f32> {
+    let idx = to_linear_index(x, y, z, params.dim);
+    if (idx < 0 || mask[u32(idx)] == 0u) {
+        return vec4<f32>(0.0);
+    }
+    return u[u32(idx)];
+}
+
+fn coarse_u_at(x: i32, y: i32, z: i32) -> vec4<f32> {
+    let idx = to_linear_index(x, y, z, params.coarse_dim);
+    if (idx < 0 || coarseMask[u32(idx)] == 0u) {
+        return vec4<f32>(0.0);
+    }
+    return coarseU[u32(idx)];
+}
+
+// Sum of the six neighbors weighted by 1/h^2 along their axis
+fn neighbor_sum(c: vec3<i32>, h2_inv: vec3<f32>) -> vec4<f32> {
+    return
+        (u_at(c.x - 1, c.y, c.z) + u_at(c.x + 1, c.y, c.z)) * h2_inv.x +
+        (u_at(c.x, c.y - 1, c.z) + u_at(c.x, c.y + 1, c.z)) * h2_inv.y +
+        (u_at(c.x, c.y, c.z - 1) + u_at(c.x, c.y, c.z + 1)) * h2_inv.z;
+}
+
+@compute @workgroup_size(256)
+// Packs the deposited sources as the finest level right-hand side
+fn packSources(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    if (mask[id] == 0u) {
+        f[id] = vec4<f32>(0.0);
+        u[id] = vec4<f32>(0.0);
+        return;
+    }
+    f[id] = vec4<f32>(MU_0 * current[id].xyz, rho[id] / EPSILON_0);
+}
+
+@compute @workgroup_size(256)
+// One red or black Gauss-Seidel half-sweep of the 7-point Laplacian
+fn smoothRedBlack(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    let c = to_grid_coords(id, params.dim);
+    if (u32(c.x + c.y + c.z) % 2u != SMOOTH_COLOR || mask[id] == 0u) {
+        return;
+    }
+
+    let h2_inv = 1.0 / (params.cell_size * params.cell_size);
+    u[id] = (neighbor_sum(c, h2_inv) + f[id]) / (2.0 * (h2_inv.x + h2_inv.y + h2_inv.z));
+}
+
+@compute @workgroup_size(256)
+// r = f + laplacian(u)
+fn computeResidual(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells) {
+        return;
+    }
+
+    if (mask[id] == 0u) {
+        residual[id] = vec4<f32>(0.0);
+        return;
+    }
+
+    let c = to_grid_coords(id, params.dim);
+    let h2_inv = 1.0 / (params.cell_size * params.cell_size);
+    let laplacian = neighbor_sum(c, h2_inv) - 2.0 * (h2_inv.x + h2_inv.y + h2_inv.z) * u[id];
+    residual[id] = f[id] + laplacian;
+}
+
+@compute @workgroup_size(256)
+// Full-weighting restriction of the residual to the coarse right-hand side, and zero initial coarse guess
+fn restrictResidual(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.coarseNCells) {
+        return;
+    }
+
+    coarseU[id] = vec4<f32>(0.0);
+    if (coarseMask[id] == 0u) {
+        coarseF[id] = vec4<f32>(0.0);
+        return;
+    }
+
+    let fine = 2 * to_grid_coords(id, params.coarse_dim);
+    var sum = vec4<f32>(0.0);
+    var weight = 0.0;
+    for (var dx: i32 = -1; dx <= 1; dx++) {
+        for (var dy: i32 = -1; dy <= 1; dy++) {
+            for (var dz: i32 = -1; dz <= 1; dz++) {
+                let idx = to_linear_index(fine.x + dx, fine.y + dy, fine.z + dz, params.dim);
+                if (idx < 0) {
+                    continue;
+                }
+                let w = f32((2 - abs(dx)) * (2 - abs(dy)) * (2 - abs(dz)));
+                sum += w * residual[u32(idx)];
+                weight += w;
+            }
+        }
+    }
+    coarseF[id] = sum / weight;
+}
+
+@compute @workgroup_size(256)
+// Trilinear prolongation of the coarse correction onto this level
+fn prolongCorrection(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nCells || mask[id] == 0u) {
+        return;
+    }
+
+    let c = to_grid_coords(id, params.dim);
+    let base = c / 2;
+    let odd = c % 2;
+
+    // Even coordinates sit on a coarse node, odd ones halfway between two
+    var correction = vec4<f32>(0.0);
+    for (var dx: i32 = 0; dx <= odd.x; dx++) {
+        for (var dy: i32 = 0; dy <= odd.y; dy++) {
+            for (var dz: i32 = 0; dz <= odd.z; dz++) {
+                correction += coarse_u_at(base.x + dx, base.y + dy, base.z + dz);
+            }
+        }
+    }
+    let n = f32((1 + odd.x) * (1 + odd.y) * (1 + odd.z));
+    u[id] += correction / n;
+}
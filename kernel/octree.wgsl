@@ -0,0 +1,57 @@
+// Barnes-Hut octree built on the CPU (see src/octree.h). Nodes are stored in pre-order so the tree can be
+// walked without a stack: descending goes to node + 1, skipping a subtree jumps to links.y.
+struct OctreeNode {
+    center: vec4<f32>,  // [x, y, z, total charge], center is the |charge|-weighted centroid
+    dipole: vec4<f32>,  // [px, py, pz, node size], dipole moment about the center
+    current: vec4<f32>, // [sum(q * vx), sum(q * vy), sum(q * vz), unused]
+    links: vec4<u32>,   // [unused, end of subtree, first particle, particle count (0 for internal nodes)]
+}
+
+// Computes E and B field at a given location due to all particles in the octree. Nodes with
+// size / distance < theta are approximated by their monopole + dipole (E) and summed current (B); leaves
+// that get opened are summed directly.
+fn compute_octree_field_contributions(
+    nNodes: u32,
+    octreeNodes: ptr<storage, array<OctreeNode>, read>,
+    octreeParticles: ptr<storage, array<u32>, read>,
+    particlePos: ptr<storage, array<vec4<f32>>, read_write>,
+    particleVel: ptr<storage, array<vec4<f32>>, read_write>,
+    loc: vec3<f32>,
+    skipId: i32,
+    theta: f32,
+    E: ptr<function, vec3<f32>>,
+    B: ptr<function, vec3<f32>>
+) {
+    var node: u32 = 0u;
+    while (node < nNodes) {
+        let n = (*octreeNodes)[node];
+
+        if (n.links.w > 0u) {
+            // Leaf: direct sum over its particles
+            for (var k: u32 = n.links.z; k < n.links.z + n.links.w; k++) {
+                let i = (*octreeParticles)[k];
+                if (i == u32(skipId)) {
+                    continue;
+                }
+                let pos = (*particlePos)[i];
+                compute_single_particle_field_contribution(pos.xyz, (*particleVel)[i].xyz, pos.w, loc, E, B);
+            }
+            node = n.links.y;
+            continue;
+        }
+
+        let r = loc - n.center.xyz;
+        let r_mag = length(r);
+        if (n.dipole.w < theta * r_mag) {
+            // Far enough away: monopole + dipole for E, summed current for B
+            let r_norm = r / r_mag;
+            let p = n.dipole.xyz;
+            let inv_r2 = 1.0 / (r_mag * r_mag);
+            *E += K_E * inv_r2 * (n.center.w * r_norm + (3.0 * dot(p, r_norm) * r_norm - p) / r_mag);
+            *B += MU_0_OVER_4_PI * inv_r2 * cross(n.current.xyz, r_norm);
+            node = n.links.y;
+        } else {
+            node++;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+// Draws the initial particles on the GPU. Each particle's numbers come from Philox keyed by the seed with the
+// particle index as the counter, so the result depends only on the seed, not on dispatch order.
+const MAX_INIT_SPECIES: u32 = 10u;
+
+const DISTRIBUTION_BOX: u32 = 0u;
+const DISTRIBUTION_CYLINDRICAL: u32 = 1u;
+
+// Second counter word, separating the draws made for each particle
+const STREAM_POSITION: u32 = 0u;
+const STREAM_VELOCITY: u32 = 1u;
+
+struct ParticleInitParams {
+    seed: vec2<u32>,
+    nParticles: u32,
+    distribution: u32,
+    distMin: vec4<f32>, // xyz: lower corner, (r, y, theta) for DISTRIBUTION_CYLINDRICAL
+    distMax: vec4<f32>,
+    nSpecies: u32,
+    species: array<vec4<f32>, MAX_INIT_SPECIES>, // [species, cumulative fraction, velocity sigma, unused]
+}
+
+@group(0) @binding(0) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(1) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(2) var<uniform> params: ParticleInitParams;
+
+fn sample_species(u: f32) -> vec4<f32> {
+    for (var i = 0u; i < params.nSpecies; i++) {
+        if (u < params.species[i].y) {
+            return params.species[i];
+        }
+    }
+    return params.species[params.nSpecies - 1u];
+}
+
+fn sample_position(u: vec3<f32>) -> vec3<f32> {
+    let p = params.distMin.xyz + u * (params.distMax.xyz - params.distMin.xyz);
+    if (params.distribution == DISTRIBUTION_CYLINDRICAL) {
+        return vec3<f32>(p.x * sin(p.z), p.y, p.x * cos(p.z));
+    }
+    return p;
+}
+
+@compute @workgroup_size(256)
+fn initParticles(@builtin(global_invocation_id) global_id: vec3<u32>, @builtin(num_workgroups) num_workgroups: vec3<u32>) {
+    // Large inits are dispatched in 2D to stay under the per-dimension workgroup limit
+    let id = global_id.x + global_id.y * num_workgroups.x * 256u;
+    if (id >= params.nParticles) {
+        return;
+    }
+
+    let r0 = philox4x32_10(vec4<u32>(id, STREAM_POSITION, 0u, 0u), params.seed);
+    let r1 = philox4x32_10(vec4<u32>(id, STREAM_VELOCITY, 0u, 0u), params.seed);
+
+    let species = sample_species(philox_uniform(r0.x));
+    let pos = sample_position(vec3<f32>(philox_uniform(r0.y), philox_uniform(r0.z), philox_uniform(r0.w)));
+
+    // Maxwell-Boltzmann: each component normal with the species' sigma
+    let n01 = philox_normal2(r1.x, r1.y);
+    let n23 = philox_normal2(r1.z, r1.w);
+    let vel = species.z * vec3<f32>(n01.x, n01.y, n23.x);
+
+    particlePos[id] = vec4<f32>(pos, species.x);
+    particleVel[id] = vec4<f32>(vel, 0.0);
+}
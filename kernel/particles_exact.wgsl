@@ -7,6 +7,8 @@ struct ComputeMotionParams {
     nCurrentSegments: u32,
     solenoidFlux: f32,
     enableParticleFieldContributions: u32,
+    openingAngle: f32,             // Barnes-Hut opening angle
+    nOctreeNodes: u32,             // 0 sums over all particles directly
 }
 
 @group(0) @binding(0) var<storage, read_write> nParticles: u32;
@@ -15,23 +17,26 @@ struct ComputeMotionParams {
 @group(0) @binding(3) var<storage, read> currentSegments: array<vec4<f32>>;
 @group(0) @binding(4) var<storage, read_write> debug: array<vec4<f32>>;
 @group(0) @binding(5) var<uniform> params: ComputeMotionParams;
+@group(0) @binding(6) var<storage, read> octreeNodes: array<OctreeNode>;
+@group(0) @binding(7) var<storage, read> octreeParticles: array<u32>;
+@group(0) @binding(8) var<uniform> speciesTable: SpeciesTable;
 
 @compute @workgroup_size(256)
 // Lorentz particle push based on exact calculations of E and B field from the scene
-fn computeMotion(@builtin(global_invocation_id) global_id: vec3<u32>) {
+fn computeMotion(
+    @builtin(global_invocation_id) global_id: vec3<u32>,
+    @builtin(local_invocation_index) local_idx: u32
+) {
     let id = global_id.x;
-    if (id >= nParticles) {
-        return;
-    }
 
-    let species = particlePos[id].w;
-    if (species == 0.0) {
-        return; // inactive particle
-    }
+    // Out-of-range and inactive invocations still take part in the tiled particle sum
+    let inRange = id < nParticles;
+    let species = particlePos[select(0u, id, inRange)].w;
+    let active = inRange && species != 0.0;
 
     // Extract position and charge-to-mass ratio for this particle
-    let pos = vec3<f32>(particlePos[id].xyz);
-    let vel = vec3<f32>(particleVel[id].xyz);
+    let pos = vec3<f32>(particlePos[select(0u, id, inRange)].xyz);
+    let vel = vec3<f32>(particleVel[select(0u, id, inRange)].xyz);
     let mass = particle_mass(species);
     let q_over_m = charge_to_mass_ratio(species);
 
@@ -39,9 +44,13 @@ fn computeMotion(@builtin(global_invocation_id) global_id: vec3<u32>) {
     var E = vec3<f32>(0.0, 0.0, 0.0);
     var B = vec3<f32>(0.0, 0.0, 0.0);
 
-    if (params.enableParticleFieldContributions != 0u) {
+    if (params.enableParticleFieldContributions != 0u && params.nOctreeNodes > 0u) {
+        if (active) {
+            compute_octree_field_contributions(params.nOctreeNodes, &octreeNodes, &octreeParticles, &particlePos, &particleVel, pos, i32(id), params.openingAngle, &E, &B);
+        }
+    } else if (params.enableParticleFieldContributions != 0u) {
         var collider_id: i32 = -1;
-        compute_particle_field_contributions(nParticles, &particlePos, &particleVel, pos, i32(id), &E, &B, &collider_id);
+        compute_particle_field_contributions_tiled(&nParticles, &particlePos, &particleVel, pos, i32(id), local_idx, &E, &B, &collider_id);
         
         // to avoid both work items spawning a new particle, check id < collider_id, which will only be true for one of them
         if (collider_id >= 0 && i32(id) < collider_id) {
@@ -49,6 +58,10 @@ fn computeMotion(@builtin(global_invocation_id) global_id: vec3<u32>) {
         }
     }
 
+    if (!active) {
+        return; // inactive particle
+    }
+
     // Calculate the contribution of the currents
     B += compute_currents_b_field(&currentSegments, params.nCurrentSegments, pos);
 
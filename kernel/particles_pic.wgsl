@@ -1,3 +1,5 @@
+// The eField and bField bindings (3 and 4) and gather_particle_fields come from
+// kernel/particles_pic_field_buffers.wgsl or, with --fieldTextures, kernel/particles_pic_field_textures.wgsl
 struct ComputeMotionParams {
     dt: f32,
     enableParticleFieldContributions: u32,
@@ -6,12 +8,11 @@ struct ComputeMotionParams {
 @group(0) @binding(0) var<storage, read_write> nParticles: u32;
 @group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
 @group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
-@group(0) @binding(3) var<storage, read_write> eField: array<vec4<f32>>;
-@group(0) @binding(4) var<storage, read_write> bField: array<vec4<f32>>;
 @group(0) @binding(5) var<storage, read_write> debug: array<vec4<f32>>;
 @group(0) @binding(6) var<uniform> params: ComputeMotionParams;
 @group(0) @binding(7) var<uniform> mesh: MeshProperties;
 @group(0) @binding(8) var<storage, read> cellLocation: array<vec4<f32>>;
+@group(0) @binding(9) var<uniform> speciesTable: SpeciesTable;
 
 @compute @workgroup_size(256)
 // Lorentz particle push based on E and B fields interpolated from mesh
@@ -31,35 +32,10 @@ fn computeMotion(@builtin(global_invocation_id) global_id: vec3<u32>) {
     var vel = vec3<f32>(particleVel[id].xyz);
     let q_over_m = charge_to_mass_ratio(species);
 
-    // Locate the particle in the mesh
-    var neighbors: CellNeighbors = cell_neighbors(pos, &mesh);
-
-    var E: vec3<f32>;
-    var B: vec3<f32>;
-    if (neighbors.xp_yp_zp == -1i) {
-        // Outside mesh: assume zero field so particle continues with constant velocity; boundary will wrap.
-        E = vec3<f32>(0.0, 0.0, 0.0);
-        B = vec3<f32>(0.0, 0.0, 0.0);
-    } else {
-        // Compute the E and B fields at the neighbor cells
-        var neighbors_E: CellNeighborVectors = cell_neighbor_vectors(&neighbors, &eField);
-        var neighbors_B: CellNeighborVectors = cell_neighbor_vectors(&neighbors, &bField);
-
-        // Compute this particle's self contribution and subtract it out
-        if (params.enableParticleFieldContributions != 0u) {
-            var self_contribution_E: CellNeighborVectors;
-            var self_contribution_B: CellNeighborVectors;
-            compute_self_field_contribution(pos, vel, species, &neighbors, &cellLocation, &self_contribution_E, &self_contribution_B);
-
-            // Subtract out this particle's contribution from the neighbor cell fields
-            subtract_self_field_contribution(&neighbors_E, &self_contribution_E);
-            subtract_self_field_contribution(&neighbors_B, &self_contribution_B);
-        }
-
-        // Interpolate the E and B field at particle position from the mesh
-        E = interp(&mesh, &neighbors_E, pos);
-        B = interp(&mesh, &neighbors_B, pos);
-    }
+    // Interpolate the E and B field at particle position from the mesh
+    var E = vec3<f32>(0.0, 0.0, 0.0);
+    var B = vec3<f32>(0.0, 0.0, 0.0);
+    gather_particle_fields(pos, vel, species, &E, &B);
 
     // Push the particle through the electric and magnetic field: dv/dt = q/m (E + v x B);
     let t = q_over_m * B * 0.5 * params.dt;
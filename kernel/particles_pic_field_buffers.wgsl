@@ -0,0 +1,37 @@
+// Field gather for kernel/particles_pic.wgsl from the E and B mesh buffers
+@group(0) @binding(3) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> bField: array<vec4<f32>>;
+
+// E and B at the particle, interpolated from the 8 surrounding nodes less the particle's own contribution to them
+fn gather_particle_fields(
+    pos: vec3<f32>,
+    vel: vec3<f32>,
+    species: f32,
+    E: ptr<function, vec3<f32>>,
+    B: ptr<function, vec3<f32>>
+) {
+    // Locate the particle in the mesh
+    var neighbors: CellNeighbors = cell_neighbors(pos, &mesh);
+    if (neighbors.xp_yp_zp == -1i) {
+        // Outside mesh: assume zero field so particle continues with constant velocity; boundary will wrap.
+        return;
+    }
+
+    // Compute the E and B fields at the neighbor cells
+    var neighbors_E: CellNeighborVectors = cell_neighbor_vectors(&neighbors, &eField);
+    var neighbors_B: CellNeighborVectors = cell_neighbor_vectors(&neighbors, &bField);
+
+    // Compute this particle's self contribution and subtract it out
+    if (params.enableParticleFieldContributions != 0u) {
+        var self_contribution_E: CellNeighborVectors;
+        var self_contribution_B: CellNeighborVectors;
+        compute_self_field_contribution(pos, vel, species, &neighbors, &cellLocation, &self_contribution_E, &self_contribution_B);
+
+        // Subtract out this particle's contribution from the neighbor cell fields
+        subtract_self_field_contribution(&neighbors_E, &self_contribution_E);
+        subtract_self_field_contribution(&neighbors_B, &self_contribution_B);
+    }
+
+    *E = interp(&mesh, &neighbors_E, pos);
+    *B = interp(&mesh, &neighbors_B, pos);
+}
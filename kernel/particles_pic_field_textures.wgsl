@@ -0,0 +1,38 @@
+// Field gather for kernel/particles_pic.wgsl from the 3D field textures written by kernel/write_field_textures.wgsl,
+// selected with --fieldTextures. The textures are rgba32float and unscaled, so this matches the buffer gather.
+@group(0) @binding(3) var eField: texture_3d<f32>;
+@group(0) @binding(4) var bField: texture_3d<f32>;
+
+// E and B at the particle, interpolated from the 8 surrounding texels less the particle's own contribution to them
+fn gather_particle_fields(
+    pos: vec3<f32>,
+    vel: vec3<f32>,
+    species: f32,
+    E: ptr<function, vec3<f32>>,
+    B: ptr<function, vec3<f32>>
+) {
+    // Locate the particle in the mesh
+    var neighbors: CellNeighbors = cell_neighbors(pos, &mesh);
+    if (neighbors.xp_yp_zp == -1i) {
+        // Outside mesh: assume zero field so particle continues with constant velocity; boundary will wrap.
+        return;
+    }
+
+    // Load the E and B fields at the neighbor cells
+    var neighbors_E: CellNeighborVectors = field_texture_neighbor_vectors(eField, &neighbors, mesh.dim);
+    var neighbors_B: CellNeighborVectors = field_texture_neighbor_vectors(bField, &neighbors, mesh.dim);
+
+    // Compute this particle's self contribution and subtract it out
+    if (params.enableParticleFieldContributions != 0u) {
+        var self_contribution_E: CellNeighborVectors;
+        var self_contribution_B: CellNeighborVectors;
+        compute_self_field_contribution(pos, vel, species, &neighbors, &cellLocation, &self_contribution_E, &self_contribution_B);
+
+        // Subtract out this particle's contribution from the neighbor cell fields
+        subtract_self_field_contribution(&neighbors_E, &self_contribution_E);
+        subtract_self_field_contribution(&neighbors_B, &self_contribution_B);
+    }
+
+    *E = interp(&mesh, &neighbors_E, pos);
+    *B = interp(&mesh, &neighbors_B, pos);
+}
@@ -28,6 +28,7 @@
 #define Q_E                   (1.602176487e-19f               * (_A * _S))                              /* A s */
 #define K_E                   (1.0f / (4.0f * PI * EPSILON_0) * (_KG * _M / (_A * _A * _S * _S)))       /* kg m^3 / A^2 s^4 */
 #define MU_0_OVER_4_PI        (MU_0 / (4.0f * PI)             * (_KG * _M / (_A * _A * _S * _S)))       /* kg m / A^2 s^2 */
+#define C_LIGHT               (299792458.0f                   * (_M / _S))                              /* m / s */
 
 #define Q_OVER_M_ELECTRON     (-1.75882020109e11f * (_A * _S / _KG))    /* A s / kg */
 #define Q_OVER_M_PROTON       ( 9.57883424534e7f  * (_A * _S / _KG))    /* A s / kg */
@@ -37,6 +38,8 @@
 
 #define MACROPARTICLE_N 1e9 // Number of particles per macroparticle
 
+// Species index stored in particlePos.w, 0 for an empty slot. Rows of species_table(), so new species are added
+// there and need no shader changes.
 enum PARTICLE_SPECIES {
     NEUTRON = 1,
     ELECTRON = 2,
@@ -46,53 +49,56 @@ enum PARTICLE_SPECIES {
     HELIUM_4_NUC = 6,
     DEUTERON = 7,
     TRITON = 8,
-    ELECTRON_MACROPARTICLE = 102,
-    PROTON_MACROPARTICLE = 103
+    ELECTRON_MACROPARTICLE = 9,
+    PROTON_MACROPARTICLE = 10
 };
 
+#define MAX_SPECIES 16 // Rows in the species table, matching MAX_SPECIES in kernel/species.wgsl
+
+// One row of the species table, laid out as SpeciesInfo in kernel/species.wgsl. Mass and charge are those of one
+// simulated particle, i.e. weight physical particles; q/m is the physical ratio, which weighting leaves unchanged.
+struct SpeciesInfo {
+    float mass;     // kg
+    float charge;   // A s
+    float qOverM;   // A s / kg
+    float weight;   // Physical particles per simulated particle
+    float color[4]; // RGBA the renderers draw the species in
+};
+
+// Species registry shared by the host, the compute kernels and the render shaders, indexed by PARTICLE_SPECIES
+inline const SpeciesInfo* species_table() {
+    static const SpeciesInfo table[MAX_SPECIES] = {
+        { 0.0f,                             0.0f,                     0.0f,                  0.0f,            { 1.0f, 1.0f, 1.0f, 1.0f } }, // empty slot, white
+        { M_NEUTRON,                        0.0f,                     0.0f,                  1.0f,            { 0.5f, 0.5f, 0.5f, 1.0f } }, // neutron, gray
+        { M_ELECTRON,                       -Q_E,                     Q_OVER_M_ELECTRON,     1.0f,            { 0.0f, 0.0f, 1.0f, 1.0f } }, // electron, blue
+        { M_PROTON,                         Q_E,                      Q_OVER_M_PROTON,       1.0f,            { 1.0f, 0.0f, 0.0f, 1.0f } }, // proton, red
+        { M_DEUTERIUM,                      0.0f,                     0.0f,                  1.0f,            { 0.0f, 1.0f, 0.0f, 1.0f } }, // deuterium, green
+        { M_TRITIUM,                        0.0f,                     0.0f,                  1.0f,            { 1.0f, 0.0f, 1.0f, 1.0f } }, // tritium, purple
+        { M_HELIUM_4_NUC,                   2.0f * Q_E,               Q_OVER_M_HELIUM_4_NUC, 1.0f,            { 1.0f, 0.7f, 0.0f, 1.0f } }, // helium4, orange
+        { M_DEUTERON,                       Q_E,                      Q_OVER_M_DEUTERON,     1.0f,            { 0.0f, 0.8f, 0.0f, 1.0f } }, // ion_deuterium, green
+        { M_TRITON,                         Q_E,                      Q_OVER_M_TRITON,       1.0f,            { 0.8f, 0.0f, 0.8f, 1.0f } }, // ion_tritium, purple
+        { M_ELECTRON * MACROPARTICLE_N,     -Q_E * MACROPARTICLE_N,   Q_OVER_M_ELECTRON,     MACROPARTICLE_N, { 0.0f, 0.0f, 1.0f, 1.0f } }, // electron macroparticle, blue
+        { M_PROTON * MACROPARTICLE_N,       Q_E * MACROPARTICLE_N,    Q_OVER_M_PROTON,       MACROPARTICLE_N, { 1.0f, 0.0f, 0.0f, 1.0f } }  // proton macroparticle, red
+    };
+    return table;
+}
+
+// Row for the species stored in particlePos.w; out-of-range values read the last (unused) row
+inline const SpeciesInfo& species_info(float species) {
+    int i = static_cast<int>(species);
+    return species_table()[i < 0 || i >= MAX_SPECIES ? MAX_SPECIES - 1 : i];
+}
+
 inline float particle_mass(float species) {
-    if      (species == 1.0)   return M_NEUTRON;
-    else if (species == 2.0)   return M_ELECTRON;
-    else if (species == 3.0)   return M_PROTON;
-    else if (species == 4.0)   return M_DEUTERIUM;
-    else if (species == 5.0)   return M_TRITIUM;
-    else if (species == 6.0)   return M_HELIUM_4_NUC;
-    else if (species == 7.0)   return M_DEUTERON;
-    else if (species == 8.0)   return M_TRITON;
-    else if (species == 102.0) return M_ELECTRON;
-    else if (species == 103.0) return M_PROTON;
-
-    return 0.0; // error case, should never happen
+    return species_info(species).mass;
 }
 
 inline float particle_charge(float species) {
-    if      (species == 1.0)   return 0;         // neutron
-    else if (species == 2.0)   return -Q_E;      // electron
-    else if (species == 3.0)   return Q_E;       // proton
-    else if (species == 4.0)   return 0;         // deuterium
-    else if (species == 5.0)   return 0;         // tritium
-    else if (species == 6.0)   return 2.0 * Q_E; // helium4
-    else if (species == 7.0)   return Q_E;       // ion_deuterium
-    else if (species == 8.0)   return Q_E;       // ion_tritium
-    else if (species == 102.0) return -Q_E * MACROPARTICLE_N;   // electron macroparticle
-    else if (species == 103.0) return  Q_E * MACROPARTICLE_N;   // proton macroparticle
-
-    return 0.0; // error case, should never happen
+    return species_info(species).charge;
 }
 
 inline float charge_to_mass_ratio(float species) {
-    if      (species == 1.0)   return 0.0;
-    else if (species == 2.0)   return Q_OVER_M_ELECTRON;
-    else if (species == 3.0)   return Q_OVER_M_PROTON;
-    else if (species == 4.0)   return 0;
-    else if (species == 5.0)   return 0;
-    else if (species == 6.0)   return Q_OVER_M_HELIUM_4_NUC;
-    else if (species == 7.0)   return Q_OVER_M_DEUTERON;
-    else if (species == 8.0)   return Q_OVER_M_TRITON;
-    else if (species == 102.0) return Q_OVER_M_ELECTRON * MACROPARTICLE_N;
-    else if (species == 103.0) return Q_OVER_M_PROTON * MACROPARTICLE_N;
-
-    return 0.0; // error case, should never happen
+    return species_info(species).qOverM;
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+// Philox4x32-10 counter-based RNG: each (counter, key) pair maps to four independent 32-bit words, with no state
+// carried between draws. Mirrors src/util/philox.h.
+const PHILOX_M0: u32 = 0xD2511F53u;
+const PHILOX_M1: u32 = 0xCD9E8D57u;
+const PHILOX_W0: u32 = 0x9E3779B9u;
+const PHILOX_W1: u32 = 0xBB67AE85u;
+
+// Full 64-bit product of a and b as (hi, lo), built from 16-bit halves since WGSL has no u64
+fn mulhilo(a: u32, b: u32) -> vec2<u32> {
+    let aLo = a & 0xFFFFu;
+    let aHi = a >> 16u;
+    let bLo = b & 0xFFFFu;
+    let bHi = b >> 16u;
+
+    let loLo = aLo * bLo;
+    let hiLo = aHi * bLo;
+    let loHi = aLo * bHi;
+    let hiHi = aHi * bHi;
+
+    // At most 0xFFFFFFFF, so this can't wrap
+    let cross = (loLo >> 16u) + (hiLo & 0xFFFFu) + loHi;
+    let hi = hiHi + (hiLo >> 16u) + (cross >> 16u);
+    let lo = (cross << 16u) | (loLo & 0xFFFFu);
+    return vec2<u32>(hi, lo);
+}
+
+fn philox4x32_10(counter: vec4<u32>, key: vec2<u32>) -> vec4<u32> {
+    var ctr = counter;
+    var k = key;
+    for (var i = 0u; i < 10u; i++) {
+        let p0 = mulhilo(PHILOX_M0, ctr.x);
+        let p1 = mulhilo(PHILOX_M1, ctr.z);
+        ctr = vec4<u32>(p1.x ^ ctr.y ^ k.x, p1.y, p0.x ^ ctr.w ^ k.y, p0.y);
+        k += vec2<u32>(PHILOX_W0, PHILOX_W1);
+    }
+    return ctr;
+}
+
+// Uniform in [0, 1), from the top 24 bits
+fn philox_uniform(x: u32) -> f32 {
+    return f32(x >> 8u) * (1.0 / 16777216.0);
+}
+
+// Uniform in (0, 1], safe to take the log of
+fn philox_uniform_open(x: u32) -> f32 {
+    return f32((x >> 8u) + 1u) * (1.0 / 16777216.0);
+}
+
+// Two standard normals from two words (Box-Muller)
+fn philox_normal2(a: u32, b: u32) -> vec2<f32> {
+    let r = sqrt(-2.0 * log(philox_uniform_open(a)));
+    let theta = 2.0 * PI * philox_uniform(b);
+    return vec2<f32>(r * cos(theta), r * sin(theta));
+}
@@ -0,0 +1,160 @@
+// Counting sort of the particle arrays by mesh cell, so particles that gather from the same field nodes sit next
+// to each other in memory. A particle's key is the cell of the base node cell_neighbors picks for it; dead slots
+// and particles outside the mesh share one bucket after the last cell. Dispatches:
+//
+//   clearCounts    zero the per-cell counts
+//   countCells     key each particle and count it into its cell, keeping its rank within the cell
+//   scanCells      exclusive scan of the counts within each 256-cell block, in place
+//   scanBlockSums  exclusive scan of the block totals (one workgroup)
+//   scatter        write each particle into its cell's range of the scratch arrays
+//   copyBack       copy the scratch arrays over the particle arrays
+//   finishOffsets  (optional) add the block offsets in, leaving each cell's first sorted slot in cellStart
+//
+// Ranks come from atomics, so particles within a cell can land in a different order from run to run.
+const SORT_BLOCK: u32 = 256u;
+
+struct SortParams {
+    nCells: u32, // Mesh cells; bucket nCells holds dead and out-of-mesh particles
+}
+
+@group(0) @binding(0) var<storage, read_write> nParticles: u32;
+@group(0) @binding(1) var<storage, read_write> particlePos: array<vec4<f32>>;
+@group(0) @binding(2) var<storage, read_write> particleVel: array<vec4<f32>>;
+@group(0) @binding(3) var<storage, read_write> scratchPos: array<vec4<f32>>;
+@group(0) @binding(4) var<storage, read_write> scratchVel: array<vec4<f32>>;
+@group(0) @binding(5) var<storage, read_write> particleKey: array<vec2<u32>>; // [cell, rank within the cell]
+@group(0) @binding(6) var<storage, read_write> cellStart: array<atomic<u32>>; // Counts, then start offsets
+@group(0) @binding(7) var<storage, read_write> blockSums: array<u32>;
+@group(0) @binding(8) var<uniform> params: SortParams;
+@group(0) @binding(9) var<uniform> mesh: MeshProperties;
+
+var<workgroup> scanTile: array<u32, SORT_BLOCK>;
+
+// Inclusive Hillis-Steele scan of one value per invocation across the workgroup
+fn workgroup_inclusive_scan(lid: u32, value: u32) -> u32 {
+    scanTile[lid] = value;
+    workgroupBarrier();
+    for (var offset: u32 = 1u; offset < SORT_BLOCK; offset <<= 1u) {
+        var add: u32 = 0u;
+        if (lid >= offset) {
+            add = scanTile[lid - offset];
+        }
+        workgroupBarrier();
+        scanTile[lid] += add;
+        workgroupBarrier();
+    }
+    let result = scanTile[lid];
+    workgroupBarrier();
+    return result;
+}
+
+// Cell of the base node a particle interpolates from, as in cell_neighbors
+fn particle_cell(pos: vec4<f32>) -> u32 {
+    if (pos.w == 0.0 ||
+        pos.x < mesh.min.x || pos.x >= mesh.max.x ||
+        pos.y < mesh.min.y || pos.y >= mesh.max.y ||
+        pos.z < mesh.min.z || pos.z >= mesh.max.z) {
+        return params.nCells;
+    }
+
+    let base = vec3<i32>((pos.xyz - mesh.min) / mesh.cell_size);
+    let idx = to_linear_index(base.x, base.y, base.z, mesh.dim);
+    if (idx < 0i) {
+        return params.nCells;
+    }
+    return u32(idx);
+}
+
+@compute @workgroup_size(256)
+fn clearCounts(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id > params.nCells) {
+        return;
+    }
+    atomicStore(&cellStart[id], 0u);
+}
+
+@compute @workgroup_size(256)
+fn countCells(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let cell = particle_cell(particlePos[id]);
+    particleKey[id] = vec2<u32>(cell, atomicAdd(&cellStart[cell], 1u));
+}
+
+@compute @workgroup_size(256)
+fn scanCells(
+    @builtin(global_invocation_id) global_id: vec3<u32>,
+    @builtin(local_invocation_index) lid: u32,
+    @builtin(workgroup_id) workgroup_id: vec3<u32>
+) {
+    let id = global_id.x;
+    var count: u32 = 0u;
+    if (id <= params.nCells) {
+        count = atomicLoad(&cellStart[id]);
+    }
+
+    let inclusive = workgroup_inclusive_scan(lid, count);
+    if (id <= params.nCells) {
+        atomicStore(&cellStart[id], inclusive - count);
+    }
+    if (lid == SORT_BLOCK - 1u) {
+        blockSums[workgroup_id.x] = inclusive;
+    }
+}
+
+@compute @workgroup_size(256)
+fn scanBlockSums(@builtin(local_invocation_index) lid: u32) {
+    let nBlocks = (params.nCells + SORT_BLOCK) / SORT_BLOCK;
+
+    // Scan the block totals a chunk at a time, carrying the running sum between chunks
+    var carry: u32 = 0u;
+    for (var base: u32 = 0u; base < nBlocks; base += SORT_BLOCK) {
+        let b = base + lid;
+        var total: u32 = 0u;
+        if (b < nBlocks) {
+            total = blockSums[b];
+        }
+        let inclusive = workgroup_inclusive_scan(lid, total);
+        if (b < nBlocks) {
+            blockSums[b] = carry + inclusive - total;
+        }
+        carry += workgroupUniformLoad(&scanTile[SORT_BLOCK - 1u]);
+    }
+}
+
+@compute @workgroup_size(256)
+fn scatter(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    let key = particleKey[id];
+    let dst = blockSums[key.x / SORT_BLOCK] + atomicLoad(&cellStart[key.x]) + key.y;
+    scratchPos[dst] = particlePos[id];
+    scratchVel[dst] = particleVel[id];
+}
+
+@compute @workgroup_size(256)
+fn copyBack(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= nParticles) {
+        return;
+    }
+
+    particlePos[id] = scratchPos[id];
+    particleVel[id] = scratchVel[id];
+}
+
+@compute @workgroup_size(256)
+fn finishOffsets(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id > params.nCells) {
+        return;
+    }
+    atomicStore(&cellStart[id], atomicLoad(&cellStart[id]) + blockSums[id / SORT_BLOCK]);
+}
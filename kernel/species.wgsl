@@ -0,0 +1,36 @@
+// Species table, filled from species_table() in physical_constants.h. particlePos.w holds the species index, 0 for
+// an empty slot. Shaders that include this bind the table as speciesTable.
+const MAX_SPECIES: u32 = 16u;
+
+struct SpeciesInfo {
+    mass: f32,        // kg per simulated particle
+    charge: f32,      // A s per simulated particle
+    q_over_m: f32,    // A s / kg
+    weight: f32,      // physical particles per simulated particle
+    color: vec4<f32>, // render color
+}
+
+struct SpeciesTable {
+    species: array<SpeciesInfo, MAX_SPECIES>,
+}
+
+// Row for the species stored in particlePos.w; out-of-range values read the last (unused) row
+fn species_info(species: f32) -> SpeciesInfo {
+    return speciesTable.species[min(u32(species), MAX_SPECIES - 1u)];
+}
+
+fn particle_mass(species: f32) -> f32 {
+    return species_info(species).mass;
+}
+
+fn particle_charge(species: f32) -> f32 {
+    return species_info(species).charge;
+}
+
+fn charge_to_mass_ratio(species: f32) -> f32 {
+    return species_info(species).q_over_m;
+}
+
+fn species_color(species: f32) -> vec4<f32> {
+    return species_info(species).color;
+}
@@ -0,0 +1,57 @@
+// Traces field lines through the field cached on the mesh. The same kernel runs for the E and B tracers, each
+// with its own trails and field bound. The field binding (1) and sample_field come from
+// kernel/tracer_field_buffer.wgsl or, with --fieldTextures, kernel/tracer_field_texture.wgsl.
+const TRACER_STEP: f32 = 0.005 * _M;
+
+struct TracerParams {
+    nTracers: u32,
+    tracerLength: u32,
+    curTraceIdx: u32,
+    nPoints: u32,
+}
+
+@group(0) @binding(0) var<storage, read_write> tracerTrails: array<vec3<f32>>;
+@group(0) @binding(2) var<storage, read_write> debug: array<vec4<f32>>;
+@group(0) @binding(3) var<uniform> params: TracerParams;
+@group(0) @binding(4) var<uniform> mesh: MeshProperties;
+
+// Unit vector along the field at a position, zero where there is no field
+fn field_direction(pos: vec3<f32>) -> vec3<f32> {
+    // First scale up the field to avoid underflow when normalizing
+    let F = sample_field(pos) * 1e10;
+    if (length(F) > 0.0) {
+        return normalize(F);
+    }
+    return vec3<f32>(0.0);
+}
+
+// One invocation per tracer, extending its trail by params.nPoints RK4 steps of TRACER_STEP along the field
+// starting at params.curTraceIdx
+@compute @workgroup_size(64)
+fn updateTrails(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let id = global_id.x;
+    if (id >= params.nTracers) {
+        return;
+    }
+
+    let traceStart = id * params.tracerLength;
+
+    // Each point starts from the one before it, so a trail's points are written in order
+    for (var k: u32 = 0u; k < params.nPoints; k++) {
+        // The first point of each trail is its fixed start
+        let idx = (params.curTraceIdx + k) % params.tracerLength;
+        if (idx == 0u) {
+            continue;
+        }
+
+        let p = tracerTrails[traceStart + idx - 1];
+        let k1 = field_direction(p);
+        let k2 = field_direction(p + 0.5 * TRACER_STEP * k1);
+        let k3 = field_direction(p + 0.5 * TRACER_STEP * k2);
+        let k4 = field_direction(p + TRACER_STEP * k3);
+        tracerTrails[traceStart + idx] = p + (TRACER_STEP / 6.0) * (k1 + 2.0 * k2 + 2.0 * k3 + k4);
+
+        let F = sample_field(p);
+        debug[id] = vec4<f32>(F, length(F));
+    }
+}
@@ -0,0 +1,12 @@
+// Field lookup for kernel/tracer.wgsl from the mesh field buffer
+@group(0) @binding(1) var<storage, read_write> field: array<vec4<f32>>;
+
+// Field at a position, interpolated from the mesh, or zero outside it
+fn sample_field(pos: vec3<f32>) -> vec3<f32> {
+    var neighbors = cell_neighbors(pos, &mesh);
+    if (neighbors.xp_yp_zp == -1i) {
+        return vec3<f32>(0.0);
+    }
+    var neighbors_F = cell_neighbor_vectors(&neighbors, &field);
+    return interp(&mesh, &neighbors_F, pos);
+}
@@ -0,0 +1,20 @@
+// Copies the E and B mesh fields into the 3D textures read through kernel/field_texture.wgsl. The texture bindings
+// come from kernel/field_texture_rgba32float.wgsl or kernel/field_texture_rgba16float.wgsl, since the format is
+// part of the storage texture type.
+@group(0) @binding(0) var<storage, read_write> eField: array<vec4<f32>>;
+@group(0) @binding(1) var<storage, read_write> bField: array<vec4<f32>>;
+@group(0) @binding(2) var<uniform> params: FieldTextureParams;
+@group(0) @binding(3) var<uniform> mesh: MeshProperties;
+
+// One invocation per mesh node
+@compute @workgroup_size(256)
+fn writeFieldTextures(@builtin(global_invocation_id) global_id: vec3<u32>) {
+    let idx = global_id.x;
+    if (idx >= mesh.dim.x * mesh.dim.y * mesh.dim.z) {
+        return;
+    }
+
+    let coords = to_grid_coords(idx, mesh.dim);
+    textureStore(eTexture, coords, vec4<f32>(eField[idx].xyz * params.eScale, 0.0));
+    textureStore(bTexture, coords, vec4<f32>(bField[idx].xyz * params.bScale, 0.0));
+}
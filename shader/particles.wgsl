@@ -15,6 +15,7 @@ struct Uniforms {
 }
 
 @group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var<uniform> speciesTable: SpeciesTable;
 
 @vertex
 fn vertexMain(input: VertexInput) -> VertexOutput {
@@ -27,18 +28,8 @@ fn vertexMain(input: VertexInput) -> VertexOutput {
     output.position = uniforms.projection * viewPos;
     
     // Set color based on species
-         if (input.species == NEUTRON)                { output.color = vec4f(0.5, 0.5, 0.5, 1.0); } // gray
-    else if (input.species == ELECTRON)               { output.color = vec4f(0.0, 0.0, 1.0, 1.0); } // blue
-    else if (input.species == PROTON)                 { output.color = vec4f(1.0, 0.0, 0.0, 1.0); } // red
-    else if (input.species == DEUTERIUM)              { output.color = vec4f(0.0, 1.0, 0.0, 1.0); } // green
-    else if (input.species == TRITIUM)                { output.color = vec4f(1.0, 0.0, 1.0, 1.0); } // purple
-    else if (input.species == HELIUM_4_NUC)           { output.color = vec4f(1.0, 0.7, 0.0, 1.0); } // orange
-    else if (input.species == DEUTERON)               { output.color = vec4f(0.0, 0.8, 0.0, 1.0); } // green
-    else if (input.species == TRITON)                 { output.color = vec4f(0.8, 0.0, 0.8, 1.0); } // purple
-    else if (input.species == ELECTRON_MACROPARTICLE) { output.color = vec4f(0.0, 0.0, 1.0, 1.0); } // blue
-    else if (input.species == PROTON_MACROPARTICLE)   { output.color = vec4f(1.0, 0.0, 0.0, 1.0); } // red
-    else                                              { output.color = vec4f(1.0, 1.0, 1.0, 1.0); } // default white
-    
+    output.color = species_color(input.species);
+
     return output;
 }
 
@@ -19,6 +19,7 @@ struct Uniforms {
 }
 
 @group(0) @binding(0) var<uniform> uniforms: Uniforms;
+@group(0) @binding(1) var<uniform> speciesTable: SpeciesTable;
 
 @vertex
 fn vertexMain(input: VertexInput, instance: InstanceInput) -> VertexOutput {
@@ -39,19 +40,8 @@ fn vertexMain(input: VertexInput, instance: InstanceInput) -> VertexOutput {
     output.normal = normalize(input.position);
     
     // Set color based on species (same as particles.wgsl)
-    let species = instance.instancePosition.w;
-         if (species == NEUTRON)                { output.color = vec4f(0.5, 0.5, 0.5, 1.0); } // gray
-    else if (species == ELECTRON)               { output.color = vec4f(0.0, 0.0, 1.0, 1.0); } // blue
-    else if (species == PROTON)                 { output.color = vec4f(1.0, 0.0, 0.0, 1.0); } // red
-    else if (species == DEUTERIUM)              { output.color = vec4f(0.0, 1.0, 0.0, 1.0); } // green
-    else if (species == TRITIUM)                { output.color = vec4f(1.0, 0.0, 1.0, 1.0); } // purple
-    else if (species == HELIUM_4_NUC)           { output.color = vec4f(1.0, 0.7, 0.0, 1.0); } // orange
-    else if (species == DEUTERON)               { output.color = vec4f(0.0, 0.8, 0.0, 1.0); } // green
-    else if (species == TRITON)                 { output.color = vec4f(0.8, 0.0, 0.8, 1.0); } // purple
-    else if (species == ELECTRON_MACROPARTICLE) { output.color = vec4f(0.0, 0.0, 1.0, 1.0); } // blue
-    else if (species == PROTON_MACROPARTICLE)   { output.color = vec4f(1.0, 0.0, 0.0, 1.0); } // red
-    else                                        { output.color = vec4f(1.0, 1.0, 1.0, 1.0); } // default white
-    
+    output.color = species_color(instance.instancePosition.w);
+
     return output;
 }
 
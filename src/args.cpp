@@ -6,6 +6,31 @@
 
 #include "args.h"
 
+// Arguments that may be passed as a bare --key, meaning --key=true
+bool is_flag(const std::string& key) {
+    return key == "headless" || key == "profile";
+}
+
+Backend parse_backend(std::string backend) {
+    if (backend == "webgpu") {
+        return BACKEND_WEBGPU;
+    } else if (backend == "cpu") {
+        return BACKEND_CPU;
+    } else {
+        throw std::invalid_argument("Invalid backend: " + backend);
+    }
+}
+
+bool parse_bool(std::string value) {
+    if (value == "true" || value == "1") {
+        return true;
+    } else if (value == "false" || value == "0") {
+        return false;
+    } else {
+        throw std::invalid_argument("Invalid boolean: " + value);
+    }
+}
+
 std::unordered_map<std::string, std::string> parse_args(int argc, char* argv[]) {
     std::unordered_map<std::string, std::string> args;
 
@@ -20,6 +45,12 @@ std::unordered_map<std::string, std::string> parse_args(int argc, char* argv[])
         // Find the position of '=' to separate the key and value
         size_t equalPos = arg.find('=');
         if (equalPos == std::string::npos) {
+            // Boolean flags may be given without a value
+            std::string key = arg.substr(2);
+            if (is_flag(key)) {
+                args[key] = "true";
+                continue;
+            }
             throw std::invalid_argument("Invalid argument format: " + arg + ". Expected format is --key=value.");
         }
 
@@ -44,6 +75,28 @@ SceneType parse_scene_type(std::string sceneType) {
     }
 }
 
+FieldSolver parse_field_solver(std::string fieldSolver) {
+    if (fieldSolver == "auto") {
+        return FIELD_SOLVER_AUTO;
+    } else if (fieldSolver == "direct") {
+        return FIELD_SOLVER_DIRECT;
+    } else if (fieldSolver == "jacobi") {
+        return FIELD_SOLVER_JACOBI;
+    } else if (fieldSolver == "fft") {
+        return FIELD_SOLVER_FFT;
+    } else if (fieldSolver == "fft_cpu") {
+        return FIELD_SOLVER_FFT_CPU;
+    } else if (fieldSolver == "multigrid") {
+        return FIELD_SOLVER_MULTIGRID;
+    } else if (fieldSolver == "fdtd") {
+        return FIELD_SOLVER_FDTD;
+    } else if (fieldSolver == "exact") {
+        return FIELD_SOLVER_EXACT;
+    } else {
+        throw std::invalid_argument("Invalid field solver: " + fieldSolver);
+    }
+}
+
 SimulationParams extract_params(std::unordered_map<std::string, std::string> args) {
     SimulationParams params;
      for (const auto& [key, value] : args) {
@@ -51,12 +104,30 @@ SimulationParams extract_params(std::unordered_map<std::string, std::string> arg
         else if (key == "initialParticles")   params.initialParticles    = stoi(value);
         else if (key == "initialTemperature") params.initialTemperature  = stoi(value) * _K;
         else if (key == "maxParticles")       params.maxParticles        = stoi(value);
+        else if (key == "seed")               params.seed                = stoull(value);
         else if (key == "dt")                 params.dt                  = stof(value) * _S;
         else if (key == "fps")                params.targetFPS           = stoi(value);
         else if (key == "tracerDensity")      params.tracerDensity       = stof(value);
+        else if (key == "tracerPointsPerFrame") params.tracerPointsPerFrame = stoi(value);
         else if (key == "width")              params.windowWidth         = stoi(value);
         else if (key == "height")             params.windowHeight        = stoi(value);
         else if (key == "cellSpacing")        params.cellSpacing         = stof(value) * _M;
+        else if (key == "fieldSolver")        params.fieldSolver         = parse_field_solver(value);
+        else if (key == "solverIterations")   params.fieldSolverIterations = stoi(value);
+        else if (key == "multigridCycles")    params.multigridCycles     = stoi(value);
+        else if (key == "openingAngle")       params.openingAngle        = stof(value);
+        else if (key == "octreeInterval")     params.octreeInterval      = stoi(value);
+        else if (key == "fieldTextures")      params.fieldTextures       = parse_bool(value);
+        else if (key == "compactInterval")    params.compactInterval     = stoi(value);
+        else if (key == "compactDeadFraction") params.compactDeadFraction = stof(value);
+        else if (key == "sortInterval")       params.sortInterval        = stoi(value);
+        else if (key == "stepsPerSubmit")     params.stepsPerSubmit      = stoi(value);
+        else if (key == "backend")            params.backend             = parse_backend(value);
+        else if (key == "headless")           params.headless            = parse_bool(value);
+        else if (key == "steps")              params.steps               = stoul(value);
+        else if (key == "simTime")            params.simTime             = stof(value) * _S;
+        else if (key == "profile")            params.profile             = parse_bool(value);
+        else if (key == "profileCsv")         params.profileCsv          = value;
         else throw std::invalid_argument("Invalid argument '" + key + "'");
      }
     return params;
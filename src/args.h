@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include "physical_constants.h"
@@ -9,23 +10,65 @@ enum SceneType {
     SCENE_TYPE_TOKAMAK,
 };
 
+enum FieldSolver {
+    FIELD_SOLVER_AUTO,    // Scene default: FFT for the periodic free space scene, multigrid for the tokamak
+    FIELD_SOLVER_DIRECT,  // Direct Coulomb/Biot-Savart sums over all particles at every cell (reference)
+    FIELD_SOLVER_JACOBI,  // Cloud-in-cell deposit plus Jacobi relaxation of the potentials on the mesh
+    FIELD_SOLVER_FFT,     // Cloud-in-cell deposit plus spectral solve with periodic boundaries on the GPU
+    FIELD_SOLVER_FFT_CPU, // Spectral solve on the CPU (multithreaded), used when the mesh is too large for the GPU FFT
+    FIELD_SOLVER_MULTIGRID, // Cloud-in-cell deposit plus multigrid V-cycles, Dirichlet on inactive cells
+    FIELD_SOLVER_FDTD,    // Electromagnetic: Yee-lattice E/B advanced from the deposited current each step
+    FIELD_SOLVER_EXACT,   // Particle-particle fields summed at each particle in the push, through a Barnes-Hut octree
+};
+
+enum Backend {
+    BACKEND_WEBGPU, // Kernels run on the WebGPU device
+    BACKEND_CPU,    // Native multithreaded kernels (src/cpu_backend.h); the device is only used for rendering
+};
+
 struct SimulationParams {
     SceneType sceneType = SCENE_TYPE_TOKAMAK;
 
+    // Run parameters
+    Backend backend = BACKEND_WEBGPU;            // Where the simulation steps run
+    bool headless = false;                       // Compute only: no window, surface, rendering or input
+    glm::u32 steps = 0;                          // Stop after this many steps, 0 for no limit
+    glm::f32 simTime = 0.0f * _S;                // Stop once this much time has been simulated, s, 0 for no limit
+    bool profile = false;                        // Time each kernel and report rolling averages with the step log
+    std::string profileCsv = "kernel_times.csv"; // Where the profiled averages are written
+
     // Rendering parameters
     glm::u32 windowWidth = 1500;                 // Window width, px
     glm::u32 windowHeight = 1200;                // Window height, px
     glm::u16 targetFPS = 60;                     // Target FPS
     glm::f32 tracerDensity = 2.0;                // Tracer density, % of cells
+    glm::u32 tracerPointsPerFrame = 8;           // Tracer trail points computed per rendered frame
 
     // Particle initialization parameters
     glm::f32 initialTemperature = 100000.0 * _K; // Initial plasma temperature, K
     glm::u32 initialParticles = 100000;          // Number of initial particles
     glm::u32 maxParticles = 150000;              // Maximum number of particles
+    glm::u64 seed = 0;                           // Initial particle RNG seed, 0 picks one from the clock
     glm::f32 dt = 1e-10f * _S;                   // Simulation dt, s
+    glm::u32 stepsPerSubmit = 1;                 // Simulation steps recorded per command buffer submit
+
+    // Particle compaction parameters
+    glm::u32 compactInterval = 1000;             // Steps between compaction checks, 0 disables
+    glm::f32 compactDeadFraction = 0.25f;        // Compact once more than this fraction of the slots are dead
+
+    // Particle sorting parameters
+    glm::u32 sortInterval = 0;                   // Steps between sorts of the particles by cell, 0 disables
 
     // Cell parameters
     glm::f32 cellSpacing = 0.05f * _M;           // Distance between simulation mesh cells, m
+
+    // Field solver parameters
+    FieldSolver fieldSolver = FIELD_SOLVER_AUTO;   // How particle contributions to the fields are computed
+    glm::u32 fieldSolverIterations = 16;         // Relaxation sweeps per step for the Jacobi solver
+    glm::u32 multigridCycles = 1;                // V-cycles per step for the multigrid solver
+    glm::f32 openingAngle = 0.5f;                // Barnes-Hut opening angle for the exact solver, 0 sums directly
+    glm::u32 octreeInterval = 1;                 // Steps between octree rebuilds for the exact solver, above 1 the tree moments go stale
+    bool fieldTextures = false;                  // The GPU push and tracers read E and B from 3D textures, not buffers
 };
 
 std::unordered_map<std::string, std::string> parse_args(int argc, char* argv[]);
@@ -3,6 +3,7 @@
 #include <vector>
 #include "util/wgpu_util.h"
 #include "compute/boundary.h"
+#include "compute/indirect.h"
 
 struct BoundaryParams {
     glm::f32 x_min;
@@ -13,7 +14,7 @@ struct BoundaryParams {
     glm::f32 z_max;
 };
 
-BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles) {
+BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles, const UniformArena& uniforms) {
     BoundaryCompute boundaryCompute = {};
 
     wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/boundary.wgsl");
@@ -22,14 +23,6 @@ BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuff
         exit(1);
     }
 
-    wgpu::BufferDescriptor paramsBufferDesc = {
-        .label = "Boundary Compute Params Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-        .size = sizeof(BoundaryParams),
-        .mappedAtCreation = false
-    };
-    boundaryCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
-
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
         {
             .binding = 0,
@@ -52,14 +45,8 @@ BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuff
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = maxParticles * sizeof(glm::f32vec4)
             }
-        }, {
-            .binding = 3,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(BoundaryParams)
-            }
-        }
+        },
+        uniform_arena_layout_entry(3, sizeof(BoundaryParams))
     };
 
     wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
@@ -102,12 +89,8 @@ BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuff
             .buffer = particleBuf.vel,
             .offset = 0,
             .size = maxParticles * sizeof(glm::f32vec4)
-        }, {
-            .binding = 3,
-            .buffer = boundaryCompute.paramsBuffer,
-            .offset = 0,
-            .size = sizeof(BoundaryParams)
-        }
+        },
+        uniform_arena_bind_group_entry(uniforms, 3, sizeof(BoundaryParams))
     };
 
     wgpu::BindGroupDescriptor computeBindGroupDesc = {
@@ -121,17 +104,17 @@ BoundaryCompute create_boundary_compute(wgpu::Device& device, const ParticleBuff
     return boundaryCompute;
 }
 
-void run_boundary_compute(
-    wgpu::Device& device,
+// Pushes the params and binds the pipeline, leaving the dispatch to the caller
+static void bind_boundary_compute(
     wgpu::ComputePassEncoder& computePass,
     const BoundaryCompute& boundaryCompute,
+    UniformArena& uniforms,
     glm::f32 x_min,
     glm::f32 x_max,
     glm::f32 y_min,
     glm::f32 y_max,
     glm::f32 z_min,
-    glm::f32 z_max,
-    glm::u32 nParticles)
+    glm::f32 z_max)
 {
     BoundaryParams params = {
         .x_min = x_min,
@@ -141,11 +124,42 @@ void run_boundary_compute(
         .z_min = z_min,
         .z_max = z_max
     };
-    device.GetQueue().WriteBuffer(boundaryCompute.paramsBuffer, 0, &params, sizeof(BoundaryParams));
+    glm::u32 paramsOffset = push_uniform(uniforms, params);
 
     computePass.SetPipeline(boundaryCompute.pipeline);
-    computePass.SetBindGroup(0, boundaryCompute.bindGroup);
+    computePass.SetBindGroup(0, boundaryCompute.bindGroup, 1, &paramsOffset);
+}
+
+void run_boundary_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const BoundaryCompute& boundaryCompute,
+    UniformArena& uniforms,
+    glm::f32 x_min,
+    glm::f32 x_max,
+    glm::f32 y_min,
+    glm::f32 y_max,
+    glm::f32 z_min,
+    glm::f32 z_max,
+    glm::u32 nParticles)
+{
+    bind_boundary_compute(computePass, boundaryCompute, uniforms, x_min, x_max, y_min, y_max, z_min, z_max);
 
     glm::u32 workgroupCount = (nParticles + 255) / 256;
     computePass.DispatchWorkgroups(workgroupCount, 1, 1);
 }
+
+void run_boundary_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const BoundaryCompute& boundaryCompute,
+    UniformArena& uniforms,
+    glm::f32 x_min,
+    glm::f32 x_max,
+    glm::f32 y_min,
+    glm::f32 y_max,
+    glm::f32 z_min,
+    glm::f32 z_max,
+    const wgpu::Buffer& indirectArgs)
+{
+    bind_boundary_compute(computePass, boundaryCompute, uniforms, x_min, x_max, y_min, y_max, z_min, z_max);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
@@ -4,23 +4,24 @@
 #include <glm/glm.hpp>
 #include "util/wgpu_util.h"
 #include "shared/particles.h"
+#include "util/uniform_arena.h"
 
 struct BoundaryCompute {
     wgpu::BindGroupLayout bindGroupLayout;
     wgpu::ComputePipeline pipeline;
     wgpu::BindGroup bindGroup;
-    wgpu::Buffer paramsBuffer;
 };
 
 BoundaryCompute create_boundary_compute(
     wgpu::Device& device,
     const ParticleBuffers& particleBuf,
-    glm::u32 maxParticles);
+    glm::u32 maxParticles,
+    const UniformArena& uniforms);
 
 void run_boundary_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
     const BoundaryCompute& boundaryCompute,
+    UniformArena& uniforms,
     glm::f32 x_min,
     glm::f32 x_max,
     glm::f32 y_min,
@@ -28,3 +29,16 @@ void run_boundary_compute(
     glm::f32 z_min,
     glm::f32 z_max,
     glm::u32 nParticles);
+
+// Same as above, with the workgroup count taken from the dispatch args in indirectArgs (see compute/indirect.h)
+void run_boundary_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const BoundaryCompute& boundaryCompute,
+    UniformArena& uniforms,
+    glm::f32 x_min,
+    glm::f32 x_max,
+    glm::f32 y_min,
+    glm::f32 y_max,
+    glm::f32 z_min,
+    glm::f32 z_max,
+    const wgpu::Buffer& indirectArgs);
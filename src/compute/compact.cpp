@@ -0,0 +1,233 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/compact.h"
+
+// C++ struct matching the WGSL CompactParams struct
+struct CompactParams {
+    glm::f32 deadFraction;
+};
+
+const glm::u32 COMPACT_BLOCK = 256; // COMPACT_BLOCK in kernel/compact.wgsl
+
+CompactCompute create_compact_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles, glm::f32 deadFraction) {
+    CompactCompute compactCompute = {};
+    compactCompute.maxParticles = maxParticles;
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/compact.wgsl");
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create compact compute shader module" << std::endl;
+        exit(1);
+    }
+
+    glm::u32 nBlocks = (maxParticles + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+    glm::u64 particleSize = maxParticles * sizeof(glm::f32vec4);
+
+    // Create scratch and scan buffers
+    auto storage_buffer = [&device](const char* label, glm::u64 size) {
+        wgpu::BufferDescriptor desc = {
+            .label = label,
+            .usage = wgpu::BufferUsage::Storage,
+            .size = size,
+            .mappedAtCreation = false
+        };
+        return device.CreateBuffer(&desc);
+    };
+    compactCompute.scratchPos = storage_buffer("Compact Scratch Position Buffer", particleSize);
+    compactCompute.scratchVel = storage_buffer("Compact Scratch Velocity Buffer", particleSize);
+    compactCompute.localOffset = storage_buffer("Compact Local Offset Buffer", maxParticles * sizeof(glm::u32));
+    compactCompute.blockSums = storage_buffer("Compact Block Sums Buffer", nBlocks * sizeof(glm::u32));
+    compactCompute.state = storage_buffer("Compact State Buffer", 4 * sizeof(glm::u32));
+
+    // Create params uniform buffer
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Compact Compute Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(CompactParams),
+        .mappedAtCreation = false
+    };
+    compactCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+
+    CompactParams params = {
+        .deadFraction = deadFraction
+    };
+    device.GetQueue().WriteBuffer(compactCompute.paramsBuffer, 0, &params, sizeof(CompactParams));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // particlePos
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // particleVel
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // scratchPos
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // scratchVel
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // localOffset
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::u32)
+            }
+        }, { // blockSums
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nBlocks * sizeof(glm::u32)
+            }
+        }, { // state
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = 4 * sizeof(glm::u32)
+            }
+        }, { // params
+            .binding = 8,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(CompactParams)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Compact Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    compactCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines, one per scan/scatter stage
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Compact Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &compactCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint) {
+        wgpu::ComputePipelineDescriptor computePipelineDesc = {
+            .label = label,
+            .layout = computePipelineLayout,
+            .compute = {
+                .module = computeShaderModule,
+                .entryPoint = entryPoint
+            }
+        };
+        return device.CreateComputePipeline(&computePipelineDesc);
+    };
+    compactCompute.scanBlocksPipeline = create_pipeline("Compact Scan Blocks Pipeline", "scanBlocks");
+    compactCompute.scanBlockSumsPipeline = create_pipeline("Compact Scan Block Sums Pipeline", "scanBlockSums");
+    compactCompute.scatterPipeline = create_pipeline("Compact Scatter Pipeline", "scatter");
+    compactCompute.copyBackPipeline = create_pipeline("Compact Copy Back Pipeline", "copyBack");
+
+    // Create compute bind group
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(uint32_t)
+        }, { // particlePos
+            .binding = 1,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = particleSize
+        }, { // particleVel
+            .binding = 2,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = particleSize
+        }, { // scratchPos
+            .binding = 3,
+            .buffer = compactCompute.scratchPos,
+            .offset = 0,
+            .size = particleSize
+        }, { // scratchVel
+            .binding = 4,
+            .buffer = compactCompute.scratchVel,
+            .offset = 0,
+            .size = particleSize
+        }, { // localOffset
+            .binding = 5,
+            .buffer = compactCompute.localOffset,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::u32)
+        }, { // blockSums
+            .binding = 6,
+            .buffer = compactCompute.blockSums,
+            .offset = 0,
+            .size = nBlocks * sizeof(glm::u32)
+        }, { // state
+            .binding = 7,
+            .buffer = compactCompute.state,
+            .offset = 0,
+            .size = 4 * sizeof(glm::u32)
+        }, { // params
+            .binding = 8,
+            .buffer = compactCompute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(CompactParams)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Compact Compute Bind Group",
+        .layout = compactCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    compactCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return compactCompute;
+}
+
+void run_compact_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const CompactCompute& compactCompute)
+{
+    computePass.SetBindGroup(0, compactCompute.bindGroup);
+
+    // The live count is only known on the GPU, so every stage covers the whole array and exits past nCur
+    glm::u32 workgroupCount = (compactCompute.maxParticles + COMPACT_BLOCK - 1) / COMPACT_BLOCK;
+    computePass.SetPipeline(compactCompute.scanBlocksPipeline);
+    computePass.DispatchWorkgroups(workgroupCount, 1, 1);
+    computePass.SetPipeline(compactCompute.scanBlockSumsPipeline);
+    computePass.DispatchWorkgroups(1, 1, 1);
+    computePass.SetPipeline(compactCompute.scatterPipeline);
+    computePass.DispatchWorkgroups(workgroupCount, 1, 1);
+    computePass.SetPipeline(compactCompute.copyBackPipeline);
+    computePass.DispatchWorkgroups(workgroupCount, 1, 1);
+}
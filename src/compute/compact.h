@@ -0,0 +1,36 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "util/wgpu_util.h"
+#include "shared/particles.h"
+
+struct CompactCompute {
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::ComputePipeline scanBlocksPipeline;
+    wgpu::ComputePipeline scanBlockSumsPipeline;
+    wgpu::ComputePipeline scatterPipeline;
+    wgpu::ComputePipeline copyBackPipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::Buffer paramsBuffer;
+
+    wgpu::Buffer scratchPos;  // Packed positions, copied back over the particle array
+    wgpu::Buffer scratchVel;  // Packed velocities
+    wgpu::Buffer localOffset; // Exclusive scan of the live flags within each block
+    wgpu::Buffer blockSums;   // Live count per block, then its exclusive offset
+    wgpu::Buffer state;       // CompactState in kernel/compact.wgsl
+    glm::u32 maxParticles;
+};
+
+CompactCompute create_compact_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    glm::u32 maxParticles,
+    glm::f32 deadFraction);
+
+// Packs the live particles to the front of the arrays and sets nCur to the live count, entirely on the GPU.
+// Nothing moves unless more than the deadFraction given at creation of the current slots hold dead (species 0)
+// particles.
+void run_compact_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const CompactCompute& compactCompute);
@@ -0,0 +1,250 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/deposit.h"
+#include "compute/indirect.h"
+#include "mesh.h"
+
+// C++ struct matching the WGSL DepositParams struct
+struct DepositParams {
+    glm::u32 nCells;
+};
+
+DepositCompute create_deposit_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles)
+{
+    DepositCompute depositCompute = {};
+
+    // Create compute shader module
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/deposit.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/species.wgsl",
+            "kernel/mesh.wgsl",
+            "kernel/atomic_f32.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create deposit compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Create params uniform buffer
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Deposit Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(DepositParams),
+        .mappedAtCreation = false
+    };
+    depositCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+
+    DepositParams params = {
+        .nCells = fieldBuf.nCells
+    };
+    device.GetQueue().WriteBuffer(depositCompute.paramsBuffer, 0, &params, sizeof(DepositParams));
+
+    // Create mesh uniform buffer
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Deposit Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    depositCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(depositCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // particlePos
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, { // particleVel
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, { // rho
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = fieldBuf.nCells * sizeof(glm::f32)
+            }
+        }, { // current
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = fieldBuf.nCells * sizeof(glm::f32vec4)
+            }
+        }, { // params
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(DepositParams)
+            }
+        }, { // mesh
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }, { // speciesTable
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = SPECIES_TABLE_SIZE
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Deposit Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    depositCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines (clear and deposit share the layout)
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Deposit Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &depositCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor clearPipelineDesc = {
+        .label = "Clear Sources Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "clearSources"
+        }
+    };
+    depositCompute.clearPipeline = device.CreateComputePipeline(&clearPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor depositPipelineDesc = {
+        .label = "Deposit Sources Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "depositSources"
+        }
+    };
+    depositCompute.depositPipeline = device.CreateComputePipeline(&depositPipelineDesc);
+
+    // Create compute bind group with persistent buffers
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(glm::u32)
+        }, { // particlePos
+            .binding = 1,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, { // particleVel
+            .binding = 2,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, { // rho
+            .binding = 3,
+            .buffer = fieldBuf.rho,
+            .offset = 0,
+            .size = fieldBuf.nCells * sizeof(glm::f32)
+        }, { // current
+            .binding = 4,
+            .buffer = fieldBuf.current,
+            .offset = 0,
+            .size = fieldBuf.nCells * sizeof(glm::f32vec4)
+        }, { // params
+            .binding = 5,
+            .buffer = depositCompute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(DepositParams)
+        }, { // mesh
+            .binding = 6,
+            .buffer = depositCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }, { // speciesTable
+            .binding = 7,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Deposit Compute Bind Group",
+        .layout = depositCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    depositCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return depositCompute;
+}
+
+// Zeroes the sources and binds the deposit pipeline, leaving the particle dispatch to the caller
+static void prepare_deposit_compute(
+    wgpu::ComputePassEncoder& pass,
+    const DepositCompute& depositCompute,
+    glm::u32 nCells)
+{
+    pass.SetBindGroup(0, depositCompute.bindGroup);
+
+    // Zero the sources, then scatter every particle into its 8 surrounding nodes
+    pass.SetPipeline(depositCompute.clearPipeline);
+    pass.DispatchWorkgroups((nCells + 255) / 256, 1, 1);
+
+    pass.SetPipeline(depositCompute.depositPipeline);
+}
+
+void run_deposit_compute(
+    wgpu::ComputePassEncoder& pass,
+    const DepositCompute& depositCompute,
+    glm::u32 nCells,
+    glm::u32 nParticles)
+{
+    prepare_deposit_compute(pass, depositCompute, nCells);
+    pass.DispatchWorkgroups((nParticles + 255) / 256, 1, 1);
+}
+
+void run_deposit_compute(
+    wgpu::ComputePassEncoder& pass,
+    const DepositCompute& depositCompute,
+    glm::u32 nCells,
+    const wgpu::Buffer& indirectArgs)
+{
+    prepare_deposit_compute(pass, depositCompute, nCells);
+    pass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "mesh.h"
+
+struct DepositCompute {
+    wgpu::ComputePipeline clearPipeline;
+    wgpu::ComputePipeline depositPipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::BindGroupLayout bindGroupLayout;
+
+    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer meshBuffer;
+};
+
+DepositCompute create_deposit_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles);
+
+void run_deposit_compute(
+    wgpu::ComputePassEncoder& pass,
+    const DepositCompute& depositCompute,
+    glm::u32 nCells,
+    glm::u32 nParticles);
+
+// Same as above, with the particle workgroup count taken from the dispatch args in indirectArgs
+void run_deposit_compute(
+    wgpu::ComputePassEncoder& pass,
+    const DepositCompute& depositCompute,
+    glm::u32 nCells,
+    const wgpu::Buffer& indirectArgs);
@@ -0,0 +1,531 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/fdtd.h"
+#include "compute/indirect.h"
+#include "physical_constants.h"
+
+// Fraction of the Courant limit used for each substep
+const glm::f32 FDTD_COURANT_SAFETY = 0.9f;
+
+// C++ struct matching the WGSL FdtdParams struct
+struct FdtdParams {
+    glm::u32 nCells;
+    glm::f32 dt;
+    glm::f32 stepDt;
+};
+
+FdtdCompute create_fdtd_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const std::vector<Cell>& cells,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles,
+    const UniformArena& uniforms)
+{
+    FdtdCompute fdtdCompute = {};
+    glm::u32 nCells = fieldBuf.nCells;
+
+    // Create compute shader module
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/fdtd.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/mesh.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create FDTD compute shader module" << std::endl;
+        exit(1);
+    }
+
+    wgpu::ShaderModule depositShaderModule = create_shader_module(
+        device,
+        "kernel/fdtd_deposit.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/species.wgsl",
+            "kernel/mesh.wgsl",
+            "kernel/atomic_f32.wgsl"
+        }
+    );
+    if (!depositShaderModule) {
+        std::cerr << "Failed to create FDTD deposit shader module" << std::endl;
+        exit(1);
+    }
+
+    // Staggered fields start from zero until run_fdtd_init seeds them
+    std::vector<glm::f32vec4> zeros(nCells, glm::f32vec4(0.0f));
+
+    wgpu::BufferDescriptor yeeEDesc = {
+        .label = "Yee E Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fdtdCompute.yeeE = device.CreateBuffer(&yeeEDesc);
+    device.GetQueue().WriteBuffer(fdtdCompute.yeeE, 0, zeros.data(), nCells * sizeof(glm::f32vec4));
+
+    wgpu::BufferDescriptor yeeBDesc = {
+        .label = "Yee B Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fdtdCompute.yeeB = device.CreateBuffer(&yeeBDesc);
+    device.GetQueue().WriteBuffer(fdtdCompute.yeeB, 0, zeros.data(), nCells * sizeof(glm::f32vec4));
+
+    wgpu::BufferDescriptor yeeJDesc = {
+        .label = "Yee J Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fdtdCompute.yeeJ = device.CreateBuffer(&yeeJDesc);
+    device.GetQueue().WriteBuffer(fdtdCompute.yeeJ, 0, zeros.data(), nCells * sizeof(glm::f32vec4));
+
+    // Active nodes off the mesh faces; the rest is the conductor
+    std::vector<glm::u32> mask = interior_mask(cells, mesh);
+    wgpu::BufferDescriptor maskDesc = {
+        .label = "FDTD Mask Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::u32),
+        .mappedAtCreation = false
+    };
+    fdtdCompute.mask = device.CreateBuffer(&maskDesc);
+    device.GetQueue().WriteBuffer(fdtdCompute.mask, 0, mask.data(), nCells * sizeof(glm::u32));
+
+    // Create mesh uniform buffer
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "FDTD Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    fdtdCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(fdtdCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // yeeJ
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // yeeE
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // yeeB
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // eField
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // bField
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // mask
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::u32)
+            }
+        },
+        uniform_arena_layout_entry(6, sizeof(FdtdParams)), // params
+        { // mesh
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }, { // potential
+            .binding = 8,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "FDTD Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    fdtdCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines (all stages share the layout)
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "FDTD Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &fdtdCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor initPipelineDesc = {
+        .label = "FDTD Init Fields Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "initFields"
+        }
+    };
+    fdtdCompute.initPipeline = device.CreateComputePipeline(&initPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor updateBPipelineDesc = {
+        .label = "FDTD Update B Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "updateB"
+        }
+    };
+    fdtdCompute.updateBPipeline = device.CreateComputePipeline(&updateBPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor updateEPipelineDesc = {
+        .label = "FDTD Update E Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "updateE"
+        }
+    };
+    fdtdCompute.updateEPipeline = device.CreateComputePipeline(&updateEPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor applyPipelineDesc = {
+        .label = "FDTD Yee Fields Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "addYeeFields"
+        }
+    };
+    fdtdCompute.applyPipeline = device.CreateComputePipeline(&applyPipelineDesc);
+
+    // Create compute bind group with persistent buffers
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // yeeJ
+            .binding = 0,
+            .buffer = fdtdCompute.yeeJ,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // yeeE
+            .binding = 1,
+            .buffer = fdtdCompute.yeeE,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // yeeB
+            .binding = 2,
+            .buffer = fdtdCompute.yeeB,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // eField
+            .binding = 3,
+            .buffer = fieldBuf.eField,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // bField
+            .binding = 4,
+            .buffer = fieldBuf.bField,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // mask
+            .binding = 5,
+            .buffer = fdtdCompute.mask,
+            .offset = 0,
+            .size = nCells * sizeof(glm::u32)
+        },
+        uniform_arena_bind_group_entry(uniforms, 6, sizeof(FdtdParams)), // params
+        { // mesh
+            .binding = 7,
+            .buffer = fdtdCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }, { // potential
+            .binding = 8,
+            .buffer = fieldBuf.potential,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "FDTD Bind Group",
+        .layout = fdtdCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    fdtdCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    // Create the current deposit bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> depositBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // particlePos
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, { // particleVel
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, { // yeeJ
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        },
+        uniform_arena_layout_entry(4, sizeof(FdtdParams)), // params
+        { // mesh
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }, { // speciesTable
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = SPECIES_TABLE_SIZE
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor depositBindGroupLayoutDesc = {
+        .label = "FDTD Deposit Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(depositBindings.size()),
+        .entries = depositBindings.data()
+    };
+    fdtdCompute.depositBindGroupLayout = device.CreateBindGroupLayout(&depositBindGroupLayoutDesc);
+
+    // Create the current deposit pipelines (clear and deposit share the layout)
+    wgpu::PipelineLayoutDescriptor depositPipelineLayoutDesc = {
+        .label = "FDTD Deposit Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &fdtdCompute.depositBindGroupLayout
+    };
+    wgpu::PipelineLayout depositPipelineLayout = device.CreatePipelineLayout(&depositPipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor clearCurrentPipelineDesc = {
+        .label = "FDTD Clear Current Compute Pipeline",
+        .layout = depositPipelineLayout,
+        .compute = {
+            .module = depositShaderModule,
+            .entryPoint = "clearCurrent"
+        }
+    };
+    fdtdCompute.clearCurrentPipeline = device.CreateComputePipeline(&clearCurrentPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor depositCurrentPipelineDesc = {
+        .label = "FDTD Deposit Current Compute Pipeline",
+        .layout = depositPipelineLayout,
+        .compute = {
+            .module = depositShaderModule,
+            .entryPoint = "depositCurrent"
+        }
+    };
+    fdtdCompute.depositCurrentPipeline = device.CreateComputePipeline(&depositCurrentPipelineDesc);
+
+    // Create the current deposit bind group with persistent buffers
+    std::vector<wgpu::BindGroupEntry> depositEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(glm::u32)
+        }, { // particlePos
+            .binding = 1,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, { // particleVel
+            .binding = 2,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, { // yeeJ
+            .binding = 3,
+            .buffer = fdtdCompute.yeeJ,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        },
+        uniform_arena_bind_group_entry(uniforms, 4, sizeof(FdtdParams)), // params
+        { // mesh
+            .binding = 5,
+            .buffer = fdtdCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }, { // speciesTable
+            .binding = 6,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
+        }
+    };
+
+    wgpu::BindGroupDescriptor depositBindGroupDesc = {
+        .label = "FDTD Deposit Bind Group",
+        .layout = fdtdCompute.depositBindGroupLayout,
+        .entryCount = static_cast<uint32_t>(depositEntries.size()),
+        .entries = depositEntries.data()
+    };
+    fdtdCompute.depositBindGroup = device.CreateBindGroup(&depositBindGroupDesc);
+
+    return fdtdCompute;
+}
+
+glm::u32 fdtd_substeps(const MeshProperties& mesh, glm::f32 dt) {
+    // 3D Yee stability: C_LIGHT * dt * sqrt(1/hx^2 + 1/hy^2 + 1/hz^2) <= 1
+    glm::f32vec3 h = mesh.cell_size;
+    glm::f32 courant = C_LIGHT * dt * std::sqrt(1.0f / (h.x * h.x) + 1.0f / (h.y * h.y) + 1.0f / (h.z * h.z));
+    return std::max(1u, static_cast<glm::u32>(std::ceil(courant / FDTD_COURANT_SAFETY)));
+}
+
+void run_fdtd_init(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells)
+{
+    // dt is not used by the init
+    FdtdParams params = {
+        .nCells = nCells
+    };
+    glm::u32 offset = push_uniform(uniforms, params);
+
+    pass.SetPipeline(fdtdCompute.initPipeline);
+    pass.SetBindGroup(0, fdtdCompute.bindGroup, 1, &offset);
+    pass.DispatchWorkgroups((nCells + 255) / 256, 1, 1);
+}
+
+// Pushes the params, zeroes the edge currents and binds the current deposit pipeline, leaving the particle
+// dispatch to the caller. Returns the params offset for advance_fdtd_fields.
+static glm::u32 prepare_fdtd_deposit(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt)
+{
+    FdtdParams params = {
+        .nCells = nCells,
+        .dt = dt / fdtd_substeps(mesh, dt),
+        .stepDt = dt
+    };
+    glm::u32 offset = push_uniform(uniforms, params);
+
+    pass.SetBindGroup(0, fdtdCompute.depositBindGroup, 1, &offset);
+    pass.SetPipeline(fdtdCompute.clearCurrentPipeline);
+    pass.DispatchWorkgroups((nCells + 255) / 256, 1, 1);
+
+    pass.SetPipeline(fdtdCompute.depositCurrentPipeline);
+    return offset;
+}
+
+// Leapfrogs B and E through the substeps of dt with the deposited current
+static void advance_fdtd_fields(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt,
+    glm::u32 paramsOffset)
+{
+    glm::u32 nSubsteps = fdtd_substeps(mesh, dt);
+    glm::u32 nWorkgroups = (nCells + 255) / 256;
+    pass.SetBindGroup(0, fdtdCompute.bindGroup, 1, &paramsOffset);
+    for (glm::u32 i = 0; i < nSubsteps; i++) {
+        pass.SetPipeline(fdtdCompute.updateBPipeline);
+        pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+        pass.SetPipeline(fdtdCompute.updateEPipeline);
+        pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+    }
+}
+
+void run_fdtd_step(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt,
+    glm::u32 nParticles)
+{
+    glm::u32 offset = prepare_fdtd_deposit(pass, fdtdCompute, uniforms, mesh, nCells, dt);
+    pass.DispatchWorkgroups((nParticles + 255) / 256, 1, 1);
+    advance_fdtd_fields(pass, fdtdCompute, mesh, nCells, dt, offset);
+}
+
+void run_fdtd_step(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt,
+    const wgpu::Buffer& indirectArgs)
+{
+    glm::u32 offset = prepare_fdtd_deposit(pass, fdtdCompute, uniforms, mesh, nCells, dt);
+    pass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+    advance_fdtd_fields(pass, fdtdCompute, mesh, nCells, dt, offset);
+}
+
+void run_fdtd_fields(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells)
+{
+    FdtdParams params = {
+        .nCells = nCells
+    };
+    glm::u32 offset = push_uniform(uniforms, params);
+
+    pass.SetPipeline(fdtdCompute.applyPipeline);
+    pass.SetBindGroup(0, fdtdCompute.bindGroup, 1, &offset);
+    pass.DispatchWorkgroups((nCells + 255) / 256, 1, 1);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "mesh.h"
+#include "util/uniform_arena.h"
+
+// V-cycles of the electrostatic solve that seeds the Yee E, run once
+const glm::u32 FDTD_INIT_MULTIGRID_CYCLES = 16;
+
+struct FdtdCompute {
+    wgpu::ComputePipeline initPipeline;
+    wgpu::ComputePipeline clearCurrentPipeline;
+    wgpu::ComputePipeline depositCurrentPipeline;
+    wgpu::ComputePipeline updateBPipeline;
+    wgpu::ComputePipeline updateEPipeline;
+    wgpu::ComputePipeline applyPipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::BindGroup depositBindGroup;
+    wgpu::BindGroupLayout depositBindGroupLayout;
+
+    wgpu::Buffer yeeE;  // Staggered E [Ex, Ey, Ez, unused] on the cell edges
+    wgpu::Buffer yeeB;  // Staggered B [Bx, By, Bz, unused] on the cell faces
+    wgpu::Buffer yeeJ;  // Staggered current density [Jx, Jy, Jz, unused] on the cell edges
+    wgpu::Buffer mask;  // 1 for active nodes, 0 for the conductor (see interior_mask)
+    wgpu::Buffer meshBuffer;
+};
+
+// The mesh is written once here; the params are pushed to the uniform arena by each run_fdtd_*
+FdtdCompute create_fdtd_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const FieldBuffers& fieldBuf,
+    const std::vector<Cell>& cells,
+    const MeshProperties& mesh,
+    glm::u32 maxParticles,
+    const UniformArena& uniforms);
+
+// Number of substeps needed to keep dt within the Courant limit of the mesh
+glm::u32 fdtd_substeps(const MeshProperties& mesh, glm::f32 dt);
+
+// Seeds the Yee E with -grad(phi) from an electrostatic solve already in FieldBuffers::potential (e.g. multigrid
+// with the same mask) and clears the Yee B
+void run_fdtd_init(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells);
+
+// Deposits the current of the particles' last move (charge-conserving) and advances the Yee fields by dt,
+// subcycling as needed for stability
+void run_fdtd_step(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt,
+    glm::u32 nParticles);
+
+// Same as above, with the particle workgroup count taken from the dispatch args in indirectArgs
+void run_fdtd_step(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::f32 dt,
+    const wgpu::Buffer& indirectArgs);
+
+// Adds the Yee fields, averaged to the mesh nodes, into the E and B fields
+void run_fdtd_fields(
+    wgpu::ComputePassEncoder& pass,
+    const FdtdCompute& fdtdCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells);
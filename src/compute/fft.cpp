@@ -0,0 +1,305 @@
+#include <iostream>
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/fft.h"
+#include "fft_cpu.h"
+#include "physical_constants.h"
+
+// C++ struct matching the WGSL FftParams struct
+struct FftParams {
+    glm::u32 nCells;
+};
+
+FftCompute create_fft_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh)
+{
+    FftCompute fftCompute = {};
+    glm::u32 nCells = fieldBuf.nCells;
+
+    // Create compute shader module
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/fft.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/mesh.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create FFT compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Create params uniform buffer
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "FFT Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(FftParams),
+        .mappedAtCreation = false
+    };
+    fftCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+
+    FftParams params = {
+        .nCells = nCells
+    };
+    device.GetQueue().WriteBuffer(fftCompute.paramsBuffer, 0, &params, sizeof(FftParams));
+
+    // Create mesh uniform buffer
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "FFT Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    fftCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(fftCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Read buffers for the CPU fallback
+    wgpu::BufferDescriptor rhoReadBufDesc = {
+        .label = "FFT Rho Read Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+        .size = nCells * sizeof(glm::f32),
+        .mappedAtCreation = false
+    };
+    fftCompute.rhoReadBuf = device.CreateBuffer(&rhoReadBufDesc);
+
+    wgpu::BufferDescriptor currentReadBufDesc = {
+        .label = "FFT Current Read Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fftCompute.currentReadBuf = device.CreateBuffer(&currentReadBufDesc);
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // rho
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32)
+            }
+        }, { // current
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // potential
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // params
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(FftParams)
+            }
+        }, { // mesh
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "FFT Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    fftCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines (all stages share the layout)
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "FFT Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &fftCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor packPipelineDesc = {
+        .label = "FFT Pack Sources Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "packSources"
+        }
+    };
+    fftCompute.packPipeline = device.CreateComputePipeline(&packPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor scalePipelineDesc = {
+        .label = "FFT Scale Spectrum Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "scaleSpectrum"
+        }
+    };
+    fftCompute.scalePipeline = device.CreateComputePipeline(&scalePipelineDesc);
+
+    // One line transform pipeline per axis and direction, selected through pipeline constants
+    for (glm::u32 axis = 0; axis < 3; axis++) {
+        for (glm::u32 inverse = 0; inverse < 2; inverse++) {
+            std::vector<wgpu::ConstantEntry> constants = {
+                { .key = "FFT_AXIS", .value = static_cast<double>(axis) },
+                { .key = "FFT_INVERSE", .value = static_cast<double>(inverse) }
+            };
+            wgpu::ComputePipelineDescriptor linePipelineDesc = {
+                .label = "FFT Lines Compute Pipeline",
+                .layout = computePipelineLayout,
+                .compute = {
+                    .module = computeShaderModule,
+                    .entryPoint = "fftLines",
+                    .constantCount = constants.size(),
+                    .constants = constants.data()
+                }
+            };
+            fftCompute.linePipelines[axis][inverse] = device.CreateComputePipeline(&linePipelineDesc);
+        }
+    }
+
+    // Create compute bind group with persistent buffers
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // rho
+            .binding = 0,
+            .buffer = fieldBuf.rho,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32)
+        }, { // current
+            .binding = 1,
+            .buffer = fieldBuf.current,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // potential
+            .binding = 2,
+            .buffer = fieldBuf.potential,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // params
+            .binding = 3,
+            .buffer = fftCompute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(FftParams)
+        }, { // mesh
+            .binding = 4,
+            .buffer = fftCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "FFT Bind Group",
+        .layout = fftCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    fftCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return fftCompute;
+}
+
+bool fft_gpu_supported(const MeshProperties& mesh) {
+    return mesh.dim.x <= FFT_MAX_LINE && mesh.dim.y <= FFT_MAX_LINE && mesh.dim.z <= FFT_MAX_LINE;
+}
+
+// Dispatches one workgroup per mesh line along the given axis, folding into 2D past the per-dimension limit
+static void dispatch_fft_lines(
+    wgpu::ComputePassEncoder& pass,
+    const FftCompute& fftCompute,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::u32 axis,
+    bool inverse)
+{
+    const glm::u32 maxWorkgroups = 65535;
+    glm::u32 nLines = nCells / mesh.dim[axis];
+    glm::u32 nx = std::min(nLines, maxWorkgroups);
+    glm::u32 ny = (nLines + nx - 1) / nx;
+
+    pass.SetPipeline(fftCompute.linePipelines[axis][inverse ? 1 : 0]);
+    pass.DispatchWorkgroups(nx, ny, 1);
+}
+
+void run_fft_poisson(
+    wgpu::ComputePassEncoder& pass,
+    const FftCompute& fftCompute,
+    const MeshProperties& mesh,
+    glm::u32 nCells)
+{
+    glm::u32 nWorkgroups = (nCells + 255) / 256;
+    pass.SetBindGroup(0, fftCompute.bindGroup);
+
+    pass.SetPipeline(fftCompute.packPipeline);
+    pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+
+    for (glm::u32 axis = 0; axis < 3; axis++) {
+        dispatch_fft_lines(pass, fftCompute, mesh, nCells, axis, false);
+    }
+
+    pass.SetPipeline(fftCompute.scalePipeline);
+    pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+
+    for (glm::u32 axis = 0; axis < 3; axis++) {
+        dispatch_fft_lines(pass, fftCompute, mesh, nCells, axis, true);
+    }
+}
+
+void solve_fft_poisson_cpu(
+    wgpu::Device& device,
+    wgpu::Instance& instance,
+    const FftCompute& fftCompute,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 nThreads)
+{
+    glm::u32 nCells = fieldBuf.nCells;
+
+    wgpu::CommandEncoderDescriptor encoderDesc{.label = "FFT Readback Command Encoder"};
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&encoderDesc);
+    encoder.CopyBufferToBuffer(fieldBuf.rho, 0, fftCompute.rhoReadBuf, 0, nCells * sizeof(glm::f32));
+    encoder.CopyBufferToBuffer(fieldBuf.current, 0, fftCompute.currentReadBuf, 0, nCells * sizeof(glm::f32vec4));
+    wgpu::CommandBuffer commands = encoder.Finish();
+    device.GetQueue().Submit(1, &commands);
+
+    std::vector<glm::f32> rho(nCells);
+    std::vector<glm::f32vec4> current(nCells);
+    if (!read_buffer(instance, fftCompute.rhoReadBuf, nCells * sizeof(glm::f32), rho.data()) ||
+        !read_buffer(instance, fftCompute.currentReadBuf, nCells * sizeof(glm::f32vec4), current.data())) {
+        return;
+    }
+
+    // Same packing as the GPU path: (MU_0*Jx + i*MU_0*Jy) and (MU_0*Jz + i*rho/EPSILON_0)
+    std::vector<std::complex<glm::f32>> a(nCells), b(nCells);
+    for (glm::u32 i = 0; i < nCells; i++) {
+        a[i] = std::complex<glm::f32>(MU_0 * current[i].x, MU_0 * current[i].y);
+        b[i] = std::complex<glm::f32>(MU_0 * current[i].z, rho[i] / EPSILON_0);
+    }
+
+    solve_poisson_periodic(a, mesh, nThreads);
+    solve_poisson_periodic(b, mesh, nThreads);
+
+    std::vector<glm::f32vec4> potential(nCells);
+    for (glm::u32 i = 0; i < nCells; i++) {
+        potential[i] = glm::f32vec4(a[i].real(), a[i].imag(), b[i].real(), b[i].imag());
+    }
+    device.GetQueue().WriteBuffer(fieldBuf.potential, 0, potential.data(), nCells * sizeof(glm::f32vec4));
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "shared/fields.h"
+#include "mesh.h"
+
+// Longest mesh line the GPU transform can hold in workgroup memory (FFT_MAX_LINE in kernel/fft.wgsl)
+const glm::u32 FFT_MAX_LINE = 512;
+
+struct FftCompute {
+    wgpu::ComputePipeline packPipeline;
+    wgpu::ComputePipeline linePipelines[3][2]; // [axis][forward, inverse]
+    wgpu::ComputePipeline scalePipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::BindGroupLayout bindGroupLayout;
+
+    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer meshBuffer;
+
+    // Readback buffers for the CPU fallback
+    wgpu::Buffer rhoReadBuf;
+    wgpu::Buffer currentReadBuf;
+};
+
+// The params and mesh are written once here
+FftCompute create_fft_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh);
+
+// Whether every mesh line fits the GPU transform; otherwise the CPU fallback has to be used
+bool fft_gpu_supported(const MeshProperties& mesh);
+
+// Solves FieldBuffers::potential from the deposited rho and current with periodic boundaries on the GPU
+void run_fft_poisson(
+    wgpu::ComputePassEncoder& pass,
+    const FftCompute& fftCompute,
+    const MeshProperties& mesh,
+    glm::u32 nCells);
+
+// Same solve on the CPU: reads back the deposited sources (which must already be submitted), transforms them
+// across nThreads and uploads the result to FieldBuffers::potential
+void solve_fft_poisson_cpu(
+    wgpu::Device& device,
+    wgpu::Instance& instance,
+    const FftCompute& fftCompute,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 nThreads);
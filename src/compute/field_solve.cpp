@@ -0,0 +1,255 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/field_solve.h"
+#include "mesh.h"
+
+// C++ struct matching the WGSL FieldSolveParams struct
+struct FieldSolveParams {
+    glm::u32 nCells;
+    glm::u32 periodic;
+};
+
+FieldSolveCompute create_field_solve_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 periodic)
+{
+    FieldSolveCompute fieldSolveCompute = {};
+    glm::u32 nCells = fieldBuf.nCells;
+
+    // Create compute shader module
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/field_solve.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/mesh.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create field solve compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Scratch potential for ping-ponging Jacobi sweeps
+    wgpu::BufferDescriptor potentialScratchDesc = {
+        .label = "Potential Scratch Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fieldSolveCompute.potentialScratch = device.CreateBuffer(&potentialScratchDesc);
+
+    // Create params uniform buffer
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Field Solve Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(FieldSolveParams),
+        .mappedAtCreation = false
+    };
+    fieldSolveCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+
+    FieldSolveParams params = {
+        .nCells = nCells,
+        .periodic = periodic
+    };
+    device.GetQueue().WriteBuffer(fieldSolveCompute.paramsBuffer, 0, &params, sizeof(FieldSolveParams));
+
+    // Create mesh uniform buffer
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Field Solve Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    fieldSolveCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(fieldSolveCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // rho
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32)
+            }
+        }, { // current
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // potentialIn
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // potentialOut
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // eField
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // bField
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // params
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(FieldSolveParams)
+            }
+        }, { // mesh
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Field Solve Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    fieldSolveCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines (relax and apply share the layout)
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Field Solve Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &fieldSolveCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor relaxPipelineDesc = {
+        .label = "Relax Potential Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "relaxPotential"
+        }
+    };
+    fieldSolveCompute.relaxPipeline = device.CreateComputePipeline(&relaxPipelineDesc);
+
+    wgpu::ComputePipelineDescriptor applyPipelineDesc = {
+        .label = "Potential Fields Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "addPotentialFields"
+        }
+    };
+    fieldSolveCompute.applyPipeline = device.CreateComputePipeline(&applyPipelineDesc);
+
+    // Create the two ping-pong bind groups
+    const wgpu::Buffer potentials[2] = {fieldBuf.potential, fieldSolveCompute.potentialScratch};
+    for (int i = 0; i < 2; i++) {
+        std::vector<wgpu::BindGroupEntry> computeEntries = {
+            { // rho
+                .binding = 0,
+                .buffer = fieldBuf.rho,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32)
+            }, { // current
+                .binding = 1,
+                .buffer = fieldBuf.current,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // potentialIn
+                .binding = 2,
+                .buffer = potentials[i],
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // potentialOut
+                .binding = 3,
+                .buffer = potentials[1 - i],
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // eField
+                .binding = 4,
+                .buffer = fieldBuf.eField,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // bField
+                .binding = 5,
+                .buffer = fieldBuf.bField,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // params
+                .binding = 6,
+                .buffer = fieldSolveCompute.paramsBuffer,
+                .offset = 0,
+                .size = sizeof(FieldSolveParams)
+            }, { // mesh
+                .binding = 7,
+                .buffer = fieldSolveCompute.meshBuffer,
+                .offset = 0,
+                .size = sizeof(MeshPropertiesUniform)
+            }
+        };
+
+        wgpu::BindGroupDescriptor computeBindGroupDesc = {
+            .label = "Field Solve Bind Group",
+            .layout = fieldSolveCompute.bindGroupLayout,
+            .entryCount = static_cast<uint32_t>(computeEntries.size()),
+            .entries = computeEntries.data()
+        };
+        fieldSolveCompute.bindGroups[i] = device.CreateBindGroup(&computeBindGroupDesc);
+    }
+
+    return fieldSolveCompute;
+}
+
+void run_potential_relax(
+    wgpu::ComputePassEncoder& pass,
+    const FieldSolveCompute& fieldSolveCompute,
+    glm::u32 nCells,
+    glm::u32 nIterations)
+{
+    // Sweeps alternate direction, so round up to an even count to finish in FieldBuffers::potential
+    glm::u32 nSweeps = (nIterations + 1) & ~1u;
+    glm::u32 nWorkgroups = (nCells + 255) / 256;
+
+    pass.SetPipeline(fieldSolveCompute.relaxPipeline);
+    for (glm::u32 i = 0; i < nSweeps; i++) {
+        pass.SetBindGroup(0, fieldSolveCompute.bindGroups[i % 2]);
+        pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+    }
+}
+
+void run_potential_fields(
+    wgpu::ComputePassEncoder& pass,
+    const FieldSolveCompute& fieldSolveCompute,
+    glm::u32 nCells)
+{
+    glm::u32 nWorkgroups = (nCells + 255) / 256;
+
+    pass.SetPipeline(fieldSolveCompute.applyPipeline);
+    pass.SetBindGroup(0, fieldSolveCompute.bindGroups[0]);
+    pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+}
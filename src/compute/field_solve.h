@@ -0,0 +1,38 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "shared/fields.h"
+#include "mesh.h"
+
+struct FieldSolveCompute {
+    wgpu::ComputePipeline relaxPipeline;
+    wgpu::ComputePipeline applyPipeline;
+    wgpu::BindGroup bindGroups[2]; // [0]: potential -> scratch, [1]: scratch -> potential
+    wgpu::BindGroupLayout bindGroupLayout;
+
+    wgpu::Buffer potentialScratch;
+    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer meshBuffer;
+};
+
+// The params and mesh are written once here. With periodic set, neighbors wrap around the mesh (for the potentials
+// of the spectral solvers); otherwise the potentials are held at zero past it.
+FieldSolveCompute create_field_solve_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    glm::u32 periodic);
+
+// Relaxes FieldBuffers::potential against the deposited rho and current (warm-started from the last step)
+void run_potential_relax(
+    wgpu::ComputePassEncoder& pass,
+    const FieldSolveCompute& fieldSolveCompute,
+    glm::u32 nCells,
+    glm::u32 nIterations);
+
+// Adds E = -grad(phi) and B = curl(A) from FieldBuffers::potential into the E and B fields
+void run_potential_fields(
+    wgpu::ComputePassEncoder& pass,
+    const FieldSolveCompute& fieldSolveCompute,
+    glm::u32 nCells);
@@ -0,0 +1,222 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/field_textures.h"
+
+static wgpu::Texture create_field_texture(
+    wgpu::Device& device,
+    const char* label,
+    const MeshProperties& mesh,
+    wgpu::TextureFormat format)
+{
+    wgpu::TextureDescriptor textureDesc = {
+        .label = label,
+        .usage = wgpu::TextureUsage::StorageBinding | wgpu::TextureUsage::TextureBinding,
+        .dimension = wgpu::TextureDimension::e3D,
+        .size = { mesh.dim.x, mesh.dim.y, mesh.dim.z },
+        .format = format
+    };
+    return device.CreateTexture(&textureDesc);
+}
+
+FieldTextureCompute create_field_texture_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    wgpu::TextureFormat format,
+    glm::f32 eScale,
+    glm::f32 bScale)
+{
+    FieldTextureCompute compute = {};
+    compute.format = format;
+    compute.nCells = fieldBuf.nCells;
+    compute.params = { .eScale = eScale, .bScale = bScale };
+
+    const char* textureHeader = nullptr;
+    if (format == wgpu::TextureFormat::RGBA32Float) {
+        textureHeader = "kernel/field_texture_rgba32float.wgsl";
+    } else if (format == wgpu::TextureFormat::RGBA16Float) {
+        textureHeader = "kernel/field_texture_rgba16float.wgsl";
+    } else {
+        std::cerr << "Field textures must be rgba32float or rgba16float" << std::endl;
+        exit(1);
+    }
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/write_field_textures.wgsl",
+        {
+            "kernel/mesh.wgsl",
+            "kernel/field_texture.wgsl",
+            textureHeader
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create field texture compute shader module" << std::endl;
+        exit(1);
+    }
+
+    compute.eTexture = create_field_texture(device, "E Field Texture", mesh, format);
+    compute.bTexture = create_field_texture(device, "B Field Texture", mesh, format);
+    compute.eView = compute.eTexture.CreateView();
+    compute.bView = compute.bTexture.CreateView();
+
+    // Linear filtering between texel centers is trilinear interpolation between mesh nodes
+    wgpu::SamplerDescriptor samplerDesc = {
+        .label = "Field Texture Sampler",
+        .addressModeU = wgpu::AddressMode::ClampToEdge,
+        .addressModeV = wgpu::AddressMode::ClampToEdge,
+        .addressModeW = wgpu::AddressMode::ClampToEdge,
+        .magFilter = wgpu::FilterMode::Linear,
+        .minFilter = wgpu::FilterMode::Linear,
+        .mipmapFilter = wgpu::MipmapFilterMode::Nearest
+    };
+    compute.sampler = device.CreateSampler(&samplerDesc);
+
+    // Create params and mesh uniform buffers. They do not change after creation.
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Field Texture Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(FieldTextureParams),
+        .mappedAtCreation = false
+    };
+    compute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+    device.GetQueue().WriteBuffer(compute.paramsBuffer, 0, &compute.params, sizeof(FieldTextureParams));
+
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Field Texture Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    compute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(compute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    glm::u64 fieldSize = fieldBuf.nCells * sizeof(glm::f32vec4);
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // eField
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = fieldSize
+            }
+        }, { // bField
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = fieldSize
+            }
+        }, { // params
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(FieldTextureParams)
+            }
+        }, { // mesh
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }, { // eTexture
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .storageTexture = {
+                .access = wgpu::StorageTextureAccess::WriteOnly,
+                .format = format,
+                .viewDimension = wgpu::TextureViewDimension::e3D
+            }
+        }, { // bTexture
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .storageTexture = {
+                .access = wgpu::StorageTextureAccess::WriteOnly,
+                .format = format,
+                .viewDimension = wgpu::TextureViewDimension::e3D
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Field Texture Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    compute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipeline
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Field Texture Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &compute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor computePipelineDesc = {
+        .label = "Field Texture Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "writeFieldTextures"
+        }
+    };
+    compute.pipeline = device.CreateComputePipeline(&computePipelineDesc);
+
+    // Create compute bind group
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // eField
+            .binding = 0,
+            .buffer = fieldBuf.eField,
+            .offset = 0,
+            .size = fieldSize
+        }, { // bField
+            .binding = 1,
+            .buffer = fieldBuf.bField,
+            .offset = 0,
+            .size = fieldSize
+        }, { // params
+            .binding = 2,
+            .buffer = compute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(FieldTextureParams)
+        }, { // mesh
+            .binding = 3,
+            .buffer = compute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }, { // eTexture
+            .binding = 4,
+            .textureView = compute.eView
+        }, { // bTexture
+            .binding = 5,
+            .textureView = compute.bView
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Field Texture Compute Bind Group",
+        .layout = compute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    compute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return compute;
+}
+
+void run_field_texture_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const FieldTextureCompute& compute)
+{
+    computePass.SetPipeline(compute.pipeline);
+    computePass.SetBindGroup(0, compute.bindGroup);
+    computePass.DispatchWorkgroups((compute.nCells + 255) / 256, 1, 1);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "shared/fields.h"
+#include "mesh.h"
+
+// FieldTextureParams in kernel/field_texture.wgsl, padded to 16 bytes
+struct FieldTextureParams {
+    glm::f32 eScale;
+    glm::f32 bScale;
+    glm::f32 _pad[2];
+};
+
+// The E and B fields as 3D textures, texel (x, y, z) holding mesh node (x, y, z), for kernels that read them through
+// kernel/field_texture.wgsl instead of the field buffers
+struct FieldTextureCompute {
+    wgpu::ComputePipeline pipeline;
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::BindGroup bindGroup;
+    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer meshBuffer;
+
+    wgpu::TextureFormat format;
+    wgpu::Texture eTexture;
+    wgpu::Texture bTexture;
+    wgpu::TextureView eView;
+    wgpu::TextureView bView;
+    wgpu::Sampler sampler; // Linear, clamp-to-edge, for sample_field_texture()
+
+    FieldTextureParams params;
+    glm::u32 nCells;
+};
+
+// Format is RGBA32Float or RGBA16Float. Only rgba16float can be hardware filtered without the float32-filterable
+// feature; its range tops out at 65504, so the fields are stored times eScale and bScale.
+FieldTextureCompute create_field_texture_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    wgpu::TextureFormat format,
+    glm::f32 eScale = 1.0f,
+    glm::f32 bScale = 1.0f);
+
+// Copies the current E and B fields into the textures. Run it after the field stages have written them.
+void run_field_texture_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const FieldTextureCompute& compute);
@@ -20,12 +20,13 @@ FieldCompute create_field_compute(
     const FieldBuffers& fieldBuf,
     const wgpu::Buffer& currentSegmentsBuffer,
     glm::u32 nCurrentSegments,
-    glm::u32 maxParticles
+    glm::u32 maxParticles,
+    const UniformArena& uniforms
 ) {
     FieldCompute fieldCompute = {};
 
     // Create compute shader module
-    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/fields.wgsl", {"kernel/physical_constants.wgsl", "kernel/field_common.wgsl"});
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/fields.wgsl", {"kernel/physical_constants.wgsl", "kernel/species.wgsl", "kernel/field_common.wgsl"});
     if (!computeShaderModule) {
         std::cerr << "Failed to create compute shader module" << std::endl;
         exit(1);
@@ -55,14 +56,22 @@ FieldCompute create_field_compute(
     };
     fieldCompute.debugBuffer = device.CreateBuffer(&debugBufferDesc);
 
-    // Create params uniform buffer
-    wgpu::BufferDescriptor paramsBufferDesc = {
-        .label = "Fields Params Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-        .size = sizeof(ComputeFieldsParams),
+    // Create the cached external field buffers, filled by run_external_field_compute
+    wgpu::BufferDescriptor externalEFieldDesc = {
+        .label = "External E Field Buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+        .size = nCells * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
-    fieldCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+    fieldCompute.externalEField = device.CreateBuffer(&externalEFieldDesc);
+
+    wgpu::BufferDescriptor externalBFieldDesc = {
+        .label = "External B Field Buffer",
+        .usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fieldCompute.externalBField = device.CreateBuffer(&externalBFieldDesc);
 
     // Create compute bind group layout
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
@@ -122,12 +131,28 @@ FieldCompute create_field_compute(
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = nCells * sizeof(glm::f32vec4)
             }
-        }, { // params
-            .binding = 8,
+        },
+        uniform_arena_layout_entry(8, sizeof(ComputeFieldsParams)), // params
+        { // externalEField
+            .binding = 9,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // externalBField
+            .binding = 10,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // speciesTable
+            .binding = 11,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
                 .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(ComputeFieldsParams)
+                .minBindingSize = SPECIES_TABLE_SIZE
             }
         }
     };
@@ -157,6 +182,16 @@ FieldCompute create_field_compute(
     };
     fieldCompute.pipeline = device.CreateComputePipeline(&computePipelineDesc);
 
+    wgpu::ComputePipelineDescriptor externalPipelineDesc = {
+        .label = "External Field Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "computeExternalFields"
+        }
+    };
+    fieldCompute.externalPipeline = device.CreateComputePipeline(&externalPipelineDesc);
+
     // Create compute bind group with persistent buffers
     std::vector<wgpu::BindGroupEntry> computeEntries = {
         { // nParticles
@@ -199,11 +234,23 @@ FieldCompute create_field_compute(
             .buffer = fieldCompute.debugBuffer,
             .offset = 0,
             .size = nCells * sizeof(glm::f32vec4)
-        }, { // params
-            .binding = 8,
-            .buffer = fieldCompute.paramsBuffer,
+        },
+        uniform_arena_bind_group_entry(uniforms, 8, sizeof(ComputeFieldsParams)), // params
+        { // externalEField
+            .binding = 9,
+            .buffer = fieldCompute.externalEField,
+            .offset = 0,
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // externalBField
+            .binding = 10,
+            .buffer = fieldCompute.externalBField,
             .offset = 0,
-            .size = sizeof(ComputeFieldsParams)
+            .size = nCells * sizeof(glm::f32vec4)
+        }, { // speciesTable
+            .binding = 11,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
         }
     };
 
@@ -219,26 +266,48 @@ FieldCompute create_field_compute(
 }
 
 void run_field_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& pass,
     FieldCompute& fieldCompute,
+    UniformArena& uniforms,
     glm::u32 nCells,
     glm::u32 nCurrentSegments,
     glm::f32 solenoidFlux,
     glm::u32 enableParticleFieldContributions)
 {
-    // Update params buffer
     ComputeFieldsParams params = {
         .nCells = nCells,
         .nCurrentSegments = nCurrentSegments,
         .solenoidFlux = solenoidFlux,
         .enableParticleFieldContributions = enableParticleFieldContributions
     };
-    device.GetQueue().WriteBuffer(fieldCompute.paramsBuffer, 0, &params, sizeof(ComputeFieldsParams));
+    glm::u32 paramsOffset = push_uniform(uniforms, params);
 
     glm::u32 nWorkgroups = (nCells + 255) / 256;
 
     pass.SetPipeline(fieldCompute.pipeline);
-    pass.SetBindGroup(0, fieldCompute.bindGroup);
+    pass.SetBindGroup(0, fieldCompute.bindGroup, 1, &paramsOffset);
     pass.DispatchWorkgroups(nWorkgroups, 1, 1);
-} 
\ No newline at end of file
+}
+
+void run_external_field_compute(
+    wgpu::ComputePassEncoder& pass,
+    FieldCompute& fieldCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells,
+    glm::u32 nCurrentSegments)
+{
+    // Only nCells and nCurrentSegments are read by computeExternalFields
+    ComputeFieldsParams params = {
+        .nCells = nCells,
+        .nCurrentSegments = nCurrentSegments,
+        .solenoidFlux = 0.0f,
+        .enableParticleFieldContributions = 0u
+    };
+    glm::u32 paramsOffset = push_uniform(uniforms, params);
+
+    glm::u32 nWorkgroups = (nCells + 255) / 256;
+
+    pass.SetPipeline(fieldCompute.externalPipeline);
+    pass.SetBindGroup(0, fieldCompute.bindGroup, 1, &paramsOffset);
+    pass.DispatchWorkgroups(nWorkgroups, 1, 1);
+}
@@ -5,15 +5,18 @@
 #include "shared/particles.h"
 #include "shared/fields.h"
 #include "mesh.h"
+#include "util/uniform_arena.h"
 
 struct FieldCompute {
     wgpu::ComputePipeline pipeline;
+    wgpu::ComputePipeline externalPipeline;
     wgpu::BindGroup bindGroup;
     wgpu::BindGroupLayout bindGroupLayout;
 
     wgpu::Buffer cellLocationBuffer;
     wgpu::Buffer debugBuffer;
-    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer externalEField; // Solenoid E per unit flux, scaled by solenoidFlux each step
+    wgpu::Buffer externalBField; // Biot-Savart B of the current segments
 };
 
 FieldCompute create_field_compute(
@@ -23,13 +26,23 @@ FieldCompute create_field_compute(
     const FieldBuffers& fieldBuf,
     const wgpu::Buffer& currentSegmentsBuffer,
     glm::u32 nCurrentSegments,
-    glm::u32 maxParticles);
+    glm::u32 maxParticles,
+    const UniformArena& uniforms);
 
 void run_field_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& pass,
     FieldCompute& fieldCompute,
+    UniformArena& uniforms,
     glm::u32 nCells,
     glm::u32 nCurrentSegments,
     glm::f32 solenoidFlux,
-    glm::u32 enableParticleFieldContributions); 
\ No newline at end of file
+    glm::u32 enableParticleFieldContributions);
+
+// Rebuilds the cached external fields on the mesh. Only needed when the current segments change; the solenoid
+// term is cached per unit flux, so flux changes take effect without a rebuild.
+void run_external_field_compute(
+    wgpu::ComputePassEncoder& pass,
+    FieldCompute& fieldCompute,
+    UniformArena& uniforms,
+    glm::u32 nCells,
+    glm::u32 nCurrentSegments);
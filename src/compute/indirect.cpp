@@ -0,0 +1,123 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/indirect.h"
+
+ParticleIndirectArgs particle_indirect_args(glm::u32 nParticles, glm::u32 sphereIndexCount) {
+    return {
+        .dispatchX = (nParticles + 255) / 256,
+        .dispatchY = 1,
+        .dispatchZ = 1,
+        .vertexCount = nParticles,
+        .drawInstanceCount = 1,
+        .firstVertex = 0,
+        .drawFirstInstance = 0,
+        .indexCount = sphereIndexCount,
+        .sphereInstanceCount = nParticles,
+        .firstIndex = 0,
+        .baseVertex = 0,
+        .sphereFirstInstance = 0
+    };
+}
+
+ParticleIndirectCompute create_particle_indirect_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    glm::u32 initialParticles,
+    glm::u32 sphereIndexCount)
+{
+    ParticleIndirectCompute compute = {};
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/indirect_args.wgsl");
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create indirect args compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Create args buffer, read by DispatchWorkgroupsIndirect / DrawIndirect / DrawIndexedIndirect
+    wgpu::BufferDescriptor argsBufferDesc = {
+        .label = "Particle Indirect Args Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Indirect,
+        .size = sizeof(ParticleIndirectArgs),
+        .mappedAtCreation = false
+    };
+    compute.argsBuffer = device.CreateBuffer(&argsBufferDesc);
+    ParticleIndirectArgs initialArgs = particle_indirect_args(initialParticles, sphereIndexCount);
+    device.GetQueue().WriteBuffer(compute.argsBuffer, 0, &initialArgs, sizeof(ParticleIndirectArgs));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // args
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(ParticleIndirectArgs)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Indirect Args Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    compute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipeline
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Indirect Args Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &compute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor computePipelineDesc = {
+        .label = "Indirect Args Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "buildIndirectArgs"
+        }
+    };
+    compute.pipeline = device.CreateComputePipeline(&computePipelineDesc);
+
+    // Create compute bind group
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(uint32_t)
+        }, { // args
+            .binding = 1,
+            .buffer = compute.argsBuffer,
+            .offset = 0,
+            .size = sizeof(ParticleIndirectArgs)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Indirect Args Compute Bind Group",
+        .layout = compute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    compute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return compute;
+}
+
+void run_particle_indirect_compute(wgpu::ComputePassEncoder& computePass, const ParticleIndirectCompute& compute) {
+    computePass.SetPipeline(compute.pipeline);
+    computePass.SetBindGroup(0, compute.bindGroup);
+    computePass.DispatchWorkgroups(1, 1, 1);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "util/wgpu_util.h"
+#include "shared/particles.h"
+
+// C++ struct matching the WGSL ParticleIndirectArgs struct
+struct ParticleIndirectArgs {
+    glm::u32 dispatchX;
+    glm::u32 dispatchY;
+    glm::u32 dispatchZ;
+    glm::u32 vertexCount;
+    glm::u32 drawInstanceCount;
+    glm::u32 firstVertex;
+    glm::u32 drawFirstInstance;
+    glm::u32 indexCount;
+    glm::u32 sphereInstanceCount;
+    glm::u32 firstIndex;
+    glm::u32 baseVertex;
+    glm::u32 sphereFirstInstance;
+};
+
+// Byte offsets of each argument block within the args buffer
+const glm::u64 PARTICLE_DISPATCH_ARGS_OFFSET = offsetof(ParticleIndirectArgs, dispatchX);
+const glm::u64 PARTICLE_DRAW_ARGS_OFFSET = offsetof(ParticleIndirectArgs, vertexCount);
+const glm::u64 PARTICLE_SPHERE_DRAW_ARGS_OFFSET = offsetof(ParticleIndirectArgs, indexCount);
+
+struct ParticleIndirectCompute {
+    wgpu::ComputePipeline pipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::BindGroupLayout bindGroupLayout;
+
+    wgpu::Buffer argsBuffer; // ParticleIndirectArgs, usable as Indirect
+};
+
+// Arguments for n particles, as written by kernel/indirect_args.wgsl
+ParticleIndirectArgs particle_indirect_args(glm::u32 nParticles, glm::u32 sphereIndexCount);
+
+// The args buffer starts out filled for initialParticles, so it is valid before the first run
+ParticleIndirectCompute create_particle_indirect_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    glm::u32 initialParticles,
+    glm::u32 sphereIndexCount);
+
+// Rebuilds the args from the GPU particle count; run after any pass that changes nCur
+void run_particle_indirect_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleIndirectCompute& compute);
@@ -0,0 +1,347 @@
+#include <iostream>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/multigrid.h"
+
+// Coarsening stops before any mesh dimension drops below 3 nodes
+const glm::u32 MULTIGRID_MAX_LEVELS = 8;
+const glm::u32 MULTIGRID_MIN_COARSEN_DIM = 5;
+
+// Red-black sweeps per level on the way down and up, and on the coarsest level
+const glm::u32 MULTIGRID_PRE_SMOOTH = 2;
+const glm::u32 MULTIGRID_POST_SMOOTH = 2;
+const glm::u32 MULTIGRID_COARSEST_SMOOTH = 32;
+
+// C++ struct matching the WGSL MultigridParams struct
+struct MultigridParams {
+    glm::u32vec3 dim;
+    glm::u32 nCells;
+    glm::f32vec3 cell_size;
+    glm::u32 coarseNCells;
+    glm::u32vec3 coarseDim;
+    glm::u32 _padding;
+};
+
+static wgpu::Buffer create_level_buffer(wgpu::Device& device, const char* label, size_t size) {
+    wgpu::BufferDescriptor bufferDesc = {
+        .label = label,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = size,
+        .mappedAtCreation = false
+    };
+    return device.CreateBuffer(&bufferDesc);
+}
+
+MultigridCompute create_multigrid_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const std::vector<Cell>& cells,
+    const MeshProperties& mesh)
+{
+    MultigridCompute multigridCompute = {};
+    glm::u32 nCells = fieldBuf.nCells;
+
+    // Create compute shader module
+    wgpu::ShaderModule computeShaderModule = create_shader_module(
+        device,
+        "kernel/multigrid.wgsl",
+        {
+            "kernel/physical_constants.wgsl",
+            "kernel/mesh.wgsl"
+        }
+    );
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create multigrid compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Build the level meshes and masks, finest first. The nodes on the mesh faces are held at zero too: coarse
+    // node i sits on fine node 2i, so the faces are the only boundary every level sees at the same place.
+    std::vector<MeshProperties> meshes = { mesh };
+    std::vector<std::vector<glm::u32>> masks = { interior_mask(cells, mesh) };
+    while (meshes.size() < MULTIGRID_MAX_LEVELS) {
+        const MeshProperties& fine = meshes.back();
+        if (std::min({fine.dim.x, fine.dim.y, fine.dim.z}) < MULTIGRID_MIN_COARSEN_DIM) break;
+
+        MeshProperties coarse = coarsen_mesh(fine);
+        masks.push_back(coarsen_mask(masks.back(), fine.dim, coarse.dim));
+        meshes.push_back(coarse);
+    }
+
+    // Create per-level buffers
+    multigridCompute.levels.resize(meshes.size());
+    for (size_t l = 0; l < meshes.size(); l++) {
+        MultigridLevel& level = multigridCompute.levels[l];
+        level.mesh = meshes[l];
+        level.nCells = meshes[l].dim.x * meshes[l].dim.y * meshes[l].dim.z;
+
+        size_t vecSize = level.nCells * sizeof(glm::f32vec4);
+        level.u = l == 0 ? fieldBuf.potential : create_level_buffer(device, "Multigrid Potential Buffer", vecSize);
+        level.f = create_level_buffer(device, "Multigrid Source Buffer", vecSize);
+        level.residual = create_level_buffer(device, "Multigrid Residual Buffer", vecSize);
+        level.mask = create_level_buffer(device, "Multigrid Mask Buffer", level.nCells * sizeof(glm::u32));
+        device.GetQueue().WriteBuffer(level.mask, 0, masks[l].data(), level.nCells * sizeof(glm::u32));
+
+        wgpu::BufferDescriptor paramsBufferDesc = {
+            .label = "Multigrid Params Buffer",
+            .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+            .size = sizeof(MultigridParams),
+            .mappedAtCreation = false
+        };
+        level.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+    }
+
+    // The coarsest level has no coarser level, so it binds small placeholders instead
+    MultigridLevel placeholder = {
+        .mesh = { .dim = glm::u32vec3(1) },
+        .nCells = 1,
+        .u = create_level_buffer(device, "Multigrid Placeholder Potential Buffer", sizeof(glm::f32vec4)),
+        .f = create_level_buffer(device, "Multigrid Placeholder Source Buffer", sizeof(glm::f32vec4)),
+        .mask = create_level_buffer(device, "Multigrid Placeholder Mask Buffer", sizeof(glm::u32))
+    };
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // rho
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32)
+            }
+        }, { // current
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
+            }
+        }, { // u
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::f32vec4)
+            }
+        }, { // f
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::f32vec4)
+            }
+        }, { // residual
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::f32vec4)
+            }
+        }, { // mask
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // coarseU
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::f32vec4)
+            }
+        }, { // coarseF
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::f32vec4)
+            }
+        }, { // coarseMask
+            .binding = 8,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // params
+            .binding = 9,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MultigridParams)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Multigrid Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    multigridCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines (all stages share the layout)
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Multigrid Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &multigridCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint, std::vector<wgpu::ConstantEntry> constants) {
+        wgpu::ComputePipelineDescriptor pipelineDesc = {
+            .label = label,
+            .layout = computePipelineLayout,
+            .compute = {
+                .module = computeShaderModule,
+                .entryPoint = entryPoint,
+                .constantCount = constants.size(),
+                .constants = constants.data()
+            }
+        };
+        return device.CreateComputePipeline(&pipelineDesc);
+    };
+    multigridCompute.packPipeline = create_pipeline("Multigrid Pack Sources Compute Pipeline", "packSources", {});
+    multigridCompute.smoothPipelines[0] = create_pipeline("Multigrid Smooth Red Compute Pipeline", "smoothRedBlack", {{ .key = "SMOOTH_COLOR", .value = 0.0 }});
+    multigridCompute.smoothPipelines[1] = create_pipeline("Multigrid Smooth Black Compute Pipeline", "smoothRedBlack", {{ .key = "SMOOTH_COLOR", .value = 1.0 }});
+    multigridCompute.residualPipeline = create_pipeline("Multigrid Residual Compute Pipeline", "computeResidual", {});
+    multigridCompute.restrictPipeline = create_pipeline("Multigrid Restrict Compute Pipeline", "restrictResidual", {});
+    multigridCompute.prolongPipeline = create_pipeline("Multigrid Prolong Compute Pipeline", "prolongCorrection", {});
+
+    // Write static per-level params and create one bind group per level
+    for (size_t l = 0; l < multigridCompute.levels.size(); l++) {
+        MultigridLevel& level = multigridCompute.levels[l];
+        const MultigridLevel& coarse = l + 1 < multigridCompute.levels.size() ? multigridCompute.levels[l + 1] : placeholder;
+
+        MultigridParams params = {
+            .dim = level.mesh.dim,
+            .nCells = level.nCells,
+            .cell_size = level.mesh.cell_size,
+            .coarseNCells = l + 1 < multigridCompute.levels.size() ? coarse.nCells : 0,
+            .coarseDim = coarse.mesh.dim,
+            ._padding = 0
+        };
+        device.GetQueue().WriteBuffer(level.paramsBuffer, 0, &params, sizeof(MultigridParams));
+
+        std::vector<wgpu::BindGroupEntry> computeEntries = {
+            { // rho
+                .binding = 0,
+                .buffer = fieldBuf.rho,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32)
+            }, { // current
+                .binding = 1,
+                .buffer = fieldBuf.current,
+                .offset = 0,
+                .size = nCells * sizeof(glm::f32vec4)
+            }, { // u
+                .binding = 2,
+                .buffer = level.u,
+                .offset = 0,
+                .size = level.nCells * sizeof(glm::f32vec4)
+            }, { // f
+                .binding = 3,
+                .buffer = level.f,
+                .offset = 0,
+                .size = level.nCells * sizeof(glm::f32vec4)
+            }, { // residual
+                .binding = 4,
+                .buffer = level.residual,
+                .offset = 0,
+                .size = level.nCells * sizeof(glm::f32vec4)
+            }, { // mask
+                .binding = 5,
+                .buffer = level.mask,
+                .offset = 0,
+                .size = level.nCells * sizeof(glm::u32)
+            }, { // coarseU
+                .binding = 6,
+                .buffer = coarse.u,
+                .offset = 0,
+                .size = coarse.nCells * sizeof(glm::f32vec4)
+            }, { // coarseF
+                .binding = 7,
+                .buffer = coarse.f,
+                .offset = 0,
+                .size = coarse.nCells * sizeof(glm::f32vec4)
+            }, { // coarseMask
+                .binding = 8,
+                .buffer = coarse.mask,
+                .offset = 0,
+                .size = coarse.nCells * sizeof(glm::u32)
+            }, { // params
+                .binding = 9,
+                .buffer = level.paramsBuffer,
+                .offset = 0,
+                .size = sizeof(MultigridParams)
+            }
+        };
+
+        wgpu::BindGroupDescriptor computeBindGroupDesc = {
+            .label = "Multigrid Bind Group",
+            .layout = multigridCompute.bindGroupLayout,
+            .entryCount = static_cast<uint32_t>(computeEntries.size()),
+            .entries = computeEntries.data()
+        };
+        level.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+    }
+
+    std::cout << "Multigrid levels: " << multigridCompute.levels.size() << std::endl;
+
+    return multigridCompute;
+}
+
+static void dispatch_level(
+    wgpu::ComputePassEncoder& pass,
+    const wgpu::ComputePipeline& pipeline,
+    const MultigridLevel& level,
+    glm::u32 nInvocations)
+{
+    pass.SetPipeline(pipeline);
+    pass.SetBindGroup(0, level.bindGroup);
+    pass.DispatchWorkgroups((nInvocations + 255) / 256, 1, 1);
+}
+
+static void smooth_level(
+    wgpu::ComputePassEncoder& pass,
+    const MultigridCompute& multigridCompute,
+    const MultigridLevel& level,
+    glm::u32 nSweeps)
+{
+    for (glm::u32 i = 0; i < nSweeps; i++) {
+        dispatch_level(pass, multigridCompute.smoothPipelines[0], level, level.nCells);
+        dispatch_level(pass, multigridCompute.smoothPipelines[1], level, level.nCells);
+    }
+}
+
+void run_multigrid_poisson(
+    wgpu::ComputePassEncoder& pass,
+    const MultigridCompute& multigridCompute,
+    glm::u32 nCycles)
+{
+    const std::vector<MultigridLevel>& levels = multigridCompute.levels;
+    size_t coarsest = levels.size() - 1;
+
+    dispatch_level(pass, multigridCompute.packPipeline, levels[0], levels[0].nCells);
+
+    for (glm::u32 cycle = 0; cycle < nCycles; cycle++) {
+        // Down: smooth, then restrict the residual as the next level's right-hand side
+        for (size_t l = 0; l < coarsest; l++) {
+            smooth_level(pass, multigridCompute, levels[l], MULTIGRID_PRE_SMOOTH);
+            dispatch_level(pass, multigridCompute.residualPipeline, levels[l], levels[l].nCells);
+            dispatch_level(pass, multigridCompute.restrictPipeline, levels[l], levels[l + 1].nCells);
+        }
+
+        smooth_level(pass, multigridCompute, levels[coarsest], MULTIGRID_COARSEST_SMOOTH);
+
+        // Up: add the coarse correction, then smooth
+        for (size_t l = coarsest; l-- > 0;) {
+            dispatch_level(pass, multigridCompute.prolongPipeline, levels[l], levels[l].nCells);
+            smooth_level(pass, multigridCompute, levels[l], MULTIGRID_POST_SMOOTH);
+        }
+    }
+}
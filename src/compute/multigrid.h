@@ -0,0 +1,45 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "shared/fields.h"
+#include "mesh.h"
+
+// One level of the multigrid hierarchy. Level 0 solves directly into FieldBuffers::potential.
+struct MultigridLevel {
+    MeshProperties mesh;
+    glm::u32 nCells;
+
+    wgpu::Buffer u;        // Potentials on this level [Ax, Ay, Az, phi]
+    wgpu::Buffer f;        // Right-hand side on this level
+    wgpu::Buffer residual; // f + laplacian(u)
+    wgpu::Buffer mask;     // 1 for active cells, 0 for the Dirichlet region
+    wgpu::Buffer paramsBuffer;
+    wgpu::BindGroup bindGroup; // This level coupled with the next coarser level
+};
+
+struct MultigridCompute {
+    wgpu::ComputePipeline packPipeline;
+    wgpu::ComputePipeline smoothPipelines[2]; // [red, black]
+    wgpu::ComputePipeline residualPipeline;
+    wgpu::ComputePipeline restrictPipeline;
+    wgpu::ComputePipeline prolongPipeline;
+    wgpu::BindGroupLayout bindGroupLayout;
+
+    std::vector<MultigridLevel> levels;
+};
+
+// Builds the level hierarchy from the mesh, taking the Dirichlet region from the inactive cells (Cell::pos.w)
+MultigridCompute create_multigrid_compute(
+    wgpu::Device& device,
+    const FieldBuffers& fieldBuf,
+    const std::vector<Cell>& cells,
+    const MeshProperties& mesh);
+
+// Runs nCycles V-cycles on FieldBuffers::potential (warm-started from the last step) against the deposited
+// rho and current
+void run_multigrid_poisson(
+    wgpu::ComputePassEncoder& pass,
+    const MultigridCompute& multigridCompute,
+    glm::u32 nCycles);
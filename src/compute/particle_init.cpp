@@ -0,0 +1,165 @@
+#include <iostream>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "util/philox.h"
+#include "compute/particle_init.h"
+#include "plasma.h"
+
+// C++ struct matching the WGSL ParticleInitParams struct
+struct ParticleInitParams {
+    glm::u32 seed[2];
+    glm::u32 nParticles;
+    glm::u32 distribution;
+    glm::f32vec4 distMin;
+    glm::f32vec4 distMax;
+    glm::u32 nSpecies;
+    glm::u32 _pad[3];
+    glm::f32vec4 species[MAX_INIT_SPECIES]; // [species, cumulative fraction, velocity sigma, unused]
+};
+
+// WebGPU's default maxComputeWorkgroupsPerDimension
+const glm::u32 MAX_WORKGROUPS_PER_DIMENSION = 65535;
+
+ParticleInitCompute create_particle_init_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles) {
+    ParticleInitCompute particleInitCompute = {};
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/particle_init.wgsl", {"kernel/physical_constants.wgsl", "kernel/rng.wgsl"});
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create particle init compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // Create params uniform buffer
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Particle Init Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(ParticleInitParams),
+        .mappedAtCreation = false
+    };
+    particleInitCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        {
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, {
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+            }
+        }, {
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(ParticleInitParams)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Particle Init Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    particleInitCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Particle Init Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &particleInitCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    wgpu::ComputePipelineDescriptor computePipelineDesc = {
+        .label = "Particle Init Compute Pipeline",
+        .layout = computePipelineLayout,
+        .compute = {
+            .module = computeShaderModule,
+            .entryPoint = "initParticles"
+        }
+    };
+    particleInitCompute.pipeline = device.CreateComputePipeline(&computePipelineDesc);
+
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        {
+            .binding = 0,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, {
+            .binding = 1,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::f32vec4)
+        }, {
+            .binding = 2,
+            .buffer = particleInitCompute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(ParticleInitParams)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Particle Init Compute Bind Group",
+        .layout = particleInitCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    particleInitCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return particleInitCompute;
+}
+
+void run_particle_init_compute(
+    wgpu::Device& device,
+    const ParticleInitCompute& particleInitCompute,
+    const ParticleDistribution& distribution,
+    const std::vector<SpeciesFraction>& species,
+    glm::f32 temperature,
+    glm::u64 seed,
+    glm::u32 nParticles)
+{
+    if (species.empty() || species.size() > MAX_INIT_SPECIES) {
+        std::cerr << "Particle init takes 1 to " << MAX_INIT_SPECIES << " species, got " << species.size() << std::endl;
+        exit(1);
+    }
+    if (nParticles == 0) return;
+
+    std::array<glm::u32, 2> key = philox_key(seed);
+    ParticleInitParams params = {
+        .seed = { key[0], key[1] },
+        .nParticles = nParticles,
+        .distribution = distribution.type,
+        .distMin = glm::f32vec4(distribution.min, 0.0f),
+        .distMax = glm::f32vec4(distribution.max, 0.0f),
+        .nSpecies = static_cast<glm::u32>(species.size())
+    };
+
+    std::vector<glm::f32vec4> speciesTable = species_init_table(species, temperature);
+    std::copy(speciesTable.begin(), speciesTable.end(), params.species);
+    device.GetQueue().WriteBuffer(particleInitCompute.paramsBuffer, 0, &params, sizeof(ParticleInitParams));
+
+    glm::u32 nWorkgroups = (nParticles + 255) / 256;
+    glm::u32 workgroupsX = std::min(nWorkgroups, MAX_WORKGROUPS_PER_DIMENSION);
+    glm::u32 workgroupsY = (nWorkgroups + workgroupsX - 1) / workgroupsX;
+
+    wgpu::CommandEncoderDescriptor encoderDesc{.label = "Particle Init Command Encoder"};
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&encoderDesc);
+    wgpu::ComputePassDescriptor computePassDesc{.label = "Particle Init Pass"};
+    wgpu::ComputePassEncoder computePass = encoder.BeginComputePass(&computePassDesc);
+    computePass.SetPipeline(particleInitCompute.pipeline);
+    computePass.SetBindGroup(0, particleInitCompute.bindGroup);
+    computePass.DispatchWorkgroups(workgroupsX, workgroupsY, 1);
+    computePass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    device.GetQueue().Submit(1, &commands);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "util/wgpu_util.h"
+#include "shared/particles.h"
+
+const glm::u32 MAX_INIT_SPECIES = 10; // MAX_INIT_SPECIES in kernel/particle_init.wgsl
+
+struct ParticleInitCompute {
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::ComputePipeline pipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::Buffer paramsBuffer;
+};
+
+ParticleInitCompute create_particle_init_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    glm::u32 maxParticles);
+
+// Fills the first nParticles slots with particles placed by distribution, with species in the given
+// proportions and Maxwell-Boltzmann velocities at temperature, and submits. Particle i depends only on seed and i.
+void run_particle_init_compute(
+    wgpu::Device& device,
+    const ParticleInitCompute& particleInitCompute,
+    const ParticleDistribution& distribution,
+    const std::vector<SpeciesFraction>& species,
+    glm::f32 temperature,
+    glm::u64 seed,
+    glm::u32 nParticles);
@@ -5,6 +5,10 @@
 #include "shared/particles.h"
 #include "shared/fields.h"
 #include "mesh.h"
+#include "octree.h"
+#include "util/uniform_arena.h"
+
+struct FieldTextureCompute;
 
 struct ParticleCompute {
     wgpu::ComputePipeline pipeline;
@@ -14,9 +18,10 @@ struct ParticleCompute {
     wgpu::Buffer nParticlesReadBuf;
     wgpu::Buffer debugStorageBuf;
     wgpu::Buffer debugReadBuf;
-    wgpu::Buffer paramsBuffer;
-    wgpu::Buffer meshBuffer;
+    wgpu::Buffer paramsBuffer; // Exact kernel only; the PIC kernel reads its params from the uniform arena
     wgpu::Buffer cellLocationBuffer;
+    wgpu::Buffer octreeNodesBuffer;
+    wgpu::Buffer octreeParticlesBuffer;
 };
 
 ParticleCompute create_particle_compute(
@@ -26,13 +31,20 @@ ParticleCompute create_particle_compute(
     glm::u32 nCurrentSegments,
     glm::u32 maxParticles);
 
+// The params and mesh are read from the uniform arena, pushed by each run_particle_pic_compute. With fieldTextures
+// the push reads E and B from its rgba32float textures, which run_field_texture_compute must refresh every step,
+// instead of from fieldBuf.
 ParticleCompute create_particle_pic_compute(
     wgpu::Device& device,
     const std::vector<Cell>& cells,
     const ParticleBuffers& particleBuf,
     const FieldBuffers& fieldBuf,
-    glm::u32 maxParticles);
+    glm::u32 maxParticles,
+    const UniformArena& uniforms,
+    const FieldTextureCompute* fieldTextures = nullptr);
 
+// With nOctreeNodes > 0 the particle fields come from the tree last uploaded by upload_particle_octree, opening
+// nodes wider than openingAngle times their distance; otherwise they are summed directly over all particles
 void run_particle_compute(
     wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
@@ -41,17 +53,45 @@ void run_particle_compute(
     glm::f32 solenoidFlux,
     glm::u32 enableParticleFieldContributions,
     glm::u32 nCurrentSegments,
-    glm::u32 nParticles);
+    glm::u32 nParticles,
+    glm::f32 openingAngle,
+    glm::u32 nOctreeNodes);
 
-void run_particle_pic_compute(
+// Same as above, with the workgroup count taken from the dispatch args in indirectArgs (see compute/indirect.h)
+void run_particle_compute(
     wgpu::Device& device,
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& compute,
+    glm::f32 dt,
+    glm::f32 solenoidFlux,
+    glm::u32 enableParticleFieldContributions,
+    glm::u32 nCurrentSegments,
+    const wgpu::Buffer& indirectArgs,
+    glm::f32 openingAngle,
+    glm::u32 nOctreeNodes);
+
+void run_particle_pic_compute(
     wgpu::ComputePassEncoder& computePass,
     const ParticleCompute& particleCompute,
+    UniformArena& uniforms,
     const MeshProperties& mesh,
     glm::f32 dt,
     glm::u32 enableParticleFieldContributions,
     glm::u32 nParticles);
 
+// Same as above, with the workgroup count taken from the dispatch args in indirectArgs (see compute/indirect.h)
+void run_particle_pic_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& particleCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::f32 dt,
+    glm::u32 enableParticleFieldContributions,
+    const wgpu::Buffer& indirectArgs);
+
+// Uploads a tree built from the current particle state for run_particle_compute, returning its node count
+glm::u32 upload_particle_octree(wgpu::Device& device, const ParticleCompute& compute, const Octree& tree);
+
 glm::u32 read_nparticles(wgpu::Device& device, wgpu::Instance& instance, const ParticleCompute& compute);
 
 void read_particles_debug(wgpu::Device& device, wgpu::Instance& instance, const ParticleCompute& compute, std::vector<glm::f32vec4>& debug, glm::u32 n);
\ No newline at end of file
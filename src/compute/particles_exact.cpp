@@ -3,6 +3,7 @@
 #include <vector>
 #include "util/wgpu_util.h"
 #include "compute/particles.h"
+#include "compute/indirect.h"
 
 // C++ struct matching the WGSL ComputeMotionParams struct
 struct ComputeMotionParams {
@@ -10,6 +11,8 @@ struct ComputeMotionParams {
     glm::u32 nCurrentSegments;
     glm::f32 solenoidFlux;
     glm::u32 enableParticleFieldContributions;
+    glm::f32 openingAngle;
+    glm::u32 nOctreeNodes;
 };
 
 ParticleCompute create_particle_compute(
@@ -22,7 +25,7 @@ ParticleCompute create_particle_compute(
     ParticleCompute particleCompute = {};
 
     // Create compute shader module
-    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/particles_exact.wgsl", {"kernel/physical_constants.wgsl", "kernel/field_common.wgsl"});
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/particles_exact.wgsl", {"kernel/physical_constants.wgsl", "kernel/species.wgsl", "kernel/field_common.wgsl", "kernel/octree.wgsl"});
     if (!computeShaderModule) {
         std::cerr << "Failed to create compute shader module" << std::endl;
         exit(1);
@@ -64,6 +67,23 @@ ParticleCompute create_particle_compute(
     };
     particleCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
 
+    // Octree buffers, sized for the largest tree build_octree can produce
+    wgpu::BufferDescriptor octreeNodesBufDesc = {
+        .label = "Particle Octree Nodes Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = 2 * maxParticles * sizeof(OctreeNode),
+        .mappedAtCreation = false
+    };
+    particleCompute.octreeNodesBuffer = device.CreateBuffer(&octreeNodesBufDesc);
+
+    wgpu::BufferDescriptor octreeParticlesBufDesc = {
+        .label = "Particle Octree Particles Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .size = maxParticles * sizeof(glm::u32),
+        .mappedAtCreation = false
+    };
+    particleCompute.octreeParticlesBuffer = device.CreateBuffer(&octreeParticlesBufDesc);
+
     // Create compute bind group layout
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
         { // nParticles
@@ -108,6 +128,27 @@ ParticleCompute create_particle_compute(
                 .type = wgpu::BufferBindingType::Uniform,
                 .minBindingSize = sizeof(ComputeMotionParams)
             }
+        }, { // octreeNodes
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = 2 * maxParticles * sizeof(OctreeNode)
+            }
+        }, { // octreeParticles
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = maxParticles * sizeof(glm::u32)
+            }
+        }, { // speciesTable
+            .binding = 8,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = SPECIES_TABLE_SIZE
+            }
         }
     };
 
@@ -168,6 +209,21 @@ ParticleCompute create_particle_compute(
             .buffer = particleCompute.paramsBuffer,
             .offset = 0,
             .size = sizeof(ComputeMotionParams)
+        }, { // octreeNodes
+            .binding = 6,
+            .buffer = particleCompute.octreeNodesBuffer,
+            .offset = 0,
+            .size = 2 * maxParticles * sizeof(OctreeNode)
+        }, { // octreeParticles
+            .binding = 7,
+            .buffer = particleCompute.octreeParticlesBuffer,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::u32)
+        }, { // speciesTable
+            .binding = 8,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
         }
     };
 
@@ -182,7 +238,8 @@ ParticleCompute create_particle_compute(
     return particleCompute;
 }
 
-void run_particle_compute(
+// Writes the params and sets the pipeline for an exact push
+static void bind_particle_compute(
     wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
     const ParticleCompute& particleCompute,
@@ -190,34 +247,79 @@ void run_particle_compute(
     glm::f32 solenoidFlux,
     glm::u32 enableParticleFieldContributions,
     glm::u32 nCurrentSegments,
-    glm::u32 nParticles)
+    glm::f32 openingAngle,
+    glm::u32 nOctreeNodes)
 {
-    // Update params buffer
     ComputeMotionParams params = {
         .dt = dt,
         .nCurrentSegments = nCurrentSegments,
         .solenoidFlux = solenoidFlux,
-        .enableParticleFieldContributions = enableParticleFieldContributions
+        .enableParticleFieldContributions = enableParticleFieldContributions,
+        .openingAngle = openingAngle,
+        .nOctreeNodes = nOctreeNodes
     };
     device.GetQueue().WriteBuffer(particleCompute.paramsBuffer, 0, &params, sizeof(ComputeMotionParams));
 
-    // Each workgroup processes 16 particles (workgroup_size(16))
-    glm::u32 workgroupSize = 16;
-    glm::u32 nWorkgroups = (nParticles + workgroupSize - 1) / workgroupSize;
-
     computePass.SetPipeline(particleCompute.pipeline);
     computePass.SetBindGroup(0, particleCompute.bindGroup);
+}
+
+void run_particle_compute(
+    wgpu::Device& device,
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& particleCompute,
+    glm::f32 dt,
+    glm::f32 solenoidFlux,
+    glm::u32 enableParticleFieldContributions,
+    glm::u32 nCurrentSegments,
+    glm::u32 nParticles,
+    glm::f32 openingAngle,
+    glm::u32 nOctreeNodes)
+{
+    bind_particle_compute(device, computePass, particleCompute, dt, solenoidFlux, enableParticleFieldContributions, nCurrentSegments, openingAngle, nOctreeNodes);
+
+    // Each workgroup processes 256 particles (workgroup_size(256)); extra workgroups would each repeat the
+    // full tiled particle sum
+    glm::u32 workgroupSize = 256;
+    glm::u32 nWorkgroups = (nParticles + workgroupSize - 1) / workgroupSize;
     computePass.DispatchWorkgroups(nWorkgroups, 1, 1);
 }
 
+void run_particle_compute(
+    wgpu::Device& device,
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& particleCompute,
+    glm::f32 dt,
+    glm::f32 solenoidFlux,
+    glm::u32 enableParticleFieldContributions,
+    glm::u32 nCurrentSegments,
+    const wgpu::Buffer& indirectArgs,
+    glm::f32 openingAngle,
+    glm::u32 nOctreeNodes)
+{
+    bind_particle_compute(device, computePass, particleCompute, dt, solenoidFlux, enableParticleFieldContributions, nCurrentSegments, openingAngle, nOctreeNodes);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
+
+glm::u32 upload_particle_octree(wgpu::Device& device, const ParticleCompute& particleCompute, const Octree& tree) {
+    if (tree.nodes.empty()) return 0;
+    device.GetQueue().WriteBuffer(particleCompute.octreeNodesBuffer, 0, tree.nodes.data(), tree.nodes.size() * sizeof(OctreeNode));
+    device.GetQueue().WriteBuffer(particleCompute.octreeParticlesBuffer, 0, tree.particles.data(), tree.particles.size() * sizeof(glm::u32));
+    return static_cast<glm::u32>(tree.nodes.size());
+}
+
 glm::u32 read_nparticles(wgpu::Device& device, wgpu::Instance& instance, const ParticleCompute& compute) {
-    const void* nParticlesRaw = read_buffer(device, instance, compute.nParticlesReadBuf, sizeof(glm::u32));
-    return *reinterpret_cast<const glm::u32*>(nParticlesRaw);
+    glm::u32 nParticles = 0;
+    if (!read_buffer(instance, compute.nParticlesReadBuf, sizeof(glm::u32), &nParticles)) {
+        std::cerr << "Failed to read particle count" << std::endl;
+    }
+    return nParticles;
 }
 
 void read_particles_debug(wgpu::Device& device, wgpu::Instance& instance, const ParticleCompute& compute, std::vector<glm::f32vec4>& debug, glm::u32 n) {
-    const void* debugRaw = read_buffer(device, instance, compute.debugReadBuf, n * sizeof(glm::f32vec4));
-    const glm::f32vec4* debugStart = reinterpret_cast<const glm::f32vec4*>(debugRaw);
-    const glm::f32vec4* debugEnd = debugStart + n;
-    debug.assign(debugStart, debugEnd);
+    debug.resize(n);
+    if (!read_buffer(instance, compute.debugReadBuf, n * sizeof(glm::f32vec4), debug.data())) {
+        std::cerr << "Failed to read particle debug buffer" << std::endl;
+        debug.clear();
+    }
 }
\ No newline at end of file
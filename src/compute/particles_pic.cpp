@@ -3,6 +3,8 @@
 #include <vector>
 #include "util/wgpu_util.h"
 #include "compute/particles.h"
+#include "compute/indirect.h"
+#include "compute/field_textures.h"
 #include "mesh.h"
 
 // C++ struct matching the WGSL ComputeMotionParams struct
@@ -11,23 +13,14 @@ struct ComputeMotionParams {
     glm::u32 enableParticleFieldContributions;
 };
 
-struct MeshPropertiesUniform {
-    glm::f32vec3 min; // minimum cell center
-    glm::f32 _padding1; // padding for 16-byte alignment
-    glm::f32vec3 max; // maximum cell center
-    glm::f32 _padding2; // padding for 16-byte alignment
-    glm::u32vec3 dim; // number of cells in each dimension
-    glm::u32 _padding3; // padding for 16-byte alignment
-    glm::f32vec3 cell_size; // cell size
-    glm::f32 _padding4; // padding for 16-byte alignment
-};
-
 ParticleCompute create_particle_pic_compute(
     wgpu::Device& device,
     const std::vector<Cell>& cells,
     const ParticleBuffers& particleBuf,
     const FieldBuffers& fieldBuf,
-    glm::u32 maxParticles)
+    glm::u32 maxParticles,
+    const UniformArena& uniforms,
+    const FieldTextureCompute* fieldTextures)
 {
     ParticleCompute particleCompute = {};
 
@@ -46,16 +39,20 @@ ParticleCompute create_particle_pic_compute(
     particleCompute.cellLocationBuffer = device.CreateBuffer(&cellLocationBufferDesc);
     device.GetQueue().WriteBuffer(particleCompute.cellLocationBuffer, 0, cellLocations.data(), nCells * sizeof(glm::f32vec4));
 
-    // Create compute shader module
-    wgpu::ShaderModule computeShaderModule = create_shader_module(
-        device,
-        "kernel/particles_pic.wgsl",
-        {
-            "kernel/physical_constants.wgsl",
-            "kernel/field_common.wgsl",
-            "kernel/mesh.wgsl"
-        }
-    );
+    // Create compute shader module, with the field gather for the buffers or the textures
+    std::vector<std::string> headers = {
+        "kernel/physical_constants.wgsl",
+        "kernel/species.wgsl",
+        "kernel/field_common.wgsl",
+        "kernel/mesh.wgsl"
+    };
+    if (fieldTextures) {
+        headers.push_back("kernel/field_texture.wgsl");
+        headers.push_back("kernel/particles_pic_field_textures.wgsl");
+    } else {
+        headers.push_back("kernel/particles_pic_field_buffers.wgsl");
+    }
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/particles_pic.wgsl", headers);
     if (!computeShaderModule) {
         std::cerr << "Failed to create compute shader module" << std::endl;
         exit(1);
@@ -88,24 +85,6 @@ ParticleCompute create_particle_pic_compute(
     };
     particleCompute.debugReadBuf = device.CreateBuffer(&debugReadBufDesc);
 
-    // Create params uniform buffer
-    wgpu::BufferDescriptor paramsBufferDesc = {
-        .label = "Particle Compute Params Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-        .size = sizeof(ComputeMotionParams),
-        .mappedAtCreation = false
-    };
-    particleCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
-
-    // Create mesh uniform buffer
-    wgpu::BufferDescriptor meshBufferDesc = {
-        .label = "Particle Compute Mesh Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-        .size = sizeof(MeshPropertiesUniform),
-        .mappedAtCreation = false
-    };
-    particleCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
-
     // Create compute bind group layout
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
         { // nParticles
@@ -129,20 +108,6 @@ ParticleCompute create_particle_pic_compute(
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = maxParticles * sizeof(glm::f32vec4)
             }
-        }, { // eField
-            .binding = 3,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = fieldBuf.nCells * sizeof(glm::f32vec4)
-            }
-        }, { // bField
-            .binding = 4,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = fieldBuf.nCells * sizeof(glm::f32vec4)
-            }
         }, { // debug
             .binding = 5,
             .visibility = wgpu::ShaderStage::Compute,
@@ -150,29 +115,46 @@ ParticleCompute create_particle_pic_compute(
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = maxParticles * sizeof(glm::f32vec4)
             }
-        }, { // params
-            .binding = 6,
+        },
+        uniform_arena_layout_entry(6, sizeof(ComputeMotionParams)),   // params
+        uniform_arena_layout_entry(7, sizeof(MeshPropertiesUniform)), // mesh
+        { // cellLocation
+            .binding = 8,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(ComputeMotionParams)
+                .type = wgpu::BufferBindingType::ReadOnlyStorage,
+                .minBindingSize = nCells * sizeof(glm::f32vec4)
             }
-        }, { // mesh
-            .binding = 7,
+        }, { // speciesTable
+            .binding = 9,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
                 .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(MeshPropertiesUniform)
-            }
-        }, { // cellLocation
-            .binding = 8,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::ReadOnlyStorage,
-                .minBindingSize = nCells * sizeof(glm::f32vec4)
+                .minBindingSize = SPECIES_TABLE_SIZE
             }
         }
     };
+    for (glm::u32 binding : {3u, 4u}) { // eField, bField
+        if (fieldTextures) {
+            computeBindings.push_back({
+                .binding = binding,
+                .visibility = wgpu::ShaderStage::Compute,
+                .texture = {
+                    .sampleType = wgpu::TextureSampleType::UnfilterableFloat,
+                    .viewDimension = wgpu::TextureViewDimension::e3D
+                }
+            });
+        } else {
+            computeBindings.push_back({
+                .binding = binding,
+                .visibility = wgpu::ShaderStage::Compute,
+                .buffer = {
+                    .type = wgpu::BufferBindingType::Storage,
+                    .minBindingSize = fieldBuf.nCells * sizeof(glm::f32vec4)
+                }
+            });
+        }
+    }
 
     wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
         .label = "Particle Compute Bind Group Layout",
@@ -216,38 +198,49 @@ ParticleCompute create_particle_pic_compute(
             .buffer = particleBuf.vel,
             .offset = 0,
             .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // eField
-            .binding = 3,
-            .buffer = fieldBuf.eField,
-            .offset = 0,
-            .size = fieldBuf.nCells * sizeof(glm::f32vec4)
-        }, { // bField
-            .binding = 4,
-            .buffer = fieldBuf.bField,
-            .offset = 0,
-            .size = fieldBuf.nCells * sizeof(glm::f32vec4)
         }, { // debug
             .binding = 5,
             .buffer = particleCompute.debugStorageBuf,
             .offset = 0,
             .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // params
-            .binding = 6,
-            .buffer = particleCompute.paramsBuffer,
-            .offset = 0,
-            .size = sizeof(ComputeMotionParams)
-        }, { // mesh
-            .binding = 7,
-            .buffer = particleCompute.meshBuffer,
-            .offset = 0,
-            .size = sizeof(MeshPropertiesUniform)
-        }, { // cellLocation
+        },
+        uniform_arena_bind_group_entry(uniforms, 6, sizeof(ComputeMotionParams)),   // params
+        uniform_arena_bind_group_entry(uniforms, 7, sizeof(MeshPropertiesUniform)), // mesh
+        { // cellLocation
             .binding = 8,
             .buffer = particleCompute.cellLocationBuffer,
             .offset = 0,
             .size = nCells * sizeof(glm::f32vec4)
+        }, { // speciesTable
+            .binding = 9,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
         }
     };
+    if (fieldTextures) {
+        computeEntries.push_back({ // eField
+            .binding = 3,
+            .textureView = fieldTextures->eView
+        });
+        computeEntries.push_back({ // bField
+            .binding = 4,
+            .textureView = fieldTextures->bView
+        });
+    } else {
+        computeEntries.push_back({ // eField
+            .binding = 3,
+            .buffer = fieldBuf.eField,
+            .offset = 0,
+            .size = fieldBuf.nCells * sizeof(glm::f32vec4)
+        });
+        computeEntries.push_back({ // bField
+            .binding = 4,
+            .buffer = fieldBuf.bField,
+            .offset = 0,
+            .size = fieldBuf.nCells * sizeof(glm::f32vec4)
+        });
+    }
 
     wgpu::BindGroupDescriptor computeBindGroupDesc = {
         .label = "Particle Compute Bind Group",
@@ -260,35 +253,54 @@ ParticleCompute create_particle_pic_compute(
     return particleCompute;
 }
 
-void run_particle_pic_compute(
-    wgpu::Device& device,
+// Pushes the params and binds the pipeline, leaving the dispatch to the caller
+static void bind_particle_pic_compute(
     wgpu::ComputePassEncoder& computePass,
     const ParticleCompute& particleCompute,
+    UniformArena& uniforms,
     const MeshProperties& mesh,
     glm::f32 dt,
-    glm::u32 enableParticleFieldContributions,
-    glm::u32 nParticles)
+    glm::u32 enableParticleFieldContributions)
 {
-    // Update params buffer
     ComputeMotionParams params = {
         .dt = dt,
         .enableParticleFieldContributions = enableParticleFieldContributions
     };
-    device.GetQueue().WriteBuffer(particleCompute.paramsBuffer, 0, &params, sizeof(ComputeMotionParams));
-
-    MeshPropertiesUniform meshUniform = {
-        .min = mesh.min,
-        .max = mesh.max,
-        .dim = mesh.dim,
-        .cell_size = mesh.cell_size
+    glm::u32 offsets[] = {
+        push_uniform(uniforms, params),
+        push_uniform(uniforms, mesh_uniform(mesh))
     };
-    device.GetQueue().WriteBuffer(particleCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
-
-    // Each workgroup processes 16 particles (workgroup_size(16))
-    glm::u32 workgroupSize = 16;
-    glm::u32 nWorkgroups = (nParticles + workgroupSize - 1) / workgroupSize;
 
     computePass.SetPipeline(particleCompute.pipeline);
-    computePass.SetBindGroup(0, particleCompute.bindGroup);
+    computePass.SetBindGroup(0, particleCompute.bindGroup, 2, offsets);
+}
+
+void run_particle_pic_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& particleCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::f32 dt,
+    glm::u32 enableParticleFieldContributions,
+    glm::u32 nParticles)
+{
+    bind_particle_pic_compute(computePass, particleCompute, uniforms, mesh, dt, enableParticleFieldContributions);
+
+    // Each workgroup processes 256 particles (workgroup_size(256))
+    glm::u32 workgroupSize = 256;
+    glm::u32 nWorkgroups = (nParticles + workgroupSize - 1) / workgroupSize;
     computePass.DispatchWorkgroups(nWorkgroups, 1, 1);
-}
\ No newline at end of file
+}
+
+void run_particle_pic_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const ParticleCompute& particleCompute,
+    UniformArena& uniforms,
+    const MeshProperties& mesh,
+    glm::f32 dt,
+    glm::u32 enableParticleFieldContributions,
+    const wgpu::Buffer& indirectArgs)
+{
+    bind_particle_pic_compute(computePass, particleCompute, uniforms, mesh, dt, enableParticleFieldContributions);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
@@ -0,0 +1,276 @@
+#include <iostream>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/wgpu_util.h"
+#include "compute/sort.h"
+#include "compute/indirect.h"
+
+// C++ struct matching the WGSL SortParams struct
+struct SortParams {
+    glm::u32 nCells;
+};
+
+const glm::u32 SORT_BLOCK = 256; // SORT_BLOCK in kernel/sort.wgsl
+
+SortCompute create_sort_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::u32 maxParticles)
+{
+    SortCompute sortCompute = {};
+    sortCompute.nCells = nCells;
+
+    wgpu::ShaderModule computeShaderModule = create_shader_module(device, "kernel/sort.wgsl", {"kernel/mesh.wgsl"});
+    if (!computeShaderModule) {
+        std::cerr << "Failed to create sort compute shader module" << std::endl;
+        exit(1);
+    }
+
+    // One bucket per cell plus one for dead and out-of-mesh particles
+    glm::u32 nBuckets = nCells + 1;
+    glm::u32 nBlocks = (nBuckets + SORT_BLOCK - 1) / SORT_BLOCK;
+    glm::u64 particleSize = maxParticles * sizeof(glm::f32vec4);
+
+    // Create scratch, key and scan buffers
+    auto storage_buffer = [&device](const char* label, glm::u64 size, wgpu::BufferUsage usage = wgpu::BufferUsage::None) {
+        wgpu::BufferDescriptor desc = {
+            .label = label,
+            .usage = wgpu::BufferUsage::Storage | usage,
+            .size = size,
+            .mappedAtCreation = false
+        };
+        return device.CreateBuffer(&desc);
+    };
+    sortCompute.scratchPos = storage_buffer("Sort Scratch Position Buffer", particleSize);
+    sortCompute.scratchVel = storage_buffer("Sort Scratch Velocity Buffer", particleSize);
+    sortCompute.particleKey = storage_buffer("Sort Particle Key Buffer", maxParticles * sizeof(glm::u32vec2));
+    sortCompute.cellStart = storage_buffer("Sort Cell Start Buffer", nBuckets * sizeof(glm::u32), wgpu::BufferUsage::CopySrc);
+    sortCompute.blockSums = storage_buffer("Sort Block Sums Buffer", nBlocks * sizeof(glm::u32));
+
+    // Create params and mesh uniform buffers. Neither changes after creation.
+    wgpu::BufferDescriptor paramsBufferDesc = {
+        .label = "Sort Compute Params Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(SortParams),
+        .mappedAtCreation = false
+    };
+    sortCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
+    SortParams params = {
+        .nCells = nCells
+    };
+    device.GetQueue().WriteBuffer(sortCompute.paramsBuffer, 0, &params, sizeof(SortParams));
+
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Sort Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    sortCompute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(sortCompute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
+    // Create compute bind group layout
+    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
+        { // nParticles
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = sizeof(glm::u32)
+            }
+        }, { // particlePos
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // particleVel
+            .binding = 2,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // scratchPos
+            .binding = 3,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // scratchVel
+            .binding = 4,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = particleSize
+            }
+        }, { // particleKey
+            .binding = 5,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = maxParticles * sizeof(glm::u32vec2)
+            }
+        }, { // cellStart
+            .binding = 6,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nBuckets * sizeof(glm::u32)
+            }
+        }, { // blockSums
+            .binding = 7,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = nBlocks * sizeof(glm::u32)
+            }
+        }, { // params
+            .binding = 8,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(SortParams)
+            }
+        }, { // mesh
+            .binding = 9,
+            .visibility = wgpu::ShaderStage::Compute,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
+            }
+        }
+    };
+
+    wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
+        .label = "Sort Compute Bind Group Layout",
+        .entryCount = static_cast<uint32_t>(computeBindings.size()),
+        .entries = computeBindings.data()
+    };
+    sortCompute.bindGroupLayout = device.CreateBindGroupLayout(&computeBindGroupLayoutDesc);
+
+    // Create compute pipelines, one per count/scan/scatter stage
+    wgpu::PipelineLayoutDescriptor computePipelineLayoutDesc = {
+        .label = "Sort Compute Pipeline Layout",
+        .bindGroupLayoutCount = 1,
+        .bindGroupLayouts = &sortCompute.bindGroupLayout
+    };
+    wgpu::PipelineLayout computePipelineLayout = device.CreatePipelineLayout(&computePipelineLayoutDesc);
+
+    auto create_pipeline = [&](const char* label, const char* entryPoint) {
+        wgpu::ComputePipelineDescriptor computePipelineDesc = {
+            .label = label,
+            .layout = computePipelineLayout,
+            .compute = {
+                .module = computeShaderModule,
+                .entryPoint = entryPoint
+            }
+        };
+        return device.CreateComputePipeline(&computePipelineDesc);
+    };
+    sortCompute.clearCountsPipeline = create_pipeline("Sort Clear Counts Pipeline", "clearCounts");
+    sortCompute.countCellsPipeline = create_pipeline("Sort Count Cells Pipeline", "countCells");
+    sortCompute.scanCellsPipeline = create_pipeline("Sort Scan Cells Pipeline", "scanCells");
+    sortCompute.scanBlockSumsPipeline = create_pipeline("Sort Scan Block Sums Pipeline", "scanBlockSums");
+    sortCompute.scatterPipeline = create_pipeline("Sort Scatter Pipeline", "scatter");
+    sortCompute.copyBackPipeline = create_pipeline("Sort Copy Back Pipeline", "copyBack");
+    sortCompute.finishOffsetsPipeline = create_pipeline("Sort Finish Offsets Pipeline", "finishOffsets");
+
+    // Create compute bind group
+    std::vector<wgpu::BindGroupEntry> computeEntries = {
+        { // nParticles
+            .binding = 0,
+            .buffer = particleBuf.nCur,
+            .offset = 0,
+            .size = sizeof(uint32_t)
+        }, { // particlePos
+            .binding = 1,
+            .buffer = particleBuf.pos,
+            .offset = 0,
+            .size = particleSize
+        }, { // particleVel
+            .binding = 2,
+            .buffer = particleBuf.vel,
+            .offset = 0,
+            .size = particleSize
+        }, { // scratchPos
+            .binding = 3,
+            .buffer = sortCompute.scratchPos,
+            .offset = 0,
+            .size = particleSize
+        }, { // scratchVel
+            .binding = 4,
+            .buffer = sortCompute.scratchVel,
+            .offset = 0,
+            .size = particleSize
+        }, { // particleKey
+            .binding = 5,
+            .buffer = sortCompute.particleKey,
+            .offset = 0,
+            .size = maxParticles * sizeof(glm::u32vec2)
+        }, { // cellStart
+            .binding = 6,
+            .buffer = sortCompute.cellStart,
+            .offset = 0,
+            .size = nBuckets * sizeof(glm::u32)
+        }, { // blockSums
+            .binding = 7,
+            .buffer = sortCompute.blockSums,
+            .offset = 0,
+            .size = nBlocks * sizeof(glm::u32)
+        }, { // params
+            .binding = 8,
+            .buffer = sortCompute.paramsBuffer,
+            .offset = 0,
+            .size = sizeof(SortParams)
+        }, { // mesh
+            .binding = 9,
+            .buffer = sortCompute.meshBuffer,
+            .offset = 0,
+            .size = sizeof(MeshPropertiesUniform)
+        }
+    };
+
+    wgpu::BindGroupDescriptor computeBindGroupDesc = {
+        .label = "Sort Compute Bind Group",
+        .layout = sortCompute.bindGroupLayout,
+        .entryCount = static_cast<uint32_t>(computeEntries.size()),
+        .entries = computeEntries.data()
+    };
+    sortCompute.bindGroup = device.CreateBindGroup(&computeBindGroupDesc);
+
+    return sortCompute;
+}
+
+void run_sort_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const SortCompute& sortCompute,
+    const wgpu::Buffer& indirectArgs,
+    bool cellOffsets)
+{
+    computePass.SetBindGroup(0, sortCompute.bindGroup);
+
+    // Cell stages cover every bucket; particle stages cover nCur through the indirect args
+    glm::u32 cellWorkgroups = (sortCompute.nCells + SORT_BLOCK) / SORT_BLOCK;
+    computePass.SetPipeline(sortCompute.clearCountsPipeline);
+    computePass.DispatchWorkgroups(cellWorkgroups, 1, 1);
+    computePass.SetPipeline(sortCompute.countCellsPipeline);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+    computePass.SetPipeline(sortCompute.scanCellsPipeline);
+    computePass.DispatchWorkgroups(cellWorkgroups, 1, 1);
+    computePass.SetPipeline(sortCompute.scanBlockSumsPipeline);
+    computePass.DispatchWorkgroups(1, 1, 1);
+    computePass.SetPipeline(sortCompute.scatterPipeline);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+    computePass.SetPipeline(sortCompute.copyBackPipeline);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+    if (cellOffsets) {
+        computePass.SetPipeline(sortCompute.finishOffsetsPipeline);
+        computePass.DispatchWorkgroups(cellWorkgroups, 1, 1);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include "util/wgpu_util.h"
+#include "shared/particles.h"
+#include "mesh.h"
+
+struct SortCompute {
+    wgpu::BindGroupLayout bindGroupLayout;
+    wgpu::ComputePipeline clearCountsPipeline;
+    wgpu::ComputePipeline countCellsPipeline;
+    wgpu::ComputePipeline scanCellsPipeline;
+    wgpu::ComputePipeline scanBlockSumsPipeline;
+    wgpu::ComputePipeline scatterPipeline;
+    wgpu::ComputePipeline copyBackPipeline;
+    wgpu::ComputePipeline finishOffsetsPipeline;
+    wgpu::BindGroup bindGroup;
+    wgpu::Buffer paramsBuffer;
+    wgpu::Buffer meshBuffer;
+
+    wgpu::Buffer scratchPos;  // Sorted positions, copied back over the particle array
+    wgpu::Buffer scratchVel;  // Sorted velocities
+    wgpu::Buffer particleKey; // [cell, rank within the cell] per particle
+    wgpu::Buffer cellStart;   // nCells + 1 entries; with cell offsets, cell c's particles are [cellStart[c], cellStart[c + 1])
+    wgpu::Buffer blockSums;   // Count per block of cells, then its exclusive offset
+    glm::u32 nCells;
+};
+
+SortCompute create_sort_compute(
+    wgpu::Device& device,
+    const ParticleBuffers& particleBuf,
+    const MeshProperties& mesh,
+    glm::u32 nCells,
+    glm::u32 maxParticles);
+
+// Reorders the first nCur particles by the mesh cell they interpolate from, with dead and out-of-mesh particles
+// after the last cell. The count is unchanged. With cellOffsets, cellStart is left holding each cell's first
+// sorted slot for later stages, valid until the particles next move. Particle dispatches take their workgroup
+// count from the dispatch args in indirectArgs.
+void run_sort_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const SortCompute& sortCompute,
+    const wgpu::Buffer& indirectArgs,
+    bool cellOffsets);
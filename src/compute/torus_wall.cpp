@@ -3,13 +3,14 @@
 #include <vector>
 #include "util/wgpu_util.h"
 #include "compute/torus_wall.h"
+#include "compute/indirect.h"
 
 struct TorusWallParams {
     glm::f32 r1;  // Major radius of torus
     glm::f32 r2;  // Minor radius of torus
 };
 
-TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles) {
+TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleBuffers& particleBuf, glm::u32 maxParticles, const UniformArena& uniforms) {
     TorusWallCompute torusWallCompute = {};
 
     // Create compute shader module
@@ -19,15 +20,6 @@ TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleB
         exit(1);
     }
 
-    // Create params uniform buffer
-    wgpu::BufferDescriptor paramsBufferDesc = {
-        .label = "Torus Wall Compute Params Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
-        .size = sizeof(TorusWallParams),
-        .mappedAtCreation = false
-    };
-    torusWallCompute.paramsBuffer = device.CreateBuffer(&paramsBufferDesc);
-
     // Create compute bind group layout
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
         { // nParticles
@@ -51,14 +43,8 @@ TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleB
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = maxParticles * sizeof(glm::f32vec4)
             }
-        }, { // params
-            .binding = 3,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(TorusWallParams)
-            }
-        }
+        },
+        uniform_arena_layout_entry(3, sizeof(TorusWallParams)) // params
     };
 
     wgpu::BindGroupLayoutDescriptor computeBindGroupLayoutDesc = {
@@ -103,12 +89,8 @@ TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleB
             .buffer = particleBuf.vel,
             .offset = 0,
             .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // params
-            .binding = 3,
-            .buffer = torusWallCompute.paramsBuffer,
-            .offset = 0,
-            .size = sizeof(TorusWallParams)
-        }
+        },
+        uniform_arena_bind_group_entry(uniforms, 3, sizeof(TorusWallParams)) // params
     };
 
     wgpu::BindGroupDescriptor computeBindGroupDesc = {
@@ -122,26 +104,48 @@ TorusWallCompute create_torus_wall_compute(wgpu::Device& device, const ParticleB
     return torusWallCompute;
 }
 
-void run_torus_wall_compute(
-    wgpu::Device& device,
+// Pushes the params and binds the pipeline, leaving the dispatch to the caller
+static void bind_torus_wall_compute(
     wgpu::ComputePassEncoder& computePass,
     const TorusWallCompute& torusWallCompute,
+    UniformArena& uniforms,
     glm::f32 r1,
-    glm::f32 r2,
-    glm::u32 nParticles)
+    glm::f32 r2)
 {
-    // Update params buffer
     TorusWallParams params = {
         .r1 = r1,
         .r2 = r2
     };
-    device.GetQueue().WriteBuffer(torusWallCompute.paramsBuffer, 0, &params, sizeof(TorusWallParams));
+    glm::u32 paramsOffset = push_uniform(uniforms, params);
 
     // Set pipeline and bind group
     computePass.SetPipeline(torusWallCompute.pipeline);
-    computePass.SetBindGroup(0, torusWallCompute.bindGroup);
+    computePass.SetBindGroup(0, torusWallCompute.bindGroup, 1, &paramsOffset);
+}
+
+void run_torus_wall_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const TorusWallCompute& torusWallCompute,
+    UniformArena& uniforms,
+    glm::f32 r1,
+    glm::f32 r2,
+    glm::u32 nParticles)
+{
+    bind_torus_wall_compute(computePass, torusWallCompute, uniforms, r1, r2);
 
     // Dispatch compute shader
     glm::u32 workgroupCount = (nParticles + 255) / 256;
     computePass.DispatchWorkgroups(workgroupCount, 1, 1);
 }
+
+void run_torus_wall_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const TorusWallCompute& torusWallCompute,
+    UniformArena& uniforms,
+    glm::f32 r1,
+    glm::f32 r2,
+    const wgpu::Buffer& indirectArgs)
+{
+    bind_torus_wall_compute(computePass, torusWallCompute, uniforms, r1, r2);
+    computePass.DispatchWorkgroupsIndirect(indirectArgs, PARTICLE_DISPATCH_ARGS_OFFSET);
+}
@@ -4,23 +4,33 @@
 #include <glm/glm.hpp>
 #include "util/wgpu_util.h"
 #include "shared/particles.h"
+#include "util/uniform_arena.h"
 
 struct TorusWallCompute {
     wgpu::BindGroupLayout bindGroupLayout;
     wgpu::ComputePipeline pipeline;
     wgpu::BindGroup bindGroup;
-    wgpu::Buffer paramsBuffer;
 };
 
 TorusWallCompute create_torus_wall_compute(
     wgpu::Device& device,
     const ParticleBuffers& particleBuf,
-    glm::u32 maxParticles);
+    glm::u32 maxParticles,
+    const UniformArena& uniforms);
 
 void run_torus_wall_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
     const TorusWallCompute& torusWallCompute,
+    UniformArena& uniforms,
     glm::f32 r1,
     glm::f32 r2,
     glm::u32 nParticles);
+
+// Same as above, with the workgroup count taken from the dispatch args in indirectArgs (see compute/indirect.h)
+void run_torus_wall_compute(
+    wgpu::ComputePassEncoder& computePass,
+    const TorusWallCompute& torusWallCompute,
+    UniformArena& uniforms,
+    glm::f32 r1,
+    glm::f32 r2,
+    const wgpu::Buffer& indirectArgs);
@@ -1,453 +1,272 @@
 #include "compute/tracers.h"
+#include "compute/field_textures.h"
 #include "util/wgpu_util.h"
-#include "shared/particles.h"
 #include <iostream>
+#include <vector>
 
-struct ETracerParams {
-    glm::f32 solenoidFlux;
-    glm::u32 enableParticleFieldContributions;
-    glm::u32 nTracers;
-    glm::u32 tracerLength;
-    glm::u32 curTraceIdx;
-};
+const glm::u32 TRACER_WORKGROUP_SIZE = 64; // @workgroup_size in kernel/tracer.wgsl
 
-struct BTracerParams {
-    glm::u32 nCurrentSegments;
-    glm::u32 enableParticleFieldContributions;
+struct TracerParams {
     glm::u32 nTracers;
     glm::u32 tracerLength;
     glm::u32 curTraceIdx;
+    glm::u32 nPoints;
 };
 
-// Helper for E tracer subparts
-void create_e_tracer_compute(
+// Debug storage buffer the kernel writes the field at each trail head to, and the buffer it is read back through
+static void create_tracer_debug_buffers(
     wgpu::Device& device,
-    TracerCompute& compute,
-    const TracerBuffers& tracerBuf,
-    const ParticleBuffers& particleBuf,
-    const wgpu::Buffer& currentSegmentsBuffer,
-    glm::u32 nCurrentSegments,
-    glm::u32 maxParticles)
+    glm::u32 nTracers,
+    const char* storageLabel,
+    const char* readLabel,
+    wgpu::Buffer& storageBuf,
+    wgpu::Buffer& readBuf)
 {
-    // Shader
-    wgpu::ShaderModule eTracerShaderModule = create_shader_module(
-        device,
-        "kernel/e_tracer.wgsl",
-        {
-            "kernel/physical_constants.wgsl",
-            "kernel/field_common.wgsl"
-        }
-    );
-    if (!eTracerShaderModule) {
-        std::cerr << "Failed to create E tracer compute shader module" << std::endl;
-        exit(1);
-    }
-
-    // Bind group layout
-    std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
-        { // nParticles
-            .binding = 0,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = sizeof(glm::u32)
-            }
-        }, { // traces
-            .binding = 1,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = tracerBuf.nTracers * TRACER_LENGTH * sizeof(glm::f32vec4)
-            }
-        }, { // pos
-            .binding = 2,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
-            }
-        }, { // vel
-            .binding = 3,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
-            }
-        }, { // debug
-            .binding = 4,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = tracerBuf.nTracers * sizeof(glm::f32vec4)
-            }
-        }, { // params
-            .binding = 5,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(ETracerParams)
-            }
-        }
-    };
-    wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc = {
-        .label = "E Tracer Bind Group Layout",
-        .entryCount = computeBindings.size(),
-        .entries = computeBindings.data()
-    };
-    compute.eBindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
-
-    // Pipeline layout
-    wgpu::PipelineLayoutDescriptor pipelineLayoutDesc = {
-        .label = "E Tracer Pipeline Layout",
-        .bindGroupLayoutCount = 1,
-        .bindGroupLayouts = &compute.eBindGroupLayout
-    };
-    wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&pipelineLayoutDesc);
-
-    // Pipeline
-    wgpu::ComputePipelineDescriptor ePipelineDesc = {
-        .label = "E Tracer Compute Pipeline",
-        .layout = pipelineLayout,
-        .compute = {
-            .module = eTracerShaderModule,
-            .entryPoint = "updateTrails"
-        }
-    };
-    compute.ePipeline = device.CreateComputePipeline(&ePipelineDesc);
-
-    // Create debug storage buffer for E tracer compute shader
-    wgpu::BufferDescriptor eDebugStorageBufDesc = {
-        .label = "E Tracer Debug Storage Buffer",
+    wgpu::BufferDescriptor storageBufDesc = {
+        .label = storageLabel,
         .usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
-        .size = tracerBuf.nTracers * sizeof(glm::f32vec4),
+        .size = nTracers * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
-    compute.eDebugStorageBuf = device.CreateBuffer(&eDebugStorageBufDesc);
-    
-    // Create debug read buffer for E tracer CPU access
-    wgpu::BufferDescriptor eDebugReadBufDesc = {
-        .label = "E Tracer Debug Read Buffer",
+    storageBuf = device.CreateBuffer(&storageBufDesc);
+
+    wgpu::BufferDescriptor readBufDesc = {
+        .label = readLabel,
         .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
-        .size = tracerBuf.nTracers * sizeof(glm::f32vec4),
+        .size = nTracers * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
-    compute.eDebugReadBuf = device.CreateBuffer(&eDebugReadBufDesc);
+    readBuf = device.CreateBuffer(&readBufDesc);
+}
 
-    // Params buffer
-    wgpu::BufferDescriptor eParamsBufferDesc = {
-        .label = "E Tracer Params Buffer",
-        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
-        .size = sizeof(ETracerParams),
-        .mappedAtCreation = false
+// Bind group tracing one set of trails through one field, read from fieldTexture if it is set and field otherwise
+static wgpu::BindGroup create_tracer_bind_group(
+    wgpu::Device& device,
+    const TracerCompute& compute,
+    const char* label,
+    const wgpu::Buffer& traces,
+    const wgpu::Buffer& field,
+    const wgpu::TextureView& fieldTexture,
+    const wgpu::Buffer& debug,
+    glm::u32 nTracers,
+    glm::u32 nCells,
+    const UniformArena& uniforms)
+{
+    wgpu::BindGroupEntry fieldEntry = {
+        .binding = 1,
+        .buffer = field,
+        .offset = 0,
+        .size = nCells * sizeof(glm::f32vec4)
     };
-    compute.eParamsBuffer = device.CreateBuffer(&eParamsBufferDesc);
+    if (fieldTexture) {
+        fieldEntry = {
+            .binding = 1,
+            .textureView = fieldTexture
+        };
+    }
 
-    // Bind group
-    std::vector<wgpu::BindGroupEntry> eBindGroupEntries = {
-        { // nParticles
+    std::vector<wgpu::BindGroupEntry> entries = {
+        { // tracerTrails
             .binding = 0,
-            .buffer = particleBuf.nCur,
+            .buffer = traces,
             .offset = 0,
-            .size = sizeof(glm::u32)
-        }, { // traces
-            .binding = 1,
-            .buffer = tracerBuf.e_traces,
-            .offset = 0,
-            .size = tracerBuf.nTracers * TRACER_LENGTH * sizeof(glm::f32vec4)
-        }, { // particlePos
+            .size = nTracers * TRACER_LENGTH * sizeof(glm::f32vec4)
+        },
+        fieldEntry, // field
+        { // debug
             .binding = 2,
-            .buffer = particleBuf.pos,
-            .offset = 0,
-            .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // particleVel
-            .binding = 3,
-            .buffer = particleBuf.vel,
+            .buffer = debug,
             .offset = 0,
-            .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // debug
+            .size = nTracers * sizeof(glm::f32vec4)
+        },
+        uniform_arena_bind_group_entry(uniforms, 3, sizeof(TracerParams)), // params
+        { // mesh
             .binding = 4,
-            .buffer = compute.eDebugStorageBuf,
-            .offset = 0,
-            .size = tracerBuf.nTracers * sizeof(glm::f32vec4)
-        }, { // params
-            .binding = 5,
-            .buffer = compute.eParamsBuffer,
+            .buffer = compute.meshBuffer,
             .offset = 0,
-            .size = sizeof(ETracerParams)
+            .size = sizeof(MeshPropertiesUniform)
         }
     };
-    wgpu::BindGroupDescriptor eBindGroupDesc = {
-        .layout = compute.eBindGroupLayout,
-        .entryCount = eBindGroupEntries.size(),
-        .entries = eBindGroupEntries.data()
+    wgpu::BindGroupDescriptor bindGroupDesc = {
+        .label = label,
+        .layout = compute.bindGroupLayout,
+        .entryCount = entries.size(),
+        .entries = entries.data()
     };
-    compute.eBindGroup = device.CreateBindGroup(&eBindGroupDesc);
-
-    compute.curTraceIdxE = 0;
+    return device.CreateBindGroup(&bindGroupDesc);
 }
 
-// Helper for B tracer subparts
-void create_b_tracer_compute(
+TracerCompute create_tracer_compute(
     wgpu::Device& device,
-    TracerCompute& compute,
     const TracerBuffers& tracerBuf,
-    const ParticleBuffers& particleBuf,
-    const wgpu::Buffer& currentSegmentsBuffer,
-    glm::u32 nCurrentSegments,
-    glm::u32 maxParticles)
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    const UniformArena& uniforms,
+    const FieldTextureCompute* fieldTextures)
 {
-    // Shader
-    wgpu::ShaderModule bTracerShaderModule = create_shader_module(
-        device,
-        "kernel/b_tracer.wgsl",
-        {
-            "kernel/physical_constants.wgsl",
-            "kernel/field_common.wgsl"
-        }
-    );
-    if (!bTracerShaderModule) {
-        std::cerr << "Failed to create B tracer compute shader module" << std::endl;
+    TracerCompute compute = {};
+
+    // Shader, with the field lookup for the buffers or the textures
+    std::vector<std::string> headers = {
+        "kernel/physical_constants.wgsl",
+        "kernel/mesh.wgsl"
+    };
+    if (fieldTextures) {
+        headers.push_back("kernel/field_texture.wgsl");
+        headers.push_back("kernel/tracer_field_texture.wgsl");
+    } else {
+        headers.push_back("kernel/tracer_field_buffer.wgsl");
+    }
+    wgpu::ShaderModule tracerShaderModule = create_shader_module(device, "kernel/tracer.wgsl", headers);
+    if (!tracerShaderModule) {
+        std::cerr << "Failed to create tracer compute shader module" << std::endl;
         exit(1);
     }
 
+    // Mesh uniform buffer. It does not change after creation.
+    wgpu::BufferDescriptor meshBufferDesc = {
+        .label = "Tracer Mesh Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = sizeof(MeshPropertiesUniform),
+        .mappedAtCreation = false
+    };
+    compute.meshBuffer = device.CreateBuffer(&meshBufferDesc);
+    MeshPropertiesUniform meshUniform = mesh_uniform(mesh);
+    device.GetQueue().WriteBuffer(compute.meshBuffer, 0, &meshUniform, sizeof(MeshPropertiesUniform));
+
     // Bind group layout
     std::vector<wgpu::BindGroupLayoutEntry> computeBindings = {
-        { // nParticles
+        { // tracerTrails
             .binding = 0,
             .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = sizeof(glm::u32)
-            }
-        }, { // traces
-            .binding = 1,
-            .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
                 .type = wgpu::BufferBindingType::Storage,
                 .minBindingSize = tracerBuf.nTracers * TRACER_LENGTH * sizeof(glm::f32vec4)
             }
-        }, { // pos
+        }, { // debug
             .binding = 2,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
                 .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
-            }
-        }, { // vel
-            .binding = 3,
-            .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = maxParticles * sizeof(glm::f32vec4)
+                .minBindingSize = tracerBuf.nTracers * sizeof(glm::f32vec4)
             }
-        }, { // currentSegments
+        },
+        uniform_arena_layout_entry(3, sizeof(TracerParams)), // params
+        { // mesh
             .binding = 4,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
-                .type = wgpu::BufferBindingType::ReadOnlyStorage,
-                .minBindingSize = nCurrentSegments * sizeof(glm::f32vec4) * 3
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(MeshPropertiesUniform)
             }
-        }, { // debug
-            .binding = 5,
+        }
+    };
+    if (fieldTextures) {
+        computeBindings.push_back({ // field
+            .binding = 1,
             .visibility = wgpu::ShaderStage::Compute,
-            .buffer = {
-                .type = wgpu::BufferBindingType::Storage,
-                .minBindingSize = tracerBuf.nTracers * sizeof(glm::f32vec4)
+            .texture = {
+                .sampleType = wgpu::TextureSampleType::UnfilterableFloat,
+                .viewDimension = wgpu::TextureViewDimension::e3D
             }
-        }, { // params
-            .binding = 6,
+        });
+    } else {
+        computeBindings.push_back({ // field
+            .binding = 1,
             .visibility = wgpu::ShaderStage::Compute,
             .buffer = {
-                .type = wgpu::BufferBindingType::Uniform,
-                .minBindingSize = sizeof(BTracerParams)
+                .type = wgpu::BufferBindingType::Storage,
+                .minBindingSize = fieldBuf.nCells * sizeof(glm::f32vec4)
             }
-        }
-    };
+        });
+    }
     wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc = {
-        .label = "B Tracer Bind Group Layout",
+        .label = "Tracer Bind Group Layout",
         .entryCount = computeBindings.size(),
         .entries = computeBindings.data()
     };
-    compute.bBindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+    compute.bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
 
     // Pipeline layout
     wgpu::PipelineLayoutDescriptor pipelineLayoutDesc = {
-        .label = "B Tracer Pipeline Layout",
+        .label = "Tracer Pipeline Layout",
         .bindGroupLayoutCount = 1,
-        .bindGroupLayouts = &compute.bBindGroupLayout
+        .bindGroupLayouts = &compute.bindGroupLayout
     };
     wgpu::PipelineLayout pipelineLayout = device.CreatePipelineLayout(&pipelineLayoutDesc);
 
     // Pipeline
-    wgpu::ComputePipelineDescriptor bPipelineDesc = {
-        .label = "B Tracer Compute Pipeline",
+    wgpu::ComputePipelineDescriptor pipelineDesc = {
+        .label = "Tracer Compute Pipeline",
         .layout = pipelineLayout,
         .compute = {
-            .module = bTracerShaderModule,
+            .module = tracerShaderModule,
             .entryPoint = "updateTrails"
         }
     };
-    compute.bPipeline = device.CreateComputePipeline(&bPipelineDesc);
-
-    // Create debug storage buffer for B tracer compute shader
-    wgpu::BufferDescriptor bDebugStorageBufDesc = {
-        .label = "B Tracer Debug Storage Buffer",
-        .usage = wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
-        .size = tracerBuf.nTracers * sizeof(glm::f32vec4),
-        .mappedAtCreation = false
-    };
-    compute.bDebugStorageBuf = device.CreateBuffer(&bDebugStorageBufDesc);
-    
-    // Create debug read buffer for B tracer CPU access
-    wgpu::BufferDescriptor bDebugReadBufDesc = {
-        .label = "B Tracer Debug Read Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
-        .size = tracerBuf.nTracers * sizeof(glm::f32vec4),
-        .mappedAtCreation = false
-    };
-    compute.bDebugReadBuf = device.CreateBuffer(&bDebugReadBufDesc);
-
-    // Params buffer
-    wgpu::BufferDescriptor bParamsBufferDesc = {
-        .label = "B Tracer Params Buffer",
-        .usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
-        .size = sizeof(BTracerParams),
-        .mappedAtCreation = false
-    };
-    compute.bParamsBuffer = device.CreateBuffer(&bParamsBufferDesc);
-
-    // Bind group
-    std::vector<wgpu::BindGroupEntry> bBindGroupEntries = {
-        { // nParticles
-            .binding = 0,
-            .buffer = particleBuf.nCur,
-            .offset = 0,
-            .size = sizeof(glm::u32)
-        }, { // traces
-            .binding = 1,
-            .buffer = tracerBuf.b_traces,
-            .offset = 0,
-            .size = tracerBuf.nTracers * TRACER_LENGTH * sizeof(glm::f32vec4)
-        }, { // particlePos
-            .binding = 2,
-            .buffer = particleBuf.pos,
-            .offset = 0,
-            .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // particleVel
-            .binding = 3,
-            .buffer = particleBuf.vel,
-            .offset = 0,
-            .size = maxParticles * sizeof(glm::f32vec4)
-        }, { // currentSegments
-            .binding = 4,
-            .buffer = currentSegmentsBuffer,
-            .offset = 0,
-            .size = nCurrentSegments * sizeof(glm::f32vec4) * 3
-        }, { // debug
-            .binding = 5,
-            .buffer = compute.bDebugStorageBuf,
-            .offset = 0,
-            .size = tracerBuf.nTracers * sizeof(glm::f32vec4)
-        }, { // params
-            .binding = 6,
-            .buffer = compute.bParamsBuffer,
-            .offset = 0,
-            .size = sizeof(BTracerParams)
-        }
-    };
-    wgpu::BindGroupDescriptor bBindGroupDesc = {
-        .layout = compute.bBindGroupLayout,
-        .entryCount = bBindGroupEntries.size(),
-        .entries = bBindGroupEntries.data()
-    };
-    compute.bBindGroup = device.CreateBindGroup(&bBindGroupDesc);
+    compute.pipeline = device.CreateComputePipeline(&pipelineDesc);
 
-    compute.curTraceIdxB = 0;
-}
+    // Debug buffers
+    create_tracer_debug_buffers(device, tracerBuf.nTracers, "E Tracer Debug Storage Buffer", "E Tracer Debug Read Buffer", compute.eDebugStorageBuf, compute.eDebugReadBuf);
+    create_tracer_debug_buffers(device, tracerBuf.nTracers, "B Tracer Debug Storage Buffer", "B Tracer Debug Read Buffer", compute.bDebugStorageBuf, compute.bDebugReadBuf);
 
-TracerCompute create_tracer_compute(
-    wgpu::Device& device,
-    const TracerBuffers& tracerBuf,
-    const ParticleBuffers& particleBuf,
-    const wgpu::Buffer& currentSegmentsBuffer,
-    glm::u32 nCurrentSegments,
-    glm::u32 maxParticles)
-{
-    TracerCompute compute = {};
+    // E and B bind groups
+    wgpu::TextureView eTexture = fieldTextures ? fieldTextures->eView : wgpu::TextureView();
+    wgpu::TextureView bTexture = fieldTextures ? fieldTextures->bView : wgpu::TextureView();
+    compute.eBindGroup = create_tracer_bind_group(device, compute, "E Tracer Bind Group", tracerBuf.e_traces, fieldBuf.eField, eTexture, compute.eDebugStorageBuf, tracerBuf.nTracers, fieldBuf.nCells, uniforms);
+    compute.bBindGroup = create_tracer_bind_group(device, compute, "B Tracer Bind Group", tracerBuf.b_traces, fieldBuf.bField, bTexture, compute.bDebugStorageBuf, tracerBuf.nTracers, fieldBuf.nCells, uniforms);
 
-    // E and B subparts
-    create_e_tracer_compute(device, compute, tracerBuf, particleBuf, currentSegmentsBuffer, nCurrentSegments, maxParticles);
-    create_b_tracer_compute(device, compute, tracerBuf, particleBuf, currentSegmentsBuffer, nCurrentSegments, maxParticles);
+    compute.curTraceIdx = 0;
 
     return compute;
 }
 
 void run_tracer_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
     TracerCompute& compute,
-    glm::f32 dt,
-    glm::f32 solenoidFlux,
-    glm::u32 enableParticleFieldContributions,
-    glm::u32 nCurrentSegments,
-    glm::u32 nParticles,
+    UniformArena& uniforms,
     glm::u32 nTracers,
-    glm::u32 tracerLength)
+    glm::u32 tracerLength,
+    glm::u32 nPoints)
 {
-    // Update E tracer params buffer
-    ETracerParams eParams = {
-        .solenoidFlux = solenoidFlux,
-        .enableParticleFieldContributions = enableParticleFieldContributions,
-        .nTracers = nTracers,
-        .tracerLength = tracerLength,
-        .curTraceIdx = compute.curTraceIdxE
-    };
-    device.GetQueue().WriteBuffer(compute.eParamsBuffer, 0, &eParams, sizeof(ETracerParams));
-    
-    // Update B tracer params buffer
-    BTracerParams bParams = {
-        .nCurrentSegments = nCurrentSegments,
-        .enableParticleFieldContributions = enableParticleFieldContributions,
+    if (nTracers == 0 || nPoints == 0) return;
+
+    // E and B trails advance together, so both take the same params
+    TracerParams params = {
         .nTracers = nTracers,
         .tracerLength = tracerLength,
-        .curTraceIdx = compute.curTraceIdxB
+        .curTraceIdx = compute.curTraceIdx,
+        .nPoints = nPoints
     };
-    device.GetQueue().WriteBuffer(compute.bParamsBuffer, 0, &bParams, sizeof(BTracerParams));
-    
+    glm::u32 paramsOffset = push_uniform(uniforms, params);
+
+    // One invocation per tracer
+    glm::u32 nWorkgroups = (nTracers + TRACER_WORKGROUP_SIZE - 1) / TRACER_WORKGROUP_SIZE;
+    computePass.SetPipeline(compute.pipeline);
+
     // Run E tracer compute
-    computePass.SetPipeline(compute.ePipeline);
-    computePass.SetBindGroup(0, compute.eBindGroup);
-    computePass.DispatchWorkgroups(nTracers, 1, 1);
-    
+    computePass.SetBindGroup(0, compute.eBindGroup, 1, &paramsOffset);
+    computePass.DispatchWorkgroups(nWorkgroups, 1, 1);
+
     // Run B tracer compute
-    computePass.SetPipeline(compute.bPipeline);
-    computePass.SetBindGroup(0, compute.bBindGroup);
-    computePass.DispatchWorkgroups(nTracers, 1, 1);
+    computePass.SetBindGroup(0, compute.bBindGroup, 1, &paramsOffset);
+    computePass.DispatchWorkgroups(nWorkgroups, 1, 1);
 
-    compute.curTraceIdxE = (compute.curTraceIdxE + 1) % TRACER_LENGTH;
-    compute.curTraceIdxB = (compute.curTraceIdxB + 1) % TRACER_LENGTH;
+    compute.curTraceIdx = (compute.curTraceIdx + nPoints) % TRACER_LENGTH;
 }
 
 void read_e_tracer_debug(wgpu::Device& device, wgpu::Instance& instance, const TracerCompute& compute, std::vector<glm::f32vec4>& debug, glm::u32 n) {
-    const void* debugRaw = read_buffer(device, instance, compute.eDebugReadBuf, n * sizeof(glm::f32vec4));
-    if (!debugRaw) {
+    debug.resize(n);
+    if (!read_buffer(instance, compute.eDebugReadBuf, n * sizeof(glm::f32vec4), debug.data())) {
         std::cerr << "Failed to read E tracer debug buffer" << std::endl;
         debug.clear();
-        return;
     }
-    const glm::f32vec4* debugStart = reinterpret_cast<const glm::f32vec4*>(debugRaw);
-    const glm::f32vec4* debugEnd = debugStart + n;
-    debug.assign(debugStart, debugEnd);
 }
 
 void read_b_tracer_debug(wgpu::Device& device, wgpu::Instance& instance, const TracerCompute& compute, std::vector<glm::f32vec4>& debug, glm::u32 n) {
-    const void* debugRaw = read_buffer(device, instance, compute.bDebugReadBuf, n * sizeof(glm::f32vec4));
-    if (!debugRaw) {
+    debug.resize(n);
+    if (!read_buffer(instance, compute.bDebugReadBuf, n * sizeof(glm::f32vec4), debug.data())) {
         std::cerr << "Failed to read B tracer debug buffer" << std::endl;
         debug.clear();
-        return;
     }
-    const glm::f32vec4* debugStart = reinterpret_cast<const glm::f32vec4*>(debugRaw);
-    const glm::f32vec4* debugEnd = debugStart + n;
-    debug.assign(debugStart, debugEnd);
 }
@@ -3,18 +3,19 @@
 #include <webgpu/webgpu_cpp.h>
 #include <glm/glm.hpp>
 #include "shared/tracers.h"
-#include "shared/particles.h"
+#include "shared/fields.h"
+#include "util/uniform_arena.h"
+#include "mesh.h"
 
+struct FieldTextureCompute;
+
+// E and B tracers share the kernel in kernel/tracer.wgsl, each bound to its own trails and mesh field (or field texture)
 struct TracerCompute {
-    wgpu::ComputePipeline ePipeline;
-    wgpu::ComputePipeline bPipeline;
+    wgpu::ComputePipeline pipeline;
+    wgpu::BindGroupLayout bindGroupLayout;
     wgpu::BindGroup eBindGroup;
     wgpu::BindGroup bBindGroup;
-    wgpu::BindGroupLayout eBindGroupLayout;
-    wgpu::BindGroupLayout bBindGroupLayout;
-
-    wgpu::Buffer eParamsBuffer;
-    wgpu::Buffer bParamsBuffer;
+    wgpu::Buffer meshBuffer;
 
     // Debug buffers
     wgpu::Buffer eDebugStorageBuf;
@@ -22,29 +23,28 @@ struct TracerCompute {
     wgpu::Buffer bDebugStorageBuf;
     wgpu::Buffer bDebugReadBuf;
 
-    glm::u32 curTraceIdxE;
-    glm::u32 curTraceIdxB;
+    glm::u32 curTraceIdx;
 };
 
+// Tracers follow the fields in fieldBuf, as last written by the field stages, over the given mesh. With
+// fieldTextures they follow its rgba32float textures instead, which run_field_texture_compute must keep current.
 TracerCompute create_tracer_compute(
     wgpu::Device& device,
     const TracerBuffers& tracerBuf,
-    const ParticleBuffers& particleBuf,
-    const wgpu::Buffer& currentSegmentsBuffer,
-    glm::u32 nCurrentSegments,
-    glm::u32 maxParticles);
+    const FieldBuffers& fieldBuf,
+    const MeshProperties& mesh,
+    const UniformArena& uniforms,
+    const FieldTextureCompute* fieldTextures = nullptr);
 
+// Extends every trail by nPoints points, one invocation per tracer. The params change every run (trail index), so
+// they are pushed to the arena and bound by dynamic offset.
 void run_tracer_compute(
-    wgpu::Device& device,
     wgpu::ComputePassEncoder& computePass,
     TracerCompute& compute,
-    glm::f32 dt,
-    glm::f32 solenoidFlux,
-    glm::u32 enableParticleFieldContributions,
-    glm::u32 nCurrentSegments,
-    glm::u32 nParticles,
+    UniformArena& uniforms,
     glm::u32 nTracers,
-    glm::u32 tracerLength);
+    glm::u32 tracerLength,
+    glm::u32 nPoints);
 
 void read_e_tracer_debug(
     wgpu::Device& device,
@@ -58,4 +58,4 @@ void read_b_tracer_debug(
     wgpu::Instance& instance,
     const TracerCompute& compute,
     std::vector<glm::f32vec4>& debug,
-    glm::u32 n);
\ No newline at end of file
+    glm::u32 n);
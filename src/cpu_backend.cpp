@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "cpu_backend.h"
+#include "physical_constants.h"
+#include "shared/tracers.h"
+#include "util/parallel.h"
+
+// TRACER_STEP in kernel/tracer.wgsl
+const glm::f32 TRACER_STEP = 0.005f * _M;
+
+static CpuVectorField create_vector_field(glm::u32 n) {
+    return CpuVectorField {
+        .x = std::vector<glm::f32>(n, 0.0f),
+        .y = std::vector<glm::f32>(n, 0.0f),
+        .z = std::vector<glm::f32>(n, 0.0f)
+    };
+}
+
+static glm::f32vec3 load(const CpuVectorField& field, glm::u32 i) {
+    return glm::f32vec3(field.x[i], field.y[i], field.z[i]);
+}
+
+static void store(CpuVectorField& field, glm::u32 i, glm::f32vec3 v) {
+    field.x[i] = v.x;
+    field.y[i] = v.y;
+    field.z[i] = v.z;
+}
+
+// Every per-particle array, for moves that apply to all of them
+static std::array<std::vector<glm::f32>*, 7> particle_components(CpuParticles& p) {
+    return { &p.x, &p.y, &p.z, &p.species, &p.vx, &p.vy, &p.vz };
+}
+
+// Refreshes the charge of every slot, 0 for dead ones, so the field sums need no species lookup
+static void refresh_charges(CpuParticles& p, WorkerPool& pool) {
+    p.charge.resize(p.species.size());
+    parallel_for(pool, p.n, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            p.charge[i] = p.species[i] == 0.0f ? 0.0f : particle_charge(p.species[i]);
+        }
+    });
+}
+
+// compute_particle_field_contributions over the SoA arrays. Dead particles carry zero charge and coincident ones
+// (|r| < 1e-5) are masked rather than skipped, so the loop body has no branches and vectorizes.
+static void sum_particle_fields(const CpuParticles& p, glm::f32vec3 loc, glm::f32vec3& E, glm::f32vec3& B) {
+    const glm::f32* px = p.x.data();
+    const glm::f32* py = p.y.data();
+    const glm::f32* pz = p.z.data();
+    const glm::f32* vx = p.vx.data();
+    const glm::f32* vy = p.vy.data();
+    const glm::f32* vz = p.vz.data();
+    const glm::f32* q = p.charge.data();
+
+    glm::f32 ex = 0.0f, ey = 0.0f, ez = 0.0f;
+    glm::f32 bx = 0.0f, by = 0.0f, bz = 0.0f;
+    for (glm::u32 i = 0; i < p.n; i++) {
+        glm::f32 rx = loc.x - px[i];
+        glm::f32 ry = loc.y - py[i];
+        glm::f32 rz = loc.z - pz[i];
+        glm::f32 r2 = rx * rx + ry * ry + rz * rz;
+        glm::f32 rMag = std::sqrt(r2);
+
+        // q / r^3, so s * r is q r_norm / r^2
+        glm::f32 s = rMag < 0.00001f ? 0.0f : q[i] / (r2 * rMag);
+        ex += s * rx;
+        ey += s * ry;
+        ez += s * rz;
+        bx += s * (vy[i] * rz - vz[i] * ry);
+        by += s * (vz[i] * rx - vx[i] * rz);
+        bz += s * (vx[i] * ry - vy[i] * rx);
+    }
+    E += K_E * glm::f32vec3(ex, ey, ez);
+    B += MU_0_OVER_4_PI * glm::f32vec3(bx, by, bz);
+}
+
+// compute_single_particle_field_contribution
+static void add_particle_field(glm::f32vec3 pos, glm::f32vec3 vel, glm::f32 charge, glm::f32vec3 loc, glm::f32vec3& E, glm::f32vec3& B) {
+    glm::f32vec3 r = loc - pos;
+    glm::f32 rMag = glm::length(r);
+    if (rMag < 0.00001f) {
+        return;
+    }
+    glm::f32vec3 rNorm = r / rMag;
+    E += ((K_E * charge) / (rMag * rMag)) * rNorm;
+    B += ((MU_0_OVER_4_PI * charge) / (rMag * rMag)) * glm::cross(vel, rNorm);
+}
+
+// compute_currents_b_field
+static glm::f32vec3 currents_b_field(const std::vector<CurrentVector>& currents, glm::f32vec3 loc) {
+    glm::f32vec3 B(0.0f);
+    for (const CurrentVector& current : currents) {
+        if (current.i == 0.0f) continue;
+
+        glm::f32vec3 r = loc - glm::f32vec3(current.x);
+        glm::f32 rMag = glm::length(r);
+        B += MU_0_OVER_4_PI * current.i * glm::cross(glm::f32vec3(current.dx), r) / (rMag * rMag * rMag);
+    }
+    return B;
+}
+
+// compute_solenoid_e_field
+static glm::f32vec3 solenoid_e_field(glm::f32 solenoidFlux, glm::f32vec3 loc) {
+    glm::f32vec3 solenoidAxis(0.0f, 1.0f, 0.0f);
+    glm::f32vec3 solenoidR(loc.x, 0.0f, loc.z);
+    glm::f32 solenoidEMag = solenoidFlux / (2.0f * PI * glm::length(solenoidR));
+    return solenoidEMag * glm::cross(solenoidAxis, glm::normalize(solenoidR));
+}
+
+// Unit vector along a field, scaled up first to avoid underflow when normalizing, as the tracer kernels do
+static glm::f32vec3 field_direction(glm::f32vec3 field) {
+    field = field * 1e10f;
+    glm::f32 mag = glm::length(field);
+    return mag > 0.0f ? field / mag : glm::f32vec3(0.0f);
+}
+
+// trilinear, with the corners ordered x fastest, then y, then z
+static glm::f32vec3 trilinear(const glm::f32vec3 (&corners)[8], glm::f32vec3 w) {
+    glm::f32vec3 v_ym_zm = glm::mix(corners[0], corners[1], w.x);
+    glm::f32vec3 v_yp_zm = glm::mix(corners[2], corners[3], w.x);
+    glm::f32vec3 v_ym_zp = glm::mix(corners[4], corners[5], w.x);
+    glm::f32vec3 v_yp_zp = glm::mix(corners[6], corners[7], w.x);
+    glm::f32vec3 v_zm = glm::mix(v_ym_zm, v_yp_zm, w.y);
+    glm::f32vec3 v_zp = glm::mix(v_ym_zp, v_yp_zp, w.y);
+    return glm::mix(v_zm, v_zp, w.z);
+}
+
+// sample_field in kernel/tracer_field_buffer.wgsl: the field interpolated from the mesh, or zero outside it
+static glm::f32vec3 sample_mesh_field(const CpuVectorField& field, const MeshProperties& mesh, glm::f32vec3 pos) {
+    CellNeighbors neighbors = cell_neighbors(pos, mesh);
+    if (neighbors.xp_yp_zp == -1) {
+        return glm::f32vec3(0.0f);
+    }
+    glm::i32 corners[8] = {
+        neighbors.xm_ym_zm, neighbors.xp_ym_zm, neighbors.xm_yp_zm, neighbors.xp_yp_zm,
+        neighbors.xm_ym_zp, neighbors.xp_ym_zp, neighbors.xm_yp_zp, neighbors.xp_yp_zp
+    };
+    glm::f32vec3 cornerF[8];
+    for (int k = 0; k < 8; k++) {
+        cornerF[k] = load(field, static_cast<glm::u32>(corners[k]));
+    }
+    glm::f32vec3 cellIdxFrac = (pos - mesh.min) / mesh.cell_size;
+    return trilinear(cornerF, cellIdxFrac - glm::floor(cellIdxFrac));
+}
+
+// One RK4 step of TRACER_STEP along the field lines, as updateTrails takes
+static glm::f32vec3 trace_field_line(const CpuVectorField& field, const MeshProperties& mesh, glm::f32vec3 p) {
+    auto direction = [&](glm::f32vec3 q) { return field_direction(sample_mesh_field(field, mesh, q)); };
+    glm::f32vec3 k1 = direction(p);
+    glm::f32vec3 k2 = direction(p + 0.5f * TRACER_STEP * k1);
+    glm::f32vec3 k3 = direction(p + 0.5f * TRACER_STEP * k2);
+    glm::f32vec3 k4 = direction(p + TRACER_STEP * k3);
+    return p + (TRACER_STEP / 6.0f) * (k1 + 2.0f * k2 + 2.0f * k3 + k4);
+}
+
+// wrap_axis in kernel/boundary.wgsl
+static glm::f32 wrap_axis(glm::f32 posAxis, glm::f32 minAxis, glm::f32 maxAxis) {
+    glm::f32 extent = maxAxis - minAxis;
+    if (extent <= 0.0f) {
+        return posAxis;
+    }
+    glm::f32 d = posAxis - minAxis;
+    return minAxis + d - extent * std::floor(d / extent);
+}
+
+CpuSimulation create_cpu_simulation(
+    const std::vector<Cell>& cells,
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::u32 nParticles,
+    const std::vector<glm::f32vec4>& tracerLoc,
+    glm::u32 nThreads)
+{
+    CpuSimulation sim = {};
+    sim.nThreads = std::max(1u, nThreads);
+    sim.pool = std::make_shared<WorkerPool>(sim.nThreads);
+
+    // Particles, with every slot up to the maximum allocated so compaction and later growth never reallocate
+    CpuParticles& p = sim.particles;
+    glm::u32 nMax = static_cast<glm::u32>(pos.size());
+    for (std::vector<glm::f32>* component : particle_components(p)) {
+        component->assign(nMax, 0.0f);
+    }
+    p.charge.assign(nMax, 0.0f);
+    for (glm::u32 i = 0; i < nParticles; i++) {
+        p.x[i] = pos[i].x;
+        p.y[i] = pos[i].y;
+        p.z[i] = pos[i].z;
+        p.species[i] = pos[i].w;
+        p.vx[i] = vel[i].x;
+        p.vy[i] = vel[i].y;
+        p.vz[i] = vel[i].z;
+    }
+    p.n = nParticles;
+
+    // Mesh
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+    sim.cellLocation = create_vector_field(nCells);
+    for (glm::u32 i = 0; i < nCells; i++) {
+        store(sim.cellLocation, i, glm::f32vec3(cells[i].pos));
+    }
+    sim.eField = create_vector_field(nCells);
+    sim.bField = create_vector_field(nCells);
+    sim.externalEField = create_vector_field(nCells);
+    sim.externalBField = create_vector_field(nCells);
+
+    // Tracer trails, every point starting at the tracer location as in create_tracer_buffers
+    for (const glm::f32vec4& loc : tracerLoc) {
+        for (glm::u32 i = 0; i < TRACER_LENGTH; i++) {
+            sim.eTraces.push_back(glm::f32vec4(loc.x, loc.y, loc.z, 0.0f));
+        }
+    }
+    sim.bTraces = sim.eTraces;
+    sim.nTracers = static_cast<glm::u32>(tracerLoc.size());
+
+    return sim;
+}
+
+void cpu_external_field_compute(CpuSimulation& sim, const std::vector<CurrentVector>& currents) {
+    glm::u32 nCells = static_cast<glm::u32>(sim.cellLocation.x.size());
+    parallel_for(*sim.pool, nCells, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            glm::f32vec3 loc = load(sim.cellLocation, i);
+            store(sim.externalBField, i, currents_b_field(currents, loc));
+            store(sim.externalEField, i, solenoid_e_field(1.0f, loc));
+        }
+    });
+}
+
+void cpu_field_compute(CpuSimulation& sim, glm::f32 solenoidFlux, bool enableParticleFieldContributions) {
+    if (enableParticleFieldContributions) {
+        refresh_charges(sim.particles, *sim.pool);
+    }
+
+    glm::u32 nCells = static_cast<glm::u32>(sim.cellLocation.x.size());
+    parallel_for(*sim.pool, nCells, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            glm::f32vec3 E(0.0f);
+            glm::f32vec3 B(0.0f);
+            if (enableParticleFieldContributions) {
+                sum_particle_fields(sim.particles, load(sim.cellLocation, i), E, B);
+            }
+
+            // Add the cached contributions of the currents and the central solenoid
+            B += load(sim.externalBField, i);
+            E += solenoidFlux * load(sim.externalEField, i);
+
+            store(sim.eField, i, E);
+            store(sim.bField, i, B);
+        }
+    });
+    sim.fieldsUpdated = true;
+}
+
+void cpu_tracer_compute(CpuSimulation& sim, const MeshProperties& mesh, glm::u32 nPoints) {
+    if (nPoints == 0) return;
+
+    parallel_for(*sim.pool, sim.nTracers, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 tracer = begin; tracer < end; tracer++) {
+            glm::u32 traceStart = tracer * TRACER_LENGTH;
+            for (glm::u32 k = 0; k < nPoints; k++) {
+                // The first point of each trail is its fixed start, so the kernel skips the point that would overwrite it
+                glm::u32 idx = (sim.curTraceIdx + k) % TRACER_LENGTH;
+                if (idx == 0) continue;
+
+                glm::f32vec3 eNext = trace_field_line(sim.eField, mesh, glm::f32vec3(sim.eTraces[traceStart + idx - 1]));
+                glm::f32vec3 bNext = trace_field_line(sim.bField, mesh, glm::f32vec3(sim.bTraces[traceStart + idx - 1]));
+                sim.eTraces[traceStart + idx] = glm::f32vec4(eNext.x, eNext.y, eNext.z, 0.0f);
+                sim.bTraces[traceStart + idx] = glm::f32vec4(bNext.x, bNext.y, bNext.z, 0.0f);
+            }
+        }
+    });
+    sim.tracersUpdated = true;
+
+    sim.curTraceIdx = (sim.curTraceIdx + nPoints) % TRACER_LENGTH;
+}
+
+void cpu_particle_pic_compute(CpuSimulation& sim, const MeshProperties& mesh, glm::f32 dt, bool enableParticleFieldContributions) {
+    CpuParticles& p = sim.particles;
+    parallel_for(*sim.pool, p.n, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            glm::f32 species = p.species[i];
+            if (species == 0.0f) {
+                continue; // inactive particle
+            }
+
+            glm::f32vec3 pos(p.x[i], p.y[i], p.z[i]);
+            glm::f32vec3 vel(p.vx[i], p.vy[i], p.vz[i]);
+            glm::f32 qOverM = charge_to_mass_ratio(species);
+
+            // Outside the mesh the fields are taken as zero and the particle coasts
+            glm::f32vec3 E(0.0f);
+            glm::f32vec3 B(0.0f);
+            CellNeighbors neighbors = cell_neighbors(pos, mesh);
+            if (neighbors.xp_yp_zp != -1) {
+                glm::i32 corners[8] = {
+                    neighbors.xm_ym_zm, neighbors.xp_ym_zm, neighbors.xm_yp_zm, neighbors.xp_yp_zm,
+                    neighbors.xm_ym_zp, neighbors.xp_ym_zp, neighbors.xm_yp_zp, neighbors.xp_yp_zp
+                };
+                glm::f32vec3 cornerE[8];
+                glm::f32vec3 cornerB[8];
+                glm::f32 charge = particle_charge(species);
+                for (int k = 0; k < 8; k++) {
+                    glm::u32 cell = static_cast<glm::u32>(corners[k]);
+                    cornerE[k] = load(sim.eField, cell);
+                    cornerB[k] = load(sim.bField, cell);
+
+                    // Subtract this particle's own contribution from the mesh fields
+                    if (enableParticleFieldContributions) {
+                        glm::f32vec3 selfE(0.0f);
+                        glm::f32vec3 selfB(0.0f);
+                        add_particle_field(pos, vel, charge, load(sim.cellLocation, cell), selfE, selfB);
+                        cornerE[k] -= selfE;
+                        cornerB[k] -= selfB;
+                    }
+                }
+
+                glm::f32vec3 cellIdxFrac = (pos - mesh.min) / mesh.cell_size;
+                glm::f32vec3 w = cellIdxFrac - glm::floor(cellIdxFrac);
+                E = trilinear(cornerE, w);
+                B = trilinear(cornerB, w);
+            }
+
+            // Boris push: dv/dt = q/m (E + v x B)
+            glm::f32vec3 t = qOverM * B * 0.5f * dt;
+            glm::f32 tMag = glm::length(t);
+            glm::f32vec3 s = 2.0f * t / (1.0f + tMag * tMag);
+            glm::f32vec3 vMinus = vel + qOverM * E * 0.5f * dt;
+            glm::f32vec3 vPrime = vMinus + glm::cross(vMinus, t);
+            glm::f32vec3 vPlus = vMinus + glm::cross(vPrime, s);
+            glm::f32vec3 velNew = vPlus + qOverM * E * 0.5f * dt;
+            glm::f32vec3 posNew = pos + velNew * dt;
+
+            p.x[i] = posNew.x;
+            p.y[i] = posNew.y;
+            p.z[i] = posNew.z;
+            p.vx[i] = velNew.x;
+            p.vy[i] = velNew.y;
+            p.vz[i] = velNew.z;
+        }
+    });
+}
+
+void cpu_torus_wall_compute(CpuSimulation& sim, glm::f32 r1, glm::f32 r2) {
+    CpuParticles& p = sim.particles;
+    parallel_for(*sim.pool, p.n, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            // Distance from the torus centerline, a circle of radius r1 in the xz-plane
+            glm::f32 radialDistFromTorusCenterline = std::sqrt(p.x[i] * p.x[i] + p.z[i] * p.z[i]) - r1;
+            glm::f32 distFromTorusCenterline = std::sqrt(radialDistFromTorusCenterline * radialDistFromTorusCenterline + p.y[i] * p.y[i]);
+            if (distFromTorusCenterline >= r2) {
+                p.species[i] = 0.0f;
+            }
+        }
+    });
+}
+
+void cpu_boundary_compute(CpuSimulation& sim, glm::f32vec3 min, glm::f32vec3 max) {
+    CpuParticles& p = sim.particles;
+    parallel_for(*sim.pool, p.n, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            if (p.species[i] == 0.0f) continue;
+            p.x[i] = wrap_axis(p.x[i], min.x, max.x);
+            p.y[i] = wrap_axis(p.y[i], min.y, max.y);
+            p.z[i] = wrap_axis(p.z[i], min.z, max.z);
+        }
+    });
+}
+
+bool cpu_compact(CpuSimulation& sim, glm::f32 deadFraction) {
+    CpuParticles& p = sim.particles;
+    glm::u32 live = 0;
+    for (glm::u32 i = 0; i < p.n; i++) {
+        if (p.species[i] != 0.0f) live++;
+    }
+    glm::f32 dead = static_cast<glm::f32>(p.n - live);
+    if (!(dead > 0.0f && dead > deadFraction * p.n)) {
+        return false;
+    }
+
+    auto components = particle_components(p);
+    glm::u32 dst = 0;
+    for (glm::u32 i = 0; i < p.n; i++) {
+        if (p.species[i] == 0.0f) continue;
+        if (dst != i) {
+            for (std::vector<glm::f32>* component : components) {
+                (*component)[dst] = (*component)[i];
+            }
+        }
+        dst++;
+    }
+    for (std::vector<glm::f32>* component : components) {
+        std::fill(component->begin() + dst, component->begin() + p.n, 0.0f);
+    }
+    p.n = dst;
+    return true;
+}
+
+// particle_cell in kernel/sort.wgsl
+static glm::u32 particle_cell(const CpuParticles& p, glm::u32 i, const MeshProperties& mesh, glm::u32 nCells) {
+    if (p.species[i] == 0.0f ||
+        p.x[i] < mesh.min.x || p.x[i] >= mesh.max.x ||
+        p.y[i] < mesh.min.y || p.y[i] >= mesh.max.y ||
+        p.z[i] < mesh.min.z || p.z[i] >= mesh.max.z) {
+        return nCells;
+    }
+
+    glm::i32 idx = to_linear_index(
+        static_cast<glm::i32>((p.x[i] - mesh.min.x) / mesh.cell_size.x),
+        static_cast<glm::i32>((p.y[i] - mesh.min.y) / mesh.cell_size.y),
+        static_cast<glm::i32>((p.z[i] - mesh.min.z) / mesh.cell_size.z),
+        mesh.dim);
+    return idx < 0 ? nCells : static_cast<glm::u32>(idx);
+}
+
+void cpu_sort(CpuSimulation& sim, const MeshProperties& mesh) {
+    CpuParticles& p = sim.particles;
+    glm::u32 nCells = mesh.dim.x * mesh.dim.y * mesh.dim.z;
+
+    // Count each bucket into the slot after it, so the running sum leaves each bucket's start
+    std::vector<glm::u32> cell(p.n);
+    std::vector<glm::u32> cellStart(nCells + 2, 0);
+    for (glm::u32 i = 0; i < p.n; i++) {
+        cell[i] = particle_cell(p, i, mesh, nCells);
+        cellStart[cell[i] + 1]++;
+    }
+    for (glm::u32 c = 0; c <= nCells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+
+    std::vector<glm::u32> order(p.n);
+    for (glm::u32 i = 0; i < p.n; i++) {
+        order[cellStart[cell[i]]++] = i;
+    }
+
+    std::vector<glm::f32> sorted(p.n);
+    for (std::vector<glm::f32>* component : particle_components(p)) {
+        parallel_for(*sim.pool, p.n, [&](glm::u32 begin, glm::u32 end) {
+            for (glm::u32 j = begin; j < end; j++) {
+                sorted[j] = (*component)[order[j]];
+            }
+        });
+        std::copy(sorted.begin(), sorted.end(), component->begin());
+    }
+}
+
+void cpu_particle_vec4s(const CpuParticles& particles, std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) {
+    pos.resize(particles.n);
+    vel.resize(particles.n);
+    for (glm::u32 i = 0; i < particles.n; i++) {
+        pos[i] = glm::f32vec4(particles.x[i], particles.y[i], particles.z[i], particles.species[i]);
+        vel[i] = glm::f32vec4(particles.vx[i], particles.vy[i], particles.vz[i], 0.0f);
+    }
+}
+
+std::vector<glm::f32vec4> cpu_field_vec4s(const CpuVectorField& field) {
+    std::vector<glm::f32vec4> out(field.x.size());
+    for (size_t i = 0; i < out.size(); i++) {
+        out[i] = glm::f32vec4(field.x[i], field.y[i], field.z[i], 0.0f);
+    }
+    return out;
+}
+
+void CpuBackend::allocate(const BackendInit& init) {
+    this->sim = create_cpu_simulation(init.cells, init.particlePos, init.particleVel, init.initialParticles, init.tracerLoc, init.cpuThreads);
+    this->mesh = init.mesh;
+    this->wall = init.wall;
+    this->currents = init.currents;
+    this->compactInterval = init.compactInterval;
+    this->compactDeadFraction = init.compactDeadFraction;
+    this->sortInterval = init.sortInterval;
+    this->profiling = init.profile;
+
+    this->device = init.device;
+    this->particles = init.particles;
+    this->fields = init.fields;
+    this->tracers = init.tracers;
+    this->particleIndirect = init.particleIndirect;
+
+    std::cout << "CPU backend: " << sim.nThreads << " threads" << std::endl;
+    if (init.fieldSolver != FIELD_SOLVER_DIRECT) {
+        std::cout << "CPU backend sums particle fields directly; the grid field solvers are GPU only" << std::endl;
+    }
+}
+
+// Runs one stage, adding its wall-clock time to profile when profiling
+template <typename StageFn>
+static void run_stage(bool profiling, KernelProfile& profile, ProfiledStage stage, StageFn&& fn) {
+    if (!profiling) {
+        fn();
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    add_kernel_sample(profile, stage, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+}
+
+void CpuBackend::step(glm::u32 nSteps, const StepInputs& inputs) {
+    for (glm::u32 i = 0; i < nSteps; i++) {
+        bool runFieldStage;
+        this->schedule_stages(inputs, runFieldStage);
+
+        if (this->refreshExternalFields) {
+            run_stage(profiling, profile, STAGE_EXTERNAL_FIELDS, [&] { cpu_external_field_compute(sim, currents); });
+            this->refreshExternalFields = false;
+        }
+        if (runFieldStage) {
+            run_stage(profiling, profile, STAGE_FIELDS, [&] { cpu_field_compute(sim, inputs.solenoidFlux, inputs.enableParticleFieldContributions); });
+        }
+
+        run_stage(profiling, profile, STAGE_MOTION, [&] { cpu_particle_pic_compute(sim, mesh, inputs.dt, inputs.enableParticleFieldContributions); });
+        run_stage(profiling, profile, STAGE_WALL, [&] {
+            if (wall.type == WALL_TORUS) {
+                cpu_torus_wall_compute(sim, wall.r1, wall.r2);
+            } else {
+                cpu_boundary_compute(sim, wall.min, wall.max);
+            }
+        });
+
+        if (compact_due()) {
+            run_stage(profiling, profile, STAGE_COMPACT, [&] { cpu_compact(sim, compactDeadFraction); });
+        }
+        if (sort_due()) {
+            run_stage(profiling, profile, STAGE_SORT, [&] { cpu_sort(sim, mesh); });
+        }
+        stepCount++;
+    }
+}
+
+void CpuBackend::trace(glm::u32 nPoints, const StepInputs& inputs) {
+    glm::u32 due = this->tracer_points_due(inputs, nPoints, sim.curTraceIdx);
+    if (due == 0) return;
+    run_stage(profiling, profile, STAGE_TRACERS, [&] { cpu_tracer_compute(sim, mesh, due); });
+}
+
+BackendDiagnostics CpuBackend::read_diagnostics() {
+    return BackendDiagnostics{
+        .nParticles = sim.particles.n,
+        .step = stepCount,
+        .kernelTimings = profiling ? kernel_timings(profile) : std::vector<KernelTiming>{}
+    };
+}
+
+void CpuBackend::snapshot(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) {
+    cpu_particle_vec4s(sim.particles, pos, vel);
+}
+
+void CpuBackend::sync_render_buffers() {
+    // Headless CPU runs create no device, so there is nothing to render into
+    if (!device) {
+        return;
+    }
+    wgpu::Queue queue = device.GetQueue();
+
+    std::vector<glm::f32vec4> pos, vel;
+    cpu_particle_vec4s(sim.particles, pos, vel);
+    queue.WriteBuffer(particles.nCur, 0, &sim.particles.n, sizeof(glm::u32));
+    queue.WriteBuffer(particles.pos, 0, pos.data(), pos.size() * sizeof(glm::f32vec4));
+    queue.WriteBuffer(particles.vel, 0, vel.data(), vel.size() * sizeof(glm::f32vec4));
+
+    if (sim.fieldsUpdated) {
+        std::vector<glm::f32vec4> eField = cpu_field_vec4s(sim.eField);
+        std::vector<glm::f32vec4> bField = cpu_field_vec4s(sim.bField);
+        queue.WriteBuffer(fields.eField, 0, eField.data(), eField.size() * sizeof(glm::f32vec4));
+        queue.WriteBuffer(fields.bField, 0, bField.data(), bField.size() * sizeof(glm::f32vec4));
+        sim.fieldsUpdated = false;
+    }
+    if (sim.tracersUpdated) {
+        queue.WriteBuffer(tracers.e_traces, 0, sim.eTraces.data(), sim.eTraces.size() * sizeof(glm::f32vec4));
+        queue.WriteBuffer(tracers.b_traces, 0, sim.bTraces.data(), sim.bTraces.size() * sizeof(glm::f32vec4));
+        sim.tracersUpdated = false;
+    }
+
+    // Rebuild the draw args from the uploaded count
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+    run_particle_indirect_compute(pass, particleIndirect);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "simulation_backend.h"
+#include "current_segment.h"
+#include "mesh.h"
+#include "util/parallel.h"
+
+// Native implementation of the per-step kernels, selected with --backend=cpu: external and per-step fields,
+// tracers, the PIC push, the torus wall / box boundary, compaction and sorting. State is held as structure-of-arrays so
+// the per-particle and per-cell loops are unit-stride, and each stage is split across a pool of nThreads. Every function
+// mirrors the kernel named in its comment, so results match the GPU up to float rounding. Particle fields always
+// use the direct sum; the grid solvers are GPU only.
+
+// Particles as separate component arrays; species 0 marks a dead slot, as pos.w does on the GPU
+struct CpuParticles {
+    std::vector<glm::f32> x, y, z, species;
+    std::vector<glm::f32> vx, vy, vz;
+    std::vector<glm::f32> charge; // Scratch: per-particle charge (0 when dead), refreshed by the field sums
+    glm::u32 n = 0;               // Slots in use, live or dead (the GPU nParticles)
+};
+
+// Vector field over the mesh cells
+struct CpuVectorField {
+    std::vector<glm::f32> x, y, z;
+};
+
+struct CpuSimulation {
+    CpuParticles particles;
+    CpuVectorField cellLocation;
+    CpuVectorField eField;
+    CpuVectorField bField;
+    CpuVectorField externalEField;  // Solenoid E per unit flux, scaled by solenoidFlux each step
+    CpuVectorField externalBField;  // Biot-Savart B of the current segments
+    std::vector<glm::f32vec4> eTraces; // Same layout as TracerBuffers, so the trails upload as they are
+    std::vector<glm::f32vec4> bTraces;
+    glm::u32 nTracers = 0;
+    glm::u32 curTraceIdx = 0;
+    glm::u32 nThreads = 1;
+    std::shared_ptr<WorkerPool> pool; // nThreads workers, kept across steps; copies of the simulation share it
+
+    // Set when a stage rewrites the fields or the trails, cleared by whoever uploads them for rendering
+    bool fieldsUpdated = false;
+    bool tracersUpdated = false;
+};
+
+// Takes the first nParticles of pos ([x, y, z, species]) and vel, with room for pos.size() particles, and
+// starts every tracer trail at its location in tracerLoc
+CpuSimulation create_cpu_simulation(
+    const std::vector<Cell>& cells,
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::u32 nParticles,
+    const std::vector<glm::f32vec4>& tracerLoc,
+    glm::u32 nThreads);
+
+// computeExternalFields: caches the current segment B and unit-flux solenoid E at each cell
+void cpu_external_field_compute(CpuSimulation& sim, const std::vector<CurrentVector>& currents);
+
+// computeFields: cached external fields plus, if enabled, the direct sum over all particles
+void cpu_field_compute(CpuSimulation& sim, glm::f32 solenoidFlux, bool enableParticleFieldContributions);
+
+// tracer updateTrails: extends every trail by nPoints RK4 steps along the fields cached on the mesh
+void cpu_tracer_compute(CpuSimulation& sim, const MeshProperties& mesh, glm::u32 nPoints);
+
+// computeMotion: Boris push with E and B interpolated from the mesh, less the particle's own contribution
+void cpu_particle_pic_compute(CpuSimulation& sim, const MeshProperties& mesh, glm::f32 dt, bool enableParticleFieldContributions);
+
+// checkWallInteractions: particles outside the torus of radii r1 (major) and r2 (minor) die
+void cpu_torus_wall_compute(CpuSimulation& sim, glm::f32 r1, glm::f32 r2);
+
+// applyBoundary: wraps particles periodically into the box [min, max]
+void cpu_boundary_compute(CpuSimulation& sim, glm::f32vec3 min, glm::f32vec3 max);
+
+// Packs the live particles to the front, preserving their order, once more than deadFraction of the slots are
+// dead. Returns whether it compacted.
+bool cpu_compact(CpuSimulation& sim, glm::f32 deadFraction);
+
+// kernel/sort.wgsl: reorders the particles by the mesh cell they interpolate from, dead and out-of-mesh particles
+// after the last cell. Stable, where the GPU sort orders each cell by its atomics.
+void cpu_sort(CpuSimulation& sim, const MeshProperties& mesh);
+
+// The first n particles in the GPU layout ([x, y, z, species] and [vx, vy, vz, 0])
+void cpu_particle_vec4s(const CpuParticles& particles, std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel);
+
+// A field in the GPU layout ([x, y, z, 0] per cell)
+std::vector<glm::f32vec4> cpu_field_vec4s(const CpuVectorField& field);
+
+// Runs the stages above on the host, copying the state into the render buffers on sync_render_buffers
+class CpuBackend : public SimulationBackend {
+public:
+    void allocate(const BackendInit& init) override;
+    void step(glm::u32 nSteps, const StepInputs& inputs) override;
+    void trace(glm::u32 nPoints, const StepInputs& inputs) override;
+    BackendDiagnostics read_diagnostics() override;
+    void snapshot(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) override;
+    void sync_render_buffers() override;
+
+private:
+    CpuSimulation sim;
+    MeshProperties mesh;
+    WallParameters wall;
+    glm::f32 compactDeadFraction;
+    bool profiling;
+    KernelProfile profile; // Wall-clock stage times
+
+    // Render buffers, null on headless runs
+    wgpu::Device device;
+    ParticleBuffers particles;
+    FieldBuffers fields;
+    TracerBuffers tracers;
+    ParticleIndirectCompute particleIndirect;
+};
@@ -0,0 +1,121 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include "fft_cpu.h"
+#include "util/parallel.h"
+
+using Complex = std::complex<glm::f32>;
+
+static bool is_power_of_two(glm::u32 n) {
+    return (n & (n - 1)) == 0;
+}
+
+// exp(+-2*pi*i * k / n) for k in [0, n)
+static std::vector<Complex> twiddles(glm::u32 n, bool inverse) {
+    std::vector<Complex> w(n);
+    double sign = inverse ? 1.0 : -1.0;
+    for (glm::u32 k = 0; k < n; k++) {
+        double angle = sign * 2.0 * M_PI * k / n;
+        w[k] = Complex(static_cast<glm::f32>(std::cos(angle)), static_cast<glm::f32>(std::sin(angle)));
+    }
+    return w;
+}
+
+static void transform_line(std::vector<Complex>& line, std::vector<Complex>& scratch, const std::vector<Complex>& w) {
+    glm::u32 n = static_cast<glm::u32>(line.size());
+
+    if (is_power_of_two(n)) {
+        // Bit-reversal permutation, then log2(n) butterfly stages
+        for (glm::u32 i = 1, j = 0; i < n; i++) {
+            glm::u32 bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(line[i], line[j]);
+        }
+        for (glm::u32 span = 1; span < n; span *= 2) {
+            glm::u32 step = n / (2 * span);
+            for (glm::u32 group = 0; group < n; group += 2 * span) {
+                for (glm::u32 pos = 0; pos < span; pos++) {
+                    Complex a = line[group + pos];
+                    Complex b = line[group + pos + span] * w[pos * step];
+                    line[group + pos] = a + b;
+                    line[group + pos + span] = a - b;
+                }
+            }
+        }
+    } else {
+        for (glm::u32 k = 0; k < n; k++) {
+            Complex sum = 0.0f;
+            for (glm::u32 j = 0; j < n; j++) {
+                sum += line[j] * w[(static_cast<glm::u64>(k) * j) % n];
+            }
+            scratch[k] = sum;
+        }
+        std::swap(line, scratch);
+    }
+}
+
+void fft_axis(std::vector<Complex>& data, glm::u32vec3 dim, glm::u32 axis, bool inverse, glm::u32 nThreads) {
+    glm::u32 n = dim[axis];
+    glm::u32 nLines = dim.x * dim.y * dim.z / n;
+    std::vector<Complex> w = twiddles(n, inverse);
+
+    parallel_for(nLines, nThreads, [&](glm::u32 begin, glm::u32 end) {
+        std::vector<Complex> line(n), scratch(n);
+        for (glm::u32 l = begin; l < end; l++) {
+            // Linear index is x * dim.z * dim.y + z * dim.y + y
+            size_t start, stride;
+            if (axis == 0) {
+                start = l;
+                stride = static_cast<size_t>(dim.z) * dim.y;
+            } else if (axis == 1) {
+                start = static_cast<size_t>(l) * dim.y;
+                stride = 1;
+            } else {
+                start = static_cast<size_t>(l / dim.y) * dim.z * dim.y + l % dim.y;
+                stride = dim.y;
+            }
+
+            for (glm::u32 i = 0; i < n; i++) line[i] = data[start + i * stride];
+            transform_line(line, scratch, w);
+            for (glm::u32 i = 0; i < n; i++) data[start + i * stride] = line[i];
+        }
+    });
+}
+
+void fft_3d(std::vector<Complex>& data, glm::u32vec3 dim, bool inverse, glm::u32 nThreads) {
+    for (glm::u32 axis = 0; axis < 3; axis++) {
+        fft_axis(data, dim, axis, inverse, nThreads);
+    }
+}
+
+void solve_poisson_periodic(std::vector<Complex>& data, const MeshProperties& mesh, glm::u32 nThreads) {
+    glm::u32vec3 dim = mesh.dim;
+    glm::u32 nCells = dim.x * dim.y * dim.z;
+
+    // Eigenvalues of the 1D second difference along each axis
+    std::vector<glm::f32> k2[3];
+    for (glm::u32 axis = 0; axis < 3; axis++) {
+        glm::f32 h = mesh.cell_size[axis];
+        k2[axis].resize(dim[axis]);
+        for (glm::u32 m = 0; m < dim[axis]; m++) {
+            k2[axis][m] = static_cast<glm::f32>((2.0 - 2.0 * std::cos(2.0 * M_PI * m / dim[axis])) / (h * h));
+        }
+    }
+
+    fft_3d(data, dim, false, nThreads);
+
+    parallel_for(dim.x, nThreads, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 x = begin; x < end; x++) {
+            for (glm::u32 z = 0; z < dim.z; z++) {
+                for (glm::u32 y = 0; y < dim.y; y++) {
+                    size_t idx = to_linear_index(x, y, z, dim);
+                    glm::f32 eigenvalue = k2[0][x] + k2[1][y] + k2[2][z];
+                    data[idx] = eigenvalue == 0.0f ? Complex(0.0f) : data[idx] / (eigenvalue * nCells);
+                }
+            }
+        }
+    });
+
+    fft_3d(data, dim, true, nThreads);
+}
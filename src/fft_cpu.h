@@ -0,0 +1,21 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh.h"
+
+// CPU transforms over mesh-ordered complex grids (linear index x * dim.z * dim.y + z * dim.y + y). Used as the
+// fallback for the GPU spectral field solve. Power-of-two lines use radix-2 Cooley-Tukey, other lengths a
+// direct DFT. Neither direction is normalized.
+
+// Transforms every line of the grid along one axis (0 = x, 1 = y, 2 = z) in place
+void fft_axis(std::vector<std::complex<glm::f32>>& data, glm::u32vec3 dim, glm::u32 axis, bool inverse, glm::u32 nThreads);
+
+// Transforms the grid along all three axes in place
+void fft_3d(std::vector<std::complex<glm::f32>>& data, glm::u32vec3 dim, bool inverse, glm::u32 nThreads);
+
+// Solves laplacian(u) = -f in place on the periodic mesh, whose period is dim * cell_size (MeshProperties::periodic),
+// using the discrete 7-point Laplacian so the result matches the grid relaxation solvers. The mean of f is dropped
+// (uniform neutralizing background).
+void solve_poisson_periodic(std::vector<std::complex<glm::f32>>& data, const MeshProperties& mesh, glm::u32 nThreads);
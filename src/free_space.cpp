@@ -1,20 +1,15 @@
 #define _USE_MATH_DEFINES
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include "free_space.h"
 #include "emscripten_key.h"
 
-inline float rand_range(float min, float max) {
-    return static_cast<float>(rand()) / RAND_MAX * (max - min) + min;
-}
-
 FreeSpaceScene::FreeSpaceScene() : Scene() {
 }
 
 void FreeSpaceScene::init(const SimulationParams& params) {
     Scene::init(params);
-
-    this->boundaryCompute = create_boundary_compute(device, particles, params.maxParticles);
     this->cameraDistance = 3.0f * _M;
 }
 
@@ -22,87 +17,79 @@ void FreeSpaceScene::render_details(wgpu::RenderPassEncoder& pass) {
     Scene::render_details(pass);
 }
 
-void FreeSpaceScene::compute_field_step(wgpu::ComputePassEncoder& pass) {
-    run_field_compute(
-        device,
-        pass,
-        fieldCompute,
-        static_cast<glm::u32>(cells.size()),
-        static_cast<glm::u32>(cachedCurrents.size()),
-        0.0f,
-        enableParticleFieldContributions);
+// Particles wrap around the mesh box
+WallParameters FreeSpaceScene::wall_parameters() {
+    return WallParameters{ .type = WALL_PERIODIC_BOX, .min = mesh.min, .max = mesh_upper_bound(mesh) };
+}
 
-    // Run tracer compute
-    run_tracer_compute(
-        device,
-        pass,
-        tracerCompute,
-        dt,
-        0.0f,
-        enableParticleFieldContributions,
-        static_cast<glm::u32>(cachedCurrents.size()),
-        nParticles,
-        tracers.nTracers,
-        TRACER_LENGTH);
+// Particles wrap around the box, so the periodic spectral solve applies
+FieldSolver FreeSpaceScene::default_field_solver() {
+    return FIELD_SOLVER_FFT;
 }
 
-void FreeSpaceScene::compute_wall_interactions(wgpu::ComputePassEncoder& pass) {
-    run_boundary_compute(
-        device,
-        pass,
-        boundaryCompute,
-        mesh.min.x,
-        mesh.max.x,
-        mesh.min.y,
-        mesh.max.y,
-        mesh.min.z,
-        mesh.max.z,
-        nParticles);
+// Power of two nearest to n (in log scale), at least 2
+static glm::u32 nearest_power_of_two(glm::f32 n) {
+    glm::i32 p = static_cast<glm::i32>(std::round(std::log2(std::max(n, 2.0f))));
+    return 1u << p;
 }
 
+// Under the spectral solvers the box is periodic, so the nodes on the +s faces would duplicate the ones on the -s
+// faces: each axis holds n nodes spaced 2s / n apart, starting at -s. With the GPU FFT, n is snapped to the power of
+// two nearest the requested spacing so the transforms run radix-2. The other solvers hold the potentials at zero
+// past the mesh, so it keeps the requested spacing and spans both faces.
 std::vector<Cell> FreeSpaceScene::get_mesh_cells(glm::f32vec3 size, MeshProperties& mesh) {
     float s = 1.0f * _M;
     glm::vec3 minCoord { -s, -s, -s };
     glm::vec3 maxCoord { s, s, s };
-    
+    bool periodic = this->fieldSolver == FIELD_SOLVER_FFT || this->fieldSolver == FIELD_SOLVER_FFT_CPU;
+
+    glm::u32vec3 n;
+    glm::f32vec3 spacing;
+    for (int axis = 0; axis < 3; axis++) {
+        glm::f32 intervals = (maxCoord[axis] - minCoord[axis]) / size[axis];
+        if (this->fieldSolver == FIELD_SOLVER_FFT) {
+            n[axis] = nearest_power_of_two(intervals);
+            spacing[axis] = (maxCoord[axis] - minCoord[axis]) / n[axis];
+        } else if (periodic) {
+            n[axis] = std::max(2u, static_cast<glm::u32>(std::round(intervals)));
+            spacing[axis] = (maxCoord[axis] - minCoord[axis]) / n[axis];
+        } else {
+            // Nodes at the requested spacing from -s up to s, allowing for the rounding of the division
+            n[axis] = static_cast<glm::u32>(std::floor(intervals + 1e-4f)) + 1;
+            spacing[axis] = size[axis];
+        }
+    }
+    if (spacing.x != size.x || spacing.y != size.y || spacing.z != size.z) {
+        std::cout << "Cell spacing " << size.x << " m adjusted to " << spacing.x << " m to tile the periodic box";
+        if (this->fieldSolver == FIELD_SOLVER_FFT) std::cout << " with power-of-two FFT lines";
+        std::cout << std::endl;
+    }
+
     std::vector<Cell> cells;
-    glm::u32 nx = 0, ny = 0, nz = 0;
-    bool countZ = true, countY = true;
-    for (float x = minCoord.x; x <= maxCoord.x; x += size.x) {
-        for (float z = minCoord.z; z <= maxCoord.z; z += size.z) {
-            for (float y = minCoord.y; y <= maxCoord.y; y += size.y) {
+    for (glm::u32 ix = 0; ix < n.x; ix++) {
+        for (glm::u32 iz = 0; iz < n.z; iz++) {
+            for (glm::u32 iy = 0; iy < n.y; iy++) {
+                glm::f32vec3 p = minCoord + glm::f32vec3(ix, iy, iz) * spacing;
                 Cell cell;
-                cell.pos = glm::f32vec4 { x, y, z, 1.0f };
-                cell.min = glm::f32vec3 { x - size.x/2.0f, y - size.y/2.0f, z - size.z/2.0f };
-                cell.max = glm::f32vec3 { x + size.x/2.0f, y + size.y/2.0f, z + size.z/2.0f };
+                cell.pos = glm::f32vec4 { p.x, p.y, p.z, 1.0f };
+                cell.min = p - spacing / 2.0f;
+                cell.max = p + spacing / 2.0f;
                 cells.push_back(cell);
-                if (countY) ny++;
             }
-            if (countZ) nz++;
-            countY = false;
         }
-        nx++;
-        countZ = false;
     }
-    mesh.dim = glm::u32vec3 { nx, ny, nz };
-    mesh.cell_size = size;
+    mesh.dim = n;
+    mesh.cell_size = spacing;
     mesh.min = minCoord;
-    mesh.max = maxCoord;
+    mesh.max = minCoord + glm::f32vec3(n - 1u) * spacing;
+    mesh.periodic = periodic;
     
     return cells;
 }
 
-glm::f32vec4 FreeSpaceScene::rand_particle_position() {
+ParticleDistribution FreeSpaceScene::particle_distribution() {
     float s = 1.0f * _M;
-    glm::vec3 minCoord { -s, -s, -s };
-    glm::vec3 maxCoord { s, s, s };
-
-    float x = rand_range(minCoord.x, maxCoord.x);
-    float y = rand_range(minCoord.y, maxCoord.y);
-    float z = rand_range(minCoord.z, maxCoord.z);
-
-    // [x, y, z, unused]
-    return glm::f32vec4 { x, y, z, 0.0f };
+    return ParticleDistribution{ .type = DISTRIBUTION_BOX, .min = glm::f32vec3(-s), .max = glm::f32vec3(s) };
 }
 
 std::vector<CurrentVector> FreeSpaceScene::get_currents() {
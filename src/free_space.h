@@ -2,7 +2,6 @@
 
 #include "util/wgpu_util.h"
 #include "scene.h"
-#include "compute/boundary.h"
 #include "args.h"
 
 
@@ -17,15 +16,12 @@ public:
     void render_details(wgpu::RenderPassEncoder& pass) override;
 
     // Compute
-    void compute_field_step(wgpu::ComputePassEncoder& pass) override;
-    void compute_wall_interactions(wgpu::ComputePassEncoder& pass) override;
+    WallParameters wall_parameters() override;
+    FieldSolver default_field_solver() override;
 
     // Scene-dependent functions
     std::vector<Cell> get_mesh_cells(glm::f32vec3 size, MeshProperties& mesh) override;
-    glm::f32vec4 rand_particle_position() override;
+    ParticleDistribution particle_distribution() override;
     std::vector<CurrentVector> get_currents() override;
     bool process_input(bool (*debounce_input)()) override;
-
-private:
-    BoundaryCompute boundaryCompute;
 };
\ No newline at end of file
@@ -1,5 +1,15 @@
 #include "mesh.h"
 
+MeshPropertiesUniform mesh_uniform(const MeshProperties& mesh) {
+    return MeshPropertiesUniform {
+        .min = mesh.min,
+        .periodic = mesh.periodic ? 1u : 0u,
+        .max = mesh.max,
+        .dim = mesh.dim,
+        .cell_size = mesh.cell_size
+    };
+}
+
 glm::i32 to_linear_index(glm::i32 x, glm::i32 y, glm::i32 z, glm::u32vec3 dim) {
     if (x < 0 || y < 0 || z < 0 || glm::u32(x) >= dim.x || glm::u32(y) >= dim.y || glm::u32(z) >= dim.z) {
         return -1; // Out of bounds
@@ -7,9 +17,26 @@ glm::i32 to_linear_index(glm::i32 x, glm::i32 y, glm::i32 z, glm::u32vec3 dim) {
     return glm::i32((glm::u32(x) * dim.z * dim.y) + (glm::u32(z) * dim.y) + glm::u32(y));
 }
 
+glm::f32vec3 mesh_upper_bound(const MeshProperties& mesh) {
+    if (mesh.periodic) {
+        return mesh.min + glm::f32vec3(mesh.dim) * mesh.cell_size;
+    }
+    return mesh.max;
+}
+
+// Node index along one axis, wrapped around a periodic mesh
+static glm::i32 wrap_node(glm::i32 i, glm::u32 n, bool periodic) {
+    if (!periodic) {
+        return i;
+    }
+    glm::i32 d = glm::i32(n);
+    return (i % d + d) % d;
+}
+
 CellNeighbors cell_neighbors(glm::f32vec3 pos, const MeshProperties& mesh) {
     // Check if particle is outside the mesh bounds
-    if (pos.x < mesh.min.x || pos.x >= mesh.max.x || pos.y < mesh.min.y || pos.y >= mesh.max.y || pos.z < mesh.min.z || pos.z >= mesh.max.z) {
+    glm::f32vec3 upper = mesh_upper_bound(mesh);
+    if (pos.x < mesh.min.x || pos.x >= upper.x || pos.y < mesh.min.y || pos.y >= upper.y || pos.z < mesh.min.z || pos.z >= upper.z) {
         CellNeighbors neighbors;
         neighbors.xp_yp_zp = -1;
         neighbors.xp_yp_zm = -1;
@@ -22,32 +49,68 @@ CellNeighbors cell_neighbors(glm::f32vec3 pos, const MeshProperties& mesh) {
         return neighbors;
     }
     
-    // Calculate which cell the particle is in
-    glm::i32 cell_x = glm::i32((pos.x - mesh.min.x) / mesh.cell_size.x);
-    glm::i32 cell_y = glm::i32((pos.y - mesh.min.y) / mesh.cell_size.y);
-    glm::i32 cell_z = glm::i32((pos.z - mesh.min.z) / mesh.cell_size.z);
-    
-    // Determine which of the 8 surrounding cells to use based on particle position within the cell
-    glm::f32 local_x = (pos.x - mesh.min.x) / mesh.cell_size.x - glm::f32(cell_x);
-    glm::f32 local_y = (pos.y - mesh.min.y) / mesh.cell_size.y - glm::f32(cell_y);
-    glm::f32 local_z = (pos.z - mesh.min.z) / mesh.cell_size.z - glm::f32(cell_z);
-    
-    // Calculate which cell to base calculations off of
-    glm::i32 base_x = cell_x + (local_x > 0.5 ? 0 : -1);
-    glm::i32 base_y = cell_y + (local_y > 0.5 ? 0 : -1);
-    glm::i32 base_z = cell_z + (local_z > 0.5 ? 0 : -1);
+    // Mesh nodes are cell centers starting at mesh.min, so the node at or below the position is the base
+    // corner. This matches the weights used by interp() and the cloud-in-cell deposit. Past the last node of a
+    // periodic mesh, the upper corner wraps around to node 0.
+    glm::i32 base_x = wrap_node(glm::i32((pos.x - mesh.min.x) / mesh.cell_size.x), mesh.dim.x, mesh.periodic);
+    glm::i32 base_y = wrap_node(glm::i32((pos.y - mesh.min.y) / mesh.cell_size.y), mesh.dim.y, mesh.periodic);
+    glm::i32 base_z = wrap_node(glm::i32((pos.z - mesh.min.z) / mesh.cell_size.z), mesh.dim.z, mesh.periodic);
+    glm::i32 next_x = wrap_node(base_x + 1, mesh.dim.x, mesh.periodic);
+    glm::i32 next_y = wrap_node(base_y + 1, mesh.dim.y, mesh.periodic);
+    glm::i32 next_z = wrap_node(base_z + 1, mesh.dim.z, mesh.periodic);
     
     // Calculate the 8 corner cells around the particle
     CellNeighbors neighbors;
 
-    neighbors.xp_yp_zp = to_linear_index(base_x + 1, base_y + 1, base_z + 1, mesh.dim); // x+, y+, z+
-    neighbors.xp_yp_zm = to_linear_index(base_x + 1, base_y + 1, base_z, mesh.dim); // x+, y+, z-
-    neighbors.xp_ym_zp = to_linear_index(base_x + 1, base_y, base_z + 1, mesh.dim); // x+, y-, z+
-    neighbors.xp_ym_zm = to_linear_index(base_x + 1, base_y, base_z, mesh.dim); // x+, y-, z-
-    neighbors.xm_yp_zp = to_linear_index(base_x, base_y + 1, base_z + 1, mesh.dim); // x-, y+, z+
-    neighbors.xm_yp_zm = to_linear_index(base_x, base_y + 1, base_z, mesh.dim); // x-, y+, z-
-    neighbors.xm_ym_zp = to_linear_index(base_x, base_y, base_z + 1, mesh.dim); // x-, y-, z+
+    neighbors.xp_yp_zp = to_linear_index(next_x, next_y, next_z, mesh.dim); // x+, y+, z+
+    neighbors.xp_yp_zm = to_linear_index(next_x, next_y, base_z, mesh.dim); // x+, y+, z-
+    neighbors.xp_ym_zp = to_linear_index(next_x, base_y, next_z, mesh.dim); // x+, y-, z+
+    neighbors.xp_ym_zm = to_linear_index(next_x, base_y, base_z, mesh.dim); // x+, y-, z-
+    neighbors.xm_yp_zp = to_linear_index(base_x, next_y, next_z, mesh.dim); // x-, y+, z+
+    neighbors.xm_yp_zm = to_linear_index(base_x, next_y, base_z, mesh.dim); // x-, y+, z-
+    neighbors.xm_ym_zp = to_linear_index(base_x, base_y, next_z, mesh.dim); // x-, y-, z+
     neighbors.xm_ym_zm = to_linear_index(base_x, base_y, base_z, mesh.dim); // x-, y-, z-
     
     return neighbors;
-}
\ No newline at end of file
+}
+
+MeshProperties coarsen_mesh(const MeshProperties& mesh) {
+    // An even fine dimension gets one coarse node past its last node, so the coarse mesh still spans it
+    MeshProperties coarse;
+    coarse.dim = glm::u32vec3 { mesh.dim.x / 2 + 1, mesh.dim.y / 2 + 1, mesh.dim.z / 2 + 1 };
+    coarse.cell_size = glm::f32vec3 { 2.0f * mesh.cell_size.x, 2.0f * mesh.cell_size.y, 2.0f * mesh.cell_size.z };
+    coarse.min = mesh.min;
+    coarse.max = glm::f32vec3 {
+        mesh.min.x + (coarse.dim.x - 1) * coarse.cell_size.x,
+        mesh.min.y + (coarse.dim.y - 1) * coarse.cell_size.y,
+        mesh.min.z + (coarse.dim.z - 1) * coarse.cell_size.z
+    };
+    return coarse;
+}
+
+std::vector<glm::u32> interior_mask(const std::vector<Cell>& cells, const MeshProperties& mesh) {
+    std::vector<glm::u32> mask(cells.size());
+    for (glm::u32 x = 0; x < mesh.dim.x; x++) {
+        for (glm::u32 z = 0; z < mesh.dim.z; z++) {
+            for (glm::u32 y = 0; y < mesh.dim.y; y++) {
+                glm::i32 i = to_linear_index(x, y, z, mesh.dim);
+                bool onFace = x == 0 || y == 0 || z == 0 || x == mesh.dim.x - 1 || y == mesh.dim.y - 1 || z == mesh.dim.z - 1;
+                mask[i] = cells[i].pos.w > 0.0f && !onFace ? 1u : 0u;
+            }
+        }
+    }
+    return mask;
+}
+
+std::vector<glm::u32> coarsen_mask(const std::vector<glm::u32>& mask, glm::u32vec3 fineDim, glm::u32vec3 coarseDim) {
+    std::vector<glm::u32> coarse(coarseDim.x * coarseDim.y * coarseDim.z);
+    for (glm::i32 x = 0; x < glm::i32(coarseDim.x); x++) {
+        for (glm::i32 z = 0; z < glm::i32(coarseDim.z); z++) {
+            for (glm::i32 y = 0; y < glm::i32(coarseDim.y); y++) {
+                glm::i32 fine = to_linear_index(2 * x, 2 * y, 2 * z, fineDim);
+                coarse[to_linear_index(x, y, z, coarseDim)] = fine < 0 ? 0u : mask[fine];
+            }
+        }
+    }
+    return coarse;
+}
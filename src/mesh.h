@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <glm/glm.hpp>
 
 // The full mesh, including active and inactive cells. The mesh is always a grid, to support easier
@@ -10,6 +11,19 @@ struct MeshProperties {
     glm::f32vec3 max; // maximum cell center
     glm::u32vec3 dim; // number of cells in each dimension
     glm::f32vec3 cell_size; // cell size
+    bool periodic = false; // the mesh wraps around over dim * cell_size, so node dim - 1 neighbors node 0
+};
+
+// MeshProperties laid out to match the WGSL MeshProperties uniform (vec3 members are 16-byte aligned)
+struct MeshPropertiesUniform {
+    glm::f32vec3 min; // minimum cell center
+    glm::u32 periodic; // 1 if the mesh wraps around
+    glm::f32vec3 max; // maximum cell center
+    glm::f32 _padding2; // padding for 16-byte alignment
+    glm::u32vec3 dim; // number of cells in each dimension
+    glm::u32 _padding3; // padding for 16-byte alignment
+    glm::f32vec3 cell_size; // cell size
+    glm::f32 _padding4; // padding for 16-byte alignment
 };
 
 // Active cells define the boundary of the active plasma region. When a particle reaches the boundary,
@@ -31,4 +45,22 @@ struct CellNeighbors {
     glm::i32 xm_ym_zm; // x-, y-, z-
 };
 
-CellNeighbors cell_neighbors(glm::f32vec3 pos, const MeshProperties& mesh);
\ No newline at end of file
+MeshPropertiesUniform mesh_uniform(const MeshProperties& mesh);
+
+glm::i32 to_linear_index(glm::i32 x, glm::i32 y, glm::i32 z, glm::u32vec3 dim);
+
+// Upper corner of the region the mesh covers: the last node for a bounded mesh, one cell past it for a periodic one
+glm::f32vec3 mesh_upper_bound(const MeshProperties& mesh);
+
+CellNeighbors cell_neighbors(glm::f32vec3 pos, const MeshProperties& mesh);
+
+// Mesh made of every other node of the given mesh (coarse node i is fine node 2i), for multigrid
+MeshProperties coarsen_mesh(const MeshProperties& mesh);
+
+// Active-cell mask (1 = active) from Cell::pos.w, with the nodes on the mesh faces inactive too. The grid solvers
+// with a wall hold these inactive nodes at zero potential (multigrid) or treat them as a conductor (FDTD).
+std::vector<glm::u32> interior_mask(const std::vector<Cell>& cells, const MeshProperties& mesh);
+
+// Active-cell mask (1 = active) of the coarse mesh, injected from the fine node under each coarse node. Coarse
+// nodes past the fine mesh are inactive.
+std::vector<glm::u32> coarsen_mask(const std::vector<glm::u32>& mask, glm::u32vec3 fineDim, glm::u32vec3 coarseDim);
\ No newline at end of file
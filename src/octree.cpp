@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "octree.h"
+#include "physical_constants.h"
+
+namespace {
+
+struct OctreeBuilder {
+    const std::vector<glm::f32vec4>& pos;
+    const std::vector<glm::f32vec4>& vel;
+    Octree& tree;
+    std::vector<glm::u32> scratch;
+
+    glm::u32 octant(glm::u32 i, glm::f32vec3 mid) const {
+        const glm::f32vec4& p = pos[i];
+        return (p.x >= mid.x ? 4u : 0u) | (p.z >= mid.z ? 2u : 0u) | (p.y >= mid.y ? 1u : 0u);
+    }
+
+    static glm::f32vec3 child_min(glm::f32vec3 boxMin, glm::f32 half, glm::u32 oct) {
+        return glm::f32vec3(
+            boxMin.x + ((oct & 4u) ? half : 0.0f),
+            boxMin.y + ((oct & 1u) ? half : 0.0f),
+            boxMin.z + ((oct & 2u) ? half : 0.0f));
+    }
+
+    // Charge, |charge|-weighted center, dipole and current of tree.particles[begin, end)
+    OctreeNode moments(glm::u32 begin, glm::u32 end, glm::f32 size) const {
+        glm::f64 q = 0.0, absQ = 0.0;
+        glm::f64vec3 center(0.0, 0.0, 0.0), current(0.0, 0.0, 0.0);
+        for (glm::u32 k = begin; k < end; k++) {
+            const glm::f32vec4& p = pos[tree.particles[k]];
+            const glm::f32vec4& v = vel[tree.particles[k]];
+            glm::f64 charge = particle_charge(p.w);
+            q += charge;
+            absQ += std::abs(charge);
+            center += std::abs(charge) * glm::f64vec3(p.x, p.y, p.z);
+            current += charge * glm::f64vec3(v.x, v.y, v.z);
+        }
+        center = center / absQ;
+
+        glm::f64vec3 dipole(0.0, 0.0, 0.0);
+        for (glm::u32 k = begin; k < end; k++) {
+            const glm::f32vec4& p = pos[tree.particles[k]];
+            dipole += glm::f64 { particle_charge(p.w) } * (glm::f64vec3(p.x, p.y, p.z) - center);
+        }
+
+        OctreeNode node;
+        node.center = glm::f32vec4(center.x, center.y, center.z, q);
+        node.dipole = glm::f32vec4(dipole.x, dipole.y, dipole.z, size);
+        node.current = glm::f32vec4(current.x, current.y, current.z, 0.0f);
+        node.links = glm::u32vec4(0u, 0u, begin, 0u);
+        return node;
+    }
+
+    // Appends the subtree over tree.particles[begin, end) in pre-order and returns its root index
+    glm::u32 build(glm::u32 begin, glm::u32 end, glm::f32vec3 boxMin, glm::f32 size, glm::u32 depth) {
+        glm::u32 count = end - begin;
+
+        // Collapse chains of single-child nodes, so every internal node has at least two children
+        while (count > OCTREE_LEAF_SIZE && depth < OCTREE_MAX_DEPTH) {
+            glm::f32 half = 0.5f * size;
+            glm::f32vec3 mid(boxMin.x + half, boxMin.y + half, boxMin.z + half);
+            glm::u32 first = octant(tree.particles[begin], mid);
+            bool split = false;
+            for (glm::u32 k = begin + 1; k < end && !split; k++) {
+                split = octant(tree.particles[k], mid) != first;
+            }
+            if (split) break;
+            boxMin = child_min(boxMin, half, first);
+            size = half;
+            depth++;
+        }
+
+        glm::u32 index = static_cast<glm::u32>(tree.nodes.size());
+        tree.nodes.push_back(moments(begin, end, size));
+
+        if (count <= OCTREE_LEAF_SIZE || depth >= OCTREE_MAX_DEPTH) {
+            tree.nodes[index].links = glm::u32vec4(0u, index + 1u, begin, count);
+            return index;
+        }
+
+        // Counting sort of the range by octant
+        glm::f32 half = 0.5f * size;
+        glm::f32vec3 mid(boxMin.x + half, boxMin.y + half, boxMin.z + half);
+        std::array<glm::u32, 9> offsets = {};
+        for (glm::u32 k = begin; k < end; k++) {
+            offsets[octant(tree.particles[k], mid) + 1]++;
+        }
+        for (glm::u32 o = 0; o < 8; o++) {
+            offsets[o + 1] += offsets[o];
+        }
+        std::array<glm::u32, 9> fill = offsets;
+        for (glm::u32 k = begin; k < end; k++) {
+            scratch[fill[octant(tree.particles[k], mid)]++] = tree.particles[k];
+        }
+        std::copy(scratch.begin(), scratch.begin() + count, tree.particles.begin() + begin);
+
+        for (glm::u32 o = 0; o < 8; o++) {
+            if (offsets[o + 1] > offsets[o]) {
+                build(begin + offsets[o], begin + offsets[o + 1], child_min(boxMin, half, o), half, depth + 1);
+            }
+        }
+
+        tree.nodes[index].links.y = static_cast<glm::u32>(tree.nodes.size());
+        return index;
+    }
+};
+
+void add_particle_field(glm::f32vec4 p, glm::f32vec4 v, glm::f32vec3 loc, glm::f32vec3& E, glm::f32vec3& B) {
+    glm::f32 charge = particle_charge(p.w);
+    glm::f32vec3 r = loc - glm::f32vec3(p.x, p.y, p.z);
+    glm::f32 r_mag = glm::length(r);
+    if (r_mag < 0.00001f) return;
+
+    glm::f32vec3 r_norm = r / r_mag;
+    E += ((K_E * charge) / (r_mag * r_mag)) * r_norm;
+    B += ((MU_0_OVER_4_PI * charge) / (r_mag * r_mag)) * glm::cross(glm::f32vec3(v.x, v.y, v.z), r_norm);
+}
+
+} // namespace
+
+Octree build_octree(const std::vector<glm::f32vec4>& pos, const std::vector<glm::f32vec4>& vel, glm::u32 n) {
+    Octree tree;
+    glm::f32vec3 lo(INFINITY, INFINITY, INFINITY);
+    glm::f32vec3 hi(-INFINITY, -INFINITY, -INFINITY);
+    for (glm::u32 i = 0; i < n; i++) {
+        if (pos[i].w == 0.0f || particle_charge(pos[i].w) == 0.0f) continue;
+        glm::f32vec3 p(pos[i].x, pos[i].y, pos[i].z);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+        tree.particles.push_back(i);
+    }
+    if (tree.particles.empty()) return tree;
+
+    // Pad the cube slightly so the particles on the upper faces fall inside it
+    glm::f32 size = std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z });
+    size = size > 0.0f ? size * 1.0001f : 1.0f;
+
+    glm::u32 count = static_cast<glm::u32>(tree.particles.size());
+    tree.nodes.reserve(2 * count);
+    OctreeBuilder builder { pos, vel, tree, std::vector<glm::u32>(count) };
+    builder.build(0, count, lo, size, 0);
+    return tree;
+}
+
+void octree_fields(
+    const Octree& tree,
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::f32vec3 loc,
+    glm::i32 skipId,
+    glm::f32 theta,
+    glm::f32vec3& E,
+    glm::f32vec3& B)
+{
+    glm::u32 nNodes = static_cast<glm::u32>(tree.nodes.size());
+    glm::u32 node = 0;
+    while (node < nNodes) {
+        const OctreeNode& n = tree.nodes[node];
+
+        if (n.links.w > 0u) {
+            // Leaf: direct sum over its particles
+            for (glm::u32 k = n.links.z; k < n.links.z + n.links.w; k++) {
+                glm::u32 i = tree.particles[k];
+                if (static_cast<glm::i32>(i) == skipId) continue;
+                add_particle_field(pos[i], vel[i], loc, E, B);
+            }
+            node = n.links.y;
+            continue;
+        }
+
+        glm::f32vec3 r = loc - glm::f32vec3(n.center.x, n.center.y, n.center.z);
+        glm::f32 r_mag = glm::length(r);
+        if (n.dipole.w < theta * r_mag) {
+            // Far enough away: monopole + dipole for E, summed current for B
+            glm::f32vec3 r_norm = r / r_mag;
+            glm::f32vec3 p(n.dipole.x, n.dipole.y, n.dipole.z);
+            glm::f32vec3 j(n.current.x, n.current.y, n.current.z);
+            glm::f32 inv_r2 = 1.0f / (r_mag * r_mag);
+            E += K_E * inv_r2 * (n.center.w * r_norm + (3.0f * glm::dot(p, r_norm) * r_norm - p) / r_mag);
+            B += MU_0_OVER_4_PI * inv_r2 * glm::cross(j, r_norm);
+            node = n.links.y;
+        } else {
+            node++;
+        }
+    }
+}
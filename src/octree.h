@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+// Barnes-Hut octree over the particles for the exact (particle-particle) pusher. The tree is built on the CPU
+// and uploaded as a flat pre-order node array, so a kernel can walk it without a stack: descending goes to
+// node + 1, skipping a subtree jumps to links.y.
+
+const glm::u32 OCTREE_LEAF_SIZE = 8;   // Max particles in a leaf (exceeded only at OCTREE_MAX_DEPTH)
+const glm::u32 OCTREE_MAX_DEPTH = 24;
+
+// Node layout matching the WGSL OctreeNode struct
+struct OctreeNode {
+    glm::f32vec4 center;  // [x, y, z, total charge], center is the |charge|-weighted centroid
+    glm::f32vec4 dipole;  // [px, py, pz, node size], dipole moment about the center
+    glm::f32vec4 current; // [sum(q * vx), sum(q * vy), sum(q * vz), unused]
+    glm::u32vec4 links;   // [unused, end of subtree, first particle, particle count (0 for internal nodes)]
+};
+
+struct Octree {
+    std::vector<OctreeNode> nodes;
+    std::vector<glm::u32> particles; // Particle indices, grouped by leaf
+};
+
+// Builds the tree over the first n particles ([x, y, z, species] and [vx, vy, vz, unused]), skipping inactive
+// and neutral ones. Holds at most 2 * n nodes.
+Octree build_octree(const std::vector<glm::f32vec4>& pos, const std::vector<glm::f32vec4>& vel, glm::u32 n);
+
+// Reference evaluation of the E and B fields at loc from the tree, mirroring the kernel traversal. Nodes are
+// approximated when size / distance < theta; theta = 0 reproduces the direct sum.
+void octree_fields(
+    const Octree& tree,
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::f32vec3 loc,
+    glm::i32 skipId,
+    glm::f32 theta,
+    glm::f32vec3& E,
+    glm::f32vec3& B);
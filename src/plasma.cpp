@@ -1,67 +1,98 @@
-#include <vector>
 #include <iostream>
-#include <random>
+#include <vector>
 #include <cmath>
 #include <glm/glm.hpp>
 #include "physical_constants.h"
+#include "util/parallel.h"
+#include "util/philox.h"
+#include "plasma.h"
 
 const double k_B = 1.380649e-23 * _J / _K; // Boltzmann constant (J/K)
 
-inline float rand_range(float min, float max) {
-    return static_cast<float>(rand()) / RAND_MAX * (max - min) + min;
-}
-
-glm::f32vec4 maxwell_boltzmann_particle_velocty(float T, float mass) {
-    // Define parameters for the Maxwell-Boltzmann distribution
-    float sigma = std::sqrt(k_B * T / mass); // Standard deviation for the velocity distribution
+// Second Philox counter word, STREAM_POSITION and STREAM_VELOCITY in kernel/particle_init.wgsl
+const glm::u32 STREAM_POSITION = 0u;
+const glm::u32 STREAM_VELOCITY = 1u;
 
-    // Random number generation
-    std::random_device rd;  // Seed for the random number engine
-    std::mt19937 gen(rd()); // Mersenne Twister random number generator
-    std::normal_distribution<> normal(0.0, sigma); // Gaussian distribution with mean 0 and std dev sigma
+float maxwell_boltzmann_sigma(float T, float mass) {
+    return std::sqrt(k_B * T / mass);
+}
 
-    // Sample velocities in 3D and calculate the magnitude
-    float vx = normal(gen);
-    float vy = normal(gen);
-    float vz = normal(gen);
+std::vector<glm::f32vec4> species_init_table(const std::vector<SpeciesFraction>& species, glm::f32 temperature) {
+    std::vector<glm::f32vec4> table;
+    table.reserve(species.size());
 
-    return glm::f32vec4 { vx, vy, vz, 0.0f };
+    // Cumulative fractions, normalized so the last is exactly 1
+    glm::f32 total = 0.0f;
+    for (const SpeciesFraction& s : species) total += s.parts;
+    glm::f32 cumulative = 0.0f;
+    for (size_t i = 0; i < species.size(); i++) {
+        cumulative += species[i].parts;
+        glm::f32 species_f = static_cast<glm::f32>(species[i].species);
+        // Macroparticles move like the particles they stand for, so the thermal speed uses the physical mass
+        const SpeciesInfo& info = species_info(species_f);
+        table.push_back(glm::f32vec4(
+            species_f,
+            i + 1 == species.size() ? 1.0f : cumulative / total,
+            maxwell_boltzmann_sigma(temperature, info.mass / info.weight),
+            0.0f));
+    }
+    return table;
 }
 
-PARTICLE_SPECIES rand_particle_species(
-    float partsNeutron,
-    float partsElectron,
-    float partsProton,
-    float partsDeuterium,
-    float partsTritium,
-    float partsIonDeuterium,
-    float partsIonTritium,
-    float partsElectronMacroparticle,
-    float partsProtonMacroparticle)
+void sample_initial_particle(
+    glm::u32 i,
+    glm::u64 seed,
+    const ParticleDistribution& distribution,
+    const std::vector<glm::f32vec4>& speciesTable,
+    glm::f32vec4& pos,
+    glm::f32vec4& vel)
 {
-    float total = partsNeutron + partsElectron + partsProton + partsDeuterium + partsTritium + partsIonDeuterium + partsIonTritium + partsElectronMacroparticle + partsProtonMacroparticle;
-    float rnd = rand_range(0.0, total);
+    std::array<glm::u32, 2> key = philox_key(seed);
+    std::array<glm::u32, 4> r0 = philox4x32_10({ i, STREAM_POSITION, 0u, 0u }, key);
+    std::array<glm::u32, 4> r1 = philox4x32_10({ i, STREAM_VELOCITY, 0u, 0u }, key);
+
+    glm::f32 u = philox_uniform(r0[0]);
+    glm::f32vec4 species = speciesTable.back();
+    for (const glm::f32vec4& row : speciesTable) {
+        if (u < row.y) {
+            species = row;
+            break;
+        }
+    }
 
-    float level = partsNeutron;
-    if (rnd < level) return NEUTRON;
-    level += partsElectron;
-    if (rnd < level) return ELECTRON;
-    level += partsProton;
-    if (rnd < level) return PROTON;
-    level += partsDeuterium;
-    if (rnd < level) return DEUTERIUM;
-    level += partsTritium;
-    if (rnd < level) return TRITIUM;
-    level += partsIonDeuterium;
-    if (rnd < level) return DEUTERON;
-    level += partsIonTritium;
-    if (rnd < level) return TRITON;
-    level += partsElectronMacroparticle;
-    if (rnd < level) return ELECTRON_MACROPARTICLE;
-    level += partsProtonMacroparticle;
-    if (rnd < level) return PROTON_MACROPARTICLE;
+    glm::f32vec3 unit(philox_uniform(r0[1]), philox_uniform(r0[2]), philox_uniform(r0[3]));
+    glm::f32vec3 p = distribution.min + unit * (distribution.max - distribution.min);
+    if (distribution.type == DISTRIBUTION_CYLINDRICAL) {
+        p = glm::f32vec3(p.x * std::sin(p.z), p.y, p.x * std::cos(p.z));
+    }
 
-    std::cerr << "Invalid particle species" << std::endl;
+    // Maxwell-Boltzmann: each component normal with the species' sigma
+    glm::f32vec2 n01 = philox_normal2(r1[0], r1[1]);
+    glm::f32vec2 n23 = philox_normal2(r1[2], r1[3]);
 
-    return NEUTRON;
-}
\ No newline at end of file
+    pos = glm::f32vec4(p, species.x);
+    vel = glm::f32vec4(species.z * n01.x, species.z * n01.y, species.z * n23.x, 0.0f);
+}
+
+void generate_initial_particles(
+    glm::f32vec4* pos,
+    glm::f32vec4* vel,
+    glm::u32 nParticles,
+    const ParticleDistribution& distribution,
+    const std::vector<SpeciesFraction>& species,
+    glm::f32 temperature,
+    glm::u64 seed,
+    glm::u32 nThreads)
+{
+    if (species.empty()) {
+        std::cerr << "Particle init needs at least one species" << std::endl;
+        exit(1);
+    }
+
+    std::vector<glm::f32vec4> speciesTable = species_init_table(species, temperature);
+    parallel_for(nParticles, nThreads, [&](glm::u32 begin, glm::u32 end) {
+        for (glm::u32 i = begin; i < end; i++) {
+            sample_initial_particle(i, seed, distribution, speciesTable, pos[i], vel[i]);
+        }
+    });
+}
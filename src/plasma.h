@@ -1,17 +1,35 @@
 #pragma once
 
+#include <vector>
 #include <glm/glm.hpp>
 #include "physical_constants.h"
+#include "shared/particles.h"
 
-glm::f32vec4 maxwell_boltzmann_particle_velocty(float T, float mass);
+// Standard deviation of each velocity component at temperature T
+float maxwell_boltzmann_sigma(float T, float mass);
 
-PARTICLE_SPECIES rand_particle_species(
-    float partsNeutron,
-    float partsElectron,
-    float partsProton,
-    float partsDeuterium,
-    float partsTritium,
-    float partsIonDeuterium,
-    float partsIonTritium,
-    float partsElectronMacroparticle,
-    float partsProtonMacroparticle);
\ No newline at end of file
+// One [species, cumulative fraction, velocity sigma, unused] row per species, the last cumulative fraction exactly 1
+std::vector<glm::f32vec4> species_init_table(const std::vector<SpeciesFraction>& species, glm::f32 temperature);
+
+// Draws particle i exactly as initParticles in kernel/particle_init.wgsl does: placed by distribution, species
+// from speciesTable and a Maxwell-Boltzmann velocity, depending only on seed and i
+void sample_initial_particle(
+    glm::u32 i,
+    glm::u64 seed,
+    const ParticleDistribution& distribution,
+    const std::vector<glm::f32vec4>& speciesTable,
+    glm::f32vec4& pos,
+    glm::f32vec4& vel);
+
+// Fills the first nParticles slots of pos and vel, split across nThreads. Since every particle has its own Philox
+// counter the result is bit-identical for any thread count, and uses the same draws as run_particle_init_compute
+// for the same seed.
+void generate_initial_particles(
+    glm::f32vec4* pos,
+    glm::f32vec4* vel,
+    glm::u32 nParticles,
+    const ParticleDistribution& distribution,
+    const std::vector<SpeciesFraction>& species,
+    glm::f32 temperature,
+    glm::u64 seed,
+    glm::u32 nThreads);
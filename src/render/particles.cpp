@@ -1,14 +1,15 @@
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 #include "render/particles.h"
+#include "compute/indirect.h"
 #include "util/wgpu_util.h"
 #include "physical_constants.h"
 
-ParticleRender create_particle_render(wgpu::Device& device) {
+ParticleRender create_particle_render(wgpu::Device& device, const ParticleBuffers& particleBuf) {
     ParticleRender render = {};
     
     // Create render shader module
-    wgpu::ShaderModule renderShaderModule = create_shader_module(device, "shader/particles.wgsl", {"kernel/physical_constants.wgsl"});
+    wgpu::ShaderModule renderShaderModule = create_shader_module(device, "shader/particles.wgsl", {"kernel/species.wgsl"});
     if (!renderShaderModule) {
         std::cerr << "Failed to create render shader module" << std::endl;
         exit(1);
@@ -24,19 +25,28 @@ ParticleRender create_particle_render(wgpu::Device& device) {
     render.uniformBuffer = device.CreateBuffer(&uniformBufferDesc);
 
     // Create render bind group layout
-    wgpu::BindGroupLayoutEntry renderBinding = {
-        .binding = 0,
-        .visibility = wgpu::ShaderStage::Vertex,
-        .buffer = {
-            .type = wgpu::BufferBindingType::Uniform,
-            .minBindingSize = sizeof(glm::mat4) * 2
+    std::vector<wgpu::BindGroupLayoutEntry> renderBindings = {
+        { // uniforms
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Vertex,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(glm::mat4) * 2
+            }
+        }, { // speciesTable
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Vertex,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = SPECIES_TABLE_SIZE
+            }
         }
     };
 
     wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc = {
         .label = "Render Bind Group Layout",
-        .entryCount = 1,
-        .entries = &renderBinding
+        .entryCount = static_cast<uint32_t>(renderBindings.size()),
+        .entries = renderBindings.data()
     };
     render.bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
 
@@ -107,17 +117,24 @@ ParticleRender create_particle_render(wgpu::Device& device) {
     render.pipeline = device.CreateRenderPipeline(&pipelineDesc);
 
     // Create render bind group
-    wgpu::BindGroupEntry bindGroupEntry = {
-        .binding = 0,
-        .buffer = render.uniformBuffer,
-        .offset = 0,
-        .size = sizeof(glm::mat4) * 2
+    std::vector<wgpu::BindGroupEntry> bindGroupEntries = {
+        { // uniforms
+            .binding = 0,
+            .buffer = render.uniformBuffer,
+            .offset = 0,
+            .size = sizeof(glm::mat4) * 2
+        }, { // speciesTable
+            .binding = 1,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
+        }
     };
 
     wgpu::BindGroupDescriptor bindGroupDesc = {
         .layout = render.bindGroupLayout,
-        .entryCount = 1,
-        .entries = &bindGroupEntry
+        .entryCount = static_cast<uint32_t>(bindGroupEntries.size()),
+        .entries = bindGroupEntries.data()
     };
     render.bindGroup = device.CreateBindGroup(&bindGroupDesc);
 
@@ -139,3 +156,19 @@ void render_particles(wgpu::Device& device, wgpu::RenderPassEncoder& pass, const
     // Draw the particles
     pass.Draw(nParticles, 1, 0, 0);  // nParticles vertices, 1 instance, starting at vertex 0, instance 0
 }
+
+void render_particles(wgpu::Device& device, wgpu::RenderPassEncoder& pass, const ParticleBuffers& particleBuf, const ParticleRender& render, const wgpu::Buffer& indirectArgs, glm::mat4 view, glm::mat4 projection) {
+    // Update uniform buffer with matrices
+    std::vector<glm::mat4> matrices = {view, projection};
+    device.GetQueue().WriteBuffer(render.uniformBuffer, 0, matrices.data(), sizeof(glm::mat4) * 2);
+
+    // Set the pipeline and bind group
+    pass.SetPipeline(render.pipeline);
+    pass.SetBindGroup(0, render.bindGroup);
+
+    // Bind every slot; the GPU count decides how many are drawn
+    pass.SetVertexBuffer(0, particleBuf.pos, 0, particleBuf.nMax * sizeof(glm::f32vec4));
+
+    // Draw the particles
+    pass.DrawIndirect(indirectArgs, PARTICLE_DRAW_ARGS_OFFSET);
+}
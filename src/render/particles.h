@@ -15,7 +15,8 @@ struct ParticleRender {
     wgpu::RenderPipeline pipeline;
 };
 
-ParticleRender create_particle_render(wgpu::Device& device);
+// Colors each particle from the species table in particleBuf
+ParticleRender create_particle_render(wgpu::Device& device, const ParticleBuffers& particleBuf);
 
 void render_particles(
     wgpu::Device& device,
@@ -24,4 +25,14 @@ void render_particles(
     const ParticleRender& render,
     glm::u32 nParticles,
     glm::mat4 view,
-    glm::mat4 projection);
\ No newline at end of file
+    glm::mat4 projection);
+
+// Same as above, with the point count taken from the draw args in indirectArgs (see compute/indirect.h)
+void render_particles(
+    wgpu::Device& device,
+    wgpu::RenderPassEncoder& pass,
+    const ParticleBuffers& particleBuf,
+    const ParticleRender& render,
+    const wgpu::Buffer& indirectArgs,
+    glm::mat4 view,
+    glm::mat4 projection);
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <glm/gtc/type_ptr.hpp>
 #include "render/spheres.h"
+#include "compute/indirect.h"
 #include "util/wgpu_util.h"
 #include "physical_constants.h"
 
@@ -52,11 +53,11 @@ std::pair<std::vector<glm::f32vec3>, std::vector<glm::u32>> create_sphere_vertic
     return {vertices, indices};
 }
 
-SphereRender create_sphere_render(wgpu::Device& device) {
+SphereRender create_sphere_render(wgpu::Device& device, const ParticleBuffers& particleBuf) {
     SphereRender render = {};
     
     // Create render shader module
-    wgpu::ShaderModule renderShaderModule = create_shader_module(device, "shader/spheres.wgsl", {"kernel/physical_constants.wgsl"});
+    wgpu::ShaderModule renderShaderModule = create_shader_module(device, "shader/spheres.wgsl", {"kernel/species.wgsl"});
     if (!renderShaderModule) {
         std::cerr << "Failed to create sphere render shader module" << std::endl;
         exit(1);
@@ -96,19 +97,28 @@ SphereRender create_sphere_render(wgpu::Device& device) {
     render.uniformBuffer = device.CreateBuffer(&uniformBufferDesc);
 
     // Create render bind group layout
-    wgpu::BindGroupLayoutEntry renderBinding = {
-        .binding = 0,
-        .visibility = wgpu::ShaderStage::Vertex,
-        .buffer = {
-            .type = wgpu::BufferBindingType::Uniform,
-            .minBindingSize = sizeof(glm::mat4) * 2
+    std::vector<wgpu::BindGroupLayoutEntry> renderBindings = {
+        { // uniforms
+            .binding = 0,
+            .visibility = wgpu::ShaderStage::Vertex,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = sizeof(glm::mat4) * 2
+            }
+        }, { // speciesTable
+            .binding = 1,
+            .visibility = wgpu::ShaderStage::Vertex,
+            .buffer = {
+                .type = wgpu::BufferBindingType::Uniform,
+                .minBindingSize = SPECIES_TABLE_SIZE
+            }
         }
     };
 
     wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc = {
         .label = "Sphere Render Bind Group Layout",
-        .entryCount = 1,
-        .entries = &renderBinding
+        .entryCount = static_cast<uint32_t>(renderBindings.size()),
+        .entries = renderBindings.data()
     };
     render.bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
 
@@ -193,17 +203,24 @@ SphereRender create_sphere_render(wgpu::Device& device) {
     render.pipeline = device.CreateRenderPipeline(&pipelineDesc);
 
     // Create render bind group
-    wgpu::BindGroupEntry bindGroupEntry = {
-        .binding = 0,
-        .buffer = render.uniformBuffer,
-        .offset = 0,
-        .size = sizeof(glm::mat4) * 2
+    std::vector<wgpu::BindGroupEntry> bindGroupEntries = {
+        { // uniforms
+            .binding = 0,
+            .buffer = render.uniformBuffer,
+            .offset = 0,
+            .size = sizeof(glm::mat4) * 2
+        }, { // speciesTable
+            .binding = 1,
+            .buffer = particleBuf.species,
+            .offset = 0,
+            .size = SPECIES_TABLE_SIZE
+        }
     };
 
     wgpu::BindGroupDescriptor bindGroupDesc = {
         .layout = render.bindGroupLayout,
-        .entryCount = 1,
-        .entries = &bindGroupEntry
+        .entryCount = static_cast<uint32_t>(bindGroupEntries.size()),
+        .entries = bindGroupEntries.data()
     };
     render.bindGroup = device.CreateBindGroup(&bindGroupDesc);
 
@@ -238,4 +255,32 @@ void render_particles_as_spheres(
 
     // Draw the spheres (indexed, nParticles instances)
     pass.DrawIndexed(render.indexCount, nParticles, 0, 0, 0);
-}
\ No newline at end of file
+}
+
+void render_particles_as_spheres(
+    wgpu::Device& device,
+    wgpu::RenderPassEncoder& pass,
+    const ParticleBuffers& particleBuf,
+    const SphereRender& render,
+    const wgpu::Buffer& indirectArgs,
+    glm::mat4 view,
+    glm::mat4 projection)
+{
+    // Update uniform buffer with matrices
+    std::vector<glm::mat4> matrices = {view, projection};
+    device.GetQueue().WriteBuffer(render.uniformBuffer, 0, matrices.data(), sizeof(glm::mat4) * 2);
+
+    // Set the pipeline and bind group
+    pass.SetPipeline(render.pipeline);
+    pass.SetBindGroup(0, render.bindGroup);
+
+    // Set the vertex and index buffers (sphere geometry)
+    pass.SetVertexBuffer(0, render.vertexBuffer, 0, render.vertexBuffer.GetSize());
+    pass.SetIndexBuffer(render.indexBuffer, wgpu::IndexFormat::Uint32, 0, render.indexBuffer.GetSize());
+
+    // Set the instance buffer over every slot; the GPU count decides how many are drawn
+    pass.SetVertexBuffer(1, particleBuf.pos, 0, particleBuf.nMax * sizeof(glm::f32vec4));
+
+    // Draw the spheres (indexed, one instance per particle)
+    pass.DrawIndexedIndirect(indirectArgs, PARTICLE_SPHERE_DRAW_ARGS_OFFSET);
+}
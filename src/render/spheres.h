@@ -18,7 +18,8 @@ struct SphereRender {
     glm::u32 indexCount;
 };
 
-SphereRender create_sphere_render(wgpu::Device& device);
+// Colors each particle from the species table in particleBuf
+SphereRender create_sphere_render(wgpu::Device& device, const ParticleBuffers& particleBuf);
 
 void render_particles_as_spheres(
     wgpu::Device& device,
@@ -27,4 +28,14 @@ void render_particles_as_spheres(
     const SphereRender& render,
     glm::u32 nParticles,
     glm::mat4 view,
-    glm::mat4 projection);
\ No newline at end of file
+    glm::mat4 projection);
+
+// Same as above, with the instance count taken from the draw args in indirectArgs (see compute/indirect.h)
+void render_particles_as_spheres(
+    wgpu::Device& device,
+    wgpu::RenderPassEncoder& pass,
+    const ParticleBuffers& particleBuf,
+    const SphereRender& render,
+    const wgpu::Buffer& indirectArgs,
+    glm::mat4 view,
+    glm::mat4 projection);
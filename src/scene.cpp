@@ -2,6 +2,9 @@
 #include <iostream>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <string_view>
+#include <thread>
 #include <glm/gtc/matrix_transform.hpp>
 #include "shared/particles.h"
 #include "shared/fields.h"
@@ -10,16 +13,23 @@
 #include "render/particles.h"
 #include "render/fields.h"
 #include "render/tracers.h"
-#include "compute/particles.h"
-#include "compute/fields.h"
-#include "compute/tracers.h"
+#include "compute/fft.h"
+#include "compute/particle_init.h"
 #include "current_segment.h"
 #include "scene.h"
+#include "webgpu_backend.h"
+#include "cpu_backend.h"
 #include "free_space.h"
 #include "plasma.h"
 #include "mesh.h"
 #include "emscripten_key.h"
 
+// Initial plasma: half electrons, half protons
+const std::vector<SpeciesFraction> INITIAL_SPECIES = {
+    { ELECTRON, 0.5f },
+    { PROTON, 0.5f }
+};
+
 inline float rand_range(float min, float max) {
     return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (max - min) + min;
 }
@@ -38,23 +48,56 @@ void Scene::init_webgpu() {
 #endif
     instance = wgpu::CreateInstance(&instanceDesc);
 
-    wgpu::Future f1 = instance.RequestAdapter(
-        nullptr,
-        wgpu::CallbackMode::WaitAnyOnly,
-        [this](wgpu::RequestAdapterStatus status, wgpu::Adapter a, wgpu::StringView message) {
-            if (status != wgpu::RequestAdapterStatus::Success) {
-                std::cout << "RequestAdapter: " << message.data << "\n";
-                exit(0);
-            }
-            adapter = std::move(a);
-        });
-    instance.WaitAny(f1, UINT64_MAX);
+    auto request_adapter = [this](const wgpu::RequestAdapterOptions* options) {
+        wgpu::Future f = instance.RequestAdapter(
+            options,
+            wgpu::CallbackMode::WaitAnyOnly,
+            [this](wgpu::RequestAdapterStatus status, wgpu::Adapter a, wgpu::StringView message) {
+                if (status != wgpu::RequestAdapterStatus::Success) {
+                    std::cout << "RequestAdapter: " << message.data << "\n";
+                    return;
+                }
+                adapter = std::move(a);
+            });
+        instance.WaitAny(f, UINT64_MAX);
+    };
+    request_adapter(nullptr);
 
+    // Headless runs may land on machines without a GPU, so fall back to Dawn's CPU adapter (SwiftShader)
+    if (!adapter && headless) {
+        wgpu::RequestAdapterOptions fallbackOptions{.forceFallbackAdapter = true};
+        request_adapter(&fallbackOptions);
+    }
+    if (!adapter) {
+        std::cerr << "No WebGPU adapter available" << std::endl;
+        exit(1);
+    }
+
+    wgpu::AdapterInfo adapterInfo;
+    adapter.GetInfo(&adapterInfo);
+    std::cout << "Adapter: " << std::string_view(adapterInfo.device) << " (" << std::string_view(adapterInfo.description) << ")" << std::endl;
+
+    // Storage bindings up to 2GB, capped at what the adapter allows (the CPU adapter allows less)
+    wgpu::Limits supportedLimits;
+    adapter.GetLimits(&supportedLimits);
     wgpu::Limits limits;
-    limits.maxStorageBufferBindingSize = 2ull * 1024 * 1024 * 1024; // 2GB
+    limits.maxStorageBufferBindingSize = std::min<uint64_t>(2ull * 1024 * 1024 * 1024, supportedLimits.maxStorageBufferBindingSize);
 
     wgpu::DeviceDescriptor desc{};
     desc.requiredLimits = &limits;
+
+    // Timestamp queries let --profile time each kernel stage; without them the backend times whole submits
+    std::vector<wgpu::FeatureName> requiredFeatures;
+    if (profile) {
+        if (adapter.HasFeature(wgpu::FeatureName::TimestampQuery)) {
+            requiredFeatures.push_back(wgpu::FeatureName::TimestampQuery);
+            this->timestampQueries = true;
+        } else {
+            std::cout << "Adapter has no timestamp queries, profiling whole submits on the CPU clock" << std::endl;
+        }
+    }
+    desc.requiredFeatureCount = requiredFeatures.size();
+    desc.requiredFeatures = requiredFeatures.data();
     desc.SetUncapturedErrorCallback([](const wgpu::Device&, wgpu::ErrorType errorType, wgpu::StringView message) {
         std::cout << "Error: " << static_cast<uint32_t>(errorType) << " - message: " << message.data << "\n";
     });
@@ -63,13 +106,18 @@ void Scene::init_webgpu() {
         &desc, wgpu::CallbackMode::WaitAnyOnly,
         [this](wgpu::RequestDeviceStatus status, wgpu::Device d, wgpu::StringView message) {
             if (status != wgpu::RequestDeviceStatus::Success) {
-                std::cout << "RequestDevice: " << message.data << "\n";
-                exit(0);
+                std::cerr << "RequestDevice: " << std::string_view(message) << std::endl;
+                exit(1);
             }
             device = std::move(d);
         });
     instance.WaitAny(f2, UINT64_MAX);
 
+    // Compute-only runs need no window or swapchain
+    if (headless) {
+        return;
+    }
+
 #if defined(__EMSCRIPTEN__)
     wgpu::EmscriptenSurfaceSourceCanvasHTMLSelector src{{.selector = "#canvas"}};
     wgpu::SurfaceDescriptor surfaceDesc{.nextInChain = &src};
@@ -103,10 +151,31 @@ void Scene::init_webgpu() {
 }
 
 bool Scene::is_running() {
-    return !glfwWindowShouldClose(window);
+    if (steps_remaining() == 0) {
+        return false;
+    }
+    return headless || !glfwWindowShouldClose(window);
+}
+
+// Steps left before the --steps/--simTime limit, or UINT32_MAX when neither is set
+glm::u32 Scene::steps_remaining() {
+    glm::u32 remaining = UINT32_MAX;
+    if (maxSteps > 0) {
+        glm::u32 done = static_cast<glm::u32>(simulationStep);
+        remaining = std::min(remaining, maxSteps > done ? maxSteps - done : 0u);
+    }
+    if (maxSimTime > 0.0f) {
+        double left = std::ceil((static_cast<double>(maxSimTime) - t) / static_cast<double>(dt));
+        remaining = std::min(remaining, left > 0.0 ? static_cast<glm::u32>(std::min(left, static_cast<double>(UINT32_MAX))) : 0u);
+    }
+    return remaining;
 }
 
 void Scene::terminate() {
+    if (headless) {
+        print_run_summary();
+        return;
+    }
 #if !defined(__EMSCRIPTEN__)
     glfwDestroyWindow(window);
     glfwTerminate();
@@ -117,8 +186,41 @@ void Scene::init(const SimulationParams& params) {
     this->windowWidth = params.windowWidth;
     this->windowHeight = params.windowHeight;
     this->targetFPS = params.targetFPS;
+    this->tracerPointsPerFrame = params.tracerPointsPerFrame;
     this->dt = params.dt;
-    this->init_webgpu();
+    this->fieldSolver = params.fieldSolver;
+    this->fieldSolverIterations = params.fieldSolverIterations;
+    this->multigridCycles = params.multigridCycles;
+    this->openingAngle = params.openingAngle;
+    this->octreeInterval = params.octreeInterval;
+    this->fieldTextures = params.fieldTextures;
+    this->compactInterval = params.compactInterval;
+    this->compactDeadFraction = params.compactDeadFraction;
+    this->sortInterval = params.sortInterval;
+    this->stepsPerSubmit = std::max(1u, params.stepsPerSubmit);
+    this->headless = params.headless;
+    this->maxSteps = params.steps;
+    this->maxSimTime = params.simTime;
+    this->profile = params.profile;
+    this->profileCsv = params.profileCsv;
+    this->deviceless = headless && params.backend == BACKEND_CPU;
+    if (!deviceless) {
+        this->init_webgpu();
+    }
+
+    if (profile) {
+        this->profileLog.open(profileCsv);
+        if (!profileLog) {
+            std::cerr << "Failed to open " << profileCsv << std::endl;
+            exit(1);
+        }
+        profileLog << "step,t,kernel,avg_ms,samples" << std::endl;
+    }
+
+    // The scene's default solver decides how its mesh is laid out
+    if (this->fieldSolver == FIELD_SOLVER_AUTO) {
+        this->fieldSolver = default_field_solver();
+    }
 
     // Initialize cells
     this->cells = get_mesh_cells(glm::f32vec3(params.cellSpacing), this->mesh);
@@ -129,40 +231,89 @@ void Scene::init(const SimulationParams& params) {
         cellBoxesVisible.push_back(cell.pos.w > 0.0f);
         if (cell.pos.w > 0.0f) activeCells++;
     }
-    std::cout << "Simulation cells: " << cells.size() << " (active: " << activeCells << ")" << std::endl;
+    std::cout << "Simulation cells: " << cells.size() << " (active: " << activeCells << "), spacing " << mesh.cell_size.x << " m" << std::endl;
+
+    // The GPU FFT is limited in line length, which is only known once the mesh is
+    if (this->fieldSolver == FIELD_SOLVER_FFT && !fft_gpu_supported(mesh)) {
+        std::cout << "Mesh lines exceed " << FFT_MAX_LINE << " cells, using the CPU FFT" << std::endl;
+        this->fieldSolver = FIELD_SOLVER_FFT_CPU;
+    }
+#if defined(__EMSCRIPTEN__)
+    this->cpuThreads = 1;
+#else
+    this->cpuThreads = std::max(1u, std::thread::hardware_concurrency());
+#endif
 
     // Initialize axes
-    this->axes = create_axes_buffers(device);
+    if (!deviceless) {
+        this->axes = create_axes_buffers(device);
+    }
     this->cameraDistance = 0.5f * _M;
 
-    // Initialize particles
+    // Initialize particles. The GPU draws its own; the CPU backend draws them across its threads straight into the
+    // mapped render buffers and keeps a host copy, or only the host copy when there is nothing to render.
     this->nParticles = params.initialParticles;
-	this->particles = create_particle_buffers(
-        device,
-        [this](){ return rand_particle_position(); },
-        [&params](PARTICLE_SPECIES species){ return maxwell_boltzmann_particle_velocty(params.initialTemperature, particle_mass(species)); },
-        [](){ return rand_particle_species(0.0f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f); },
-        params.initialParticles,
-        params.maxParticles);
-    this->particleRender = create_particle_render(device);
-    this->sphereRender = create_sphere_render(device);
-
-    // Initialize field vectors
-    std::vector<glm::f32vec4> eFieldLoc, eFieldVec;
-    std::vector<glm::f32vec4> bFieldLoc, bFieldVec;
-    for (auto& cell : cells) {
-        eFieldLoc.push_back(glm::f32vec4(cell.pos.x, cell.pos.y, cell.pos.z, 0.0f)); // Last element indicates E vs B
-        eFieldVec.push_back(glm::f32vec4(1.0f, 0.0f, 0.0f, 0.0f));  // initial (meaningless) value
-        bFieldLoc.push_back(glm::f32vec4(cell.pos.x, cell.pos.y, cell.pos.z, 1.0f)); // Last element indicates E vs B
-        bFieldVec.push_back(glm::f32vec4(-1.0f, 1.0f, 0.0f, 0.0f)); // initial (meaningless) value
-    }
-    this->fields = create_fields_buffers(device, cells.size());
-    this->eFieldRender = create_fields_render(device, eFieldLoc, eFieldVec, params.cellSpacing / 2.0f);
-    this->bFieldRender = create_fields_render(device, bFieldLoc, bFieldVec, params.cellSpacing / 2.0f);
+    this->seed = params.seed != 0 ? params.seed : static_cast<glm::u64>(std::chrono::system_clock::now().time_since_epoch().count());
+    std::cout << "Particle seed: " << seed << std::endl;
+    std::vector<glm::f32vec4> particlePos, particleVel;
+    auto generate_particles = [&](glm::f32vec4* pos, glm::f32vec4* vel) {
+        generate_initial_particles(
+            pos,
+            vel,
+            params.initialParticles,
+            particle_distribution(),
+            INITIAL_SPECIES,
+            params.initialTemperature,
+            seed,
+            cpuThreads);
+    };
+    if (deviceless) {
+        particlePos.resize(params.maxParticles, glm::f32vec4(0.0f));
+        particleVel.resize(params.maxParticles, glm::f32vec4(0.0f));
+        generate_particles(particlePos.data(), particleVel.data());
+    } else if (params.backend == BACKEND_CPU) {
+        this->particles = create_particle_buffers(
+            device,
+            params.maxParticles,
+            params.initialParticles,
+            [&](glm::f32vec4* pos, glm::f32vec4* vel) {
+                generate_particles(pos, vel);
+                particlePos.assign(pos, pos + params.maxParticles);
+                particleVel.assign(vel, vel + params.maxParticles);
+            });
+    } else {
+        this->particles = allocate_particle_buffers(device, params.maxParticles, params.initialParticles);
+        ParticleInitCompute particleInit = create_particle_init_compute(device, particles, params.maxParticles);
+        run_particle_init_compute(
+            device,
+            particleInit,
+            particle_distribution(),
+            INITIAL_SPECIES,
+            params.initialTemperature,
+            seed,
+            params.initialParticles);
+    }
+    if (!deviceless) {
+        this->particleRender = create_particle_render(device, particles);
+        this->sphereRender = create_sphere_render(device, particles);
+
+        // Initialize field vectors
+        std::vector<glm::f32vec4> eFieldLoc, eFieldVec;
+        std::vector<glm::f32vec4> bFieldLoc, bFieldVec;
+        for (auto& cell : cells) {
+            eFieldLoc.push_back(glm::f32vec4(cell.pos.x, cell.pos.y, cell.pos.z, 0.0f)); // Last element indicates E vs B
+            eFieldVec.push_back(glm::f32vec4(1.0f, 0.0f, 0.0f, 0.0f));  // initial (meaningless) value
+            bFieldLoc.push_back(glm::f32vec4(cell.pos.x, cell.pos.y, cell.pos.z, 1.0f)); // Last element indicates E vs B
+            bFieldVec.push_back(glm::f32vec4(-1.0f, 1.0f, 0.0f, 0.0f)); // initial (meaningless) value
+        }
+        this->fields = create_fields_buffers(device, cells.size());
+        this->eFieldRender = create_fields_render(device, eFieldLoc, eFieldVec, mesh.cell_size.x / 2.0f);
+        this->bFieldRender = create_fields_render(device, bFieldLoc, bFieldVec, mesh.cell_size.x / 2.0f);
 
-    // Initialize cell boxes
-    this->cellBoxes = create_cell_box_buffers(device, cells, params.cellSpacing);
-    update_cell_visibility(device, cellBoxes, cells, cellBoxesVisible);
+        // Initialize cell boxes
+        this->cellBoxes = create_cell_box_buffers(device, cells, mesh.cell_size.x);
+        update_cell_visibility(device, cellBoxes, cells, cellBoxesVisible);
+    }
 
     // Initialize tracers
     std::vector<glm::f32vec4> tracerLoc;
@@ -174,22 +325,84 @@ void Scene::init(const SimulationParams& params) {
             tracerLoc.push_back(glm::f32vec4(cells[i].pos.x, cells[i].pos.y, cells[i].pos.z, 0.0f));
         }
     }
-    this->tracers = create_tracer_buffers(device, tracerLoc);
-    this->eTracerRender = create_tracer_render(device);
-    this->bTracerRender = create_tracer_render(device);
+    if (!deviceless) {
+        this->tracers = create_tracer_buffers(device, tracerLoc);
+        this->eTracerRender = create_tracer_render(device);
+        this->bTracerRender = create_tracer_render(device);
+    }
 
     // Initialize currents
     this->cachedCurrents = get_currents();
-	this->currentSegmentsBuffer = get_current_segment_buffer(device, this->cachedCurrents);
 
-    // Initialize particle compute
-	this->particleCompute = create_particle_pic_compute(device, cells, particles, fields, params.maxParticles);
+    // Initialize the indirect args that follow the GPU particle count
+    if (!deviceless) {
+        this->particleIndirect = create_particle_indirect_compute(device, particles, params.initialParticles, sphereRender.indexCount);
+    }
 
-    // Initialize field compute    
-    this->fieldCompute = create_field_compute(device, cells, particles, fields, this->currentSegmentsBuffer, static_cast<glm::u32>(this->cachedCurrents.size()), params.maxParticles);
+    // Hand the initial state to the backend that steps it
+    BackendInit backendInit = {
+        .device = device,
+        .instance = instance,
+        .particles = particles,
+        .fields = fields,
+        .tracers = tracers,
+        .particleIndirect = particleIndirect,
+        .cells = cells,
+        .mesh = mesh,
+        .particlePos = std::move(particlePos),
+        .particleVel = std::move(particleVel),
+        .initialParticles = params.initialParticles,
+        .tracerLoc = std::move(tracerLoc),
+        .currents = cachedCurrents,
+        .wall = wall_parameters(),
+        .dt = dt,
+        .fieldSolver = fieldSolver,
+        .fieldSolverIterations = fieldSolverIterations,
+        .multigridCycles = multigridCycles,
+        .openingAngle = openingAngle,
+        .octreeInterval = octreeInterval,
+        .fieldTextures = fieldTextures,
+        .compactInterval = compactInterval,
+        .compactDeadFraction = compactDeadFraction,
+        .sortInterval = sortInterval,
+        .stepsPerSubmit = stepsPerSubmit,
+        .cpuThreads = cpuThreads,
+        .profile = profile,
+        .timestampQueries = timestampQueries
+    };
+    if (params.backend == BACKEND_CPU) {
+        this->simulation = std::make_unique<CpuBackend>();
+    } else {
+        this->simulation = std::make_unique<WebGpuBackend>();
+    }
+    this->simulation->allocate(backendInit);
+
+    this->runStart = std::chrono::steady_clock::now();
+}
 
-    // Initialize tracer compute
-    this->tracerCompute = create_tracer_compute(device, tracers, particles, this->currentSegmentsBuffer, static_cast<glm::u32>(this->cachedCurrents.size()), params.maxParticles);
+// Waits for the last submitted step and prints how long the run took
+void Scene::print_run_summary() {
+    BackendDiagnostics diagnostics = simulation->read_diagnostics();
+    this->nParticles = diagnostics.nParticles;
+
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+    std::cout << "RUN COMPLETE " << simulationStep << " steps, t = " << t << " s" << std::endl;
+    std::cout << "  wall time: " << wallSeconds << " s (" << simulationStep / wallSeconds << " steps/s, "
+              << 1e3 * wallSeconds / std::max(1, simulationStep) << " ms/step)" << std::endl;
+    std::cout << "  particles: " << nParticles << std::endl;
+    this->log_kernel_timings(simulationStep, diagnostics);
+}
+
+// Prints the rolling per-stage averages and appends them to the profile CSV
+void Scene::log_kernel_timings(int step, const BackendDiagnostics& diagnostics) {
+    if (!profile) return;
+
+    for (const KernelTiming& timing : diagnostics.kernelTimings) {
+        const char* name = profiled_stage_name(timing.stage);
+        std::cout << "  " << name << ": " << timing.averageMs << " ms (" << timing.samples << " samples)" << std::endl;
+        profileLog << step << "," << t << "," << name << "," << timing.averageMs << "," << timing.samples << "\n";
+    }
+    profileLog.flush();
 }
 
 glm::mat4 Scene::get_orbit_view_matrix() {
@@ -213,6 +426,11 @@ bool debounce_input() {
 }
 
 void Scene::run_once() {
+    if (headless) {
+        compute();
+        return;
+    }
+
     auto now = std::chrono::high_resolution_clock::now();
 
     // Render a frame
@@ -232,6 +450,12 @@ void Scene::render() {
     this->process_input(debounce_input);
     poll_events(device, false);
 
+    // Tracers are only drawn, so they advance once a frame rather than with every step
+    if (this->showETracers || this->showBTracers) {
+        this->simulation->trace(tracerPointsPerFrame, step_inputs());
+    }
+    this->simulation->sync_render_buffers();
+
     wgpu::SurfaceTexture surfaceTexture;
     surface.GetCurrentTexture(&surfaceTexture);
 
@@ -289,9 +513,9 @@ void Scene::render_details(wgpu::RenderPassEncoder& pass) {
     if (this->showAxes)      render_axes(device, pass, axes, view, projection);
     if (this->showParticles) {
         if (this->renderParticlesAsSpheres) {
-            render_particles_as_spheres(device, pass, particles, sphereRender, nParticles, view, projection);
+            render_particles_as_spheres(device, pass, particles, sphereRender, particleIndirect.argsBuffer, view, projection);
         } else {
-            render_particles(device, pass, particles, particleRender, nParticles, view, projection);
+            render_particles(device, pass, particles, particleRender, particleIndirect.argsBuffer, view, projection);
         }
     }
     if (this->showEField)    render_fields(device, pass, eFieldRender, fields.eField, cells.size(), view, projection);
@@ -305,63 +529,58 @@ void Scene::compute() {
     // Update currents in scene
     if (this->refreshCurrents) {
         this->cachedCurrents = get_currents();
-        update_currents_buffer(device, this->currentSegmentsBuffer, this->cachedCurrents);
+        simulation->set_currents(this->cachedCurrents);
         this->refreshCurrents = false;
     }
 
-    wgpu::CommandEncoderDescriptor encoderDesc{.label = "Compute Command Encoder"};
-    wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&encoderDesc);
-    wgpu::ComputePassDescriptor computePassDesc{.label = "Compute Pass"};
-    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&computePassDesc);
-
-    this->compute_field_step(pass);
-
-    run_particle_pic_compute(
-        device,
-        pass,
-        particleCompute,
-        mesh,
-        dt,
-        enableParticleFieldContributions,
-        nParticles);
-
-    this->compute_wall_interactions(pass);
-
-    pass.End();
-    
-    encoder.CopyBufferToBuffer(particles.nCur, 0, particleCompute.nParticlesReadBuf, 0, sizeof(glm::u32));
-    encoder.CopyBufferToBuffer(particleCompute.debugStorageBuf, 0, particleCompute.debugReadBuf, 0, 10 * sizeof(glm::f32vec4));
-    encoder.CopyBufferToBuffer(tracerCompute.eDebugStorageBuf, 0, tracerCompute.eDebugReadBuf, 0, 10 * sizeof(glm::f32vec4));
-    encoder.CopyBufferToBuffer(tracerCompute.bDebugStorageBuf, 0, tracerCompute.bDebugReadBuf, 0, 10 * sizeof(glm::f32vec4));
+    glm::u32 nSteps = std::min(stepsPerSubmit, steps_remaining());
+    simulation->step(nSteps, step_inputs());
 
-    wgpu::CommandBuffer commands = encoder.Finish();
-    device.GetQueue().Submit(1, &commands);
-
-    // std::vector<glm::f32vec4> debug;
-    // read_particles_debug(device, instance, particleCompute, debug, 1000);
+    int logStep = -1;
+    for (glm::u32 i = 0; i < nSteps; i++) {
+        if (simulationStep % 5000 == 0) logStep = simulationStep;
+        simulationStep++;
+        t += dt;
+    }
 
-    if (simulationStep % 5000 == 0) {
-        std::cout << "SIM STEP " << simulationStep << " (frame " << frameCount << ") [" << nParticles << " particles]" << std::endl;
+    // The log line takes whatever diagnostics have already come back rather than waiting on the GPU
+    if (logStep >= 0) {
+        BackendDiagnostics diagnostics = simulation->poll_diagnostics();
+        this->nParticles = diagnostics.nParticles;
+        std::cout << "SIM STEP " << logStep << " (frame " << frameCount << ") [" << nParticles << " particles]" << std::endl;
+        this->log_kernel_timings(logStep, diagnostics);
     }
-    simulationStep++;
+}
+
+// Inputs the backend steps and traces with, as the scene stands now
+StepInputs Scene::step_inputs() {
+    return StepInputs{
+        .dt = dt,
+        .solenoidFlux = solenoid_flux(),
+        .enableParticleFieldContributions = enableParticleFieldContributions
+    };
+}
 
-    t += dt;
+// Solver used when none is requested explicitly
+FieldSolver Scene::default_field_solver() {
+    return FIELD_SOLVER_JACOBI;
 }
 
-void Scene::compute_field_step(wgpu::ComputePassEncoder& pass) {
-    throw std::runtime_error("compute_field_step not implemented for base Scene class");
+// Flux through the central solenoid, V s
+glm::f32 Scene::solenoid_flux() {
+    return 0.0f;
 }
 
-void Scene::compute_wall_interactions(wgpu::ComputePassEncoder& pass) {
-    throw std::runtime_error("compute_wall_interactions not implemented for base Scene class");
+WallParameters Scene::wall_parameters() {
+    throw std::runtime_error("wall_parameters not implemented for base Scene class");
 }
 
 std::vector<Cell> Scene::get_mesh_cells(glm::f32vec3 size, MeshProperties& mesh) {
     throw std::runtime_error("get_mesh_cells not implemented for base Scene class");
 }
 
-glm::f32vec4 Scene::rand_particle_position() {
-    throw std::runtime_error("rand_particle_position not implemented for base Scene class");
+ParticleDistribution Scene::particle_distribution() {
+    throw std::runtime_error("particle_distribution not implemented for base Scene class");
 }
 
 std::vector<CurrentVector> Scene::get_currents() {
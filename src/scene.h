@@ -1,6 +1,10 @@
 #pragma once
 
 #define _USE_MATH_DEFINES
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
 #include <glm/glm.hpp>
 #include <webgpu/webgpu_cpp.h>
 #include "util/wgpu_util.h"
@@ -13,9 +17,8 @@
 #include "render/spheres.h"
 #include "render/fields.h"
 #include "render/tracers.h"
-#include "compute/particles.h"
-#include "compute/fields.h"
-#include "compute/tracers.h"
+#include "compute/indirect.h"
+#include "simulation_backend.h"
 #include "current_segment.h"
 #include "mesh.h"
 #include "args.h"
@@ -35,10 +38,11 @@ public:
     void compute();
     void terminate();
     bool is_running();
+    glm::u32 steps_remaining();
 
     // Scene-dependent functions
     virtual std::vector<Cell> get_mesh_cells(glm::f32vec3 spacing, MeshProperties& mesh);
-    virtual glm::f32vec4 rand_particle_position();
+    virtual ParticleDistribution particle_distribution();
     virtual std::vector<CurrentVector> get_currents();
     virtual bool process_input(bool (*debounce_input)());
 
@@ -62,8 +66,10 @@ public:
 
 protected:
     virtual void render_details(wgpu::RenderPassEncoder& pass);
-    virtual void compute_field_step(wgpu::ComputePassEncoder& pass);
-    virtual void compute_wall_interactions(wgpu::ComputePassEncoder& pass);
+    virtual glm::f32 solenoid_flux();
+    virtual WallParameters wall_parameters();
+    virtual FieldSolver default_field_solver();
+    StepInputs step_inputs();
 
     bool refreshCurrents = false;
     
@@ -79,21 +85,44 @@ protected:
     MeshProperties mesh;
 
     // Physics state variables
-    glm::f32 t = 0.0f * _S;    // Simulation time, s
+    glm::f64 t = 0.0 * _S;     // Simulation time, s; double so t += dt is not rounded away at small dt
     glm::f32 dt = 1e-12f * _S;  // Simulation dt, s
     bool enableParticleFieldContributions = false;
-
-    // Compute buffers
+    FieldSolver fieldSolver = FIELD_SOLVER_JACOBI;
+    glm::u32 fieldSolverIterations = 16;
+    glm::u32 multigridCycles = 1;
+    glm::f32 openingAngle = 0.5f;       // Barnes-Hut opening angle for the exact solver, 0 sums directly
+    glm::u32 octreeInterval = 1;        // Steps between octree rebuilds for the exact solver
+    bool fieldTextures = false;         // The GPU push and tracers read the fields from 3D textures
+    glm::u32 cpuThreads = 1;
+    glm::u32 compactInterval = 1000;    // Steps between compaction checks, 0 disables
+    glm::f32 compactDeadFraction = 0.25f;
+    glm::u32 sortInterval = 0;          // Steps between sorts of the particles by cell, 0 disables
+    glm::u32 stepsPerSubmit = 1;        // Steps handed to the backend per compute()
+
+    // Run limits and timing
+    bool headless = false;              // No window, surface, rendering or input
+    bool deviceless = false;            // Headless on the CPU backend: no WebGPU device or buffers at all
+    glm::u32 maxSteps = 0;              // Stop after this many steps, 0 for no limit
+    glm::f32 maxSimTime = 0.0f;         // Stop once t reaches this, 0 for no limit
+    std::chrono::steady_clock::time_point runStart;
+
+    // Kernel profiling
+    bool profile = false;               // Log rolling per-stage timings alongside SIM STEP
+    bool timestampQueries = false;      // The device has TimestampQuery enabled
+    std::string profileCsv;
+    std::ofstream profileLog;
+
+    // Simulation state, stepped by the backend and drawn by the render passes
+    std::unique_ptr<SimulationBackend> simulation;
     ParticleBuffers particles;
-    ParticleCompute particleCompute;
-    FieldCompute fieldCompute;
     TracerBuffers tracers;
-    TracerCompute tracerCompute;
-    glm::u32 nParticles;
+    ParticleIndirectCompute particleIndirect; // Dispatch/draw args built from the GPU particle count
+    glm::u32 nParticles;                      // Particle count as of the last readback (logging only)
+    glm::u64 seed = 0;                        // Initial particle RNG seed
 
     // Currents
     std::vector<CurrentVector> cachedCurrents;
-    wgpu::Buffer currentSegmentsBuffer;
 
     // WebGPU objects
     wgpu::Instance instance;
@@ -107,9 +136,15 @@ protected:
     glm::u32 windowWidth = 1024;
     glm::u32 windowHeight = 768;
     float targetFPS = 60.0f;
+    glm::u32 tracerPointsPerFrame = 8; // Tracer trail points computed per rendered frame
+
+    // Field buffers
+    FieldBuffers fields;
 
 private:
     void init_webgpu();
+    void print_run_summary();
+    void log_kernel_timings(int step, const BackendDiagnostics& diagnostics);
     glm::mat4 get_orbit_view_matrix();
 
     // Particles
@@ -117,7 +152,6 @@ private:
     SphereRender sphereRender;
     
     // Field vectors
-    FieldBuffers fields;
     FieldRender eFieldRender;
     FieldRender bFieldRender;
 
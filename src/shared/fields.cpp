@@ -7,7 +7,7 @@ FieldBuffers create_fields_buffers(wgpu::Device& device, glm::u32 nCells) {
 
     wgpu::BufferDescriptor eFieldDesc = {
         .label = "Electric Field Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
         .size = nCells * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
@@ -15,11 +15,35 @@ FieldBuffers create_fields_buffers(wgpu::Device& device, glm::u32 nCells) {
 
     wgpu::BufferDescriptor bFieldDesc = {
         .label = "Magnetic Field Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
         .size = nCells * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
     fieldBuf.bField = device.CreateBuffer(&bFieldDesc);
 
+    wgpu::BufferDescriptor rhoDesc = {
+        .label = "Charge Density Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32),
+        .mappedAtCreation = false
+    };
+    fieldBuf.rho = device.CreateBuffer(&rhoDesc);
+
+    wgpu::BufferDescriptor currentDesc = {
+        .label = "Current Density Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fieldBuf.current = device.CreateBuffer(&currentDesc);
+
+    wgpu::BufferDescriptor potentialDesc = {
+        .label = "Potential Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
+        .size = nCells * sizeof(glm::f32vec4),
+        .mappedAtCreation = false
+    };
+    fieldBuf.potential = device.CreateBuffer(&potentialDesc);
+
     return fieldBuf;
 }
\ No newline at end of file
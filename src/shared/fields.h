@@ -6,7 +6,10 @@
 struct FieldBuffers {
     wgpu::Buffer eField;    // Electric field
     wgpu::Buffer bField;    // Magnetic field
+    wgpu::Buffer rho;       // Charge density deposited from particles, C/m^3
+    wgpu::Buffer current;   // Current density deposited from particles [Jx, Jy, Jz, unused], A/m^2
+    wgpu::Buffer potential; // Potentials solved from rho and current [Ax, Ay, Az, phi]
     glm::u32 nCells;        // Number of cells
 };
 
-FieldBuffers create_fields_buffers(wgpu::Device& device, glm::u32 nCells);
\ No newline at end of file
+FieldBuffers create_fields_buffers(wgpu::Device& device, glm::u32 nCells);
@@ -1,45 +1,26 @@
 #include <iostream>
 #include <webgpu/webgpu_cpp.h>
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <vector>
 #include <functional>
 #include "physical_constants.h"
 #include "particles.h"
 
-ParticleBuffers create_particle_buffers(
-    wgpu::Device& device,
-    std::function<glm::f32vec4()> posF,
-    std::function<glm::f32vec4(PARTICLE_SPECIES)> velF,
-    std::function<PARTICLE_SPECIES()> speciesF,
-    glm::u32 initialParticles,
-    glm::u32 maxParticles
-) {
-    ParticleBuffers buf = {.nMax = maxParticles};
-    std::vector<glm::f32vec4> position_and_type;
-    std::vector<glm::f32vec4> velocity;
-
-    srand(static_cast<unsigned int>(time(0)));
-    for (int i = 0; i < maxParticles; ++i) {
-        if (i < initialParticles) {
-            PARTICLE_SPECIES species = speciesF();
-            glm::f32vec4 pos = posF();
-            glm::f32vec4 vel = velF(species);
-
-            pos[3] = (float)species;
-
-            // [x, y, z, species]
-            position_and_type.push_back(pos);
-            // [dx, dy, dz, unused]
-            velocity.push_back(vel);
-        } else {
-            // Placeholders for future particles that may be created via collisions
+wgpu::Buffer create_species_buffer(wgpu::Device& device) {
+    wgpu::BufferDescriptor speciesDesc = {
+        .label = "Species Table Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = SPECIES_TABLE_SIZE,
+        .mappedAtCreation = false
+    };
+    wgpu::Buffer buffer = device.CreateBuffer(&speciesDesc);
+    device.GetQueue().WriteBuffer(buffer, 0, species_table(), SPECIES_TABLE_SIZE);
+    return buffer;
+}
 
-            // [x, y, z, species]
-            position_and_type.push_back(glm::f32vec4 { 0.0f, 0.0f, 0.0f, 0.0f });
-            // [dx, dy, dz, unused]
-            velocity.push_back(glm::f32vec4 { 0.0f, 0.0f, 0.0f, 0.0f });
-        }
-    }
+static ParticleBuffers make_particle_buffers(wgpu::Device& device, glm::u32 maxParticles, glm::u32 initialParticles, bool mapped) {
+    ParticleBuffers buf = {.nMax = maxParticles};
 
     // Current number of particles
     wgpu::BufferDescriptor nCurDesc = {
@@ -54,22 +35,84 @@ ParticleBuffers create_particle_buffers(
     // Particle position buffer
     wgpu::BufferDescriptor posDesc = {
         .label = "Particle Position Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage | wgpu::BufferUsage::Vertex,
         .size = maxParticles * sizeof(glm::f32vec4),
-        .mappedAtCreation = false
+        .mappedAtCreation = mapped
     };
     buf.pos = device.CreateBuffer(&posDesc);
-    device.GetQueue().WriteBuffer(buf.pos, 0, position_and_type.data(), position_and_type.size() * sizeof(glm::f32vec4));
 
     // Particle velocity buffer
     wgpu::BufferDescriptor velDesc = {
         .label = "Particle Velocity Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Storage,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Storage,
         .size = maxParticles * sizeof(glm::f32vec4),
-        .mappedAtCreation = false
+        .mappedAtCreation = mapped
     };
     buf.vel = device.CreateBuffer(&velDesc);
-    device.GetQueue().WriteBuffer(buf.vel, 0, velocity.data(), velocity.size() * sizeof(glm::f32vec4));
+
+    buf.species = create_species_buffer(device);
 
     return buf;
-}
\ No newline at end of file
+}
+
+ParticleBuffers allocate_particle_buffers(wgpu::Device& device, glm::u32 maxParticles, glm::u32 initialParticles) {
+    return make_particle_buffers(device, maxParticles, initialParticles, false);
+}
+
+ParticleBuffers create_particle_buffers(
+    wgpu::Device& device,
+    glm::u32 maxParticles,
+    glm::u32 initialParticles,
+    const std::function<void(glm::f32vec4* pos, glm::f32vec4* vel)>& fill
+) {
+    ParticleBuffers buf = make_particle_buffers(device, maxParticles, initialParticles, true);
+
+    // Mapped ranges start zeroed, so only the slots fill writes need touching and nothing is staged on the host
+    fill(
+        static_cast<glm::f32vec4*>(buf.pos.GetMappedRange(0, maxParticles * sizeof(glm::f32vec4))),
+        static_cast<glm::f32vec4*>(buf.vel.GetMappedRange(0, maxParticles * sizeof(glm::f32vec4))));
+    buf.pos.Unmap();
+    buf.vel.Unmap();
+
+    return buf;
+}
+
+ParticleBuffers create_particle_buffers(
+    wgpu::Device& device,
+    const std::vector<glm::f32vec4>& position_and_type,
+    const std::vector<glm::f32vec4>& velocity,
+    glm::u32 initialParticles
+) {
+    return create_particle_buffers(
+        device,
+        static_cast<glm::u32>(position_and_type.size()),
+        initialParticles,
+        [&](glm::f32vec4* pos, glm::f32vec4* vel) {
+            std::copy(position_and_type.begin(), position_and_type.end(), pos);
+            std::copy(velocity.begin(), velocity.end(), vel);
+        });
+}
+
+ParticleBuffers create_particle_buffers(
+    wgpu::Device& device,
+    std::function<glm::f32vec4()> posF,
+    std::function<glm::f32vec4(PARTICLE_SPECIES)> velF,
+    std::function<PARTICLE_SPECIES()> speciesF,
+    glm::u32 initialParticles,
+    glm::u32 maxParticles
+) {
+    return create_particle_buffers(
+        device,
+        maxParticles,
+        initialParticles,
+        [&](glm::f32vec4* pos, glm::f32vec4* vel) {
+            for (glm::u32 i = 0; i < initialParticles; i++) {
+                PARTICLE_SPECIES species = speciesF();
+                // [x, y, z, species]
+                pos[i] = posF();
+                pos[i][3] = (float)species;
+                // [dx, dy, dz, unused]
+                vel[i] = velF(species);
+            }
+        });
+}
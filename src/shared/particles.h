@@ -2,20 +2,66 @@
 
 #include <webgpu/webgpu_cpp.h>
 #include <functional>
+#include <vector>
 #include <glm/glm.hpp>
 #include "physical_constants.h"
 
 struct ParticleBuffers {
-    wgpu::Buffer nCur;   // Current number of particles
-    wgpu::Buffer pos;    // Particle positions
-    wgpu::Buffer vel;    // Particle velocities
-    glm::u32 nMax;       // Maximum number of particles
+    wgpu::Buffer nCur;    // Current number of particles
+    wgpu::Buffer pos;     // Particle positions
+    wgpu::Buffer vel;     // Particle velocities
+    wgpu::Buffer species; // Species table the kernels and renderers look pos.w up in
+    glm::u32 nMax;        // Maximum number of particles
 };
 
+// Size of the species table uniform, MAX_SPECIES rows of SpeciesInfo
+const glm::u64 SPECIES_TABLE_SIZE = MAX_SPECIES * sizeof(SpeciesInfo);
+
+// How initial particles are spread through the scene
+enum ParticleDistributionType : glm::u32 {
+    DISTRIBUTION_BOX = 0,        // Uniform in (x, y, z) over [min, max]
+    DISTRIBUTION_CYLINDRICAL = 1 // Uniform in (r, y, theta) over [min, max], theta about the y axis from +z
+};
+
+struct ParticleDistribution {
+    ParticleDistributionType type = DISTRIBUTION_BOX;
+    glm::f32vec3 min = glm::f32vec3(0.0f);
+    glm::f32vec3 max = glm::f32vec3(0.0f);
+};
+
+// Relative share of the initial particles drawn as species
+struct SpeciesFraction {
+    PARTICLE_SPECIES species;
+    glm::f32 parts;
+};
+
+// Uploads species_table() as a uniform buffer
+wgpu::Buffer create_species_buffer(wgpu::Device& device);
+
+// Allocates maxParticles empty slots (WebGPU zero-fills new buffers) with nCur set to initialParticles, for the
+// particles to be written on the GPU
+ParticleBuffers allocate_particle_buffers(wgpu::Device& device, glm::u32 maxParticles, glm::u32 initialParticles);
+
+// Creates maxParticles slots mapped at creation and has fill write them in place: pos as [x, y, z, species] and
+// vel as [vx, vy, vz, unused]. Slots fill leaves alone stay empty (species 0).
+ParticleBuffers create_particle_buffers(
+    wgpu::Device& device,
+    glm::u32 maxParticles,
+    glm::u32 initialParticles,
+    const std::function<void(glm::f32vec4* pos, glm::f32vec4* vel)>& fill);
+
+// Uploads particles laid out as above, with pos.size() slots
+ParticleBuffers create_particle_buffers(
+    wgpu::Device& device,
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::u32 initialParticles);
+
+// Draws the first initialParticles slots one at a time from the given distributions
 ParticleBuffers create_particle_buffers(
     wgpu::Device& device,
     std::function<glm::f32vec4()> posF,
     std::function<glm::f32vec4(PARTICLE_SPECIES)> velF,
     std::function<PARTICLE_SPECIES()> speciesF,
     glm::u32 initialParticles,
-    glm::u32 maxParticles);
\ No newline at end of file
+    glm::u32 maxParticles);
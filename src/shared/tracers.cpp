@@ -16,7 +16,7 @@ TracerBuffers create_tracer_buffers(wgpu::Device& device, const std::vector<glm:
     // Create E field tracer buffer
     wgpu::BufferDescriptor eBufferDesc = {
         .label = "E Tracer Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage,
         .size = tracerTrails.size() * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
@@ -26,7 +26,7 @@ TracerBuffers create_tracer_buffers(wgpu::Device& device, const std::vector<glm:
     // Create B field tracer buffer
     wgpu::BufferDescriptor bBufferDesc = {
         .label = "B Tracer Buffer",
-        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage,
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage,
         .size = tracerTrails.size() * sizeof(glm::f32vec4),
         .mappedAtCreation = false
     };
@@ -23,6 +23,10 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: initialParticles > maxParticles" << std::endl;
         return 1;
     }
+    if (params.headless && params.steps == 0 && params.simTime <= 0.0f) {
+        std::cerr << "Error: --headless needs --steps or --simTime" << std::endl;
+        return 1;
+    }
 
 #ifdef __EMSCRIPTEN__
     // Initialize the Scene
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include "simulation_backend.h"
+
+void SimulationBackend::set_currents(const std::vector<CurrentVector>& currents) {
+    this->currents = currents;
+    this->refreshExternalFields = true;
+    this->fieldInputsChanged = true;
+}
+
+// Backends that hold their state on the host can answer immediately
+BackendDiagnostics SimulationBackend::poll_diagnostics() {
+    return read_diagnostics();
+}
+
+void SimulationBackend::schedule_stages(const StepInputs& inputs, bool& runFieldStage) {
+    if (inputs.solenoidFlux != this->lastSolenoidFlux || inputs.enableParticleFieldContributions != this->lastParticleFieldContributions) {
+        this->lastSolenoidFlux = inputs.solenoidFlux;
+        this->lastParticleFieldContributions = inputs.enableParticleFieldContributions;
+        this->fieldInputsChanged = true;
+    }
+
+    // A trail is TRACER_LENGTH points long, so that many points after a change every point has been retraced
+    if (this->fieldInputsChanged) {
+        this->tracerPointsPending = TRACER_LENGTH;
+        this->tracerRestart = true;
+    }
+
+    // Particles move every step, so their contributions keep the stage running
+    runFieldStage = this->fieldInputsChanged || inputs.enableParticleFieldContributions;
+    if (runFieldStage) this->fieldInputsChanged = false;
+}
+
+glm::u32 SimulationBackend::tracer_points_due(const StepInputs& inputs, glm::u32 nPoints, glm::u32& curTraceIdx) {
+    // Retrace from the fixed first point, so every point after it follows the new fields. Resuming mid-trail would
+    // leave the points past curTraceIdx extending a stale predecessor.
+    if (this->tracerRestart) {
+        this->tracerRestart = false;
+        curTraceIdx = 1;
+    }
+
+    // Particles move every step, so their contributions keep the trails being retraced
+    if (inputs.enableParticleFieldContributions) return nPoints;
+
+    glm::u32 due = std::min(nPoints, this->tracerPointsPending);
+    this->tracerPointsPending -= due;
+    return due;
+}
+
+bool SimulationBackend::compact_due() {
+    return compactInterval > 0 && stepCount > 0 && stepCount % compactInterval == 0;
+}
+
+bool SimulationBackend::sort_due() {
+    return sortInterval > 0 && stepCount > 0 && stepCount % sortInterval == 0;
+}
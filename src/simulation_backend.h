@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "shared/particles.h"
+#include "shared/fields.h"
+#include "shared/tracers.h"
+#include "compute/indirect.h"
+#include "current_segment.h"
+#include "mesh.h"
+#include "args.h"
+#include "util/kernel_profile.h"
+
+// Where particles leave the domain
+enum WallType {
+    WALL_TORUS,       // Absorbed outside the torus of radii r1 (major) and r2 (minor)
+    WALL_PERIODIC_BOX // Wrapped around the box [min, max]
+};
+
+struct WallParameters {
+    WallType type = WALL_PERIODIC_BOX;
+    glm::f32 r1 = 0.0f;
+    glm::f32 r2 = 0.0f;
+    glm::f32vec3 min = glm::f32vec3(0.0f);
+    glm::f32vec3 max = glm::f32vec3(0.0f);
+};
+
+// Everything a backend allocates its state from
+struct BackendInit {
+    wgpu::Device device;
+    wgpu::Instance instance;
+
+    // Buffers the render passes draw from. The WebGPU backend steps these in place; other backends copy their
+    // state into them in sync_render_buffers. Headless CPU runs leave the device and these buffers null.
+    ParticleBuffers particles;
+    FieldBuffers fields;
+    TracerBuffers tracers;
+    ParticleIndirectCompute particleIndirect;
+
+    // Initial state
+    std::vector<Cell> cells;
+    MeshProperties mesh;
+    std::vector<glm::f32vec4> particlePos; // [x, y, z, species] for every slot, as uploaded by create_particle_buffers
+    std::vector<glm::f32vec4> particleVel; // [vx, vy, vz, unused]
+    glm::u32 initialParticles = 0;
+    std::vector<glm::f32vec4> tracerLoc;
+    std::vector<CurrentVector> currents;
+    WallParameters wall;
+
+    // Solver, compaction, sorting and batching settings
+    glm::f32 dt = 0.0f;
+    FieldSolver fieldSolver = FIELD_SOLVER_JACOBI;
+    glm::u32 fieldSolverIterations = 16;
+    glm::u32 multigridCycles = 1;
+    glm::f32 openingAngle = 0.5f;  // Barnes-Hut opening angle for the exact solver, 0 sums directly
+    glm::u32 octreeInterval = 1;   // Steps between octree rebuilds for the exact solver
+    bool fieldTextures = false;    // GPU only: the PIC push and tracers read E and B from 3D textures
+    glm::u32 compactInterval = 1000;
+    glm::f32 compactDeadFraction = 0.25f;
+    glm::u32 sortInterval = 0;
+    glm::u32 stepsPerSubmit = 1;
+    glm::u32 cpuThreads = 1;
+
+    // Profiling
+    bool profile = false;          // Keep rolling per-stage timings
+    bool timestampQueries = false; // The device has TimestampQuery enabled
+};
+
+// Inputs the scene controls, held fixed over a call to step
+struct StepInputs {
+    glm::f32 dt;
+    glm::f32 solenoidFlux;
+    bool enableParticleFieldContributions;
+};
+
+struct BackendDiagnostics {
+    glm::u32 nParticles; // Particle slots in use, live or dead
+    glm::u32 step;       // Steps taken when the diagnostics were sampled
+    std::vector<KernelTiming> kernelTimings; // Rolling per-stage averages, empty unless profiling
+};
+
+// An engine that advances the simulation state. Scene decides what to step and when; the backend owns how.
+class SimulationBackend {
+public:
+    virtual ~SimulationBackend() = default;
+
+    virtual void allocate(const BackendInit& init) = 0;
+
+    // Replaces the current segments; the cached external fields are rebuilt on the next step
+    virtual void set_currents(const std::vector<CurrentVector>& currents);
+
+    virtual void step(glm::u32 nSteps, const StepInputs& inputs) = 0;
+
+    // Extends the E and B tracer trails by up to nPoints points each. Tracers only feed the renderer, so Scene
+    // runs this once a frame rather than with every step; points are skipped while the trails are up to date.
+    virtual void trace(glm::u32 nPoints, const StepInputs& inputs) = 0;
+
+    // Blocks until the steps submitted so far are done
+    virtual BackendDiagnostics read_diagnostics() = 0;
+
+    // The latest diagnostics available without waiting. These may trail the steps submitted so far by a few
+    // submits; step says which step they are from.
+    virtual BackendDiagnostics poll_diagnostics();
+
+    // Copies the particles in use out, laid out as in BackendInit
+    virtual void snapshot(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) = 0;
+
+    // Makes the latest state visible through the render buffers given to allocate
+    virtual void sync_render_buffers() = 0;
+
+protected:
+    // Decides whether the next step runs the field stage, and marks it as run
+    void schedule_stages(const StepInputs& inputs, bool& runFieldStage);
+
+    // How many of nPoints trail points the next trace should compute, and marks them as computed. Moves the
+    // backend's curTraceIdx back to the start of the trails when a retrace has just been scheduled.
+    glm::u32 tracer_points_due(const StepInputs& inputs, glm::u32 nPoints, glm::u32& curTraceIdx);
+
+    // Whether compaction is due after the current step
+    bool compact_due();
+
+    // Whether the particles are due to be sorted by cell after the current step
+    bool sort_due();
+
+    std::vector<CurrentVector> currents;
+    bool refreshExternalFields = true; // Rebuild the cached coil/solenoid fields on the next step
+    glm::u32 compactInterval = 1000;   // Steps between compaction checks, 0 disables
+    glm::u32 sortInterval = 0;         // Steps between sorts by cell, 0 disables
+    glm::u32 stepCount = 0;            // Steps taken so far
+
+    // Field and tracer scheduling. Without particle contributions the fields only change with their inputs, so the
+    // field stage and the tracers are skipped while none of them changed.
+    bool fieldInputsChanged = true;    // Mesh, currents, solenoid flux or particle-field toggle
+    glm::f32 lastSolenoidFlux = 0.0f;
+    bool lastParticleFieldContributions = false;
+    glm::u32 tracerPointsPending = TRACER_LENGTH; // Trail points left to retrace since the fields last changed
+    bool tracerRestart = false;                   // The retrace starts over from the first trail point
+};
@@ -9,16 +9,16 @@
 #include "render/ring.h"
 #include "emscripten_key.h"
 
-inline float rand_range(float min, float max) {
-    return static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * (max - min) + min;
-}
-
 TokamakScene::TokamakScene(const TorusParameters& params, const SolenoidParameters& solenoidParams) 
     : Scene(), torusParameters(params), solenoidParameters(solenoidParams) {
 }
 
 void TokamakScene::init(const SimulationParams& params) {
     Scene::init(params);
+    this->cameraDistance = 5.0f * _M;
+    if (deviceless) {
+        return;
+    }
 
     // Create torus coils buffers
     Ring toroidalRing;
@@ -36,11 +36,6 @@ void TokamakScene::init(const SimulationParams& params) {
     solenoidRing.t = 0.05f * _M;
     solenoidRing.d = torusParameters.r2 * 2.0f;
     this->solenoidBuf = create_solenoid_buffers(device, solenoidRing);
-
-    // Create torus wall compute
-    this->torusWallCompute = create_torus_wall_compute(device, particles, params.maxParticles);
-
-    this->cameraDistance = 5.0f * _M;
 }
 
 void TokamakScene::render_details(wgpu::RenderPassEncoder& pass) {
@@ -50,38 +45,18 @@ void TokamakScene::render_details(wgpu::RenderPassEncoder& pass) {
     if (this->showSolenoid) render_solenoid(device, pass, solenoidBuf, this->solenoidFlux, view, projection);
 }
 
-void TokamakScene::compute_field_step(wgpu::ComputePassEncoder& pass) {
-    run_field_compute(
-        device,
-        pass,
-        fieldCompute,
-        static_cast<glm::u32>(cells.size()),
-        static_cast<glm::u32>(cachedCurrents.size()),
-        solenoidFlux,
-        enableParticleFieldContributions);
-
-    // Run tracer compute
-    run_tracer_compute(
-        device,
-        pass,
-        tracerCompute,
-        dt,
-        solenoidFlux,
-        enableParticleFieldContributions,
-        static_cast<glm::u32>(this->cachedCurrents.size()),
-        nParticles,
-        this->tracers.nTracers,
-        TRACER_LENGTH);
+glm::f32 TokamakScene::solenoid_flux() {
+    return this->solenoidFlux;
 }
 
-void TokamakScene::compute_wall_interactions(wgpu::ComputePassEncoder& pass) {
-    run_torus_wall_compute(
-        device,
-        pass,
-        torusWallCompute,
-        torusParameters.r1,
-        torusParameters.r2,
-        nParticles);
+// The torus wall bounds the plasma, so solve with Dirichlet conditions on the inactive cells
+FieldSolver TokamakScene::default_field_solver() {
+    return FIELD_SOLVER_MULTIGRID;
+}
+
+// Particles that reach the torus wall are absorbed
+WallParameters TokamakScene::wall_parameters() {
+    return WallParameters{ .type = WALL_TORUS, .r1 = torusParameters.r1, .r2 = torusParameters.r2 };
 }
 
 std::vector<Cell> TokamakScene::get_mesh_cells(glm::f32vec3 size, MeshProperties& mesh) {
@@ -122,13 +97,13 @@ std::vector<Cell> TokamakScene::get_mesh_cells(glm::f32vec3 size, MeshProperties
     return cells;
 }
 
-glm::f32vec4 TokamakScene::rand_particle_position() {
-    float r = rand_range(torusParameters.r1 - (torusParameters.r2 / 4.0f), torusParameters.r1 + (torusParameters.r2 / 4.0f));
-    float theta = rand_range(0.0f, 2 * M_PI);
-    float y = rand_range(-torusParameters.r2 / 4.0f, torusParameters.r2 / 4.0f);
-
-    // [x, y, z, unused]
-    return glm::f32vec4 { r * sin(theta), y, r * cos(theta), 0.0f };
+// A band around the torus centerline: r within r2/4 of r1 and y within r2/4 of the midplane
+ParticleDistribution TokamakScene::particle_distribution() {
+    return ParticleDistribution{
+        .type = DISTRIBUTION_CYLINDRICAL,
+        .min = glm::f32vec3(torusParameters.r1 - (torusParameters.r2 / 4.0f), -torusParameters.r2 / 4.0f, 0.0f),
+        .max = glm::f32vec3(torusParameters.r1 + (torusParameters.r2 / 4.0f), torusParameters.r2 / 4.0f, 2 * M_PI)
+    };
 }
 
 std::vector<CurrentVector> TokamakScene::get_currents() {
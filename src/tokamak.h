@@ -5,7 +5,6 @@
 #include "render/coils.h"
 #include "render/torus.h"
 #include "render/solenoid.h"
-#include "compute/torus_wall.h"
 #include "args.h"
 
 typedef struct TorusParameters {
@@ -35,12 +34,13 @@ public:
     void render_details(wgpu::RenderPassEncoder& pass) override;
 
     // Compute
-    void compute_field_step(wgpu::ComputePassEncoder& pass) override;
-    void compute_wall_interactions(wgpu::ComputePassEncoder& pass) override;
+    glm::f32 solenoid_flux() override;
+    WallParameters wall_parameters() override;
+    FieldSolver default_field_solver() override;
 
     // Scene-dependent functions
     std::vector<Cell> get_mesh_cells(glm::f32vec3 size, MeshProperties& mesh) override;
-    glm::f32vec4 rand_particle_position() override;
+    ParticleDistribution particle_distribution() override;
     std::vector<CurrentVector> get_currents() override;
     bool process_input(bool (*debounce_input)()) override;
 
@@ -59,9 +59,6 @@ private:
     CoilsBuffers coilsBuf;
     TorusBuffers torusBuf;
     SolenoidBuffers solenoidBuf;
-    
-    // Compute buffers
-    TorusWallCompute torusWallCompute;
 
     bool showTorus = true;
     bool showCoils = true;
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <algorithm>
+#include "gpu_profiler.h"
+
+// WebGPU caps a query set at 4096 queries
+const glm::u32 MAX_TIMESTAMP_QUERIES = 4096;
+
+GpuProfiler create_gpu_profiler(wgpu::Device& device, bool timestamps, glm::u32 maxPassesPerSubmit) {
+    GpuProfiler profiler = {};
+    profiler.timestamps = timestamps;
+    if (!timestamps) {
+        return profiler;
+    }
+
+    profiler.maxPairs = std::min(maxPassesPerSubmit, MAX_TIMESTAMP_QUERIES / 2);
+    wgpu::QuerySetDescriptor querySetDesc = {
+        .label = "Profiler Query Set",
+        .type = wgpu::QueryType::Timestamp,
+        .count = 2 * profiler.maxPairs
+    };
+    profiler.querySet = device.CreateQuerySet(&querySetDesc);
+
+    glm::u64 size = 2 * profiler.maxPairs * sizeof(glm::u64);
+    wgpu::BufferDescriptor resolveDesc = {
+        .label = "Profiler Resolve Buffer",
+        .usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc,
+        .size = size
+    };
+    profiler.resolveBuf = device.CreateBuffer(&resolveDesc);
+
+    for (GpuProfilerSlot& slot : profiler.ring) {
+        wgpu::BufferDescriptor readDesc = {
+            .label = "Profiler Read Buffer",
+            .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+            .size = size
+        };
+        slot.readBuf = device.CreateBuffer(&readDesc);
+    }
+
+    return profiler;
+}
+
+bool begin_profiled_submit(GpuProfiler& profiler) {
+    GpuProfilerSlot& slot = profiler.ring[profiler.nextSlot];
+    if (slot.inFlight) {
+        profiler.activeSlot = -1;
+        return false;
+    }
+
+    profiler.activeSlot = static_cast<glm::i32>(profiler.nextSlot);
+    profiler.nextSlot = (profiler.nextSlot + 1) % PROFILER_RING_SIZE;
+    slot.stages.clear();
+    return true;
+}
+
+const wgpu::PassTimestampWrites* profile_pass(GpuProfiler& profiler, ProfiledStage stage) {
+    if (!profiler.timestamps || profiler.activeSlot < 0) {
+        return nullptr;
+    }
+    GpuProfilerSlot& slot = profiler.ring[profiler.activeSlot];
+    glm::u32 pair = static_cast<glm::u32>(slot.stages.size());
+    if (pair >= profiler.maxPairs) {
+        return nullptr;
+    }
+
+    slot.stages.push_back(stage);
+    profiler.passWrites = {
+        .querySet = profiler.querySet,
+        .beginningOfPassWriteIndex = 2 * pair,
+        .endOfPassWriteIndex = 2 * pair + 1
+    };
+    return &profiler.passWrites;
+}
+
+void end_profiled_submit(GpuProfiler& profiler, wgpu::CommandEncoder& encoder) {
+    if (profiler.activeSlot < 0) {
+        return;
+    }
+    GpuProfilerSlot& slot = profiler.ring[profiler.activeSlot];
+    glm::u32 nQueries = 2 * static_cast<glm::u32>(slot.stages.size());
+    if (nQueries > 0) {
+        encoder.ResolveQuerySet(profiler.querySet, 0, nQueries, profiler.resolveBuf, 0);
+        encoder.CopyBufferToBuffer(profiler.resolveBuf, 0, slot.readBuf, 0, nQueries * sizeof(glm::u64));
+    }
+    slot.submitTime = std::chrono::steady_clock::now();
+}
+
+void read_profiled_submit(GpuProfiler& profiler, wgpu::Device& device) {
+    if (profiler.activeSlot < 0) {
+        return;
+    }
+    glm::u32 slotIndex = static_cast<glm::u32>(profiler.activeSlot);
+    GpuProfilerSlot& slot = profiler.ring[slotIndex];
+    slot.inFlight = true;
+    profiler.activeSlot = -1;
+    GpuProfiler* p = &profiler;
+
+    // Without timestamps, time the submit from Submit to completion
+    if (!profiler.timestamps) {
+        device.GetQueue().OnSubmittedWorkDone(
+            wgpu::CallbackMode::AllowProcessEvents,
+            [p, slotIndex](wgpu::QueueWorkDoneStatus status, wgpu::StringView message) {
+                GpuProfilerSlot& slot = p->ring[slotIndex];
+                if (status == wgpu::QueueWorkDoneStatus::Success) {
+                    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - slot.submitTime).count();
+                    add_kernel_sample(p->profile, STAGE_SUBMIT, ms);
+                }
+                slot.inFlight = false;
+            });
+        return;
+    }
+
+    if (slot.stages.empty()) {
+        slot.inFlight = false;
+        return;
+    }
+
+    size_t size = 2 * slot.stages.size() * sizeof(glm::u64);
+    slot.readBuf.MapAsync(
+        wgpu::MapMode::Read,
+        0,
+        size,
+        wgpu::CallbackMode::AllowProcessEvents,
+        [p, slotIndex, size](wgpu::MapAsyncStatus status, wgpu::StringView message) {
+            GpuProfilerSlot& slot = p->ring[slotIndex];
+            if (status != wgpu::MapAsyncStatus::Success) {
+                std::cerr << "Error reading timestamps: " << message.data << std::endl;
+                slot.inFlight = false;
+                return;
+            }
+
+            // Timestamps are in nanoseconds; a pair that went backwards (e.g. across a clock reset) is dropped
+            const glm::u64* ts = static_cast<const glm::u64*>(slot.readBuf.GetConstMappedRange(0, size));
+            for (size_t i = 0; i < slot.stages.size(); i++) {
+                glm::u64 begin = ts[2 * i];
+                glm::u64 end = ts[2 * i + 1];
+                if (end >= begin) {
+                    add_kernel_sample(p->profile, slot.stages[i], (end - begin) * 1e-6);
+                }
+            }
+            slot.readBuf.Unmap();
+            slot.inFlight = false;
+        });
+}
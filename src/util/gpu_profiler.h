@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "kernel_profile.h"
+
+// Readback buffers in the ring, so a submit never waits on the map of an earlier one
+const glm::u32 PROFILER_RING_SIZE = 3;
+
+struct GpuProfilerSlot {
+    wgpu::Buffer readBuf;
+    std::vector<ProfiledStage> stages; // Stage timed by each query pair
+    bool inFlight = false;             // Submitted and not yet read back
+    std::chrono::steady_clock::time_point submitTime;
+};
+
+// Times compute passes with timestamp queries written at their start and end, resolved after each submit into a
+// ring of readback buffers and mapped asynchronously. Without timestamp queries, whole submits are timed on the
+// CPU clock from submit to completion instead. Samples land in profile from Instance::ProcessEvents.
+struct GpuProfiler {
+    bool timestamps = false;              // TimestampQuery was enabled on the device
+    glm::u32 maxPairs = 0;                // Passes that can be timed per submit
+    wgpu::QuerySet querySet;
+    wgpu::Buffer resolveBuf;
+    std::array<GpuProfilerSlot, PROFILER_RING_SIZE> ring;
+    glm::u32 nextSlot = 0;
+    glm::i32 activeSlot = -1;             // Slot of the submit being recorded, -1 when it goes untimed
+    wgpu::PassTimestampWrites passWrites; // Handed out by profile_pass
+    KernelProfile profile;
+};
+
+GpuProfiler create_gpu_profiler(wgpu::Device& device, bool timestamps, glm::u32 maxPassesPerSubmit);
+
+// Claims a ring slot for the submit about to be recorded. Returns false, leaving the submit untimed, while every
+// slot is still waiting on its readback.
+bool begin_profiled_submit(GpuProfiler& profiler);
+
+// Timestamp writes that time the next pass as stage, or nullptr when the submit is untimed, out of query pairs, or
+// timestamps are unsupported
+const wgpu::PassTimestampWrites* profile_pass(GpuProfiler& profiler, ProfiledStage stage);
+
+// Resolves the submit's timestamps into its readback buffer. Call after the last pass, before Finish.
+void end_profiled_submit(GpuProfiler& profiler, wgpu::CommandEncoder& encoder);
+
+// Starts the asynchronous readback of the submit just made
+void read_profiled_submit(GpuProfiler& profiler, wgpu::Device& device);
@@ -0,0 +1,45 @@
+#include "kernel_profile.h"
+
+const char* profiled_stage_name(ProfiledStage stage) {
+    switch (stage) {
+        case STAGE_EXTERNAL_FIELDS: return "computeExternalFields";
+        case STAGE_FIELDS:          return "computeFields";
+        case STAGE_TRACERS:         return "updateTrails";
+        case STAGE_SOURCES:         return "particleSources";
+        case STAGE_PARTICLE_FIELDS: return "particleFields";
+        case STAGE_FIELD_TEXTURES:  return "writeFieldTextures";
+        case STAGE_MOTION:          return "computeMotion";
+        case STAGE_WALL:            return "checkWallInteractions";
+        case STAGE_COMPACT:         return "compact";
+        case STAGE_SORT:            return "sort";
+        case STAGE_SUBMIT:          return "submit";
+        default:                    return "unknown";
+    }
+}
+
+void add_kernel_sample(KernelProfile& profile, ProfiledStage stage, double ms) {
+    std::vector<double>& samples = profile.samples[stage];
+    if (samples.size() < PROFILE_WINDOW) {
+        samples.push_back(ms);
+        return;
+    }
+    samples[profile.next[stage]] = ms;
+    profile.next[stage] = (profile.next[stage] + 1) % PROFILE_WINDOW;
+}
+
+std::vector<KernelTiming> kernel_timings(const KernelProfile& profile) {
+    std::vector<KernelTiming> timings;
+    for (glm::u32 i = 0; i < PROFILED_STAGE_COUNT; i++) {
+        const std::vector<double>& samples = profile.samples[i];
+        if (samples.empty()) continue;
+
+        double sum = 0.0;
+        for (double ms : samples) sum += ms;
+        timings.push_back(KernelTiming{
+            .stage = static_cast<ProfiledStage>(i),
+            .averageMs = sum / samples.size(),
+            .samples = static_cast<glm::u32>(samples.size())
+        });
+    }
+    return timings;
+}
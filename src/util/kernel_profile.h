@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Stages timed by --profile, named after the kernels they run
+enum ProfiledStage {
+    STAGE_EXTERNAL_FIELDS, // computeExternalFields
+    STAGE_FIELDS,          // computeFields
+    STAGE_TRACERS,         // updateTrails (E and B)
+    STAGE_SOURCES,         // Deposit and grid solve of the particle sources
+    STAGE_PARTICLE_FIELDS, // Particle fields from the grid solve
+    STAGE_FIELD_TEXTURES,  // writeFieldTextures, with --fieldTextures
+    STAGE_MOTION,          // computeMotion
+    STAGE_WALL,            // checkWallInteractions / applyBoundary
+    STAGE_COMPACT,         // Compaction and the indirect args rebuild
+    STAGE_SORT,            // Counting sort of the particles by cell
+    STAGE_SUBMIT,          // Whole submit, wall clock (used when timestamp queries are unsupported)
+    PROFILED_STAGE_COUNT
+};
+
+const char* profiled_stage_name(ProfiledStage stage);
+
+// Samples each rolling average covers
+const glm::u32 PROFILE_WINDOW = 256;
+
+// The last PROFILE_WINDOW durations of each stage, ms
+struct KernelProfile {
+    std::array<std::vector<double>, PROFILED_STAGE_COUNT> samples;
+    std::array<glm::u32, PROFILED_STAGE_COUNT> next = {}; // Slot the next sample overwrites once the window is full
+};
+
+struct KernelTiming {
+    ProfiledStage stage;
+    double averageMs; // Mean over the window
+    glm::u32 samples; // Samples in the window
+};
+
+void add_kernel_sample(KernelProfile& profile, ProfiledStage stage, double ms);
+
+// Rolling averages of the stages that have samples, in stage order
+std::vector<KernelTiming> kernel_timings(const KernelProfile& profile);
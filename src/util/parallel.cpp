@@ -0,0 +1,67 @@
+#include "parallel.h"
+
+WorkerPool::WorkerPool(glm::u32 nThreads) {
+    for (glm::u32 i = 1; i < std::max(1u, nThreads); i++) {
+        workers.emplace_back(&WorkerPool::work, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::run(glm::u32 n, const std::function<void(glm::u32, glm::u32)>& fn) {
+    glm::u32 nThreads = std::max(1u, std::min(size(), n));
+    glm::u32 chunk = (n + nThreads - 1) / nThreads;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &fn;
+        jobN = n;
+        jobChunk = chunk;
+        pending = (glm::u32)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    fn(0u, std::min(chunk, n));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::work(glm::u32 worker) {
+    glm::u64 seen = 0;
+    while (true) {
+        const std::function<void(glm::u32, glm::u32)>* fn;
+        glm::u32 begin, end;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            fn = job;
+            begin = std::min(worker * jobChunk, jobN);
+            end = std::min(begin + jobChunk, jobN);
+        }
+
+        if (begin < end) {
+            (*fn)(begin, end);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        done.notify_one();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Runs fn(begin, end) over [0, n) split evenly across nThreads
+template <typename Fn>
+void parallel_for(glm::u32 n, glm::u32 nThreads, Fn fn) {
+    nThreads = std::max(1u, std::min(nThreads, n));
+    if (nThreads == 1) {
+        fn(0u, n);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    glm::u32 chunk = (n + nThreads - 1) / nThreads;
+    for (glm::u32 begin = 0; begin < n; begin += chunk) {
+        threads.emplace_back(fn, begin, std::min(begin + chunk, n));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// nThreads - 1 threads that live as long as the pool and wait between jobs; the calling thread runs the first
+// chunk of each job itself. Jobs are run one at a time.
+class WorkerPool {
+public:
+    explicit WorkerPool(glm::u32 nThreads);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    glm::u32 size() const { return (glm::u32)workers.size() + 1; }
+
+    // Runs fn(begin, end) over [0, n) split as parallel_for splits it, returning once every chunk is done
+    void run(glm::u32 n, const std::function<void(glm::u32, glm::u32)>& fn);
+
+private:
+    void work(glm::u32 worker);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(glm::u32, glm::u32)>* job = nullptr;
+    glm::u32 jobN = 0;
+    glm::u32 jobChunk = 0;
+    glm::u64 generation = 0; // Bumped for each job so a worker runs it once
+    glm::u32 pending = 0;    // Workers yet to finish the current job
+    bool stopping = false;
+};
+
+// Runs fn(begin, end) over [0, n) on the pool's threads
+template <typename Fn>
+void parallel_for(WorkerPool& pool, glm::u32 n, Fn fn) {
+    if (pool.size() == 1 || n <= 1) {
+        fn(0u, n);
+        return;
+    }
+    pool.run(n, fn);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "physical_constants.h"
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"), a counter-based RNG: each
+// (counter, key) pair maps to four independent 32-bit words with no state carried between draws, so any
+// particle's numbers can be generated on any thread in any order. Mirrors philox4x32_10 in kernel/rng.wgsl.
+
+const glm::u32 PHILOX_M0 = 0xD2511F53u;
+const glm::u32 PHILOX_M1 = 0xCD9E8D57u;
+const glm::u32 PHILOX_W0 = 0x9E3779B9u;
+const glm::u32 PHILOX_W1 = 0xBB67AE85u;
+
+inline std::array<glm::u32, 4> philox4x32_10(std::array<glm::u32, 4> ctr, std::array<glm::u32, 2> key) {
+    for (int i = 0; i < 10; i++) {
+        glm::u64 p0 = static_cast<glm::u64>(PHILOX_M0) * ctr[0];
+        glm::u64 p1 = static_cast<glm::u64>(PHILOX_M1) * ctr[2];
+        ctr = {
+            static_cast<glm::u32>(p1 >> 32) ^ ctr[1] ^ key[0],
+            static_cast<glm::u32>(p1),
+            static_cast<glm::u32>(p0 >> 32) ^ ctr[3] ^ key[1],
+            static_cast<glm::u32>(p0)
+        };
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+    return ctr;
+}
+
+// Key for a 64-bit seed
+inline std::array<glm::u32, 2> philox_key(glm::u64 seed) {
+    return { static_cast<glm::u32>(seed), static_cast<glm::u32>(seed >> 32) };
+}
+
+// Uniform in [0, 1), from the top 24 bits
+inline glm::f32 philox_uniform(glm::u32 x) {
+    return static_cast<glm::f32>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Uniform in (0, 1], safe to take the log of
+inline glm::f32 philox_uniform_open(glm::u32 x) {
+    return static_cast<glm::f32>((x >> 8) + 1) * (1.0f / 16777216.0f);
+}
+
+// Two standard normals from two words (Box-Muller)
+inline glm::f32vec2 philox_normal2(glm::u32 a, glm::u32 b) {
+    glm::f32 r = std::sqrt(-2.0f * std::log(philox_uniform_open(a)));
+    glm::f32 theta = 2.0f * PI * philox_uniform(b);
+    return glm::f32vec2(r * std::cos(theta), r * std::sin(theta));
+}
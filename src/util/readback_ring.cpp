@@ -0,0 +1,74 @@
+#include <iostream>
+#include <cstring>
+#include "readback_ring.h"
+
+ReadbackRing create_readback_ring(wgpu::Device& device, glm::u64 size, const char* label) {
+    ReadbackRing ring = {};
+    ring.size = size;
+    ring.latest.resize(size, 0);
+
+    for (ReadbackSlot& slot : ring.slots) {
+        wgpu::BufferDescriptor bufferDesc = {
+            .label = label,
+            .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::MapRead,
+            .size = size,
+            .mappedAtCreation = false
+        };
+        slot.buffer = device.CreateBuffer(&bufferDesc);
+    }
+
+    return ring;
+}
+
+bool enqueue_readback(ReadbackRing& ring, wgpu::CommandEncoder& encoder, const wgpu::Buffer& src, glm::u64 srcOffset, glm::u64 tag) {
+    ReadbackSlot& slot = ring.slots[ring.next];
+    if (slot.inFlight) {
+        ring.recorded = -1;
+        ring.dropped++;
+        return false;
+    }
+
+    encoder.CopyBufferToBuffer(src, srcOffset, slot.buffer, 0, ring.size);
+    slot.inFlight = true;
+    slot.sequence = ++ring.sequence;
+    slot.tag = tag;
+    ring.recorded = static_cast<glm::i32>(ring.next);
+    ring.next = (ring.next + 1) % READBACK_RING_SIZE;
+    return true;
+}
+
+void map_readback(ReadbackRing& ring) {
+    if (ring.recorded < 0) {
+        return;
+    }
+    glm::u32 slotIndex = static_cast<glm::u32>(ring.recorded);
+    ring.recorded = -1;
+    ReadbackRing* r = &ring;
+
+    ring.slots[slotIndex].buffer.MapAsync(
+        wgpu::MapMode::Read,
+        0,
+        ring.size,
+        wgpu::CallbackMode::AllowProcessEvents,
+        [r, slotIndex](wgpu::MapAsyncStatus status, wgpu::StringView message) {
+            ReadbackSlot& slot = r->slots[slotIndex];
+            if (status != wgpu::MapAsyncStatus::Success) {
+                std::cerr << "Error reading back buffer: " << message.data << std::endl;
+                slot.inFlight = false;
+                return;
+            }
+
+            // Maps can complete out of order; keep only the newest copy
+            if (slot.sequence > r->latestSequence) {
+                std::memcpy(r->latest.data(), slot.buffer.GetConstMappedRange(0, r->size), r->size);
+                r->latestSequence = slot.sequence;
+                r->latestTag = slot.tag;
+            }
+            slot.buffer.Unmap();
+            slot.inFlight = false;
+        });
+}
+
+bool has_readback(const ReadbackRing& ring) {
+    return ring.latestSequence > 0;
+}
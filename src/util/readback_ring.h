@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+
+// Copies that can be in flight at once. With three, a copy is enqueued every submit while the two before it are
+// still being mapped.
+const glm::u32 READBACK_RING_SIZE = 3;
+
+struct ReadbackSlot {
+    wgpu::Buffer buffer; // MapRead | CopyDst
+    bool inFlight = false;
+    glm::u64 sequence = 0; // Order the copy was enqueued in
+    glm::u64 tag = 0;      // Caller's label for the copy, e.g. the step it was taken after
+};
+
+// Reads a GPU buffer region back without waiting on it. Each enqueue_readback records a copy into a free slot's
+// staging buffer; once its submit has run, the map callback copies the bytes into latest, which the ring owns,
+// and frees the slot. Callbacks run from Instance::ProcessEvents, so the data shows up a submit or two later and
+// nothing ever blocks on the GPU.
+struct ReadbackRing {
+    glm::u64 size = 0; // Bytes per copy
+    std::array<ReadbackSlot, READBACK_RING_SIZE> slots;
+    glm::u32 next = 0;
+    glm::i32 recorded = -1;     // Slot copied into by the encoder being recorded, mapped by map_readback
+    glm::u64 sequence = 0;
+    glm::u32 dropped = 0;       // Copies skipped because every slot was still in flight
+
+    // Most recent completed readback
+    std::vector<uint8_t> latest;
+    glm::u64 latestSequence = 0; // 0 until a readback has landed
+    glm::u64 latestTag = 0;
+};
+
+ReadbackRing create_readback_ring(wgpu::Device& device, glm::u64 size, const char* label);
+
+// Records a copy of ring.size bytes of src, from srcOffset, into a free slot. Returns false and records nothing
+// while every slot is still waiting on its map.
+bool enqueue_readback(ReadbackRing& ring, wgpu::CommandEncoder& encoder, const wgpu::Buffer& src, glm::u64 srcOffset, glm::u64 tag);
+
+// Starts mapping the slot the last enqueue_readback copied into. Call after the submit that holds the copy. The
+// ring must stay at the same address until its maps complete.
+void map_readback(ReadbackRing& ring);
+
+// Whether a readback has completed yet
+bool has_readback(const ReadbackRing& ring);
+
+template <typename T>
+T latest_readback(const ReadbackRing& ring, glm::u32 index = 0) {
+    return reinterpret_cast<const T*>(ring.latest.data())[index];
+}
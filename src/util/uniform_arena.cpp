@@ -0,0 +1,64 @@
+#include <iostream>
+#include <cstring>
+#include "uniform_arena.h"
+
+UniformArena create_uniform_arena(wgpu::Device& device, glm::u32 capacity) {
+    UniformArena arena = {};
+
+    wgpu::Limits limits;
+    device.GetLimits(&limits);
+    arena.slotAlignment = limits.minUniformBufferOffsetAlignment;
+    arena.capacity = (capacity + arena.slotAlignment - 1) / arena.slotAlignment * arena.slotAlignment;
+
+    wgpu::BufferDescriptor bufferDesc = {
+        .label = "Uniform Arena Buffer",
+        .usage = wgpu::BufferUsage::CopyDst | wgpu::BufferUsage::Uniform,
+        .size = arena.capacity,
+        .mappedAtCreation = false
+    };
+    arena.buffer = device.CreateBuffer(&bufferDesc);
+    arena.staging.reserve(arena.capacity);
+
+    return arena;
+}
+
+glm::u32 push_uniform(UniformArena& arena, const void* data, size_t size) {
+    glm::u32 offset = static_cast<glm::u32>(arena.staging.size());
+    glm::u32 slotSize = (static_cast<glm::u32>(size) + arena.slotAlignment - 1) / arena.slotAlignment * arena.slotAlignment;
+    if (offset + slotSize > arena.capacity) {
+        std::cerr << "Uniform arena overflow: " << offset + slotSize << " of " << arena.capacity << " bytes" << std::endl;
+        exit(1);
+    }
+
+    arena.staging.resize(offset + slotSize, 0);
+    std::memcpy(arena.staging.data() + offset, data, size);
+    return offset;
+}
+
+void flush_uniform_arena(wgpu::Device& device, UniformArena& arena) {
+    if (!arena.staging.empty()) {
+        device.GetQueue().WriteBuffer(arena.buffer, 0, arena.staging.data(), arena.staging.size());
+    }
+    arena.staging.clear();
+}
+
+wgpu::BindGroupLayoutEntry uniform_arena_layout_entry(glm::u32 binding, size_t paramsSize) {
+    return {
+        .binding = binding,
+        .visibility = wgpu::ShaderStage::Compute,
+        .buffer = {
+            .type = wgpu::BufferBindingType::Uniform,
+            .hasDynamicOffset = true,
+            .minBindingSize = paramsSize
+        }
+    };
+}
+
+wgpu::BindGroupEntry uniform_arena_bind_group_entry(const UniformArena& arena, glm::u32 binding, size_t paramsSize) {
+    return {
+        .binding = binding,
+        .buffer = arena.buffer,
+        .offset = 0,
+        .size = paramsSize
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+
+// One large uniform buffer that per-dispatch params are appended to while commands are recorded, then uploaded
+// with a single WriteBuffer before the submit. Each push lands in its own slot, bound through a dynamic offset,
+// so several steps can be recorded into one command buffer without later params overwriting earlier ones.
+struct UniformArena {
+    wgpu::Buffer buffer;
+    std::vector<uint8_t> staging; // Slots pushed since the last flush
+    glm::u32 slotAlignment;       // minUniformBufferOffsetAlignment
+    glm::u32 capacity;            // Buffer size, bytes
+};
+
+UniformArena create_uniform_arena(wgpu::Device& device, glm::u32 capacity);
+
+// Copies size bytes into the next slot and returns its dynamic offset
+glm::u32 push_uniform(UniformArena& arena, const void* data, size_t size);
+
+template <typename T>
+glm::u32 push_uniform(UniformArena& arena, const T& params) {
+    return push_uniform(arena, &params, sizeof(T));
+}
+
+// Uploads every slot pushed since the last flush and starts the arena over. Call once per batch, before Submit.
+void flush_uniform_arena(wgpu::Device& device, UniformArena& arena);
+
+// Bind group layout entry for a uniform read from the arena through a dynamic offset
+wgpu::BindGroupLayoutEntry uniform_arena_layout_entry(glm::u32 binding, size_t paramsSize);
+
+// Bind group entry covering one slot of the arena; the slot is chosen by the dynamic offset at SetBindGroup
+wgpu::BindGroupEntry uniform_arena_bind_group_entry(const UniformArena& arena, glm::u32 binding, size_t paramsSize);
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <regex>
 #include <cstdio>
+#include <cstring>
 #include "wgpu_util.h"
 
 // We define a function that hides implementation-specific variants of device polling
@@ -19,7 +20,7 @@ void poll_events(wgpu::Device& device, bool yieldToWebBrowser) {
 #endif
 }
 
-const void* read_buffer(wgpu::Device& device, wgpu::Instance& instance, const wgpu::Buffer& buffer, size_t size) {
+bool read_buffer(wgpu::Instance& instance, const wgpu::Buffer& buffer, size_t size, void* dst) {
     bool success = false;
     wgpu::FutureWaitInfo waitInfo {
         buffer.MapAsync(
@@ -34,14 +35,19 @@ const void* read_buffer(wgpu::Device& device, wgpu::Instance& instance, const wg
                 }}
             )
     };
-    wgpu::WaitStatus status =
-        instance.WaitAny(1, &waitInfo, std::numeric_limits<uint64_t>::max());
+    wgpu::WaitStatus status = instance.WaitAny(1, &waitInfo, READBACK_TIMEOUT_NS);
+    if (status != wgpu::WaitStatus::Success || !waitInfo.completed) {
+        std::cerr << "Timed out reading buffer" << std::endl;
+        return false;
+    }
     if (!success) {
-        return nullptr;
+        return false;
     }
-    const void* data = buffer.GetConstMappedRange(0, size);
+
+    // The mapped range is only valid until Unmap, so copy out first
+    std::memcpy(dst, buffer.GetConstMappedRange(0, size), size);
     buffer.Unmap();
-    return data;
+    return true;
 }
 
 std::string read_file(std::string path) {
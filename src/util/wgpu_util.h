@@ -5,7 +5,13 @@
 #include <webgpu/webgpu_cpp.h>
 
 void poll_events(wgpu::Device& device, bool yieldToWebBrowser);
-const void* read_buffer(wgpu::Device& device, wgpu::Instance& instance, const wgpu::Buffer& buffer, size_t size);
+
+// Longest a blocking readback waits for its map before giving up, ns
+const uint64_t READBACK_TIMEOUT_NS = 10'000'000'000ull;
+
+// Blocks until the buffer is mapped, then copies size bytes into dst before unmapping. Returns false if the map
+// failed or timed out. For reads that must not stall the pipeline, use a ReadbackRing (util/readback_ring.h).
+bool read_buffer(wgpu::Instance& instance, const wgpu::Buffer& buffer, size_t size, void* dst);
 
 wgpu::ShaderModule create_shader_module(wgpu::Device& device, std::string shaderPath);
 wgpu::ShaderModule create_shader_module(wgpu::Device& device, std::string kernelPath, std::vector<std::string> headerPaths);
@@ -0,0 +1,486 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include "webgpu_backend.h"
+#include "util/wgpu_util.h"
+
+void WebGpuBackend::allocate(const BackendInit& init) {
+    this->device = init.device;
+    this->instance = init.instance;
+    this->cells = init.cells;
+    this->mesh = init.mesh;
+    this->wall = init.wall;
+    this->fieldSolver = init.fieldSolver;
+    this->fieldSolverIterations = init.fieldSolverIterations;
+    this->multigridCycles = init.multigridCycles;
+    this->openingAngle = init.openingAngle;
+    this->octreeInterval = std::max(1u, init.octreeInterval);
+    this->nOctreeNodes = 0;
+    this->octreeStep = 0;
+    this->octreeStale = true;
+    this->fieldTextures = init.fieldTextures;
+    this->compactInterval = init.compactInterval;
+    this->compactDeadFraction = init.compactDeadFraction;
+    this->sortInterval = init.sortInterval;
+    this->stepsPerSubmit = std::max(1u, init.stepsPerSubmit);
+    this->cpuThreads = init.cpuThreads;
+    this->nParticles = init.initialParticles;
+    this->nParticlesStep = 0;
+    this->currents = init.currents;
+
+    this->particles = init.particles;
+    this->fields = init.fields;
+    this->tracers = init.tracers;
+    this->particleIndirect = init.particleIndirect;
+    glm::u32 maxParticles = particles.nMax;
+
+    // Initialize currents
+    this->currentSegmentsBuffer = get_current_segment_buffer(device, this->currents);
+
+    // Initialize the per-step uniform arena, sized for a full batch of steps
+    this->uniforms = create_uniform_arena(device, stepsPerSubmit * UNIFORM_SLOTS_PER_STEP * UNIFORM_SLOT_SIZE);
+
+    // Initialize the field textures. They hold the fields at full precision, so the push and tracers read the
+    // same values as from the buffers.
+    const FieldTextureCompute* textures = nullptr;
+    if (fieldTextures) {
+        this->fieldTextureCompute = create_field_texture_compute(device, fields, mesh, wgpu::TextureFormat::RGBA32Float);
+        textures = &this->fieldTextureCompute;
+    }
+
+    // Initialize particle compute; the exact solver sums the particle and external fields in the push itself
+    if (this->fieldSolver == FIELD_SOLVER_EXACT) {
+        this->particleCompute = create_particle_compute(device, particles, this->currentSegmentsBuffer, static_cast<glm::u32>(this->currents.size()), maxParticles);
+    } else {
+        this->particleCompute = create_particle_pic_compute(device, cells, particles, fields, maxParticles, uniforms, textures);
+    }
+
+    // Initialize field compute
+    this->fieldCompute = create_field_compute(device, cells, particles, fields, this->currentSegmentsBuffer, static_cast<glm::u32>(this->currents.size()), maxParticles, uniforms);
+
+    // Initialize particle deposition and grid field solve
+    bool spectral = this->fieldSolver == FIELD_SOLVER_FFT || this->fieldSolver == FIELD_SOLVER_FFT_CPU;
+    this->depositCompute = create_deposit_compute(device, particles, fields, mesh, maxParticles);
+    this->fieldSolveCompute = create_field_solve_compute(device, fields, mesh, spectral ? 1u : 0u);
+    if (spectral) {
+        this->fftCompute = create_fft_compute(device, fields, mesh);
+    }
+    if (this->fieldSolver == FIELD_SOLVER_MULTIGRID || this->fieldSolver == FIELD_SOLVER_FDTD) {
+        this->multigridCompute = create_multigrid_compute(device, fields, cells, mesh);
+    }
+    if (this->fieldSolver == FIELD_SOLVER_FDTD) {
+        this->fdtdCompute = create_fdtd_compute(device, particles, fields, cells, mesh, maxParticles, uniforms);
+        this->fdtdInitialized = false;
+        std::cout << "FDTD substeps per step: " << fdtd_substeps(mesh, init.dt) << std::endl;
+    }
+
+    // Initialize tracer compute
+    this->tracerCompute = create_tracer_compute(device, tracers, fields, mesh, uniforms, textures);
+
+    // Initialize the wall, particle compaction and sorting
+    if (wall.type == WALL_TORUS) {
+        this->torusWallCompute = create_torus_wall_compute(device, particles, maxParticles, uniforms);
+    } else {
+        this->boundaryCompute = create_boundary_compute(device, particles, maxParticles, uniforms);
+    }
+    this->compactCompute = create_compact_compute(device, particles, maxParticles, compactDeadFraction);
+    if (sortInterval > 0) {
+        this->sortCompute = create_sort_compute(device, particles, mesh, static_cast<glm::u32>(cells.size()), maxParticles);
+    }
+
+    // Initialize the diagnostics readbacks
+    this->nParticlesReadback = create_readback_ring(device, sizeof(glm::u32), "Particle Number Readback Buffer");
+    this->particleDebugReadback = create_readback_ring(device, 10 * sizeof(glm::f32vec4), "Particle Debug Readback Buffer");
+    this->eTracerDebugReadback = create_readback_ring(device, 10 * sizeof(glm::f32vec4), "E Tracer Debug Readback Buffer");
+    this->bTracerDebugReadback = create_readback_ring(device, 10 * sizeof(glm::f32vec4), "B Tracer Debug Readback Buffer");
+
+    // Initialize the profiler, with room to time every stage of a full batch
+    this->profiling = init.profile;
+    this->timedPasses = false;
+    if (profiling) {
+        this->profiler = create_gpu_profiler(device, init.timestampQueries, stepsPerSubmit * PROFILED_STAGE_COUNT);
+    }
+}
+
+void WebGpuBackend::set_currents(const std::vector<CurrentVector>& currents) {
+    SimulationBackend::set_currents(currents);
+    update_currents_buffer(device, this->currentSegmentsBuffer, this->currents);
+}
+
+void WebGpuBackend::step(glm::u32 nSteps, const StepInputs& inputs) {
+    this->collect_readbacks();
+
+    // The CPU spectral solve needs the deposited sources read back before the main pass, so those steps
+    // can't be batched
+    bool cpuSolve = inputs.enableParticleFieldContributions && fieldSolver == FIELD_SOLVER_FFT_CPU;
+    glm::u32 batchSize = cpuSolve ? 1u : stepsPerSubmit;
+
+    // The exact solver's octree is built on the CPU from a snapshot, so batches end where it is due a rebuild
+    bool useOctree = inputs.enableParticleFieldContributions && fieldSolver == FIELD_SOLVER_EXACT && openingAngle > 0.0f;
+
+    for (glm::u32 done = 0; done < nSteps; ) {
+        glm::u32 batch = std::min(batchSize, nSteps - done);
+        if (useOctree) {
+            if (octreeStale || stepCount >= octreeStep + octreeInterval) {
+                auto start = std::chrono::steady_clock::now();
+                this->rebuild_octree();
+                if (profiling) {
+                    add_kernel_sample(profiler.profile, STAGE_SOURCES, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                }
+            }
+            batch = std::min(batch, octreeStep + octreeInterval - stepCount);
+        }
+        if (cpuSolve) {
+            // This solve blocks on its own readback, so the CPU clock times it
+            auto start = std::chrono::steady_clock::now();
+            this->solve_particle_sources_cpu();
+            if (profiling) {
+                add_kernel_sample(profiler.profile, STAGE_SOURCES, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+
+        bool profiledSubmit = profiling && begin_profiled_submit(profiler);
+        this->timedPasses = profiledSubmit && profiler.timestamps;
+
+        wgpu::CommandEncoderDescriptor encoderDesc{.label = "Compute Command Encoder"};
+        this->batchEncoder = device.CreateCommandEncoder(&encoderDesc);
+        wgpu::ComputePassDescriptor computePassDesc{.label = "Compute Pass"};
+        this->batchPass = batchEncoder.BeginComputePass(&computePassDesc);
+
+        // Record the batch; per-step params go to the uniform arena. A step that compacts or sorts the particles
+        // ends the batch when the octree indexes them.
+        glm::u32 recorded = 0;
+        while (recorded < batch) {
+            this->record_step(inputs);
+            recorded++;
+            if (useOctree && octreeStale) break;
+        }
+
+        batchPass.End();
+
+        // Copy the diagnostics out for reading back once the batch has run
+        enqueue_readback(nParticlesReadback, batchEncoder, particles.nCur, 0, stepCount);
+        enqueue_readback(particleDebugReadback, batchEncoder, particleCompute.debugStorageBuf, 0, stepCount);
+        if (profiledSubmit) {
+            end_profiled_submit(profiler, batchEncoder);
+        }
+
+        wgpu::CommandBuffer commands = batchEncoder.Finish();
+        flush_uniform_arena(device, uniforms);
+        device.GetQueue().Submit(1, &commands);
+        map_readback(nParticlesReadback);
+        map_readback(particleDebugReadback);
+        if (profiledSubmit) {
+            read_profiled_submit(profiler, device);
+        }
+        done += recorded;
+    }
+
+    // The latest kernel debug output is in particleDebugReadback.latest and the tracer equivalents
+}
+
+// Records the tracer dispatches into a submit of their own, after the steps submitted so far, so the tracers follow
+// the fields those steps left on the mesh
+void WebGpuBackend::trace(glm::u32 nPoints, const StepInputs& inputs) {
+    glm::u32 due = this->tracer_points_due(inputs, nPoints, tracerCompute.curTraceIdx);
+    if (due == 0 || tracers.nTracers == 0) return;
+
+    // Only timestamped runs are profiled; a CPU-clock sample of this submit would land among the step submits
+    bool profiledSubmit = profiling && profiler.timestamps && begin_profiled_submit(profiler);
+
+    wgpu::CommandEncoderDescriptor encoderDesc{.label = "Tracer Command Encoder"};
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&encoderDesc);
+    wgpu::ComputePassDescriptor passDesc{
+        .label = "Tracer Pass",
+        .timestampWrites = profiledSubmit ? profile_pass(profiler, STAGE_TRACERS) : nullptr
+    };
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&passDesc);
+    run_tracer_compute(pass, tracerCompute, uniforms, tracers.nTracers, TRACER_LENGTH, due);
+    pass.End();
+
+    enqueue_readback(eTracerDebugReadback, encoder, tracerCompute.eDebugStorageBuf, 0, stepCount);
+    enqueue_readback(bTracerDebugReadback, encoder, tracerCompute.bDebugStorageBuf, 0, stepCount);
+    if (profiledSubmit) {
+        end_profiled_submit(profiler, encoder);
+    }
+
+    wgpu::CommandBuffer commands = encoder.Finish();
+    flush_uniform_arena(device, uniforms);
+    device.GetQueue().Submit(1, &commands);
+    map_readback(eTracerDebugReadback);
+    map_readback(bTracerDebugReadback);
+    if (profiledSubmit) {
+        read_profiled_submit(profiler, device);
+    }
+}
+
+// Runs the callbacks of any readbacks that have landed, picking up the latest particle count
+void WebGpuBackend::collect_readbacks() {
+    instance.ProcessEvents();
+    if (has_readback(nParticlesReadback) && nParticlesReadback.latestTag >= nParticlesStep) {
+        this->nParticles = latest_readback<glm::u32>(nParticlesReadback);
+        this->nParticlesStep = static_cast<glm::u32>(nParticlesReadback.latestTag);
+    }
+}
+
+// Pass to record the next stage into. A batch shares one pass unless its stages are being timed, in which case
+// each stage gets a pass of its own with timestamps written at its start and end.
+wgpu::ComputePassEncoder& WebGpuBackend::stage_pass(ProfiledStage stage) {
+    if (!timedPasses) return batchPass;
+
+    batchPass.End();
+    wgpu::ComputePassDescriptor passDesc{
+        .label = profiled_stage_name(stage),
+        .timestampWrites = profile_pass(profiler, stage)
+    };
+    this->batchPass = batchEncoder.BeginComputePass(&passDesc);
+    return batchPass;
+}
+
+// Records one simulation step into the batch
+void WebGpuBackend::record_step(const StepInputs& inputs) {
+    bool runFieldStage;
+    this->schedule_stages(inputs, runFieldStage);
+    bool gridSolve = inputs.enableParticleFieldContributions && fieldSolver != FIELD_SOLVER_DIRECT && fieldSolver != FIELD_SOLVER_EXACT;
+
+    // The coil and solenoid fields on the mesh only change with the currents
+    bool fieldsWritten = runFieldStage || gridSolve;
+    if (this->refreshExternalFields) {
+        fieldsWritten = true;
+        run_external_field_compute(
+            stage_pass(STAGE_EXTERNAL_FIELDS),
+            fieldCompute,
+            uniforms,
+            static_cast<glm::u32>(cells.size()),
+            static_cast<glm::u32>(currents.size()));
+        this->refreshExternalFields = false;
+    }
+
+    // FIELD_SOLVER_FFT_CPU is solved before the batch
+    if (gridSolve && fieldSolver != FIELD_SOLVER_FFT_CPU) {
+        this->compute_particle_sources(stage_pass(STAGE_SOURCES), inputs);
+    }
+
+    // Write the external fields (plus the direct particle sums, if selected) to the mesh
+    if (runFieldStage) {
+        run_field_compute(
+            stage_pass(STAGE_FIELDS),
+            fieldCompute,
+            uniforms,
+            static_cast<glm::u32>(cells.size()),
+            static_cast<glm::u32>(currents.size()),
+            inputs.solenoidFlux,
+            direct_particle_fields(inputs));
+    }
+
+    if (gridSolve) {
+        this->compute_particle_fields(stage_pass(STAGE_PARTICLE_FIELDS), inputs);
+    }
+
+    // Copy the fields the stages above wrote into the textures the push and tracers read
+    if (fieldTextures && fieldsWritten) {
+        run_field_texture_compute(stage_pass(STAGE_FIELD_TEXTURES), fieldTextureCompute);
+    }
+
+    if (fieldSolver == FIELD_SOLVER_EXACT) {
+        run_particle_compute(
+            device,
+            stage_pass(STAGE_MOTION),
+            particleCompute,
+            inputs.dt,
+            inputs.solenoidFlux,
+            inputs.enableParticleFieldContributions ? 1u : 0u,
+            static_cast<glm::u32>(currents.size()),
+            particleIndirect.argsBuffer,
+            openingAngle,
+            openingAngle > 0.0f ? nOctreeNodes : 0u);
+    } else {
+        run_particle_pic_compute(
+            stage_pass(STAGE_MOTION),
+            particleCompute,
+            uniforms,
+            mesh,
+            inputs.dt,
+            direct_particle_fields(inputs),
+            particleIndirect.argsBuffer);
+    }
+
+    this->compute_wall_interactions(stage_pass(STAGE_WALL));
+
+    // Periodically pack out the particles the wall has absorbed so later steps stop paying for dead slots
+    if (compact_due()) {
+        wgpu::ComputePassEncoder& compactPass = stage_pass(STAGE_COMPACT);
+        run_compact_compute(compactPass, compactCompute);
+        run_particle_indirect_compute(compactPass, particleIndirect);
+        this->octreeStale = true;
+    }
+
+    // Periodically regroup the particles by cell so neighbouring invocations of the push gather from the same
+    // field nodes. Nothing reads the per-cell offsets yet.
+    if (sort_due()) {
+        run_sort_compute(stage_pass(STAGE_SORT), sortCompute, particleIndirect.argsBuffer, false);
+        this->octreeStale = true;
+    }
+
+    stepCount++;
+}
+
+// Deposits particle charge and current onto the mesh and advances the grid field solver
+void WebGpuBackend::compute_particle_sources(wgpu::ComputePassEncoder& pass, const StepInputs& inputs) {
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+    switch (fieldSolver) {
+        case FIELD_SOLVER_JACOBI:
+            run_deposit_compute(pass, depositCompute, nCells, particleIndirect.argsBuffer);
+            run_potential_relax(pass, fieldSolveCompute, nCells, fieldSolverIterations);
+            break;
+        case FIELD_SOLVER_FFT:
+            run_deposit_compute(pass, depositCompute, nCells, particleIndirect.argsBuffer);
+            run_fft_poisson(pass, fftCompute, mesh, nCells);
+            break;
+        case FIELD_SOLVER_MULTIGRID:
+            run_deposit_compute(pass, depositCompute, nCells, particleIndirect.argsBuffer);
+            run_multigrid_poisson(pass, multigridCompute, multigridCycles);
+            break;
+        case FIELD_SOLVER_FDTD:
+            // The first step seeds the Yee E from an electrostatic solve of the deposited charge, later ones advance
+            // it with the current of the particles' last move
+            if (!fdtdInitialized) {
+                run_deposit_compute(pass, depositCompute, nCells, particleIndirect.argsBuffer);
+                run_multigrid_poisson(pass, multigridCompute, FDTD_INIT_MULTIGRID_CYCLES);
+                run_fdtd_init(pass, fdtdCompute, uniforms, nCells);
+                this->fdtdInitialized = true;
+            } else {
+                run_fdtd_step(pass, fdtdCompute, uniforms, mesh, nCells, inputs.dt, particleIndirect.argsBuffer);
+            }
+            break;
+        default:
+            break; // FIELD_SOLVER_FFT_CPU is solved before the pass
+    }
+}
+
+// Deposits on the GPU, then runs the spectral solve on the CPU and uploads the potentials
+void WebGpuBackend::solve_particle_sources_cpu() {
+    wgpu::CommandEncoderDescriptor encoderDesc{.label = "Deposit Command Encoder"};
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder(&encoderDesc);
+    wgpu::ComputePassDescriptor computePassDesc{.label = "Deposit Pass"};
+    wgpu::ComputePassEncoder pass = encoder.BeginComputePass(&computePassDesc);
+    run_deposit_compute(pass, depositCompute, static_cast<glm::u32>(cells.size()), particleIndirect.argsBuffer);
+    pass.End();
+    wgpu::CommandBuffer commands = encoder.Finish();
+    device.GetQueue().Submit(1, &commands);
+
+    solve_fft_poisson_cpu(device, instance, fftCompute, fields, mesh, cpuThreads);
+}
+
+// Rebuilds the exact solver's octree from the particle state the steps submitted so far leave, and uploads it
+void WebGpuBackend::rebuild_octree() {
+    std::vector<glm::f32vec4> pos, vel;
+    this->snapshot(pos, vel);
+    Octree tree = build_octree(pos, vel, static_cast<glm::u32>(pos.size()));
+    this->nOctreeNodes = upload_particle_octree(device, particleCompute, tree);
+    this->octreeStep = stepCount;
+    this->octreeStale = false;
+}
+
+// Adds the grid-solved particle fields on top of the external fields written by the field stage
+void WebGpuBackend::compute_particle_fields(wgpu::ComputePassEncoder& pass, const StepInputs& inputs) {
+    glm::u32 nCells = static_cast<glm::u32>(cells.size());
+    if (fieldSolver == FIELD_SOLVER_FDTD) {
+        run_fdtd_fields(pass, fdtdCompute, uniforms, nCells);
+        return;
+    }
+
+    run_potential_fields(pass, fieldSolveCompute, nCells);
+}
+
+void WebGpuBackend::compute_wall_interactions(wgpu::ComputePassEncoder& pass) {
+    if (wall.type == WALL_TORUS) {
+        run_torus_wall_compute(
+            pass,
+            torusWallCompute,
+            uniforms,
+            wall.r1,
+            wall.r2,
+            particleIndirect.argsBuffer);
+    } else {
+        run_boundary_compute(
+            pass,
+            boundaryCompute,
+            uniforms,
+            wall.min.x,
+            wall.max.x,
+            wall.min.y,
+            wall.max.y,
+            wall.min.z,
+            wall.max.z,
+            particleIndirect.argsBuffer);
+    }
+}
+
+// Whether particle fields come from the direct per-cell sums rather than the grid solve
+glm::u32 WebGpuBackend::direct_particle_fields(const StepInputs& inputs) {
+    return (inputs.enableParticleFieldContributions && fieldSolver == FIELD_SOLVER_DIRECT) ? 1u : 0u;
+}
+
+BackendDiagnostics WebGpuBackend::read_diagnostics() {
+    instance.ProcessEvents();
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(particles.nCur, 0, particleCompute.nParticlesReadBuf, 0, sizeof(glm::u32));
+    wgpu::CommandBuffer commands = encoder.Finish();
+    device.GetQueue().Submit(1, &commands);
+
+    this->nParticles = read_nparticles(device, instance, particleCompute);
+    this->nParticlesStep = stepCount;
+    return BackendDiagnostics{
+        .nParticles = nParticles,
+        .step = nParticlesStep,
+        .kernelTimings = profiling ? kernel_timings(profiler.profile) : std::vector<KernelTiming>{}
+    };
+}
+
+BackendDiagnostics WebGpuBackend::poll_diagnostics() {
+    this->collect_readbacks();
+    return BackendDiagnostics{
+        .nParticles = nParticles,
+        .step = nParticlesStep,
+        .kernelTimings = profiling ? kernel_timings(profiler.profile) : std::vector<KernelTiming>{}
+    };
+}
+
+void WebGpuBackend::snapshot(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) {
+    glm::u32 n = read_diagnostics().nParticles;
+    pos.resize(n);
+    vel.resize(n);
+    if (n == 0) return;
+
+    size_t size = n * sizeof(glm::f32vec4);
+    wgpu::BufferDescriptor posReadDesc = {
+        .label = "Snapshot Position Read Buffer",
+        .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+        .size = size
+    };
+    wgpu::BufferDescriptor velReadDesc = {
+        .label = "Snapshot Velocity Read Buffer",
+        .usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+        .size = size
+    };
+    wgpu::Buffer posReadBuf = device.CreateBuffer(&posReadDesc);
+    wgpu::Buffer velReadBuf = device.CreateBuffer(&velReadDesc);
+
+    wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(particles.pos, 0, posReadBuf, 0, size);
+    encoder.CopyBufferToBuffer(particles.vel, 0, velReadBuf, 0, size);
+    wgpu::CommandBuffer commands = encoder.Finish();
+    device.GetQueue().Submit(1, &commands);
+
+    if (!read_buffer(instance, posReadBuf, size, pos.data()) || !read_buffer(instance, velReadBuf, size, vel.data())) {
+        std::cerr << "Error reading snapshot" << std::endl;
+        pos.clear();
+        vel.clear();
+    }
+}
+
+// The render passes draw from the buffers this backend steps, so there is nothing to copy
+void WebGpuBackend::sync_render_buffers() {
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <webgpu/webgpu_cpp.h>
+#include "simulation_backend.h"
+#include "compute/particles.h"
+#include "compute/fields.h"
+#include "compute/tracers.h"
+#include "compute/field_textures.h"
+#include "compute/deposit.h"
+#include "compute/field_solve.h"
+#include "compute/fft.h"
+#include "compute/multigrid.h"
+#include "compute/fdtd.h"
+#include "compute/compact.h"
+#include "compute/sort.h"
+#include "compute/indirect.h"
+#include "compute/torus_wall.h"
+#include "compute/boundary.h"
+#include "util/uniform_arena.h"
+#include "util/gpu_profiler.h"
+#include "util/readback_ring.h"
+
+// Uniform arena slots a step may push, and the largest slot alignment WebGPU allows
+const glm::u32 UNIFORM_SLOTS_PER_STEP = 16;
+const glm::u32 UNIFORM_SLOT_SIZE = 256;
+
+// Steps the simulation in compute shaders, recording up to stepsPerSubmit steps into each command buffer
+class WebGpuBackend : public SimulationBackend {
+public:
+    void allocate(const BackendInit& init) override;
+    void set_currents(const std::vector<CurrentVector>& currents) override;
+    void step(glm::u32 nSteps, const StepInputs& inputs) override;
+    void trace(glm::u32 nPoints, const StepInputs& inputs) override;
+    BackendDiagnostics read_diagnostics() override;
+    BackendDiagnostics poll_diagnostics() override;
+    void snapshot(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) override;
+    void sync_render_buffers() override;
+
+private:
+    void record_step(const StepInputs& inputs);
+    wgpu::ComputePassEncoder& stage_pass(ProfiledStage stage);
+    void compute_particle_sources(wgpu::ComputePassEncoder& pass, const StepInputs& inputs);
+    void compute_particle_fields(wgpu::ComputePassEncoder& pass, const StepInputs& inputs);
+    void compute_wall_interactions(wgpu::ComputePassEncoder& pass);
+    void solve_particle_sources_cpu();
+    void rebuild_octree();
+    void collect_readbacks();
+    glm::u32 direct_particle_fields(const StepInputs& inputs);
+
+    wgpu::Device device;
+    wgpu::Instance instance;
+
+    std::vector<Cell> cells;
+    MeshProperties mesh;
+    WallParameters wall;
+    FieldSolver fieldSolver;
+    glm::u32 fieldSolverIterations;
+    glm::u32 multigridCycles;
+    bool fdtdInitialized; // The Yee E has been seeded from the electrostatic solve
+    glm::f32 openingAngle;
+    glm::u32 octreeInterval;
+    glm::u32 nOctreeNodes; // Nodes in the exact solver's octree as last uploaded
+    glm::u32 octreeStep;   // Step the octree was built after
+    bool octreeStale;      // Compaction or sorting has moved the particles the octree indexes
+    bool fieldTextures;    // The PIC push and tracers read the fields from fieldTextureCompute's textures
+    glm::f32 compactDeadFraction;
+    glm::u32 stepsPerSubmit;
+    glm::u32 cpuThreads;
+    glm::u32 nParticles; // Particle count as of the last readback
+    glm::u32 nParticlesStep; // Step nParticles was read back after
+
+    // Simulation state, shared with the render passes
+    ParticleBuffers particles;
+    FieldBuffers fields;
+    TracerBuffers tracers;
+    ParticleIndirectCompute particleIndirect; // Dispatch/draw args built from the GPU particle count
+
+    // Kernels
+    wgpu::Buffer currentSegmentsBuffer;
+    ParticleCompute particleCompute;
+    FieldCompute fieldCompute;
+    DepositCompute depositCompute;
+    FieldSolveCompute fieldSolveCompute;
+    FftCompute fftCompute;
+    MultigridCompute multigridCompute;
+    FdtdCompute fdtdCompute;
+    TracerCompute tracerCompute;
+    FieldTextureCompute fieldTextureCompute;
+    CompactCompute compactCompute;
+    SortCompute sortCompute;
+    TorusWallCompute torusWallCompute;
+    BoundaryCompute boundaryCompute;
+    UniformArena uniforms; // Per-dispatch params for a batch of steps
+
+    // The batch being recorded
+    wgpu::CommandEncoder batchEncoder;
+    wgpu::ComputePassEncoder batchPass;
+
+    // Diagnostics copied out after every batch and read back without waiting
+    ReadbackRing nParticlesReadback;
+    ReadbackRing particleDebugReadback;
+    ReadbackRing eTracerDebugReadback;
+    ReadbackRing bTracerDebugReadback;
+
+    // Profiling
+    bool profiling;
+    bool timedPasses; // Each stage of the batch being recorded gets its own timestamped pass
+    GpuProfiler profiler;
+};
@@ -48,6 +48,17 @@ TEST(ParseArgs, RejectsArgWithoutEquals) {
 	EXPECT_THROW(parse_args(2, argv), std::invalid_argument);
 }
 
+TEST(ParseArgs, AcceptsBareHeadlessFlag) {
+	char* argv[] = {
+		const_cast<char*>("prog"),
+		const_cast<char*>("--headless"),
+		const_cast<char*>("--steps=100")
+	};
+	auto args = parse_args(3, argv);
+	EXPECT_EQ(args["headless"], "true");
+	EXPECT_EQ(args["steps"], "100");
+}
+
 TEST(ExtractParams, ParsesSceneTypeTokamak) {
 	std::unordered_map<std::string, std::string> args = {
 		{"scene", "tokamak"}
@@ -86,3 +97,118 @@ TEST(ExtractParams, ParsesNumericParams) {
 	EXPECT_EQ(params.windowHeight, 1080u);
 	EXPECT_EQ(params.targetFPS, 30u);
 }
+
+TEST(ExtractParams, ParsesFieldSolver) {
+	std::unordered_map<std::string, std::string> args = {
+		{"fieldSolver", "direct"},
+		{"solverIterations", "32"}
+	};
+	auto params = extract_params(args);
+	EXPECT_EQ(params.fieldSolver, FIELD_SOLVER_DIRECT);
+	EXPECT_EQ(params.fieldSolverIterations, 32u);
+}
+
+TEST(ExtractParams, ParsesSpectralFieldSolvers) {
+	EXPECT_EQ(extract_params({{"fieldSolver", "fft"}}).fieldSolver, FIELD_SOLVER_FFT);
+	EXPECT_EQ(extract_params({{"fieldSolver", "fft_cpu"}}).fieldSolver, FIELD_SOLVER_FFT_CPU);
+	EXPECT_EQ(extract_params({}).fieldSolver, FIELD_SOLVER_AUTO);
+}
+
+TEST(ExtractParams, ParsesMultigridSolver) {
+	std::unordered_map<std::string, std::string> args = {
+		{"fieldSolver", "multigrid"},
+		{"multigridCycles", "3"}
+	};
+	auto params = extract_params(args);
+	EXPECT_EQ(params.fieldSolver, FIELD_SOLVER_MULTIGRID);
+	EXPECT_EQ(params.multigridCycles, 3u);
+}
+
+TEST(ExtractParams, ParsesFdtdSolver) {
+	EXPECT_EQ(extract_params({{"fieldSolver", "fdtd"}}).fieldSolver, FIELD_SOLVER_FDTD);
+}
+
+TEST(ExtractParams, ParsesExactSolver) {
+	std::unordered_map<std::string, std::string> args = {
+		{"fieldSolver", "exact"},
+		{"openingAngle", "0.3"},
+		{"octreeInterval", "5"}
+	};
+	auto params = extract_params(args);
+	EXPECT_EQ(params.fieldSolver, FIELD_SOLVER_EXACT);
+	EXPECT_FLOAT_EQ(params.openingAngle, 0.3f);
+	EXPECT_EQ(params.octreeInterval, 5u);
+	EXPECT_FLOAT_EQ(extract_params({}).openingAngle, 0.5f);
+}
+
+TEST(ExtractParams, ParsesFieldTextures) {
+	EXPECT_TRUE(extract_params({{"fieldTextures", "true"}}).fieldTextures);
+	EXPECT_FALSE(extract_params({}).fieldTextures);
+}
+
+TEST(ExtractParams, ParsesCompaction) {
+	std::unordered_map<std::string, std::string> args = {
+		{"compactInterval", "500"},
+		{"compactDeadFraction", "0.4"}
+	};
+	auto params = extract_params(args);
+	EXPECT_EQ(params.compactInterval, 500u);
+	EXPECT_FLOAT_EQ(params.compactDeadFraction, 0.4f);
+	EXPECT_EQ(extract_params({}).compactInterval, 1000u);
+}
+
+TEST(ExtractParams, ParsesSortInterval) {
+	EXPECT_EQ(extract_params({{"sortInterval", "20"}}).sortInterval, 20u);
+	EXPECT_EQ(extract_params({{"sortInterval", "0"}}).sortInterval, 0u);
+	EXPECT_EQ(extract_params({}).sortInterval, 0u);
+}
+
+TEST(ExtractParams, ParsesStepsPerSubmit) {
+	EXPECT_EQ(extract_params({{"stepsPerSubmit", "16"}}).stepsPerSubmit, 16u);
+	EXPECT_EQ(extract_params({}).stepsPerSubmit, 1u);
+}
+
+TEST(ExtractParams, ParsesHeadlessRun) {
+	std::unordered_map<std::string, std::string> args = {
+		{"headless", "true"},
+		{"steps", "2000"},
+		{"simTime", "1e-6"}
+	};
+	auto params = extract_params(args);
+	EXPECT_TRUE(params.headless);
+	EXPECT_EQ(params.steps, 2000u);
+	EXPECT_FLOAT_EQ(params.simTime, 1e-6f * _S);
+	EXPECT_FALSE(extract_params({}).headless);
+	EXPECT_THROW(extract_params({{"headless", "maybe"}}), std::invalid_argument);
+}
+
+TEST(ExtractParams, ParsesBackend) {
+	EXPECT_EQ(extract_params({{"backend", "cpu"}}).backend, BACKEND_CPU);
+	EXPECT_EQ(extract_params({{"backend", "webgpu"}}).backend, BACKEND_WEBGPU);
+	EXPECT_EQ(extract_params({}).backend, BACKEND_WEBGPU);
+	EXPECT_THROW(extract_params({{"backend", "cuda"}}), std::invalid_argument);
+}
+
+TEST(ExtractParams, ParsesProfiling) {
+	char* argv[] = {
+		const_cast<char*>("prog"),
+		const_cast<char*>("--profile"),
+		const_cast<char*>("--profileCsv=out/times.csv")
+	};
+	SimulationParams params = extract_params(parse_args(3, argv));
+	EXPECT_TRUE(params.profile);
+	EXPECT_EQ(params.profileCsv, "out/times.csv");
+	EXPECT_FALSE(extract_params({}).profile);
+}
+
+TEST(ExtractParams, ParsesSeed) {
+	EXPECT_EQ(extract_params({{"seed", "18446744073709551615"}}).seed, 18446744073709551615ull);
+	EXPECT_EQ(extract_params({}).seed, 0u);
+}
+
+TEST(ExtractParams, InvalidFieldSolverThrows) {
+	std::unordered_map<std::string, std::string> args = {
+		{"fieldSolver", "invalid"}
+	};
+	EXPECT_THROW(extract_params(args), std::invalid_argument);
+}
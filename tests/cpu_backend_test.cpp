@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "cpu_backend.h"
+#include "mesh.h"
+#include "physical_constants.h"
+
+// Tests the CPU backend's wall, boundary, compaction, sort and tracer stages, that the Boris push conserves speed
+// in a pure magnetic field, that splitting the work across threads does not change any result, and stepping it
+// through the SimulationBackend interface.
+
+namespace {
+
+// Cubic mesh of n^3 unit cells with centers from 0.5 to n - 0.5, indexed as to_linear_index expects. No center
+// sits on the solenoid axis, where its field is undefined.
+MeshProperties make_mesh(glm::u32 n, std::vector<Cell>& cells) {
+    MeshProperties mesh;
+    mesh.min = glm::f32vec3(0.5f);
+    mesh.max = glm::f32vec3(n - 0.5f);
+    mesh.dim = glm::u32vec3(n);
+    mesh.cell_size = glm::f32vec3(1.0f);
+
+    cells.assign(n * n * n, Cell{});
+    for (glm::u32 x = 0; x < n; x++)
+        for (glm::u32 y = 0; y < n; y++)
+            for (glm::u32 z = 0; z < n; z++) {
+                Cell& cell = cells[to_linear_index(x, y, z, mesh.dim)];
+                cell.pos = glm::f32vec4(x + 0.5f, y + 0.5f, z + 0.5f, 1.0f);
+                cell.min = glm::f32vec3(x, y, z);
+                cell.max = glm::f32vec3(x + 1.0f, y + 1.0f, z + 1.0f);
+            }
+    return mesh;
+}
+
+// Mesh of n^3 cells of side h centered on the origin, so no node sits on the y axis
+MeshProperties make_centered_mesh(glm::u32 n, glm::f32 h, std::vector<Cell>& cells) {
+    MeshProperties mesh;
+    mesh.min = glm::f32vec3(-0.5f * (n - 1) * h);
+    mesh.max = glm::f32vec3(0.5f * (n - 1) * h);
+    mesh.dim = glm::u32vec3(n);
+    mesh.cell_size = glm::f32vec3(h);
+
+    cells.assign(n * n * n, Cell{});
+    for (glm::u32 x = 0; x < n; x++)
+        for (glm::u32 y = 0; y < n; y++)
+            for (glm::u32 z = 0; z < n; z++) {
+                glm::f32vec3 c = mesh.min + glm::f32vec3(x, y, z) * h;
+                Cell& cell = cells[to_linear_index(x, y, z, mesh.dim)];
+                cell.pos = glm::f32vec4(c.x, c.y, c.z, 1.0f);
+                cell.min = c - glm::f32vec3(0.5f * h);
+                cell.max = c + glm::f32vec3(0.5f * h);
+            }
+    return mesh;
+}
+
+// Fields of a line charge and current along the y axis: E radial and B circling it in the xz-plane, both
+// falling off as 1/r
+void fill_line_current_fields(CpuSimulation& sim) {
+    for (size_t i = 0; i < sim.cellLocation.x.size(); i++) {
+        glm::f32 x = sim.cellLocation.x[i];
+        glm::f32 z = sim.cellLocation.z[i];
+        glm::f32 r2 = x * x + z * z;
+        sim.eField.x[i] = x / r2;
+        sim.eField.y[i] = 0.0f;
+        sim.eField.z[i] = z / r2;
+        sim.bField.x[i] = -z / r2;
+        sim.bField.y[i] = 0.0f;
+        sim.bField.z[i] = x / r2;
+    }
+}
+
+CpuSimulation make_simulation(const std::vector<glm::f32vec4>& pos, const std::vector<glm::f32vec4>& vel, glm::u32 nThreads) {
+    std::vector<Cell> cells;
+    make_mesh(4, cells);
+    return create_cpu_simulation(cells, pos, vel, static_cast<glm::u32>(pos.size()), {}, nThreads);
+}
+
+}  // namespace
+
+TEST(CpuBackend, BoundaryWrapsIntoBox) {
+    std::vector<glm::f32vec4> pos = {
+        glm::f32vec4(1.5f, 0.5f, 0.5f, ELECTRON),
+        glm::f32vec4(-0.25f, 2.25f, 0.5f, PROTON),
+        glm::f32vec4(0.5f, 0.5f, 3.5f, ELECTRON),
+        glm::f32vec4(5.0f, 5.0f, 5.0f, 0.0f)
+    };
+    std::vector<glm::f32vec4> vel(pos.size(), glm::f32vec4(0.0f));
+    CpuSimulation sim = make_simulation(pos, vel, 2);
+
+    cpu_boundary_compute(sim, glm::f32vec3(0.0f), glm::f32vec3(2.0f));
+
+    EXPECT_FLOAT_EQ(sim.particles.x[0], 1.5f);
+    EXPECT_FLOAT_EQ(sim.particles.x[1], 1.75f);
+    EXPECT_FLOAT_EQ(sim.particles.y[1], 0.25f);
+    EXPECT_FLOAT_EQ(sim.particles.z[2], 1.5f);
+    EXPECT_FLOAT_EQ(sim.particles.x[3], 5.0f); // dead slots are left alone
+}
+
+TEST(CpuBackend, TorusWallKillsParticlesOutsideMinorRadius) {
+    std::vector<glm::f32vec4> pos = {
+        glm::f32vec4(1.0f, 0.0f, 0.0f, PROTON),  // on the centerline
+        glm::f32vec4(0.0f, 0.1f, -1.0f, PROTON), // inside the minor radius
+        glm::f32vec4(1.5f, 0.0f, 0.0f, PROTON),  // outside, radially
+        glm::f32vec4(0.0f, 0.3f, 1.0f, PROTON)   // outside, vertically
+    };
+    std::vector<glm::f32vec4> vel(pos.size(), glm::f32vec4(0.0f));
+    CpuSimulation sim = make_simulation(pos, vel, 3);
+
+    cpu_torus_wall_compute(sim, 1.0f, 0.25f);
+
+    EXPECT_EQ(sim.particles.species[0], PROTON);
+    EXPECT_EQ(sim.particles.species[1], PROTON);
+    EXPECT_EQ(sim.particles.species[2], 0.0f);
+    EXPECT_EQ(sim.particles.species[3], 0.0f);
+}
+
+TEST(CpuBackend, CompactionKeepsLiveParticlesInOrder) {
+    std::vector<glm::f32vec4> pos, vel;
+    for (glm::u32 i = 0; i < 10; i++) {
+        pos.push_back(glm::f32vec4(i, 0.0f, 0.0f, i % 3 == 0 ? glm::f32(PROTON) : 0.0f));
+        vel.push_back(glm::f32vec4(0.0f, i, 0.0f, 0.0f));
+    }
+    CpuSimulation sim = make_simulation(pos, vel, 1);
+
+    // 6 of 10 slots are dead, under a 0.75 threshold nothing moves
+    EXPECT_FALSE(cpu_compact(sim, 0.75f));
+    EXPECT_EQ(sim.particles.n, 10u);
+
+    EXPECT_TRUE(cpu_compact(sim, 0.25f));
+    ASSERT_EQ(sim.particles.n, 4u);
+    for (glm::u32 i = 0; i < 4; i++) {
+        EXPECT_FLOAT_EQ(sim.particles.x[i], 3.0f * i);
+        EXPECT_FLOAT_EQ(sim.particles.vy[i], 3.0f * i);
+        EXPECT_EQ(sim.particles.species[i], PROTON);
+    }
+    EXPECT_EQ(sim.particles.species[4], 0.0f);
+}
+
+TEST(CpuBackend, SortGroupsParticlesByCell) {
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_mesh(4, cells);
+
+    // Cells are keyed by the base node, so x in [0.5, 1.5) is node 0 along x
+    std::vector<glm::f32vec4> pos = {
+        glm::f32vec4(2.6f, 0.6f, 0.6f, PROTON),   // x node 2
+        glm::f32vec4(9.0f, 0.6f, 0.6f, PROTON),   // outside the mesh
+        glm::f32vec4(0.6f, 0.6f, 0.6f, ELECTRON), // x node 0
+        glm::f32vec4(2.7f, 0.6f, 0.6f, ELECTRON), // x node 2, after the first
+        glm::f32vec4(0.6f, 0.6f, 0.6f, 0.0f),     // dead
+        glm::f32vec4(1.6f, 0.6f, 0.6f, PROTON)    // x node 1
+    };
+    std::vector<glm::f32vec4> vel;
+    for (glm::u32 i = 0; i < pos.size(); i++) {
+        vel.push_back(glm::f32vec4(i, 0.0f, 0.0f, 0.0f));
+    }
+    CpuSimulation sim = create_cpu_simulation(cells, pos, vel, static_cast<glm::u32>(pos.size()), {}, 2);
+
+    cpu_sort(sim, mesh);
+
+    // Velocities travel with their particles; the overflow bucket keeps its original order
+    std::vector<glm::f32> expected = { 2.0f, 5.0f, 0.0f, 3.0f, 1.0f, 4.0f };
+    ASSERT_EQ(sim.particles.n, 6u);
+    for (glm::u32 i = 0; i < expected.size(); i++) {
+        EXPECT_FLOAT_EQ(sim.particles.vx[i], expected[i]);
+        EXPECT_FLOAT_EQ(sim.particles.x[i], pos[static_cast<glm::u32>(expected[i])].x);
+    }
+    EXPECT_EQ(sim.particles.species[5], 0.0f);
+}
+
+TEST(CpuBackend, BorisPushConservesSpeedInUniformB) {
+    std::vector<glm::f32vec4> pos = { glm::f32vec4(1.5f, 1.5f, 1.5f, ELECTRON) };
+    std::vector<glm::f32vec4> vel = { glm::f32vec4(1e4f, 0.0f, 2e3f, 0.0f) };
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_mesh(4, cells);
+    CpuSimulation sim = create_cpu_simulation(cells, pos, vel, 1, {}, 1);
+
+    for (glm::u32 i = 0; i < cells.size(); i++) {
+        sim.bField.y[i] = 1e-3f;
+    }
+
+    glm::f32 speed = glm::length(glm::f32vec3(vel[0]));
+    for (int step = 0; step < 1000; step++) {
+        cpu_particle_pic_compute(sim, mesh, 1e-10f, false);
+    }
+    glm::f32vec3 v(sim.particles.vx[0], sim.particles.vy[0], sim.particles.vz[0]);
+    EXPECT_NEAR(glm::length(v), speed, 1e-4f * speed);
+    EXPECT_FLOAT_EQ(v.y, 0.0f); // no force along B
+    EXPECT_NE(v.x, vel[0].x);   // but it has gyrated
+}
+
+TEST(CpuBackend, ResultsDoNotDependOnThreadCount) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<glm::f32> unit(0.2f, 2.8f);
+    std::vector<glm::f32vec4> pos, vel;
+    for (int i = 0; i < 300; i++) {
+        pos.push_back(glm::f32vec4(unit(rng), unit(rng), unit(rng), i % 2 == 0 ? ELECTRON : PROTON));
+        vel.push_back(glm::f32vec4(1e3f * unit(rng), -1e3f * unit(rng), 1e3f * unit(rng), 0.0f));
+    }
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_mesh(4, cells);
+    std::vector<CurrentVector> currents = {
+        CurrentVector{ .x = glm::f32vec4(1.5f, 1.5f, -1.0f, 0.0f), .dx = glm::f32vec4(0.0f, 0.0f, 0.1f, 0.0f), .i = 1e3f }
+    };
+
+    auto run = [&](glm::u32 nThreads) {
+        CpuSimulation sim = create_cpu_simulation(cells, pos, vel, static_cast<glm::u32>(pos.size()), {}, nThreads);
+        cpu_external_field_compute(sim, currents);
+        for (int step = 0; step < 10; step++) {
+            cpu_field_compute(sim, 0.5f, true);
+            cpu_particle_pic_compute(sim, mesh, 1e-9f, true);
+            cpu_boundary_compute(sim, mesh.min, mesh.max);
+        }
+        return sim;
+    };
+    CpuSimulation serial = run(1);
+    CpuSimulation threaded = run(4);
+    for (glm::u32 i = 0; i < serial.particles.n; i++) {
+        ASSERT_TRUE(std::isfinite(serial.particles.vx[i]));
+    }
+
+    EXPECT_EQ(serial.particles.x, threaded.particles.x);
+    EXPECT_EQ(serial.particles.vz, threaded.particles.vz);
+    EXPECT_EQ(serial.eField.x, threaded.eField.x);
+    EXPECT_EQ(serial.bField.y, threaded.bField.y);
+}
+
+TEST(CpuBackend, WorkerPoolCoversEveryIndexOnceAcrossJobs) {
+    WorkerPool pool(4);
+    ASSERT_EQ(pool.size(), 4u);
+    for (glm::u32 n : { 0u, 1u, 3u, 7u, 1000u }) {
+        std::vector<int> visits(n, 0);
+        for (int job = 0; job < 50; job++) {
+            parallel_for(pool, n, [&](glm::u32 begin, glm::u32 end) {
+                for (glm::u32 i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            });
+        }
+        for (glm::u32 i = 0; i < n; i++) {
+            EXPECT_EQ(visits[i], 50) << "n = " << n << ", index " << i;
+        }
+    }
+}
+
+TEST(CpuBackend, StepsThroughBackendInterface) {
+    std::vector<Cell> cells;
+    BackendInit init;
+    init.mesh = make_mesh(4, cells);
+    init.cells = cells;
+    for (int i = 0; i < 8; i++) {
+        init.particlePos.push_back(glm::f32vec4(0.6f + 0.3f * i, 2.0f, 2.0f, i < 6 ? glm::f32(PROTON) : 0.0f));
+        init.particleVel.push_back(glm::f32vec4(1e9f, 0.0f, 0.0f, 0.0f));
+    }
+    init.initialParticles = 6;
+    init.wall = WallParameters{ .type = WALL_PERIODIC_BOX, .min = init.mesh.min, .max = init.mesh.max };
+    init.fieldSolver = FIELD_SOLVER_DIRECT;
+    init.cpuThreads = 2;
+
+    std::unique_ptr<SimulationBackend> backend = std::make_unique<CpuBackend>();
+    backend->allocate(init);
+    backend->step(20, StepInputs{ .dt = 1e-9f, .solenoidFlux = 0.0f, .enableParticleFieldContributions = false });
+
+    EXPECT_EQ(backend->read_diagnostics().nParticles, 6u);
+    std::vector<glm::f32vec4> pos, vel;
+    backend->snapshot(pos, vel);
+    ASSERT_EQ(pos.size(), 6u);
+    ASSERT_EQ(vel.size(), 6u);
+    for (const glm::f32vec4& p : pos) {
+        EXPECT_GE(p.x, init.mesh.min.x);
+        EXPECT_LE(p.x, init.mesh.max.x);
+        EXPECT_EQ(p.w, PROTON);
+    }
+}
+
+TEST(CpuBackend, CompactsAbsorbedParticlesOnInterval) {
+    std::vector<Cell> cells;
+    BackendInit init;
+    init.mesh = make_mesh(4, cells);
+    init.cells = cells;
+    for (int i = 0; i < 10; i++) {
+        // Every other particle starts outside the torus
+        glm::f32 r = i % 2 == 0 ? 1.0f : 2.0f;
+        init.particlePos.push_back(glm::f32vec4(r, 0.0f, 0.0f, PROTON));
+        init.particleVel.push_back(glm::f32vec4(0.0f));
+    }
+    init.initialParticles = 10;
+    init.wall = WallParameters{ .type = WALL_TORUS, .r1 = 1.0f, .r2 = 0.25f };
+    init.compactInterval = 1;
+    init.compactDeadFraction = 0.25f;
+
+    CpuBackend backend;
+    backend.allocate(init);
+    StepInputs inputs = { .dt = 1e-12f, .solenoidFlux = 0.0f, .enableParticleFieldContributions = false };
+
+    // Compaction only runs after a step that is a multiple of the interval, and never after the first
+    backend.step(1, inputs);
+    EXPECT_EQ(backend.read_diagnostics().nParticles, 10u);
+    backend.step(1, inputs);
+    EXPECT_EQ(backend.read_diagnostics().nParticles, 5u);
+}
+
+TEST(CpuBackend, TracesSeveralPointsPerCall) {
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_centered_mesh(16, 0.125f, cells);
+    std::vector<glm::f32vec4> tracerLoc = { glm::f32vec4(0.5f, 0.0f, 0.0f, 0.0f), glm::f32vec4(0.0f, 0.25f, -0.75f, 0.0f) };
+
+    CpuSimulation batched = create_cpu_simulation(cells, {}, {}, 0, tracerLoc, 2);
+    CpuSimulation single = create_cpu_simulation(cells, {}, {}, 0, tracerLoc, 1);
+    fill_line_current_fields(batched);
+    fill_line_current_fields(single);
+    cpu_tracer_compute(batched, mesh, 5);
+    for (int i = 0; i < 5; i++) {
+        cpu_tracer_compute(single, mesh, 1);
+    }
+
+    // The first call starts at the fixed first point, so 4 new points follow it
+    EXPECT_EQ(batched.curTraceIdx, 5u);
+    EXPECT_EQ(single.curTraceIdx, 5u);
+    for (glm::u32 tracer = 0; tracer < 2; tracer++) {
+        glm::u32 traceStart = tracer * TRACER_LENGTH;
+        for (glm::u32 idx = 1; idx < 5; idx++) {
+            EXPECT_NE(batched.eTraces[traceStart + idx], batched.eTraces[traceStart + idx - 1]);
+            EXPECT_NE(batched.bTraces[traceStart + idx], batched.bTraces[traceStart + idx - 1]);
+            EXPECT_EQ(batched.eTraces[traceStart + idx], single.eTraces[traceStart + idx]);
+            EXPECT_EQ(batched.bTraces[traceStart + idx], single.bTraces[traceStart + idx]);
+        }
+    }
+}
+
+TEST(CpuBackend, TracersFollowMeshFieldLines) {
+    std::vector<Cell> cells;
+    MeshProperties mesh = make_centered_mesh(16, 0.125f, cells);
+    std::vector<glm::f32vec4> tracerLoc = { glm::f32vec4(0.5f, 0.0f, 0.0f, 0.0f) };
+    CpuSimulation sim = create_cpu_simulation(cells, {}, {}, 0, tracerLoc, 1);
+    fill_line_current_fields(sim);
+
+    // B circles the line current, so the B trail stays on its starting radius; E points straight out from it
+    cpu_tracer_compute(sim, mesh, TRACER_LENGTH);
+    glm::f32 maxRadiusError = 0.0f;
+    for (glm::u32 idx = 0; idx < TRACER_LENGTH; idx++) {
+        glm::f32vec4 p = sim.bTraces[idx];
+        maxRadiusError = std::max(maxRadiusError, std::abs(std::sqrt(p.x * p.x + p.z * p.z) - 0.5f));
+        EXPECT_FLOAT_EQ(p.y, 0.0f);
+    }
+    // A fixed Euler step would drift outward by about 1e-2 over the trail. RK4 leaves about 4e-4, most of it from
+    // interpolating the 1/r field between nodes.
+    EXPECT_LT(maxRadiusError, 5e-4f);
+    glm::f32vec4 eEnd = sim.eTraces[TRACER_LENGTH - 1];
+    EXPECT_NEAR(eEnd.x, std::min(0.5f + (TRACER_LENGTH - 1) * 0.005f, mesh.max.x), 0.01f);
+    EXPECT_NEAR(eEnd.z, 0.0f, 1e-4f);
+}
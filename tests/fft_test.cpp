@@ -0,0 +1,128 @@
+#define _USE_MATH_DEFINES
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+#include "fft_cpu.h"
+#include "mesh.h"
+
+// Tests the CPU transforms behind the spectral field solve fallback against a direct 3D DFT, and checks that
+// the periodic Poisson solve inverts the same 7-point Laplacian the grid relaxation uses.
+
+namespace {
+
+using Complex = std::complex<float>;
+
+std::vector<Complex> random_grid(glm::u32vec3 dim, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<Complex> data(dim.x * dim.y * dim.z);
+    for (Complex& c : data) c = Complex(dist(rng), dist(rng));
+    return data;
+}
+
+std::vector<Complex> direct_dft_3d(const std::vector<Complex>& data, glm::u32vec3 dim) {
+    std::vector<Complex> out(data.size());
+    for (glm::u32 kx = 0; kx < dim.x; kx++)
+    for (glm::u32 ky = 0; ky < dim.y; ky++)
+    for (glm::u32 kz = 0; kz < dim.z; kz++) {
+        std::complex<double> sum = 0.0;
+        for (glm::u32 x = 0; x < dim.x; x++)
+        for (glm::u32 y = 0; y < dim.y; y++)
+        for (glm::u32 z = 0; z < dim.z; z++) {
+            double angle = -2.0 * M_PI * (double(kx * x) / dim.x + double(ky * y) / dim.y + double(kz * z) / dim.z);
+            sum += std::complex<double>(data[to_linear_index(x, y, z, dim)]) * std::polar(1.0, angle);
+        }
+        out[to_linear_index(kx, ky, kz, dim)] = Complex(sum);
+    }
+    return out;
+}
+
+float max_abs_diff(const std::vector<Complex>& a, const std::vector<Complex>& b) {
+    float diff = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) diff = std::max(diff, std::abs(a[i] - b[i]));
+    return diff;
+}
+
+}  // namespace
+
+TEST(Fft, MatchesDirectDftPowerOfTwo) {
+    glm::u32vec3 dim { 8, 4, 16 };
+    std::vector<Complex> data = random_grid(dim, 1);
+    std::vector<Complex> expected = direct_dft_3d(data, dim);
+
+    fft_3d(data, dim, false, 1);
+    EXPECT_LT(max_abs_diff(data, expected), 1e-3f);
+}
+
+TEST(Fft, MatchesDirectDftOtherLengths) {
+    glm::u32vec3 dim { 5, 7, 6 };
+    std::vector<Complex> data = random_grid(dim, 2);
+    std::vector<Complex> expected = direct_dft_3d(data, dim);
+
+    fft_3d(data, dim, false, 1);
+    EXPECT_LT(max_abs_diff(data, expected), 1e-3f);
+}
+
+TEST(Fft, InverseRoundTrip) {
+    glm::u32vec3 dim { 16, 9, 8 };
+    std::vector<Complex> original = random_grid(dim, 3);
+    std::vector<Complex> data = original;
+
+    fft_3d(data, dim, false, 1);
+    fft_3d(data, dim, true, 1);
+    for (Complex& c : data) c /= static_cast<float>(data.size());
+    EXPECT_LT(max_abs_diff(data, original), 1e-5f);
+}
+
+TEST(Fft, ThreadCountDoesNotChangeResult) {
+    glm::u32vec3 dim { 12, 16, 10 };
+    std::vector<Complex> single = random_grid(dim, 4);
+    std::vector<Complex> multi = single;
+
+    fft_3d(single, dim, false, 1);
+    fft_3d(multi, dim, false, 4);
+    EXPECT_EQ(max_abs_diff(single, multi), 0.0f);
+}
+
+TEST(Fft, PoissonSolveInvertsDiscreteLaplacian) {
+    MeshProperties mesh;
+    mesh.dim = glm::u32vec3 { 8, 12, 6 };
+    mesh.cell_size = glm::f32vec3 { 0.1f, 0.05f, 0.2f };
+    glm::u32vec3 dim = mesh.dim;
+
+    // Zero-mean source, since the k = 0 mode is dropped
+    std::vector<Complex> source = random_grid(dim, 5);
+    Complex mean = 0.0f;
+    for (const Complex& c : source) mean += c;
+    mean /= static_cast<float>(source.size());
+    for (Complex& c : source) c -= mean;
+
+    std::vector<Complex> u = source;
+    solve_poisson_periodic(u, mesh, 2);
+
+    // Periodic 7-point Laplacian of the solution should give back -source
+    auto at = [&](int x, int y, int z) {
+        x = (x + dim.x) % dim.x;
+        y = (y + dim.y) % dim.y;
+        z = (z + dim.z) % dim.z;
+        return u[to_linear_index(x, y, z, dim)];
+    };
+    float maxError = 0.0f, maxSource = 0.0f;
+    for (int x = 0; x < int(dim.x); x++)
+    for (int y = 0; y < int(dim.y); y++)
+    for (int z = 0; z < int(dim.z); z++) {
+        glm::f32vec3 h = mesh.cell_size;
+        Complex c = at(x, y, z);
+        Complex lap =
+            (at(x - 1, y, z) - 2.0f * c + at(x + 1, y, z)) / (h.x * h.x) +
+            (at(x, y - 1, z) - 2.0f * c + at(x, y + 1, z)) / (h.y * h.y) +
+            (at(x, y, z - 1) - 2.0f * c + at(x, y, z + 1)) / (h.z * h.z);
+        Complex f = source[to_linear_index(x, y, z, dim)];
+        maxError = std::max(maxError, std::abs(lap + f));
+        maxSource = std::max(maxSource, std::abs(f));
+    }
+    EXPECT_LT(maxError, 1e-3f * maxSource);
+}
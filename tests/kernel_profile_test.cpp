@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "util/kernel_profile.h"
+
+// Tests the rolling per-stage averages reported by --profile.
+
+TEST(KernelProfile, ReportsOnlyStagesWithSamples) {
+    KernelProfile profile;
+    EXPECT_TRUE(kernel_timings(profile).empty());
+
+    add_kernel_sample(profile, STAGE_WALL, 1.0);
+    add_kernel_sample(profile, STAGE_MOTION, 2.0);
+    add_kernel_sample(profile, STAGE_MOTION, 4.0);
+
+    std::vector<KernelTiming> timings = kernel_timings(profile);
+    ASSERT_EQ(timings.size(), 2u);
+    EXPECT_EQ(timings[0].stage, STAGE_MOTION);
+    EXPECT_DOUBLE_EQ(timings[0].averageMs, 3.0);
+    EXPECT_EQ(timings[0].samples, 2u);
+    EXPECT_EQ(timings[1].stage, STAGE_WALL);
+    EXPECT_DOUBLE_EQ(timings[1].averageMs, 1.0);
+}
+
+TEST(KernelProfile, AverageRollsOverWindow) {
+    KernelProfile profile;
+    for (glm::u32 i = 0; i < PROFILE_WINDOW; i++) {
+        add_kernel_sample(profile, STAGE_FIELDS, 1.0);
+    }
+    EXPECT_DOUBLE_EQ(kernel_timings(profile)[0].averageMs, 1.0);
+
+    // A second window's worth replaces every earlier sample
+    for (glm::u32 i = 0; i < PROFILE_WINDOW; i++) {
+        add_kernel_sample(profile, STAGE_FIELDS, 3.0);
+    }
+    std::vector<KernelTiming> timings = kernel_timings(profile);
+    EXPECT_EQ(timings[0].samples, PROFILE_WINDOW);
+    EXPECT_DOUBLE_EQ(timings[0].averageMs, 3.0);
+
+    // Half a window more leaves an even mix
+    for (glm::u32 i = 0; i < PROFILE_WINDOW / 2; i++) {
+        add_kernel_sample(profile, STAGE_FIELDS, 5.0);
+    }
+    EXPECT_DOUBLE_EQ(kernel_timings(profile)[0].averageMs, 4.0);
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "mesh.h"
+
+// Tests mesh indexing and the coarse meshes used by the multigrid field solver.
+
+TEST(Mesh, LinearIndexRoundTrip) {
+    glm::u32vec3 dim { 3, 4, 5 };
+    EXPECT_EQ(to_linear_index(0, 0, 0, dim), 0);
+    EXPECT_EQ(to_linear_index(0, 1, 0, dim), 1);
+    EXPECT_EQ(to_linear_index(0, 0, 1, dim), 4);
+    EXPECT_EQ(to_linear_index(1, 0, 0, dim), 20);
+    EXPECT_EQ(to_linear_index(3, 0, 0, dim), -1);
+    EXPECT_EQ(to_linear_index(0, -1, 0, dim), -1);
+}
+
+TEST(Mesh, CoarsenKeepsEveryOtherNode) {
+    MeshProperties mesh;
+    mesh.min = glm::f32vec3 { -1.0f, -1.0f, -1.0f };
+    mesh.dim = glm::u32vec3 { 41, 8, 1 };
+    mesh.cell_size = glm::f32vec3 { 0.05f, 0.1f, 0.2f };
+
+    MeshProperties coarse = coarsen_mesh(mesh);
+    EXPECT_EQ(coarse.dim.x, 21u);
+    EXPECT_EQ(coarse.dim.y, 5u); // one node past the last fine node
+    EXPECT_EQ(coarse.dim.z, 1u);
+    EXPECT_FLOAT_EQ(coarse.cell_size.x, 0.1f);
+    EXPECT_FLOAT_EQ(coarse.min.x, -1.0f);
+    EXPECT_FLOAT_EQ(coarse.max.x, 1.0f);
+}
+
+TEST(Mesh, CoarsenMaskInjectsFineNodes) {
+    glm::u32vec3 fineDim { 5, 5, 5 };
+    glm::u32vec3 coarseDim { 3, 3, 3 };
+
+    // Only the fine nodes with x >= 2 are active
+    std::vector<glm::u32> mask(fineDim.x * fineDim.y * fineDim.z, 0);
+    for (glm::i32 x = 2; x < 5; x++)
+        for (glm::i32 z = 0; z < 5; z++)
+            for (glm::i32 y = 0; y < 5; y++)
+                mask[to_linear_index(x, y, z, fineDim)] = 1;
+
+    std::vector<glm::u32> coarse = coarsen_mask(mask, fineDim, coarseDim);
+    ASSERT_EQ(coarse.size(), 27u);
+    for (glm::i32 x = 0; x < 3; x++) {
+        EXPECT_EQ(coarse[to_linear_index(x, 1, 1, coarseDim)], x >= 1 ? 1u : 0u);
+    }
+}
+
+TEST(Mesh, PeriodicNeighborsWrapPastLastNode) {
+    MeshProperties mesh;
+    mesh.min = glm::f32vec3 { -1.0f, -1.0f, -1.0f };
+    mesh.max = glm::f32vec3 { 0.5f, 0.5f, 0.5f };
+    mesh.dim = glm::u32vec3 { 4, 4, 4 };
+    mesh.cell_size = glm::f32vec3 { 0.5f, 0.5f, 0.5f };
+
+    // Between the last node and the +x face, inside the first cell on y and z
+    glm::f32vec3 pos { 0.75f, -0.75f, -0.75f };
+    EXPECT_EQ(cell_neighbors(pos, mesh).xp_yp_zp, -1);
+
+    mesh.periodic = true;
+    EXPECT_FLOAT_EQ(mesh_upper_bound(mesh).x, 1.0f);
+    CellNeighbors neighbors = cell_neighbors(pos, mesh);
+    EXPECT_EQ(neighbors.xm_ym_zm, to_linear_index(3, 0, 0, mesh.dim));
+    EXPECT_EQ(neighbors.xp_ym_zm, to_linear_index(0, 0, 0, mesh.dim));
+    EXPECT_EQ(neighbors.xp_yp_zp, to_linear_index(0, 1, 1, mesh.dim));
+
+    // The +x face itself is the -x face
+    EXPECT_EQ(cell_neighbors(glm::f32vec3 { 1.0f, -0.75f, -0.75f }, mesh).xp_yp_zp, -1);
+}
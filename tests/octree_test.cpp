@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "octree.h"
+#include "physical_constants.h"
+
+// Compares the Barnes-Hut octree used by the exact pusher against the direct particle-particle sum.
+
+namespace {
+
+const glm::u32 N_PARTICLES = 2000;
+const glm::u32 N_SAMPLES = 200;
+const glm::f32 OPENING_ANGLE = 0.5f;
+const glm::f32 OCTREE_TOLERANCE = 0.03f; // RMS error relative to the RMS field (B has no dipole term)
+
+void make_particles(std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) {
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<glm::f32> unit(-1.0f, 1.0f);
+    for (glm::u32 i = 0; i < N_PARTICLES; i++) {
+        glm::f32 species = (i % 2 == 0) ? static_cast<glm::f32>(ELECTRON) : static_cast<glm::f32>(PROTON);
+        if (i % 50 == 0) species = 0.0f; // a few inactive slots
+        pos.push_back(glm::f32vec4(unit(gen), 0.5f * unit(gen), unit(gen), species));
+        vel.push_back(glm::f32vec4(1e5f * unit(gen), 1e5f * unit(gen), 1e5f * unit(gen), 0.0f));
+    }
+}
+
+// Same sum as compute_particle_field_contributions in field_common.wgsl
+void direct_fields(
+    const std::vector<glm::f32vec4>& pos,
+    const std::vector<glm::f32vec4>& vel,
+    glm::f32vec3 loc,
+    glm::u32 skipId,
+    glm::f32vec3& E,
+    glm::f32vec3& B)
+{
+    for (glm::u32 i = 0; i < pos.size(); i++) {
+        if (i == skipId || pos[i].w == 0.0f) continue;
+        glm::f32 charge = particle_charge(pos[i].w);
+        glm::f32vec3 r = loc - glm::f32vec3(pos[i].x, pos[i].y, pos[i].z);
+        glm::f32 r_mag = glm::length(r);
+        if (r_mag < 0.00001f) continue;
+        glm::f32vec3 r_norm = r / r_mag;
+        E += ((K_E * charge) / (r_mag * r_mag)) * r_norm;
+        B += ((MU_0_OVER_4_PI * charge) / (r_mag * r_mag)) * glm::cross(glm::f32vec3(vel[i].x, vel[i].y, vel[i].z), r_norm);
+    }
+}
+
+// RMS of |tree - direct| over the RMS of |direct|, for E and B
+void field_errors(glm::f32 theta, glm::f64& eError, glm::f64& bError) {
+    std::vector<glm::f32vec4> pos, vel;
+    make_particles(pos, vel);
+    Octree tree = build_octree(pos, vel, N_PARTICLES);
+
+    glm::f64 eDiff = 0.0, eNorm = 0.0, bDiff = 0.0, bNorm = 0.0;
+    for (glm::u32 s = 0; s < N_SAMPLES; s++) {
+        glm::u32 id = (s * 7919u) % N_PARTICLES;
+        glm::f32vec3 loc(pos[id].x, pos[id].y, pos[id].z);
+
+        glm::f32vec3 eDirect(0.0f, 0.0f, 0.0f), bDirect(0.0f, 0.0f, 0.0f);
+        glm::f32vec3 eTree(0.0f, 0.0f, 0.0f), bTree(0.0f, 0.0f, 0.0f);
+        direct_fields(pos, vel, loc, id, eDirect, bDirect);
+        octree_fields(tree, pos, vel, loc, static_cast<glm::i32>(id), theta, eTree, bTree);
+
+        glm::f64 de = glm::length(eTree - eDirect), db = glm::length(bTree - bDirect);
+        glm::f64 ne = glm::length(eDirect), nb = glm::length(bDirect);
+        eDiff += de * de; eNorm += ne * ne;
+        bDiff += db * db; bNorm += nb * nb;
+    }
+    eError = std::sqrt(eDiff / eNorm);
+    bError = std::sqrt(bDiff / bNorm);
+}
+
+} // namespace
+
+TEST(Octree, NodeCountIsBounded) {
+    std::vector<glm::f32vec4> pos, vel;
+    make_particles(pos, vel);
+    Octree tree = build_octree(pos, vel, N_PARTICLES);
+
+    // Inactive particles are left out; every other particle lands in exactly one leaf
+    glm::u32 nActive = N_PARTICLES - (N_PARTICLES + 49) / 50;
+    ASSERT_EQ(tree.particles.size(), nActive);
+    EXPECT_LE(tree.nodes.size(), 2u * nActive);
+    EXPECT_EQ(tree.nodes[0].links.y, tree.nodes.size());
+
+    glm::u32 inLeaves = 0;
+    for (const OctreeNode& n : tree.nodes) inLeaves += n.links.w;
+    EXPECT_EQ(inLeaves, nActive);
+}
+
+TEST(Octree, ZeroOpeningAngleMatchesDirectSum) {
+    glm::f64 eError, bError;
+    field_errors(0.0f, eError, bError);
+    EXPECT_LT(eError, 1e-4);
+    EXPECT_LT(bError, 1e-4);
+}
+
+TEST(Octree, OpeningAngleWithinTolerance) {
+    glm::f64 eError, bError;
+    field_errors(OPENING_ANGLE, eError, bError);
+    EXPECT_LT(eError, OCTREE_TOLERANCE);
+    EXPECT_LT(bError, OCTREE_TOLERANCE);
+}
+
+TEST(Octree, CoincidentParticlesStopAtMaxDepth) {
+    std::vector<glm::f32vec4> pos(32, glm::f32vec4(0.25f, 0.25f, 0.25f, static_cast<glm::f32>(PROTON)));
+    std::vector<glm::f32vec4> vel(32, glm::f32vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    pos.push_back(glm::f32vec4(1.0f, 1.0f, 1.0f, static_cast<glm::f32>(ELECTRON)));
+    vel.push_back(glm::f32vec4(0.0f, 0.0f, 0.0f, 0.0f));
+
+    Octree tree = build_octree(pos, vel, static_cast<glm::u32>(pos.size()));
+    EXPECT_LE(tree.nodes.size(), 3u);
+    EXPECT_FLOAT_EQ(tree.nodes[0].center.w, 31.0f * Q_E);
+}
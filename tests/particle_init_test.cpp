@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cstring>
+#include <vector>
+#include "plasma.h"
+
+// Tests the seeded host particle init used by the CPU backend.
+
+namespace {
+
+const std::vector<SpeciesFraction> SPECIES = { { ELECTRON, 1.0f }, { PROTON, 3.0f } };
+const ParticleDistribution BOX = { .type = DISTRIBUTION_BOX, .min = glm::f32vec3(-1.0f, 0.0f, 2.0f), .max = glm::f32vec3(1.0f, 0.5f, 3.0f) };
+const glm::u32 N = 10000;
+
+void generate(glm::u64 seed, glm::u32 nThreads, const ParticleDistribution& dist, std::vector<glm::f32vec4>& pos, std::vector<glm::f32vec4>& vel) {
+    pos.assign(N, glm::f32vec4(0.0f));
+    vel.assign(N, glm::f32vec4(0.0f));
+    generate_initial_particles(pos.data(), vel.data(), N, dist, SPECIES, 300.0f, seed, nThreads);
+}
+
+} // namespace
+
+TEST(ParticleInit, SameSeedIsBitIdenticalForAnyThreadCount) {
+    std::vector<glm::f32vec4> pos1, vel1, pos7, vel7;
+    generate(42, 1, BOX, pos1, vel1);
+    generate(42, 7, BOX, pos7, vel7);
+    EXPECT_EQ(std::memcmp(pos1.data(), pos7.data(), N * sizeof(glm::f32vec4)), 0);
+    EXPECT_EQ(std::memcmp(vel1.data(), vel7.data(), N * sizeof(glm::f32vec4)), 0);
+
+    std::vector<glm::f32vec4> posOther, velOther;
+    generate(43, 7, BOX, posOther, velOther);
+    EXPECT_NE(std::memcmp(pos1.data(), posOther.data(), N * sizeof(glm::f32vec4)), 0);
+}
+
+TEST(ParticleInit, DrawsWithinDistributionAndSpeciesFractions) {
+    std::vector<glm::f32vec4> pos, vel;
+    generate(7, 4, BOX, pos, vel);
+
+    glm::u32 protons = 0;
+    for (glm::u32 i = 0; i < N; i++) {
+        EXPECT_GE(pos[i].x, BOX.min.x);
+        EXPECT_LT(pos[i].x, BOX.max.x);
+        EXPECT_GE(pos[i].y, BOX.min.y);
+        EXPECT_LT(pos[i].y, BOX.max.y);
+        EXPECT_GE(pos[i].z, BOX.min.z);
+        EXPECT_LT(pos[i].z, BOX.max.z);
+        EXPECT_EQ(vel[i].w, 0.0f);
+        if (pos[i].w == static_cast<glm::f32>(PROTON)) protons++;
+        else EXPECT_EQ(pos[i].w, static_cast<glm::f32>(ELECTRON));
+    }
+    EXPECT_NEAR(static_cast<glm::f32>(protons) / N, 0.75f, 0.02f);
+}
+
+TEST(ParticleInit, CylindricalStaysInBand) {
+    ParticleDistribution band = { .type = DISTRIBUTION_CYLINDRICAL, .min = glm::f32vec3(1.0f, -0.1f, 0.0f), .max = glm::f32vec3(1.5f, 0.1f, 2.0f * PI) };
+    std::vector<glm::f32vec4> pos, vel;
+    generate(9, 3, band, pos, vel);
+
+    for (glm::u32 i = 0; i < N; i++) {
+        glm::f32 r = glm::length(glm::f32vec2(pos[i].x, pos[i].z));
+        EXPECT_GE(r, 1.0f - 1e-5f);
+        EXPECT_LE(r, 1.5f + 1e-5f);
+        EXPECT_GE(pos[i].y, -0.1f);
+        EXPECT_LT(pos[i].y, 0.1f);
+    }
+}
+
+TEST(ParticleInit, MacroparticlesMoveLikeTheirSpecies) {
+    std::vector<glm::f32vec4> table = species_init_table({ { ELECTRON, 1.0f }, { ELECTRON_MACROPARTICLE, 1.0f } }, 300.0f);
+    EXPECT_FLOAT_EQ(table[1].z, table[0].z);
+
+    const SpeciesInfo& electron = species_info(static_cast<glm::f32>(ELECTRON));
+    const SpeciesInfo& macro = species_info(static_cast<glm::f32>(ELECTRON_MACROPARTICLE));
+    EXPECT_FLOAT_EQ(macro.qOverM, electron.qOverM);
+    EXPECT_FLOAT_EQ(macro.charge / macro.mass, electron.charge / electron.mass);
+    EXPECT_FLOAT_EQ(macro.charge, electron.charge * macro.weight);
+}
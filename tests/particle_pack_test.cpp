@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <random>
+#include "physical_constants.h"
+#include "particle_pack.h"
+
+// Tests the host side of the packed particle layout (bench/particle_pack.wgsl).
+
+namespace {
+
+// The tokamak scene's default mesh: 1.4 m across at 5 cm spacing
+MeshProperties tokamak_mesh() {
+    MeshProperties mesh;
+    mesh.min = glm::f32vec3(-1.4f, -0.4f, -1.4f);
+    mesh.cell_size = glm::f32vec3(0.05f);
+    mesh.dim = glm::u32vec3(57, 17, 57);
+    mesh.max = mesh.min + glm::f32vec3(56.0f, 16.0f, 56.0f) * 0.05f;
+    return mesh;
+}
+
+} // namespace
+
+TEST(ParticlePack, RoundTripsWithinFormatPrecision) {
+    MeshProperties mesh = tokamak_mesh();
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<glm::f32> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<glm::f32> speed(-1e7f, 1e7f);
+
+    for (int i = 0; i < 10000; i++) {
+        glm::f32vec4 pos(
+            mesh.min.x + unit(gen) * (mesh.max.x - mesh.min.x),
+            mesh.min.y + unit(gen) * (mesh.max.y - mesh.min.y),
+            mesh.min.z + unit(gen) * (mesh.max.z - mesh.min.z),
+            static_cast<glm::f32>(i % 2 == 0 ? ELECTRON : PROTON));
+        glm::f32vec3 vel(speed(gen), speed(gen), speed(gen));
+
+        PackedParticle p = pack_particle(pos, vel, mesh);
+        glm::f32vec4 posOut = unpack_particle_pos(p, mesh);
+        glm::f32vec3 velOut = unpack_particle_vel(p);
+
+        // Half a unorm16 step of a cell, plus fp32 rounding of the absolute position
+        glm::f32 posTol = 0.5f * 0.05f / 65535.0f + 1e-6f;
+        EXPECT_NEAR(posOut.x, pos.x, posTol);
+        EXPECT_NEAR(posOut.y, pos.y, posTol);
+        EXPECT_NEAR(posOut.z, pos.z, posTol);
+        EXPECT_EQ(posOut.w, pos.w);
+
+        // Velocities are stored as they are
+        EXPECT_EQ(velOut.x, vel.x);
+        EXPECT_EQ(velOut.y, vel.y);
+        EXPECT_EQ(velOut.z, vel.z);
+    }
+}
+
+TEST(ParticlePack, KeepsPerStepVelocityChanges) {
+    MeshProperties mesh = tokamak_mesh();
+    glm::f32vec4 pos(1.0f, 0.0f, 0.0f, ELECTRON);
+
+    // An electron at 1e6 m/s gains about 18 m/s along its motion in a 1e-10 s step in 1 kV/m, where an f16 step is
+    // several hundred m/s
+    glm::f32vec3 vel(1e6f, 0.0f, 0.0f);
+    glm::f32vec3 dv(17.6f, 0.0f, 0.0f);
+    glm::f32vec3 before = unpack_particle_vel(pack_particle(pos, vel, mesh));
+    glm::f32vec3 after = unpack_particle_vel(pack_particle(pos, vel + dv, mesh));
+    EXPECT_EQ(after.x - before.x, (vel.x + dv.x) - vel.x);
+    EXPECT_GT(after.x - before.x, 17.0f);
+}
+
+TEST(ParticlePack, EmptySlotsAndOutOfMeshParticles) {
+    MeshProperties mesh = tokamak_mesh();
+
+    PackedParticle empty = pack_particle(glm::f32vec4(0.3f, 0.1f, 0.2f, 0.0f), glm::f32vec3(1e5f, 0.0f, 0.0f), mesh);
+    EXPECT_EQ(empty.fracZSpecies, 0u);
+    EXPECT_EQ(unpack_particle_pos(empty, mesh).w, 0.0f);
+
+    // Outside the mesh the position is clamped onto its edge
+    glm::f32vec4 outside = unpack_particle_pos(pack_particle(glm::f32vec4(5.0f, -2.0f, 0.0f, PROTON), glm::f32vec3(0.0f), mesh), mesh);
+    EXPECT_NEAR(outside.x, mesh.max.x + mesh.cell_size.x, 1e-5f);
+    EXPECT_NEAR(outside.y, mesh.min.y, 1e-5f);
+    EXPECT_NEAR(outside.z, 0.0f, 1e-5f);
+    EXPECT_EQ(outside.w, static_cast<glm::f32>(PROTON));
+}